@@ -1057,6 +1057,13 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &fom_state_counter },
 	{ M0_AVI_ALLOC,           "alloc",           { &dec, &ptr },
 	  { "size", "addr" } },
+	{ M0_AVI_MEM,             "mem",             { &dec, &dec, &dec },
+	  { "allocated", "alloc", "free" } },
+	{ M0_AVI_MEM_CLASS,       "mem-class",       { &dec, &dec, &dec, &dec,
+						       &dec, &dec, &dec, &dec,
+						       &dec, &dec, &dec, &dec },
+	  { "16", "32", "64", "128", "256", "512", "1K", "2K", "4K", "8K",
+	    "16K", "32K" } },
 	{ M0_AVI_FOM_DESCR,       "fom-descr",       { FID, &hex0x, &rpcop,
 						       &rpcop, &bol, &dec,
 						       &dec, &dec },
@@ -1073,6 +1080,13 @@ struct m0_addb2__id_intrp ids[] = {
 	{ M0_AVI_LOCALITY_CHAN_WAIT, "loc-wait-hist",  { HIST } },
 	{ M0_AVI_LOCALITY_CHAN_CB,   "loc-cb-hist",    { HIST } },
 	{ M0_AVI_LOCALITY_CHAN_QUEUE,"loc-queue-hist", { HIST } },
+	{ M0_AVI_FOM_STEAL,       "fom-steal",       { HIST } },
+	{ M0_AVI_RUNQ_BULK,       "runq-bulk",       { HIST } },
+	{ M0_AVI_RUNQ_INTERACTIVE, "runq-interactive", { HIST } },
+	{ M0_AVI_RUNQ_BACKGROUND, "runq-background", { HIST } },
+	{ M0_AVI_RUNQ_WAIT_BULK,  "runq-wait-bulk",  { HIST } },
+	{ M0_AVI_RUNQ_WAIT_INTERACTIVE, "runq-wait-interactive", { HIST } },
+	{ M0_AVI_RUNQ_WAIT_BACKGROUND, "runq-wait-background", { HIST } },
 	{ M0_AVI_IOS_IO_DESCR,    "ios-io-descr",    { FID, FID,
 						       &hex, &hex, &dec, &dec,
 						       &dec, &dec, &dec },
@@ -1120,6 +1134,12 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &beop_state_counter },
 	{ M0_AVI_BE_TX_TO_GROUP,  "tx-to-gr", { &dec, &dec, &dec },
 	  { "tx_id", "gr_id", "inout" } },
+	{ M0_AVI_BE_RECOVERY_SCAN, "be-recovery-scan",
+	  { &duration, &dec, &dec, &dec },
+	  { "duration", "records", "io_nr", "hit_nr" } },
+	{ M0_AVI_BE_RECOVERY_GROUP, "be-recovery-group",
+	  { &dec, &duration, &duration, &duration, &duration },
+	  { "log_pos", "log_read", "reconstruct", "reapply", "place" } },
 	{ M0_AVI_NET_BUF,         "net-buf",         { &ptr, &dec, &_clock,
 						       &duration, &dec, &dec },
 	  { "buf", "qtype", "time", "duration", "status", "len" } },
@@ -99,10 +99,27 @@ enum m0_addb2_value_id {
 	M0_AVI_LONG_LOCK,
 	/** Measurement: generic attribute. */
 	M0_AVI_ATTR,
+	/** Measurement: run queue length when a fom is stolen. */
+	M0_AVI_FOM_STEAL,
+	/**
+	 * Measurement: run queue length of a fom scheduling class, in
+	 * enum m0_fom_sched_class order.
+	 */
+	M0_AVI_RUNQ_BULK,
+	M0_AVI_RUNQ_INTERACTIVE,
+	M0_AVI_RUNQ_BACKGROUND,
+	/** Measurement: run queue wait time (usec) of a scheduling class. */
+	M0_AVI_RUNQ_WAIT_BULK,
+	M0_AVI_RUNQ_WAIT_INTERACTIVE,
+	M0_AVI_RUNQ_WAIT_BACKGROUND,
 
 	M0_AVI_LIB_RANGE_START     = 0x3000,
 	/** Measurement: memory allocation. */
 	M0_AVI_ALLOC,
+	/** Measurement: allocated, cumulative allocated and freed memory. */
+	M0_AVI_MEM,
+	/** Measurement: number of allocations per size class. */
+	M0_AVI_MEM_CLASS,
 
 	M0_AVI_RM_RANGE_START      = 0x4000,
 	M0_AVI_M0T1FS_RANGE_START  = 0x5000,
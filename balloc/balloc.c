@@ -37,6 +37,7 @@
 #include "lib/arith.h"	  /* min_check, m0_is_po2 */
 #include "lib/memory.h"
 #include "lib/locality.h" /* m0_locality0_get */
+#include "lib/hash.h"     /* m0_hash */
 #include "balloc.h"
 #include "motr/magic.h"
 
@@ -268,13 +269,256 @@ static struct m0_mutex *bgi_mutex(struct m0_balloc_group_info *grp)
 	return &grp->bgi_mutex.bm_u.mutex;
 }
 
-static void lext_del(struct m0_lext *le)
+/*
+ * Free extents of a zone are kept in m0_balloc_zone_param::bzp_extents list
+ * ordered by offset. Loaded zones additionally index them with two treaps
+ * (m0_lext_tree) built of the same m0_lext nodes:
+ *
+ * - M0_LEXT_BY_OFF finds neighbours of an extent being freed and the extent
+ *   containing a given block in O(log(fragments));
+ * - M0_LEXT_BY_LEN finds the best fitting extent and the maximal extent of
+ *   the zone in O(log(fragments)), which keeps bzp_maxchunk exact.
+ *
+ * Extents in a zone never overlap and their in-place modifications never
+ * change their mutual order, so only M0_LEXT_BY_LEN has to be updated when an
+ * extent is resized, see lext_ext_set().
+ */
+
+static int lext_cmp(enum m0_lext_tree t,
+		    const struct m0_lext *a, const struct m0_lext *b)
+{
+	int rc = 0;
+
+	if (t == M0_LEXT_BY_LEN)
+		rc = M0_3WAY(m0_ext_length(&a->le_ext),
+			     m0_ext_length(&b->le_ext));
+	return rc != 0 ? rc : M0_3WAY(a->le_ext.e_start, b->le_ext.e_start);
+}
+
+/* Splits the tree into nodes less than key and the rest. */
+static void lext_tree_split(enum m0_lext_tree t, struct m0_lext *root,
+			    const struct m0_lext *key,
+			    struct m0_lext **l, struct m0_lext **r)
+{
+	if (root == NULL) {
+		*l = NULL;
+		*r = NULL;
+	} else if (lext_cmp(t, root, key) < 0) {
+		*l = root;
+		lext_tree_split(t, root->le_child[t][1], key,
+				&root->le_child[t][1], r);
+	} else {
+		*r = root;
+		lext_tree_split(t, root->le_child[t][0], key,
+				l, &root->le_child[t][0]);
+	}
+}
+
+/* Merges trees, all nodes of l are less than nodes of r. */
+static struct m0_lext *lext_tree_merge(enum m0_lext_tree t,
+				       struct m0_lext *l, struct m0_lext *r)
+{
+	if (l == NULL)
+		return r;
+	if (r == NULL)
+		return l;
+	if (l->le_prio > r->le_prio) {
+		l->le_child[t][1] = lext_tree_merge(t, l->le_child[t][1], r);
+		return l;
+	} else {
+		r->le_child[t][0] = lext_tree_merge(t, l, r->le_child[t][0]);
+		return r;
+	}
+}
+
+static void lext_tree_insert(enum m0_lext_tree t, struct m0_lext **root,
+			     struct m0_lext *le)
+{
+	while (*root != NULL && (*root)->le_prio >= le->le_prio)
+		root = &(*root)->le_child[t][lext_cmp(t, le, *root) > 0];
+	lext_tree_split(t, *root, le, &le->le_child[t][0], &le->le_child[t][1]);
+	*root = le;
+}
+
+static void lext_tree_del(enum m0_lext_tree t, struct m0_lext **root,
+			  struct m0_lext *le)
+{
+	while (*root != le) {
+		M0_ASSERT(*root != NULL);
+		root = &(*root)->le_child[t][lext_cmp(t, le, *root) > 0];
+	}
+	*root = lext_tree_merge(t, le->le_child[t][0], le->le_child[t][1]);
+	le->le_child[t][0] = NULL;
+	le->le_child[t][1] = NULL;
+}
+
+/* Adds the extent, which is already in bzp_extents list, to the trees. */
+static void lext_index_add(struct m0_balloc_zone_param *zp, struct m0_lext *le)
+{
+	int t;
+
+	le->le_prio = m0_hash((uint64_t)le);
+	for (t = 0; t < M0_LEXT_TREE_NR; ++t) {
+		le->le_child[t][0] = NULL;
+		le->le_child[t][1] = NULL;
+		lext_tree_insert(t, &zp->bzp_tree[t], le);
+	}
+}
+
+/* Changes boundaries of the extent keeping the trees consistent. */
+static void lext_ext_set(struct m0_balloc_zone_param *zp, struct m0_ext *ext,
+			 m0_bindex_t start, m0_bindex_t end)
+{
+	struct m0_lext *le = container_of(ext, struct m0_lext, le_ext);
+
+	lext_tree_del(M0_LEXT_BY_LEN, &zp->bzp_tree[M0_LEXT_BY_LEN], le);
+	ext->e_start = start;
+	ext->e_end   = end;
+	lext_tree_insert(M0_LEXT_BY_LEN, &zp->bzp_tree[M0_LEXT_BY_LEN], le);
+}
+
+/* Returns the extent with the largest start not greater than start. */
+static struct m0_lext *lext_off_floor(struct m0_balloc_zone_param *zp,
+				      m0_bindex_t start)
+{
+	struct m0_lext *le = zp->bzp_tree[M0_LEXT_BY_OFF];
+	struct m0_lext *res = NULL;
+
+	while (le != NULL) {
+		if (le->le_ext.e_start <= start) {
+			res = le;
+			le = le->le_child[M0_LEXT_BY_OFF][1];
+		} else
+			le = le->le_child[M0_LEXT_BY_OFF][0];
+	}
+	return res;
+}
+
+/* Returns the extent with the smallest start not less than start. */
+static struct m0_lext *lext_off_ceil(struct m0_balloc_zone_param *zp,
+				     m0_bindex_t start)
+{
+	struct m0_lext *le = zp->bzp_tree[M0_LEXT_BY_OFF];
+	struct m0_lext *res = NULL;
+
+	while (le != NULL) {
+		if (le->le_ext.e_start >= start) {
+			res = le;
+			le = le->le_child[M0_LEXT_BY_OFF][0];
+		} else
+			le = le->le_child[M0_LEXT_BY_OFF][1];
+	}
+	return res;
+}
+
+/* Returns the shortest (lowest for equal lengths) extent of len or more. */
+static struct m0_lext *lext_len_ceil(struct m0_balloc_zone_param *zp,
+				     m0_bcount_t len)
+{
+	struct m0_lext *le = zp->bzp_tree[M0_LEXT_BY_LEN];
+	struct m0_lext *res = NULL;
+
+	while (le != NULL) {
+		if (m0_ext_length(&le->le_ext) >= len) {
+			res = le;
+			le = le->le_child[M0_LEXT_BY_LEN][0];
+		} else
+			le = le->le_child[M0_LEXT_BY_LEN][1];
+	}
+	return res;
+}
+
+static struct m0_lext *lext_len_max(struct m0_balloc_zone_param *zp)
+{
+	struct m0_lext *le = zp->bzp_tree[M0_LEXT_BY_LEN];
+
+	while (le != NULL && le->le_child[M0_LEXT_BY_LEN][1] != NULL)
+		le = le->le_child[M0_LEXT_BY_LEN][1];
+	return le;
+}
+
+static m0_bcount_t lext_maxchunk(struct m0_balloc_zone_param *zp)
+{
+	struct m0_lext *le = lext_len_max(zp);
+
+	return le == NULL ? 0 : m0_ext_length(&le->le_ext);
+}
+
+enum {
+	/**
+	 * Size of the path stack of lext_len_walk(). Treaps are balanced with
+	 * high probability, so the bound is almost never reached.
+	 */
+	LEXT_WALK_DEPTH_MAX = 64,
+};
+
+/*
+ * Calls cb() for at most max extents of len or more blocks in the order of
+ * M0_LEXT_BY_LEN, until cb() returns true.
+ *
+ * The walk keeps the not yet visited ancestors of the current extent in a
+ * stack of LEXT_WALK_DEPTH_MAX entries. Should the tree be deeper, the
+ * oldest entries are dropped and the walk is resumed from the root after the
+ * stack drains, looking for the successor of the last visited extent.
+ */
+static bool lext_len_walk(struct m0_lext *root, m0_bcount_t len, uint32_t max,
+			  bool (*cb)(struct m0_lext *le, void *datum),
+			  void *datum)
+{
+	struct m0_lext *stack[LEXT_WALK_DEPTH_MAX];
+	struct m0_lext *last  = NULL;
+	struct m0_lext *le    = root;
+	uint32_t        depth = 0;
+	uint32_t        nr    = 0;
+	bool            lost  = false;
+
+	while (nr < max) {
+		while (le != NULL) {
+			if (m0_ext_length(&le->le_ext) >= len &&
+			    (last == NULL ||
+			     lext_cmp(M0_LEXT_BY_LEN, le, last) > 0)) {
+				if (depth == ARRAY_SIZE(stack)) {
+					memmove(stack, stack + 1,
+						--depth * sizeof stack[0]);
+					lost = true;
+				}
+				stack[depth++] = le;
+				le = le->le_child[M0_LEXT_BY_LEN][0];
+			} else
+				le = le->le_child[M0_LEXT_BY_LEN][1];
+		}
+		if (depth == 0) {
+			if (!lost)
+				break;
+			lost = false;
+			le = root;
+			continue;
+		}
+		last = stack[--depth];
+		if (cb(last, datum))
+			return true;
+		++nr;
+		le = last->le_child[M0_LEXT_BY_LEN][1];
+	}
+	return false;
+}
+
+static void lext_free(struct m0_lext *le)
 {
 	m0_list_del(&le->le_link);
 	if (le->le_is_alloc)
 		m0_free(le);
 }
 
+static void lext_del(struct m0_balloc_zone_param *zp, struct m0_lext *le)
+{
+	int t;
+
+	for (t = 0; t < M0_LEXT_TREE_NR; ++t)
+		lext_tree_del(t, &zp->bzp_tree[t], le);
+	lext_free(le);
+}
+
 static struct m0_lext* lext_create(struct m0_ext *ex)
 {
 	struct m0_lext *le;
@@ -298,9 +542,10 @@ static void extents_release(struct m0_balloc_group_info *grp,
 	m0_bcount_t                  frags = 0;
 
 	zp = is_spare(zone_type) ? &grp->bgi_spare : &grp->bgi_normal;
+	M0_SET_ARR0(zp->bzp_tree);
 	while ((l = m0_list_first(&zp->bzp_extents)) != NULL) {
 		le = m0_list_entry(l, struct m0_lext, le_link);
-		lext_del(le);
+		lext_free(le);
 		++frags;
 	}
 	M0_LOG(M0_DEBUG, "zone_type = %d, grp=%p grpno=%lu list_frags=%d"
@@ -309,15 +554,85 @@ static void extents_release(struct m0_balloc_group_info *grp,
 	M0_ASSERT(ergo(frags > 0, frags == zp->bzp_fragments));
 }
 
-M0_INTERNAL int m0_balloc_release_extents(struct m0_balloc_group_info *grp)
+static void balloc_extents_unload(struct m0_balloc_group_info *grp)
+{
+	extents_release(grp, M0_BALLOC_SPARE_ZONE);
+	extents_release(grp, M0_BALLOC_NORMAL_ZONE);
+	m0_free0(&grp->bgi_extents);
+	grp->bgi_extents_nr = 0;
+}
+
+/*
+ * Group extents are loaded on demand and kept in the LRU list of
+ * m0_balloc_loader. Lock ordering: group lock, then bl_lock. Groups are
+ * evicted under bl_lock, so their locks are only tried there.
+ */
+
+static void balloc_lru_del(struct m0_balloc_loader    *bl,
+			   struct m0_balloc_group_info *grp)
 {
+	M0_PRE(m0_mutex_is_locked(&bl->bl_lock));
+	M0_PRE(bl->bl_loaded >= grp->bgi_extents_nr);
 
+	m0_list_del(&grp->bgi_lru_link);
+	bl->bl_loaded -= grp->bgi_extents_nr;
+}
 
+/* Adds the group to the head of LRU, or moves it there if already added. */
+static void balloc_lru_touch(struct m0_balloc_loader    *bl,
+			     struct m0_balloc_group_info *grp)
+{
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
+	M0_PRE(grp->bgi_extents != NULL);
 
-	extents_release(grp, M0_BALLOC_SPARE_ZONE);
-	extents_release(grp, M0_BALLOC_NORMAL_ZONE);
-	m0_free0(&grp->bgi_extents);
+	m0_mutex_lock(&bl->bl_lock);
+	if (m0_list_link_is_in(&grp->bgi_lru_link))
+		m0_list_del(&grp->bgi_lru_link);
+	else
+		bl->bl_loaded += grp->bgi_extents_nr;
+	m0_list_add(&bl->bl_lru, &grp->bgi_lru_link);
+	m0_mutex_unlock(&bl->bl_lock);
+}
+
+/* Releases extents of the least recently used groups over the budget. */
+static void balloc_lru_shrink(struct m0_balloc_loader    *bl,
+			      struct m0_balloc_group_info *cur)
+{
+	struct m0_balloc_group_info *grp;
+	struct m0_list_link         *link;
+	struct m0_list_link         *prev;
+
+	m0_mutex_lock(&bl->bl_lock);
+	for (link = bl->bl_lru.l_tail;
+	     link != (void *)&bl->bl_lru && bl->bl_loaded > bl->bl_budget;
+	     link = prev) {
+		prev = link->ll_prev;
+		grp = m0_list_entry(link, struct m0_balloc_group_info,
+				    bgi_lru_link);
+		if (grp == cur || m0_mutex_trylock(bgi_mutex(grp)) != 0)
+			continue;
+		M0_LOG(M0_DEBUG, "evict grp=%"PRIu64" extents=%"PRIu64,
+		       grp->bgi_groupno, grp->bgi_extents_nr);
+		balloc_lru_del(bl, grp);
+		balloc_extents_unload(grp);
+		m0_mutex_unlock(bgi_mutex(grp));
+	}
+	m0_mutex_unlock(&bl->bl_lock);
+}
+
+M0_INTERNAL int m0_balloc_release_extents(struct m0_balloc_group_info *grp)
+{
+	struct m0_balloc_loader *bl = grp->bgi_loader;
+
+	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
+
+	if (bl != NULL) {
+		m0_mutex_lock(&bl->bl_lock);
+		if (m0_list_link_is_in(&grp->bgi_lru_link))
+			balloc_lru_del(bl, grp);
+		m0_mutex_unlock(&bl->bl_lock);
+	}
+	balloc_extents_unload(grp);
 	return 0;
 }
 
@@ -336,6 +651,142 @@ M0_INTERNAL void m0_balloc_unlock_group(struct m0_balloc_group_info *grp)
 	m0_mutex_unlock(bgi_mutex(grp));
 }
 
+enum {
+	/** How many groups after the last allocated block are prefetched. */
+	M0_BALLOC_PREFETCH_AHEAD = 4,
+};
+
+M0_INTERNAL struct m0_balloc_loader *m0_balloc_loader(struct m0_balloc *bal)
+{
+	/* All groups of an allocator reference the same loader. */
+	return bal->cb_group_info == NULL ? NULL :
+		bal->cb_group_info[0].bgi_loader;
+}
+
+/* Queues the group for the prefetcher unless its extents are loaded. */
+static void balloc_prefetch(struct m0_balloc *bal, m0_bindex_t group)
+{
+	struct m0_balloc_loader *bl = m0_balloc_loader(bal);
+	bool                     queued = false;
+
+	if (bl == NULL || group >= bal->cb_sb.bsb_groupcount)
+		return;
+
+	m0_mutex_lock(&bl->bl_lock);
+	if (!m0_list_link_is_in(&bal->cb_group_info[group].bgi_lru_link) &&
+	    bl->bl_qtail - bl->bl_qhead < M0_BALLOC_PREFETCH_QUEUE_SIZE) {
+		bl->bl_queue[bl->bl_qtail++ % M0_BALLOC_PREFETCH_QUEUE_SIZE] =
+			group;
+		queued = true;
+	}
+	m0_mutex_unlock(&bl->bl_lock);
+	if (queued)
+		m0_semaphore_up(&bl->bl_wakeup);
+}
+
+static void balloc_prefetcher(struct m0_balloc_loader *bl)
+{
+	struct m0_balloc            *bal = bl->bl_balloc;
+	struct m0_balloc_group_info *grp;
+	m0_bindex_t                  group;
+
+	while (true) {
+		m0_semaphore_down(&bl->bl_wakeup);
+		m0_mutex_lock(&bl->bl_lock);
+		if (bl->bl_shutdown) {
+			m0_mutex_unlock(&bl->bl_lock);
+			break;
+		}
+		M0_ASSERT(bl->bl_qhead < bl->bl_qtail);
+		group = bl->bl_queue[bl->bl_qhead++ %
+				     M0_BALLOC_PREFETCH_QUEUE_SIZE];
+		m0_mutex_unlock(&bl->bl_lock);
+
+		grp = m0_balloc_gn2info(bal, group);
+		m0_balloc_lock_group(grp);
+		if (grp->bgi_extents == NULL &&
+		    group_freeblocks_get(grp) +
+		    group_spare_freeblocks_get(grp) > 0) {
+			M0_LOG(M0_DEBUG, "prefetch grp=%"PRIu64, group);
+			(void)m0_balloc_load_extents(bal, grp);
+		}
+		m0_balloc_unlock_group(grp);
+	}
+}
+
+/*
+ * Starts the loader. It is attached to the groups by balloc_loader_attach()
+ * once they are loaded.
+ */
+static int balloc_loader_init(struct m0_balloc *bal,
+			      struct m0_balloc_loader **out)
+{
+	struct m0_balloc_loader *bl;
+	int                      rc;
+
+	M0_ALLOC_PTR(bl);
+	if (bl == NULL)
+		return M0_ERR(-ENOMEM);
+	m0_mutex_init(&bl->bl_lock);
+	m0_list_init(&bl->bl_lru);
+	m0_semaphore_init(&bl->bl_wakeup, 0);
+	bl->bl_budget = M0_BALLOC_LOADED_EXTENTS_MAX;
+	bl->bl_balloc = bal;
+
+	rc = M0_THREAD_INIT(&bl->bl_prefetcher, struct m0_balloc_loader *,
+			    NULL, &balloc_prefetcher, bl, "balloc_pf");
+	if (rc != 0) {
+		m0_semaphore_fini(&bl->bl_wakeup);
+		m0_list_fini(&bl->bl_lru);
+		m0_mutex_fini(&bl->bl_lock);
+		m0_free(bl);
+		return M0_ERR(rc);
+	}
+	*out = bl;
+	return M0_RC(rc);
+}
+
+static void balloc_loader_attach(struct m0_balloc        *bal,
+				 struct m0_balloc_loader *bl)
+{
+	m0_bcount_t i;
+
+	for (i = 0; i < bal->cb_sb.bsb_groupcount; ++i)
+		bal->cb_group_info[i].bgi_loader = bl;
+}
+
+/*
+ * Stops the prefetcher and detaches the loader from the groups. Extents of
+ * the groups are released by the caller.
+ */
+static void balloc_loader_fini(struct m0_balloc        *bal,
+			       struct m0_balloc_loader *bl)
+{
+	struct m0_list_link *link;
+
+	m0_mutex_lock(&bl->bl_lock);
+	bl->bl_shutdown = true;
+	m0_mutex_unlock(&bl->bl_lock);
+	m0_semaphore_up(&bl->bl_wakeup);
+	m0_thread_join(&bl->bl_prefetcher);
+	m0_thread_fini(&bl->bl_prefetcher);
+
+	m0_mutex_lock(&bl->bl_lock);
+	while ((link = m0_list_first(&bl->bl_lru)) != NULL)
+		balloc_lru_del(bl, m0_list_entry(link,
+						 struct m0_balloc_group_info,
+						 bgi_lru_link));
+	m0_mutex_unlock(&bl->bl_lock);
+	M0_ASSERT(bl->bl_loaded == 0);
+
+	if (m0_balloc_loader(bal) == bl)
+		balloc_loader_attach(bal, NULL);
+	m0_semaphore_fini(&bl->bl_wakeup);
+	m0_list_fini(&bl->bl_lru);
+	m0_mutex_fini(&bl->bl_lock);
+	m0_free(bl);
+}
+
 #define MAX_ALLOCATION_CHUNK 2048ULL
 
 M0_INTERNAL void m0_balloc_group_desc_init(struct m0_balloc_group_desc *desc)
@@ -373,6 +824,8 @@ static int balloc_group_info_init(struct m0_balloc_group_info *gi,
 	if (rc == 0) {
 		gi->bgi_state   = M0_BALLOC_GROUP_INFO_INIT;
 		gi->bgi_extents = NULL;
+		gi->bgi_loader  = NULL;
+		m0_list_link_init(&gi->bgi_lru_link);
 
 		spare_zone_size =
 			m0_stob_ad_spares_calc(cb->cb_sb.bsb_groupsize);
@@ -401,6 +854,7 @@ static int balloc_group_info_init(struct m0_balloc_group_info *gi,
 
 static void balloc_group_info_fini(struct m0_balloc_group_info *gi)
 {
+	m0_list_link_fini(&gi->bgi_lru_link);
 	m0_mutex_fini(bgi_mutex(gi));
 	m0_list_fini(&gi->bgi_normal.bzp_extents);
 	m0_list_fini(&gi->bgi_spare.bzp_extents);
@@ -433,11 +887,14 @@ static int balloc_group_info_load(struct m0_balloc *bal)
  */
 static void balloc_fini_internal(struct m0_balloc *bal)
 {
+	struct m0_balloc_loader     *bl = m0_balloc_loader(bal);
 	struct m0_balloc_group_info *gi;
 	int                          i;
 
 	M0_ENTRY();
 
+	if (bl != NULL)
+		balloc_loader_fini(bal, bl);
 	if (bal->cb_group_info != NULL) {
 		for (i = 0 ; i < bal->cb_sb.bsb_groupcount; i++) {
 			gi = &bal->cb_group_info[i];
@@ -468,11 +925,17 @@ static int ge_tree_cmp(const void *k0, const void *k1)
 	return M0_3WAY(*bn0, *bn1);
 }
 
+static uint64_t ge_tree_prefix(const void *k)
+{
+	return *(const m0_bindex_t *)k;
+}
+
 static const struct m0_be_btree_kv_ops ge_btree_ops = {
 	.ko_type    = M0_BBT_BALLOC_GROUP_EXTENTS,
 	.ko_ksize   = ge_tree_kv_size,
 	.ko_vsize   = ge_tree_kv_size,
-	.ko_compare = ge_tree_cmp
+	.ko_compare = ge_tree_cmp,
+	.ko_prefix  = ge_tree_prefix
 };
 
 static m0_bcount_t gd_tree_key_size(const void *k)
@@ -785,6 +1248,7 @@ static void balloc_zone_init(struct m0_balloc_zone_param *zone, uint64_t type,
 	zone->bzp_fragments = fragments;
 	zone->bzp_maxchunk = maxchunk;
 	m0_list_init(&zone->bzp_extents);
+	M0_SET_ARR0(zone->bzp_tree);
 }
 
 static int balloc_groups_write(struct m0_balloc *bal)
@@ -957,7 +1421,9 @@ static int balloc_init_internal(struct m0_balloc *bal,
 				m0_bcount_t blocks_per_group,
 				m0_bcount_t spare_blocks_per_group)
 {
-	int rc;
+	struct m0_balloc_loader *bl;
+	m0_bcount_t              i;
+	int                      rc;
 
 	M0_ENTRY();
 
@@ -968,6 +1434,12 @@ static int balloc_init_internal(struct m0_balloc *bal,
 	m0_be_btree_init(&bal->cb_db_group_desc, seg, &gd_btree_ops);
 	m0_be_btree_init(&bal->cb_db_group_extents, seg, &ge_btree_ops);
 
+	rc = balloc_loader_init(bal, &bl);
+	if (rc != 0) {
+		balloc_fini_internal(bal);
+		return M0_RC(rc);
+	}
+
 	if (bal->cb_sb.bsb_magic != M0_BALLOC_SB_MAGIC) {
 		struct m0_balloc_format_req req = { 0 };
 
@@ -978,8 +1450,12 @@ static int balloc_init_internal(struct m0_balloc *bal,
 		req.bfr_spare_reserved_blocks = spare_blocks_per_group;
 
 		rc = balloc_format(bal, &req, grp);
-		if (rc != 0)
+		if (rc == 0)
+			balloc_loader_attach(bal, bl);
+		else {
+			balloc_loader_fini(bal, bl);
 			balloc_fini_internal(bal);
+		}
 		return M0_RC(rc);
 	}
 
@@ -999,8 +1475,16 @@ static int balloc_init_internal(struct m0_balloc *bal,
 	}
 	rc = rc ?: sb_mount(bal, grp);
 out:
-	if (rc != 0)
+	if (rc != 0) {
+		balloc_loader_fini(bal, bl);
 		balloc_fini_internal(bal);
+	} else {
+		balloc_loader_attach(bal, bl);
+		/* Warm up the groups the next allocations will start from. */
+		for (i = 0; i < M0_BALLOC_PREFETCH_AHEAD; ++i)
+			balloc_prefetch(bal, (balloc_bn2gn(bal->cb_last, bal) +
+					      i) % bal->cb_sb.bsb_groupcount);
+	}
 	return M0_RC(rc);
 }
 
@@ -1175,8 +1659,8 @@ out:
 
 /* called under group lock */
 #ifdef __SPARE_SPACE__
-M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
-				       struct m0_balloc_group_info *grp)
+static int balloc_extents_load(struct m0_balloc *cb,
+			       struct m0_balloc_group_info *grp)
 {
 	struct m0_be_btree	  *db_ext = &cb->cb_db_group_extents;
 	struct m0_be_btree_cursor  cursor;
@@ -1193,14 +1677,11 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		 (int)grp->bgi_groupno, (int)group_fragments_get(grp),
 		 (int)group_spare_fragments_get(grp));
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
+	M0_PRE(grp->bgi_extents == NULL);
 
-	if (grp->bgi_extents != NULL) {
-		M0_LOG(M0_DEBUG, "Already loaded");
-		return M0_RC(0);
-	}
-
-	M0_ALLOC_ARR(grp->bgi_extents, group_fragments_get(grp) +
-		     group_spare_fragments_get(grp) + 1);
+	grp->bgi_extents_nr = group_fragments_get(grp) +
+			      group_spare_fragments_get(grp) + 1;
+	M0_ALLOC_ARR(grp->bgi_extents, grp->bgi_extents_nr);
 	if (grp->bgi_extents == NULL)
 		return M0_RC(-ENOMEM);
 
@@ -1232,11 +1713,13 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		ex->le_ext.e_end   = *(m0_bindex_t*)key.b_addr;
 		ex->le_ext.e_start = *(m0_bindex_t*)val.b_addr;
 		m0_ext_init(&ex->le_ext);
-		if (m0_ext_is_partof(&normal_range, &ex->le_ext))
+		if (m0_ext_is_partof(&normal_range, &ex->le_ext)) {
 			m0_list_add_tail(group_normal_ext(grp),
 					 &ex->le_link);
-		else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
+			lext_index_add(&grp->bgi_normal, ex);
+		} else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
 			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
+			lext_index_add(&grp->bgi_spare, ex);
 		}
 		else {
 			M0_LOG(M0_ERROR, "Invalid extent");
@@ -1253,7 +1736,7 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 			(unsigned long long)(group_fragments_get(grp) +
 					     group_spare_fragments_get(grp)));
 	if (rc != 0)
-		m0_balloc_release_extents(grp);
+		balloc_extents_unload(grp);
 
 	return M0_RC(rc);
 }
@@ -1270,8 +1753,8 @@ static void zone_params_update(struct m0_balloc_group_info *grp,
 	zp->bzp_freeblocks += m0_ext_length(ext);
 }
 
-M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
-				       struct m0_balloc_group_info *grp)
+static int balloc_extents_load(struct m0_balloc *cb,
+			       struct m0_balloc_group_info *grp)
 {
 	struct m0_be_btree	  *db_ext = &cb->cb_db_group_extents;
 	struct m0_buf              key;
@@ -1289,11 +1772,7 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		 (int)grp->bgi_groupno, (int)group_fragments_get(grp),
 		 (int)group_spare_fragments_get(grp));
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
-
-	if (grp->bgi_extents != NULL) {
-		M0_LOG(M0_DEBUG, "Already loaded");
-		return M0_RC(0);
-	}
+	M0_PRE(grp->bgi_extents == NULL);
 
 	if (group_fragments_get(grp) +
 	    group_spare_fragments_get(grp) == 0) {
@@ -1301,8 +1780,9 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		return M0_RC(0);
 	}
 
-	M0_ALLOC_ARR(grp->bgi_extents, group_fragments_get(grp) +
-		     group_spare_fragments_get(grp) + 1);
+	grp->bgi_extents_nr = group_fragments_get(grp) +
+			      group_spare_fragments_get(grp) + 1;
+	M0_ALLOC_ARR(grp->bgi_extents, grp->bgi_extents_nr);
 	if (grp->bgi_extents == NULL)
 		return M0_RC(-ENOMEM);
 
@@ -1334,11 +1814,13 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		m0_ext_init(&ex->le_ext);
 		if (m0_ext_is_partof(&normal_range, &ex->le_ext)) {
 			m0_list_add_tail(group_normal_ext(grp), &ex->le_link);
+			lext_index_add(&grp->bgi_normal, ex);
 			++normal_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_NORMAL_ZONE);
 		} else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
 			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
+			lext_index_add(&grp->bgi_spare, ex);
 			++spare_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_SPARE_ZONE);
@@ -1356,7 +1838,7 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 			(unsigned long long)(group_fragments_get(grp) +
 					     group_spare_fragments_get(grp)));
 	if (rc != 0)
-		m0_balloc_release_extents(grp);
+		balloc_extents_unload(grp);
 	else {
 		grp->bgi_normal.bzp_fragments = normal_frags;
 		grp->bgi_spare.bzp_fragments = spare_frags;
@@ -1366,6 +1848,31 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 }
 #endif
 
+/* called under group lock */
+M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
+				       struct m0_balloc_group_info *grp)
+{
+	struct m0_balloc_loader *bl = grp->bgi_loader;
+	bool                     loaded = false;
+	int                      rc;
+
+	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
+
+	if (grp->bgi_extents == NULL) {
+		rc = balloc_extents_load(cb, grp);
+		/* Groups without fragments have nothing to load. */
+		if (rc != 0 || grp->bgi_extents == NULL)
+			return rc;
+		loaded = true;
+	}
+	if (bl != NULL) {
+		balloc_lru_touch(bl, grp);
+		if (loaded)
+			balloc_lru_shrink(bl, grp);
+	}
+	return 0;
+}
+
 #if 0
 /* called under group lock */
 static int balloc_find_extent_exact(struct m0_balloc_allocation_context *bac,
@@ -1396,71 +1903,54 @@ static int balloc_find_extent_exact(struct m0_balloc_allocation_context *bac,
 }
 #endif
 
-/* called under group lock */
+struct balloc_buddy_search {
+	m0_bindex_t    bbs_zone_start;
+	m0_bcount_t    bbs_len;
+	struct m0_ext *bbs_ext;
+};
+
+static bool balloc_buddy_match(struct m0_lext *le, void *datum)
+{
+	struct balloc_buddy_search *bs = datum;
+
+	M0_LOG(M0_DEBUG, "frag="EXT_F, EXT_P(&le->le_ext));
+	if (((le->le_ext.e_start - bs->bbs_zone_start) & (bs->bbs_len - 1)) != 0)
+		return false;
+	*bs->bbs_ext = le->le_ext;
+	return true;
+}
+
+/*
+ * Finds the shortest free extent of at least len blocks starting at a len
+ * aligned offset from the zone start. len is a power of 2. At most
+ * M0_BALLOC_BUDDY_LOOKUP_MAX extents long enough are examined.
+ *
+ * called under group lock
+ */
 static int balloc_find_extent_buddy(struct balloc_allocation_context *bac,
 				    struct m0_balloc_group_info *grp,
 				    m0_bcount_t len,
 				    enum m0_balloc_allocation_flag alloc_flag,
 				    struct m0_ext *ex)
 {
-	int                          found = 0;
-	m0_bcount_t                  flen;
-	m0_bcount_t start;
-	struct m0_ext               *frag;
-	struct m0_lext              *le;
-	struct m0_ext                min = {
-					.e_start = 0,
-					.e_end = 0xffffffff,
-				     };
 	struct m0_balloc_zone_param *zp;
+	struct balloc_buddy_search   bs;
 
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
-
-	m0_ext_init(&min);
+	M0_PRE(m0_is_po2(len));
 
 	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 
 	M0_LOG(M0_DEBUG, "start=%lu len=%lu", zp->bzp_range.e_start, len);
 
-	start = zp->bzp_range.e_start;
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		frag = &le->le_ext;
-		flen = m0_ext_length(frag);
-		M0_LOG(M0_DEBUG, "frag="EXT_F, EXT_P(frag));
-repeat:
-		/*
-		{
-			char msg[128];
-			sprintf(msg, "buddy[s=%llu:0x%08llx, l=%u:0x%08x]",
-			(unsigned long long)start,
-			(unsigned long long)start,
-			(int)len, (int)len);
-			(void)msg;
-			balloc_debug_dump_extent(msg, frag);
-			}
-		*/
-		if (frag->e_start == start && flen >= len) {
-			++found;
-			if (flen < m0_ext_length(&min))
-				min = *frag;
-			if (flen == len || found > M0_BALLOC_BUDDY_LOOKUP_MAX)
-				break;
-		}
-		if (frag->e_start > start) {
-			do {
-				start += len;
-			} while (frag->e_start > start);
-			if (start >= zp->bzp_range.e_end)
-				break;
-			/* we changed the 'start'. let's restart searching. */
-			goto repeat;
-		}
-	}
-
-	if (found > 0)
-		*ex = min;
-
-	return found;
+	bs = (struct balloc_buddy_search) {
+		.bbs_zone_start = zp->bzp_range.e_start,
+		.bbs_len        = len,
+		.bbs_ext        = ex,
+	};
+	return lext_len_walk(zp->bzp_tree[M0_LEXT_BY_LEN], len,
+			     M0_BALLOC_BUDDY_LOOKUP_MAX,
+			     &balloc_buddy_match, &bs) ? 1 : 0;
 }
 
 static int balloc_use_best_found(struct balloc_allocation_context *bac,
@@ -1539,19 +2029,16 @@ static bool is_extent_free(struct m0_balloc_group_info *grp,
 {
 	struct m0_lext              *le;
 	struct m0_balloc_zone_param *zp;
-	m0_bcount_t                  frags = 0;
 
 	M0_ENTRY();
 
 	zp = is_spare(alloc_type) ? &grp->bgi_spare : &grp->bgi_normal;
 
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		*current = &le->le_ext;
-		if (m0_ext_is_partof(*current, tgt))
-			break;
-		++frags;
-	}
-	return frags < zp->bzp_fragments;
+	le = lext_off_floor(zp, tgt->e_start);
+	if (le == NULL)
+		return false;
+	*current = &le->le_ext;
+	return m0_ext_is_partof(*current, tgt);
 }
 
 static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
@@ -1566,7 +2053,6 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 	struct m0_lext              *lcur;
 	struct m0_balloc_zone_param *zp;
 	int                          rc = 0;
-	m0_bcount_t                  maxchunk;
 
 	M0_ENTRY();
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
@@ -1578,25 +2064,9 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 	balloc_debug_dump_extent("target=", tgt);
 
 	zp = is_spare(alloc_type) ? &grp->bgi_spare : &grp->bgi_normal;
-	maxchunk = zp->bzp_maxchunk;
 
 	balloc_debug_dump_extent("current=", cur);
 
-	if (m0_ext_length(cur) == zp->bzp_maxchunk) {
-		/* find next to max sized chunk */
-		maxchunk = 0;
-		m0_list_for_each_entry(&zp->bzp_extents, le,
-				       struct m0_lext, le_link) {
-			if (&le->le_ext == cur)
-				continue;
-			maxchunk = max_check(maxchunk,
-					     m0_ext_length(&le->le_ext));
-		}
-	}
-
-	M0_LOG(M0_DEBUG, "bzp_maxchunk=0x%"PRIx64" next_maxchunk=0x%"PRIx64,
-	       zp->bzp_maxchunk, maxchunk);
-
 	if (cur->e_end == tgt->e_end) {
 		key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 
@@ -1609,20 +2079,19 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			/* |   cur free   |     allocated      | */
 			/* |      |  tgt  |                    | */
 			/* +------+-------+--------------------+ */
-			cur->e_end = tgt->e_start;
+			lext_ext_set(zp, cur, cur->e_start, tgt->e_start);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_insert_sync(db, tx, &key, &val);
 			if (rc != 0)
 				return M0_RC(rc);
-			maxchunk = max_check(maxchunk, m0_ext_length(cur));
 		} else {
 			/* +-------------+---------------------+ */
 			/* |   cur free  |      allocated      | */
 			/* |     tgt     |                     | */
 			/* +-------------+---------------------+ */
 			le = container_of(cur, struct m0_lext, le_ext);
-			lext_del(le);
+			lext_del(zp, le);
 			zp->bzp_fragments--;
 		}
 	} else {
@@ -1632,7 +2101,7 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 		/* |              cur free             | */
 		/* |     tgt    |                      | */
 		/* +------------+----------------------+ */
-		cur->e_start = tgt->e_end;
+		lext_ext_set(zp, cur, tgt->e_end, cur->e_end);
 
 		key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 		val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
@@ -1640,8 +2109,6 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 		if (rc != 0)
 			return M0_RC(rc);
 
-		maxchunk = max_check(maxchunk, m0_ext_length(cur));
-
 		if (new.e_start < tgt->e_start) {
 			/* +-----------------------------------+ */
 			/* |              cur free             | */
@@ -1660,11 +2127,12 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			}
 			lcur = container_of(cur, struct m0_lext, le_ext);
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_index_add(zp, le);
 			zp->bzp_fragments++;
-			maxchunk = max_check(maxchunk, m0_ext_length(&new));
 		}
 	}
-	zp->bzp_maxchunk = maxchunk;
+	zp->bzp_maxchunk = lext_maxchunk(zp);
+	M0_LOG(M0_DEBUG, "bzp_maxchunk=0x%"PRIx64, zp->bzp_maxchunk);
 	zp->bzp_freeblocks -= m0_ext_length(tgt);
 
 	grp->bgi_state |= M0_BALLOC_GROUP_INFO_DIRTY;
@@ -1698,8 +2166,8 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 	struct m0_lext              *le;
 	struct m0_lext              *lcur;
 	struct m0_balloc_zone_param *zp;
-	m0_bcount_t                  frags = 0;
 	m0_bcount_t                  maxchunk;
+	m0_bindex_t                  start;
 	int                          rc = 0;
 	int                          found = 0;
 
@@ -1710,16 +2178,12 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 
 	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 	maxchunk = zp->bzp_maxchunk;
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		cur = &le->le_ext;
-
-		if (cur->e_start >= tgt->e_start) {
-			found = 1;
-			break;
-		}
-		pre = cur;
-		++frags;
-	}
+	/* cur is the first extent not before tgt, or the last extent. */
+	le = tgt->e_start == 0 ? NULL : lext_off_floor(zp, tgt->e_start - 1);
+	pre = le == NULL ? NULL : &le->le_ext;
+	le = lext_off_ceil(zp, tgt->e_start);
+	found = le != NULL;
+	cur = found ? &le->le_ext : pre;
 	balloc_debug_dump_extent("prev=", pre);
 	balloc_debug_dump_extent("current=", cur);
 
@@ -1745,7 +2209,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 	lcur = container_of(cur, struct m0_lext, le_ext);
 
 	if (!found) {
-		if (frags == 0) {
+		if (pre == NULL) {
 			/*       No free fragments at all:       */
 			/* +-----------------------------------+ */
 			/* |              allocated            | */
@@ -1762,6 +2226,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add(&zp->bzp_extents, &le->le_link);
+			lext_index_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1783,6 +2248,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 					return M0_RC(rc);
 				}
 				m0_list_add_after(&lcur->le_link, &le->le_link);
+				lext_index_add(zp, le);
 				++zp->bzp_fragments;
 				maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 			} else {
@@ -1795,7 +2261,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				rc = btree_delete_sync(db, tx, &key);
 				if (rc != 0)
 					return M0_RC(rc);
-				cur->e_end = tgt->e_end;
+				lext_ext_set(zp, cur, cur->e_start, tgt->e_end);
 				val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 				rc = btree_insert_sync(db, tx, &key, &val);
 				if (rc != 0)
@@ -1822,6 +2288,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_index_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1831,7 +2298,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* |     |   tgt   |                   | */
 			/* +-----+---------+-------------------+ */
 			M0_ASSERT(tgt->e_end == cur->e_start);
-			cur->e_start = tgt->e_start;
+			lext_ext_set(zp, cur, tgt->e_start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
@@ -1852,15 +2319,16 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			rc = btree_delete_sync(db, tx, &key);
 			if (rc != 0)
 				return M0_RC(rc);
-			cur->e_start = pre->e_start;
+			start = pre->e_start;
+			le = container_of(pre, struct m0_lext, le_ext);
+			lext_del(zp, le);
+			--zp->bzp_fragments;
+			lext_ext_set(zp, cur, start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
 			if (rc != 0)
 				return M0_RC(rc);
-			le = container_of(pre, struct m0_lext, le_ext);
-			lext_del(le);
-			--zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(cur));
 		} else if (pre->e_end == tgt->e_start) {
 			/*          Joint with prev:             */
@@ -1872,7 +2340,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			rc = btree_delete_sync(db, tx, &key);
 			if (rc != 0)
 				return M0_RC(rc);
-			pre->e_end = tgt->e_end;
+			lext_ext_set(zp, pre, pre->e_start, tgt->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&pre->e_start);
 			rc = btree_insert_sync(db, tx, &key, &val);
 			if (rc != 0)
@@ -1884,7 +2352,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* |  pre  |       <--|    cur free    | */
 			/* |          |  tgt  |                | */
 			/* +----------+-------+----------------+ */
-			cur->e_start = tgt->e_start;
+			lext_ext_set(zp, cur, tgt->e_start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
@@ -1908,6 +2376,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_index_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		}
@@ -2234,21 +2703,20 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 				  struct m0_balloc_group_info *grp,
 				  enum m0_balloc_allocation_flag alloc_flag)
 {
-	struct m0_list  *list;
-	m0_bcount_t	 free;
-	struct m0_ext	*ex;
-	struct m0_lext	*le;
-	int		 rc;
+	struct m0_balloc_zone_param *zp;
+	m0_bcount_t                  free;
+	struct m0_ext               *ex;
+	struct m0_lext              *le;
+	int                          rc;
 	M0_ENTRY();
 
 #ifdef __SPARE_SPACE__
 	free = is_spare(bac->bac_flags) ? group_spare_freeblocks_get(grp) :
 		group_freeblocks_get(grp);
-	list = is_spare(alloc_flag) ? &grp->bgi_spare.bzp_extents :
-		 &grp->bgi_normal.bzp_extents;
+	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 #else
 	free = group_freeblocks_get(grp);
-	list = &grp->bgi_normal.bzp_extents;
+	zp = &grp->bgi_normal;
 #endif
 
 
@@ -2256,22 +2724,39 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 		(unsigned long long)grp->bgi_groupno,
 		(unsigned long long)free);
 
-	m0_list_for_each_entry(list, le, struct m0_lext, le_link) {
-		ex = &le->le_ext;
-		if (m0_ext_length(ex) > free) {
-			M0_LOG(M0_WARN, "corrupt group=%llu "
-				"ex=[0x%08llx:0x%08llx)",
-				(unsigned long long)grp->bgi_groupno,
-				(unsigned long long)ex->e_start,
-				(unsigned long long)ex->e_end);
-			return M0_RC(-EINVAL);
-		}
-		balloc_measure_extent(bac, grp, alloc_flag, ex);
+	/*
+	 * Measuring all extents of the group ends up with the best fitting
+	 * one (the shortest one satisfying the goal, or the longest one if
+	 * none does), which the length index gives right away.
+	 */
+	if (bac->bac_flags & M0_BALLOC_HINT_FIRST)
+		le = lext_off_ceil(zp, 0);
+	else {
+		le = lext_len_ceil(zp, m0_ext_length(&bac->bac_goal));
+		if (le == NULL)
+			le = lext_len_max(zp);
+	}
+	if (le == NULL)
+		return M0_RC(0);
 
-		free -= m0_ext_length(ex);
-		if (free == 0 || bac->bac_status != M0_BALLOC_AC_CONTINUE)
-			return M0_RC(0);
+	ex = &le->le_ext;
+	if (m0_ext_length(ex) > free) {
+		M0_LOG(M0_WARN, "corrupt group=%llu "
+			"ex=[0x%08llx:0x%08llx)",
+			(unsigned long long)grp->bgi_groupno,
+			(unsigned long long)ex->e_start,
+			(unsigned long long)ex->e_end);
+		return M0_RC(-EINVAL);
 	}
+	balloc_measure_extent(bac, grp, alloc_flag, ex);
+	if (bac->bac_status != M0_BALLOC_AC_CONTINUE)
+		return M0_RC(0);
+	/*
+	 * The candidate stands for all extents of the zone: count them as
+	 * measured, so that balloc_check_limits() sees the same bac_found as
+	 * after a scan of the whole list.
+	 */
+	bac->bac_found += zp->bzp_fragments - 1;
 
 	rc = balloc_check_limits(bac, grp, 1, alloc_flag);
 	return M0_RC(rc);
@@ -2290,10 +2775,8 @@ static int balloc_try_best_found(struct balloc_allocation_context *bac,
 							  bac->bac_ctxt);
 	struct m0_balloc_group_info *grp = m0_balloc_gn2info(bac->bac_ctxt,
 							     group);
-	struct m0_ext		    *ex;
 	struct m0_ext		    *cur = NULL;
 	struct m0_lext		    *le;
-	struct m0_list              *list;
 	int			     rc = -ENOENT;
 
 	M0_ENTRY();
@@ -2312,18 +2795,11 @@ static int balloc_try_best_found(struct balloc_allocation_context *bac,
 		goto out;
 
 	rc = -ENOENT;
-	list = is_spare(alloc_flag) ? group_spare_ext(grp) :
-		 group_normal_ext(grp);
-	m0_list_for_each_entry(list, le, struct m0_lext, le_link) {
-		ex = &le->le_ext;
-		if (m0_ext_equal(ex, best)) {
-			rc = balloc_use_best_found(bac,
-						   zone_start_get(grp,
-								  alloc_flag));
-			break;
-		} else if (ex->e_start > best->e_start)
-			goto out;
-	}
+	le = lext_off_floor(is_spare(alloc_flag) ? &grp->bgi_spare :
+			    &grp->bgi_normal, best->e_start);
+	if (le == NULL || !m0_ext_equal(&le->le_ext, best))
+		goto out;
+	rc = balloc_use_best_found(bac, zone_start_get(grp, alloc_flag));
 
 	/* update db according to the allocation result */
 	if (rc == 0 && bac->bac_status == M0_BALLOC_AC_FOUND) {
@@ -2443,15 +2919,16 @@ repeat:
 				continue;
 			}
 
+			/* group descriptors suffice to skip unsuitable groups */
+			if (!balloc_is_good_group(bac, grp)) {
+				m0_balloc_unlock_group(grp);
+				continue;
+			}
 			rc = m0_balloc_load_extents(bac->bac_ctxt, grp);
 			if (rc != 0) {
 				m0_balloc_unlock_group(grp);
 				goto out;
 			}
-			if (!balloc_is_good_group(bac, grp)) {
-				m0_balloc_unlock_group(grp);
-				continue;
-			}
 			bac->bac_scanned++;
 
 			/* m0_balloc_debug_dump_group_extent("AAA", grp); */
@@ -2467,6 +2944,9 @@ repeat:
 						     M0_BALLOC_NORMAL_ZONE);
 			m0_balloc_unlock_group(grp);
 
+			if (bac->bac_status == M0_BALLOC_AC_FOUND)
+				balloc_prefetch(bac->bac_ctxt,
+						(group + 1) % ngroups);
 			if (bac->bac_status != M0_BALLOC_AC_CONTINUE)
 				break;
 		}
@@ -29,6 +29,8 @@
 #include "lib/types.h"
 #include "lib/list.h"
 #include "lib/mutex.h"
+#include "lib/semaphore.h"
+#include "lib/thread.h"
 #include "be/btree.h"
 #include "be/btree_xc.h"
 #include "format/format.h"
@@ -128,13 +130,25 @@ enum m0_balloc_allocation_flag {
 	M0_BALLOC_NORMAL_ZONE             = 1 << 13,
 };
 
+/** In-memory indices of free extents of a zone. @see m0_lext::le_child */
+enum m0_lext_tree {
+	/** Extents ordered by offset. */
+	M0_LEXT_BY_OFF,
+	/** Extents ordered by length, then by offset. */
+	M0_LEXT_BY_LEN,
+	M0_LEXT_TREE_NR
+};
+
 struct m0_balloc_zone_param {
 	enum m0_balloc_allocation_flag  bzp_type;
 	struct m0_ext                   bzp_range;
 	m0_bcount_t                     bzp_freeblocks;
 	m0_bcount_t                     bzp_fragments;
 	m0_bcount_t                     bzp_maxchunk;
+	/** Free extents of the zone ordered by offset. */
 	struct m0_list                  bzp_extents;
+	/** Roots of the trees indexing bzp_extents, see m0_lext_tree. */
+	struct m0_lext                 *bzp_tree[M0_LEXT_TREE_NR];
 };
 
 /** Linked extents */
@@ -143,6 +157,14 @@ struct m0_lext {
 	bool                le_is_alloc;
 	struct m0_list_link le_link;
 	struct m0_ext       le_ext;
+	/**
+	 * Left and right children in the trees of
+	 * m0_balloc_zone_param::bzp_tree[]. The trees are treaps: binary
+	 * search trees with le_prio being a max-heap.
+	 */
+	struct m0_lext     *le_child[M0_LEXT_TREE_NR][2];
+	/** Treap priority, the same in all trees. */
+	uint64_t            le_prio;
 };
 
 /**
@@ -157,6 +179,16 @@ struct m0_balloc_group_info {
 	struct m0_balloc_zone_param  bgi_spare;
 	/** Array of group extents */
 	struct m0_lext              *bgi_extents;
+	/** Number of elements in bgi_extents. */
+	m0_bcount_t                  bgi_extents_nr;
+	/** Linkage into m0_balloc_loader::bl_lru while extents are loaded. */
+	struct m0_list_link          bgi_lru_link;
+	/**
+	 * Loader of the allocator the group belongs to, NULL if extents are
+	 * not tracked. It is kept here rather than in m0_balloc, which is
+	 * stored in BE segment and can't be extended with volatile fields.
+	 */
+	struct m0_balloc_loader     *bgi_loader;
 	/** per-group lock */
 	struct m0_be_mutex           bgi_mutex;
 };
@@ -210,7 +242,45 @@ enum m0_balloc_super_block_version {
 };
 
 enum {
+	/** Maximum number of free extents examined by a buddy lookup. */
 	M0_BALLOC_BUDDY_LOOKUP_MAX = 10,
+	/** Default m0_balloc_loader::bl_budget. */
+	M0_BALLOC_LOADED_EXTENTS_MAX = 1 << 20,
+	/** Size of the prefetch queue of m0_balloc_loader. */
+	M0_BALLOC_PREFETCH_QUEUE_SIZE = 64,
+};
+
+/**
+   Volatile state of on-demand loading of group extents.
+
+   Only group descriptors are kept in memory for all groups. Extents of a
+   group are loaded on its first use, see m0_balloc_load_extents(), and are
+   released for the least recently used groups when more than bl_budget
+   extents are loaded. Groups which are likely to be needed soon are loaded
+   in advance by the prefetcher thread.
+ */
+struct m0_balloc_loader {
+	/** Protects all fields below and m0_balloc_group_info::bgi_lru_link. */
+	struct m0_mutex     bl_lock;
+	/** Groups with loaded extents, most recently used first. */
+	struct m0_list      bl_lru;
+	/** Total number of loaded extents of the groups in bl_lru. */
+	m0_bcount_t         bl_loaded;
+	/** Maximum number of loaded extents. */
+	m0_bcount_t         bl_budget;
+	/** Groups to be loaded by the prefetcher. */
+	m0_bindex_t         bl_queue[M0_BALLOC_PREFETCH_QUEUE_SIZE];
+	/** Number of groups taken from bl_queue. */
+	uint64_t            bl_qhead;
+	/** Number of groups put to bl_queue. */
+	uint64_t            bl_qtail;
+	/** Allocator the loader belongs to. */
+	struct m0_balloc   *bl_balloc;
+	/** Set when the prefetcher has to exit. */
+	bool                bl_shutdown;
+	/** Upped for every queued group and on shutdown. */
+	struct m0_semaphore bl_wakeup;
+	struct m0_thread    bl_prefetcher;
 };
 
 /**
@@ -267,6 +337,12 @@ static inline struct m0_balloc *b2m0(const struct m0_ad_balloc *ballroom)
 	return container_of(ballroom, struct m0_balloc, cb_ballroom);
 }
 
+/**
+   Returns the loader of the allocator or NULL if the allocator is not
+   initialised.
+ */
+M0_INTERNAL struct m0_balloc_loader *m0_balloc_loader(struct m0_balloc *bal);
+
 /**
    Request to format a container.
  */
@@ -57,6 +57,27 @@ enum balloc_invariant_enum {
 	INVAR_FREE,
 };
 
+/* bzp_maxchunk of a loaded zone has to match its longest free extent. */
+static bool balloc_ut_maxchunk_is_exact(struct m0_balloc_group_info *grp,
+					struct m0_balloc_zone_param *zp)
+{
+	struct m0_lext *le;
+	m0_bcount_t     maxchunk = 0;
+	bool            result = true;
+
+	/* The prefetcher may load or evict the group concurrently. */
+	m0_balloc_lock_group(grp);
+	if (grp->bgi_extents != NULL) {
+		m0_list_for_each_entry(&zp->bzp_extents, le,
+				       struct m0_lext, le_link)
+			maxchunk = max_check(maxchunk,
+					     m0_ext_length(&le->le_ext));
+		result = zp->bzp_maxchunk == maxchunk;
+	}
+	m0_balloc_unlock_group(grp);
+	return result;
+}
+
 bool balloc_ut_invariant(struct m0_balloc *motr_balloc,
 			 struct m0_ext alloc_ext,
 			 int balloc_invariant_flag)
@@ -85,7 +106,9 @@ bool balloc_ut_invariant(struct m0_balloc *motr_balloc,
 	return motr_balloc->cb_group_info[group].bgi_normal.bzp_freeblocks ==
 		prev_group_info_free_blocks[group] &&
 		motr_balloc->cb_sb.bsb_freeblocks ==
-		prev_free_blocks;
+		prev_free_blocks &&
+		balloc_ut_maxchunk_is_exact(&motr_balloc->cb_group_info[group],
+			&motr_balloc->cb_group_info[group].bgi_normal);
 }
 
 /**
@@ -299,6 +322,63 @@ void test_reserve_extent()
 	m0_be_ut_backend_fini(&ut_be);
 }
 
+void test_lazy_load()
+{
+	struct m0_be_ut_backend	     ut_be;
+	struct m0_be_ut_seg	     ut_seg;
+	struct m0_balloc            *motr_balloc;
+	struct m0_balloc_loader     *bl;
+	struct m0_balloc_group_info *grp;
+	m0_bcount_t                  i;
+	int			     rc;
+
+	M0_SET0(&ut_be);
+	m0_be_ut_backend_init(&ut_be);
+	m0_be_ut_seg_init(&ut_seg, &ut_be, 1ULL << 24);
+	rc = m0_balloc_create(0, ut_seg.bus_seg,
+			      m0_be_ut_backend_sm_group_lookup(&ut_be),
+			      &motr_balloc, &M0_FID_INIT(0, 1));
+	M0_UT_ASSERT(rc == 0);
+	rc = motr_balloc->cb_ballroom.ab_ops->bo_init
+		(&motr_balloc->cb_ballroom, ut_seg.bus_seg,
+		 BALLOC_DEF_BLOCK_SHIFT, BALLOC_DEF_CONTAINER_SIZE,
+		 BALLOC_DEF_BLOCKS_PER_GROUP,
+		 m0_stob_ad_spares_calc(BALLOC_DEF_BLOCKS_PER_GROUP));
+	M0_UT_ASSERT(rc == 0);
+
+	bl = m0_balloc_loader(motr_balloc);
+	M0_UT_ASSERT(bl != NULL);
+	m0_mutex_lock(&bl->bl_lock);
+	bl->bl_budget = 0;
+	m0_mutex_unlock(&bl->bl_lock);
+
+	for (i = 0; i < motr_balloc->cb_sb.bsb_groupcount; ++i) {
+		grp = m0_balloc_gn2info(motr_balloc, i);
+		m0_balloc_lock_group(grp);
+		rc = m0_balloc_load_extents(motr_balloc, grp);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(grp->bgi_extents != NULL);
+		m0_mutex_lock(&bl->bl_lock);
+		M0_UT_ASSERT(m0_list_link_is_in(&grp->bgi_lru_link));
+		/*
+		 * Everything else is evicted, except for what the single
+		 * prefetcher thread leaves: the group it is loading, which
+		 * is added to the LRU before the LRU is shrunk, and the
+		 * previous group, which its last shrink skipped because
+		 * this thread held the group lock.
+		 */
+		M0_UT_ASSERT(m0_list_length(&bl->bl_lru) <= 3);
+		m0_mutex_unlock(&bl->bl_lock);
+		m0_balloc_unlock_group(grp);
+	}
+
+	motr_balloc->cb_ballroom.ab_ops->bo_fini(&motr_balloc->cb_ballroom);
+	M0_UT_ASSERT(m0_balloc_loader(motr_balloc) == NULL);
+
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
 struct m0_ut_suite balloc_ut = {
         .ts_name  = "balloc-ut",
 	.ts_init = NULL,
@@ -306,6 +386,7 @@ struct m0_ut_suite balloc_ut = {
         .ts_tests = {
 		{ "balloc", test_balloc},
 		{ "reserve blocks for extmap", test_reserve_extent},
+		{ "lazy group loading", test_lazy_load},
 		{ NULL, NULL }
         }
 };
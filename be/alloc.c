@@ -31,6 +31,7 @@
 #include "lib/memory.h"         /* m0_addr_is_aligned */
 #include "lib/errno.h"          /* ENOSPC */
 #include "lib/misc.h"           /* memset, M0_BITS, m0_forall */
+#include "lib/processor.h"      /* m0_processor_id_get */
 #include "motr/magic.h"
 #include "be/domain.h"          /* m0_be_domain */
 
@@ -167,10 +168,57 @@
  * - allocator credit includes 2 * size requested for alignment shift greater
  *   than M0_BE_ALLOC_SHIFT_MIN;
  * - it is not truly O(1) allocator; see m0_be_fl documentation for explanation;
- * - there is one big allocator lock that protects all allocations/deallocation.
+ * - there is one big allocator lock that protects free lists and the list of
+ *   all chunks. Small allocations mostly bypass it, see "Magazines" below.
  *
  * Locks
- * Allocator lock (m0_mutex) is used to protect all allocator data.
+ * Allocator lock (m0_mutex) is used to protect all allocator data except
+ * magazines. Every magazine set has its own lock, which is taken before the
+ * allocator lock.
+ *
+ * Magazines
+ * ---------
+ *
+ * Small allocations (up to M0_BE_ALLOC_MAG_CLASS_NR * M0_BE_ALLOC_MAG_STEP
+ * bytes with default alignment in M0_BAP_NORMAL zone) are served from
+ * magazines: per-processor, per-size-class lists of chunks of the class size
+ * (m0_be_alloc_mag). There are M0_BE_ALLOC_MAG_LOC_NR magazine sets, a thread
+ * uses the set selected by the index of the processor it is running on.
+ *
+ * - m0_be_alloc_aligned() takes a chunk from the magazine under the magazine
+ *   set lock only. If the magazine is empty, it is refilled with
+ *   M0_BE_ALLOC_MAG_REFILL chunks split from the free lists under a single
+ *   acquisition of the allocator lock. Allocator credit for small sizes
+ *   accounts for the whole refill;
+ * - m0_be_free_aligned() puts a chunk of suitable size to the magazine of the
+ *   current set if it has less than M0_BE_ALLOC_MAG_CAP chunks. Otherwise the
+ *   chunk is returned to the free lists as usual.
+ *
+ * Chunks in magazines are marked as used and are accounted as used in the
+ * allocator statistics. The per-call statistics (m0_be_allocator_stats::
+ * bas_total, bas_stat0 and bas_stat1) are updated under the allocator lock
+ * only: a refill is counted as one allocation per chunk split off the free
+ * lists, a chunk returned by m0_be_allocator_destroy() as one free, while
+ * calls served by magazines are not counted. Counting them would need the
+ * allocator lock and a capture of m0_be_allocator_header::bah_stats on every
+ * call, which is what magazines avoid.
+ *
+ * Magazines are persistent and are changed in the same transaction as the
+ * allocation or deallocation, so a chunk is always either referenced by the
+ * user, or cached in a magazine, or free. At most
+ * M0_BE_ALLOC_MAG_NR * M0_BE_ALLOC_MAG_CAP chunks can be cached, they are
+ * returned to the free lists in m0_be_allocator_destroy().
+ *
+ * Size classes have the granularity of the free lists
+ * (1 << M0_BE_ALLOC_SHIFT_MIN bytes), so the chunk taken from a magazine has
+ * the same size as the chunk the free lists would give for the same request.
+ * Cached chunks are the only space overhead: at most
+ * M0_BE_ALLOC_MAG_LOC_NR * M0_BE_ALLOC_MAG_CAP * (8 + 16 + ... + 256) bytes
+ * plus chunk headers, about 132KB.
+ *
+ * Magazines are stored in the segment after m0_be_seg_hdr. Segments created
+ * with M0_BE_SEG_HDR_FORMAT_VERSION_1 have no space for them, such segments
+ * are used without magazines (m0_be_allocator::ba_mag is NULL).
  *
  * Space reservation for DIX recovery
  * ----------------------------------
@@ -219,6 +267,13 @@ M0_BE_LIST_DESCR_DEFINE(chunks_all, "list of all chunks in m0_be_allocator",
 			M0_BE_ALLOC_ALL_LINK_MAGIC, M0_BE_ALLOC_ALL_MAGIC);
 M0_BE_LIST_DEFINE(chunks_all, static, struct be_alloc_chunk);
 
+/* Chunks in magazines are linked through the link used by free lists. */
+M0_BE_LIST_DESCR_DEFINE(mag, "magazine of cached chunks in m0_be_allocator",
+			static, struct be_alloc_chunk, bac_linkage_free,
+			bac_magic_free, M0_BE_ALLOC_FREE_LINK_MAGIC,
+			M0_BE_ALLOC_MAG_MAGIC);
+M0_BE_LIST_DEFINE(mag, static, struct be_alloc_chunk);
+
 static const char *be_alloc_zone_name(enum m0_be_alloc_zone_type type)
 {
 	static const char *zone_names[] = {
@@ -716,10 +771,252 @@ static bool be_alloc_chunk_trymerge(struct m0_be_allocator *a,
 	return chunks_were_merged;
 }
 
+/** Returns chunk c to the free lists. */
+static void be_alloc_chunk_free(struct m0_be_allocator *a,
+				enum m0_be_alloc_zone_type ztype,
+				struct m0_be_tx *tx,
+				struct be_alloc_chunk *c)
+{
+	struct be_alloc_chunk *prev;
+	struct be_alloc_chunk *next;
+	bool		       chunks_were_merged;
+
+	M0_PRE(m0_mutex_is_locked(&a->ba_lock));
+	M0_PRE(be_alloc_chunk_invariant(a, c));
+	M0_PRE(!c->bac_free);
+	M0_PRE(c->bac_zone == ztype);
+
+	be_alloc_chunk_mark_free(a, ztype, tx, c);
+	/* update stats before c->bac_size gets modified due to merge */
+	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
+			c->bac_size, false, false);
+	prev = be_alloc_chunk_prev(a, ztype, c);
+	next = be_alloc_chunk_next(a, ztype, c);
+	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
+			prev, c);
+	if (chunks_were_merged)
+		c = prev;
+	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
+	be_allocator_stats_capture(a, ztype, tx);
+
+	M0_POST(c->bac_free);
+	M0_POST(c->bac_size > 0);
+	M0_POST(be_alloc_chunk_invariant(a, c));
+}
+
+static bool be_alloc_mag_size_is_cached(m0_bcount_t size, unsigned shift)
+{
+	return shift <= M0_BE_ALLOC_SHIFT_MIN && size > 0 &&
+	       size <= M0_BE_ALLOC_MAG_CLASS_NR * M0_BE_ALLOC_MAG_STEP;
+}
+
+/** Size class to allocate memory of the given size from. */
+static unsigned be_alloc_mag_class(m0_bcount_t size)
+{
+	M0_PRE(be_alloc_mag_size_is_cached(size, M0_BE_ALLOC_SHIFT_MIN));
+
+	return (size - 1) / M0_BE_ALLOC_MAG_STEP;
+}
+
+/**
+ * Size class to put the chunk to. Any chunk that is at least as large as the
+ * class size can serve allocations of this class.
+ */
+static int be_alloc_mag_chunk_class(const struct be_alloc_chunk *c)
+{
+	return c->bac_zone != M0_BAP_NORMAL ||
+	       c->bac_size < M0_BE_ALLOC_MAG_STEP ||
+	       c->bac_size >= (M0_BE_ALLOC_MAG_CLASS_NR + 1) *
+			      M0_BE_ALLOC_MAG_STEP ? -1 :
+	       c->bac_size / M0_BE_ALLOC_MAG_STEP - 1;
+}
+
+static unsigned be_alloc_mag_set(void)
+{
+	return m0_processor_id_get() % M0_BE_ALLOC_MAG_LOC_NR;
+}
+
+static struct m0_be_alloc_mag *be_alloc_mag(struct m0_be_allocator *a,
+					    unsigned set, unsigned class)
+{
+	M0_PRE(set < M0_BE_ALLOC_MAG_LOC_NR);
+	M0_PRE(class < M0_BE_ALLOC_MAG_CLASS_NR);
+
+	M0_PRE(a->ba_mag != NULL);
+
+	return &a->ba_mag[set * M0_BE_ALLOC_MAG_CLASS_NR + class];
+}
+
+static void be_alloc_mag_nr_capture(struct m0_be_allocator *a,
+				    struct m0_be_tx *tx,
+				    struct m0_be_alloc_mag *mag)
+{
+	if (tx != NULL)
+		M0_BE_TX_CAPTURE_PTR(a->ba_seg, tx, &mag->bam_nr);
+}
+
+static void be_alloc_mag_add(struct m0_be_allocator *a,
+			     struct m0_be_tx *tx,
+			     struct m0_be_alloc_mag *mag,
+			     struct be_alloc_chunk *c)
+{
+	M0_PRE(!c->bac_free);
+	M0_PRE(mag->bam_nr < M0_BE_ALLOC_MAG_CAP);
+
+	mag_be_tlink_create(c, tx);
+	mag_be_list_add(&mag->bam_chunks, tx, c);
+	++mag->bam_nr;
+	be_alloc_mag_nr_capture(a, tx, mag);
+}
+
+static void be_alloc_mag_del(struct m0_be_allocator *a,
+			     struct m0_be_tx *tx,
+			     struct m0_be_alloc_mag *mag,
+			     struct be_alloc_chunk *c)
+{
+	M0_PRE(!c->bac_free);
+	M0_PRE(mag->bam_nr > 0);
+
+	mag_be_list_del(&mag->bam_chunks, tx, c);
+	mag_be_tlink_destroy(c, tx);
+	--mag->bam_nr;
+	be_alloc_mag_nr_capture(a, tx, mag);
+}
+
+/**
+ * Splits up to M0_BE_ALLOC_MAG_REFILL chunks of the class size from the free
+ * lists and puts them to the magazine.
+ */
+static void be_alloc_mag_refill(struct m0_be_allocator *a,
+				struct m0_be_tx *tx,
+				struct m0_be_alloc_mag *mag,
+				unsigned class)
+{
+	enum m0_be_alloc_zone_type     ztype = M0_BAP_NORMAL;
+	struct m0_be_allocator_header *h     = a->ba_h[ztype];
+	m0_bcount_t                    size;
+	struct be_alloc_chunk         *c;
+	int                            i;
+
+	size = (class + 1) * M0_BE_ALLOC_MAG_STEP;
+
+	m0_mutex_lock(&a->ba_lock);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+
+	for (i = 0; i < M0_BE_ALLOC_MAG_REFILL; ++i) {
+		c = m0_be_fl_pick(&h->bah_fl, size);
+		if (c == NULL)
+			break;
+		c = be_alloc_chunk_trysplit(a, ztype, tx, c, size,
+					    M0_BE_ALLOC_SHIFT_MIN);
+		M0_ASSERT(c != NULL);
+		be_allocator_stats_update(&h->bah_stats, c->bac_size,
+					  true, false);
+		be_alloc_mag_add(a, tx, mag, c);
+	}
+	if (i > 0)
+		be_allocator_stats_capture(a, ztype, tx);
+	M0_LOG(M0_DEBUG, "allocator=%p mag=%p size=%lu refilled=%d",
+	       a, mag, size, i);
+
+	M0_POST_EX(m0_be_allocator__invariant(a));
+	m0_mutex_unlock(&a->ba_lock);
+}
+
+/** Takes a chunk for allocation of the given size from the magazine. */
+static struct be_alloc_chunk *be_alloc_mag_get(struct m0_be_allocator *a,
+					       struct m0_be_tx *tx,
+					       m0_bcount_t size)
+{
+	unsigned                set   = be_alloc_mag_set();
+	unsigned                class = be_alloc_mag_class(size);
+	struct m0_be_alloc_mag *mag   = be_alloc_mag(a, set, class);
+	struct be_alloc_chunk  *c;
+
+	m0_mutex_lock(&a->ba_mag_lock[set]);
+	if (mag_be_list_is_empty(&mag->bam_chunks))
+		be_alloc_mag_refill(a, tx, mag, class);
+	c = mag_be_list_head(&mag->bam_chunks);
+	if (c != NULL) {
+		M0_ASSERT(c->bac_size >= size);
+		be_alloc_mag_del(a, tx, mag, c);
+	}
+	m0_mutex_unlock(&a->ba_mag_lock[set]);
+	return c;
+}
+
+/**
+ * Puts the chunk to the magazine.
+ *
+ * @return false if the chunk is not suitable for magazines or the magazine
+ * is full. The chunk should be returned to the free lists in this case.
+ */
+static bool be_alloc_mag_put(struct m0_be_allocator *a,
+			     struct m0_be_tx *tx,
+			     struct be_alloc_chunk *c)
+{
+	int                     class = be_alloc_mag_chunk_class(c);
+	unsigned                set;
+	struct m0_be_alloc_mag *mag;
+	bool                    cached;
+
+	if (a->ba_mag == NULL || class < 0)
+		return false;
+	set = be_alloc_mag_set();
+	mag = be_alloc_mag(a, set, class);
+
+	m0_mutex_lock(&a->ba_mag_lock[set]);
+	cached = mag->bam_nr < M0_BE_ALLOC_MAG_CAP;
+	if (cached)
+		be_alloc_mag_add(a, tx, mag, c);
+	m0_mutex_unlock(&a->ba_mag_lock[set]);
+	return cached;
+}
+
+static void be_alloc_mag_create(struct m0_be_allocator *a,
+				struct m0_be_tx        *tx)
+{
+	struct m0_be_alloc_mag *mag;
+	int                     i;
+
+	if (a->ba_mag == NULL)
+		return;
+	for (i = 0; i < M0_BE_ALLOC_MAG_NR; ++i) {
+		mag = &a->ba_mag[i];
+		mag_be_list_create(&mag->bam_chunks, tx);
+		mag->bam_nr = 0;
+		be_alloc_mag_nr_capture(a, tx, mag);
+	}
+}
+
+/** Returns all cached chunks to the free lists and destroys magazines. */
+static void be_alloc_mag_destroy(struct m0_be_allocator *a,
+				 struct m0_be_tx        *tx)
+{
+	struct m0_be_alloc_mag *mag;
+	struct be_alloc_chunk  *c;
+	int                     i;
+
+	M0_PRE(m0_mutex_is_locked(&a->ba_lock));
+
+	if (a->ba_mag == NULL)
+		return;
+	for (i = 0; i < M0_BE_ALLOC_MAG_NR; ++i) {
+		mag = &a->ba_mag[i];
+		while ((c = mag_be_list_head(&mag->bam_chunks)) != NULL) {
+			be_alloc_mag_del(a, tx, mag, c);
+			be_alloc_chunk_free(a, M0_BAP_NORMAL, tx, c);
+		}
+		M0_ASSERT(mag->bam_nr == 0);
+		mag_be_list_destroy(&mag->bam_chunks, tx);
+	}
+}
+
 M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 				     struct m0_be_seg *seg)
 {
 	struct m0_be_seg_hdr *seg_hdr;
+	struct m0_format_tag  tag;
 	int                   i;
 
 	M0_ENTRY("a=%p seg=%p seg->bs_addr=%p seg->bs_size=%lu",
@@ -728,6 +1025,8 @@ M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 	M0_PRE(m0_be_seg__invariant(seg));
 
 	m0_mutex_init(&a->ba_lock);
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_init(&a->ba_mag_lock[i]);
 
 	a->ba_seg = seg;
 	seg_hdr = (struct m0_be_seg_hdr *)seg->bs_addr;
@@ -736,6 +1035,14 @@ M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 		M0_ASSERT(m0_addr_is_aligned(a->ba_h[i],
 					     BE_ALLOC_HEADER_SHIFT));
 	}
+	m0_format_header_unpack(&tag, &seg_hdr->bh_header);
+	a->ba_mag = tag.ot_version >= M0_BE_SEG_HDR_FORMAT_VERSION_2 ?
+		    (struct m0_be_alloc_mag *)(seg_hdr + 1) : NULL;
+	M0_ASSERT(ergo(a->ba_mag != NULL,
+		       (void *)(a->ba_mag + M0_BE_ALLOC_MAG_NR) <=
+		       seg->bs_addr + m0_be_seg_reserved(seg)));
+	M0_LOG(M0_DEBUG, "seg header version=%u magazines=%p",
+	       tag.ot_version, a->ba_mag);
 
 	return 0;
 }
@@ -748,6 +1055,8 @@ M0_INTERNAL void m0_be_allocator_fini(struct m0_be_allocator *a)
 
 	for (i = 0; i < M0_BAP_NR; ++i)
 		be_allocator_stats_print(&a->ba_h[i]->bah_stats);
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_fini(&a->ba_mag_lock[i]);
 	m0_mutex_fini(&a->ba_lock);
 
 	M0_LEAVE();
@@ -840,6 +1149,7 @@ M0_INTERNAL int m0_be_allocator_create(struct m0_be_allocator *a,
 
 	m0_mutex_lock(&a->ba_lock);
 
+	be_alloc_mag_create(a, tx);
 	remain = free_space;
 	for (i = 0; i < zones_nr; ++i) {
 		if (i < zones_nr - 1) {
@@ -888,6 +1198,7 @@ M0_INTERNAL void m0_be_allocator_destroy(struct m0_be_allocator *a,
 	m0_mutex_lock(&a->ba_lock);
 	M0_PRE_EX(m0_be_allocator__invariant(a));
 
+	be_alloc_mag_destroy(a, tx);
 	for (z = 0; z < M0_BAP_NR; ++z)
 		be_allocator_header_destroy(a, z, tx);
 
@@ -922,13 +1233,20 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	struct m0_be_tx_credit         cred_free_flag;
 	struct m0_be_tx_credit         cred_chunk_size;
 	struct m0_be_tx_credit         stats_credit;
+	struct m0_be_tx_credit         cred_mag_nr;
+	struct m0_be_tx_credit         cred_mag_add = {};
+	struct m0_be_tx_credit         cred_mag_del = {};
+	struct m0_be_tx_credit         cred_mag_alloc = {};
+	struct m0_be_tx_credit         cred_free = {};
 	struct m0_be_tx_credit         tmp;
 	struct be_alloc_chunk          chunk;
+	struct m0_be_alloc_mag         mag;
 
 	chunk_credit    = M0_BE_TX_CREDIT_TYPE(struct be_alloc_chunk);
 	cred_free_flag  = M0_BE_TX_CREDIT_PTR(&chunk.bac_free);
 	cred_chunk_size = M0_BE_TX_CREDIT_PTR(&chunk.bac_size);
 	stats_credit    = M0_BE_TX_CREDIT_PTR(&h->bah_stats);
+	cred_mag_nr     = M0_BE_TX_CREDIT_PTR(&mag.bam_nr);
 
 	m0_be_tx_credit_add(&cred_allocator,
 			    &M0_BE_TX_CREDIT_PTR(&h->bah_size));
@@ -972,6 +1290,27 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	m0_be_tx_credit_add(&cred_mark_free, &cred_free_flag);
 	m0_be_fl_credit(&h->bah_fl, M0_BFL_ADD, &cred_mark_free);
 
+	m0_be_tx_credit_add(&cred_free, &cred_mark_free);
+	m0_be_tx_credit_mac(&cred_free, &chunk_trymerge_credit, 2);
+	m0_be_tx_credit_add(&cred_free, &stats_credit);
+
+	mag_be_list_credit(M0_BLO_TLINK_CREATE, 1, &cred_mag_add);
+	mag_be_list_credit(M0_BLO_ADD,          1, &cred_mag_add);
+	m0_be_tx_credit_add(&cred_mag_add, &cred_mag_nr);
+
+	mag_be_list_credit(M0_BLO_DEL,           1, &cred_mag_del);
+	mag_be_list_credit(M0_BLO_TLINK_DESTROY, 1, &cred_mag_del);
+	m0_be_tx_credit_add(&cred_mag_del, &cred_mag_nr);
+
+	/* refill and taking a chunk from the magazine */
+	m0_be_tx_credit_mac(&cred_mag_alloc, &cred_split,
+			    M0_BE_ALLOC_MAG_REFILL);
+	m0_be_tx_credit_mac(&cred_mag_alloc, &cred_mag_add,
+			    M0_BE_ALLOC_MAG_REFILL);
+	m0_be_tx_credit_add(&cred_mag_alloc, &cred_mag_del);
+	m0_be_tx_credit_add(&cred_mag_alloc, &mem_zero_credit);
+	m0_be_tx_credit_add(&cred_mag_alloc, &stats_credit);
+
 	switch (optype) {
 		case M0_BAO_CREATE:
 			tmp = M0_BE_TX_CREDIT(0, 0);
@@ -981,6 +1320,11 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(&tmp, &cred_allocator);
 			m0_be_tx_credit_add(&tmp, &stats_credit);
 			m0_be_tx_credit_mac(accum, &tmp, M0_BAP_NR);
+			/* magazines */
+			m0_be_tx_credit_mac(accum, &cred_list_create,
+					    M0_BE_ALLOC_MAG_NR);
+			m0_be_tx_credit_mac(accum, &cred_mag_nr,
+					    M0_BE_ALLOC_MAG_NR);
 			break;
 		case M0_BAO_DESTROY:
 			tmp = M0_BE_TX_CREDIT(0, 0);
@@ -988,20 +1332,33 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(&tmp, &chunk_del_fini_credit);
 			m0_be_tx_credit_mac(&tmp, &cred_list_destroy, 2);
 			m0_be_tx_credit_mac(accum, &tmp, M0_BAP_NR);
+			/* magazines, cached chunks are freed */
+			m0_be_tx_credit_mac(accum, &cred_list_destroy,
+					    M0_BE_ALLOC_MAG_NR);
+			m0_be_tx_credit_add(&cred_free, &cred_mag_del);
+			m0_be_tx_credit_mac(accum, &cred_free,
+					    M0_BE_ALLOC_MAG_NR *
+					    M0_BE_ALLOC_MAG_CAP);
 			break;
 		case M0_BAO_ALLOC_ALIGNED:
-			m0_be_tx_credit_add(accum, &cred_split);
-			m0_be_tx_credit_add(accum, &mem_zero_credit);
-			m0_be_tx_credit_add(accum, &stats_credit);
+			tmp = M0_BE_TX_CREDIT(0, 0);
+			m0_be_tx_credit_add(&tmp, &cred_split);
+			m0_be_tx_credit_add(&tmp, &mem_zero_credit);
+			m0_be_tx_credit_add(&tmp, &stats_credit);
+			if (be_alloc_mag_size_is_cached(size, shift))
+				m0_be_tx_credit_add_max(accum, &tmp,
+							&cred_mag_alloc);
+			else
+				m0_be_tx_credit_add(accum, &tmp);
 			break;
 		case M0_BAO_ALLOC:
 			m0_be_allocator_credit(a, M0_BAO_ALLOC_ALIGNED, size,
 					       M0_BE_ALLOC_SHIFT_MIN, accum);
 			break;
 		case M0_BAO_FREE_ALIGNED:
-			m0_be_tx_credit_add(accum, &cred_mark_free);
-			m0_be_tx_credit_mac(accum, &chunk_trymerge_credit, 2);
-			m0_be_tx_credit_add(accum, &stats_credit);
+			/* size is not known here, the chunk may be cached */
+			m0_be_tx_credit_add_max(accum, &cred_free,
+						&cred_mag_add);
 			break;
 		case M0_BAO_FREE:
 			m0_be_allocator_credit(a, M0_BAO_FREE_ALIGNED, size,
@@ -1034,6 +1391,23 @@ M0_INTERNAL void m0_be_alloc_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
+	if (a->ba_mag != NULL && zonemask == M0_BITS(M0_BAP_NORMAL) &&
+	    be_alloc_mag_size_is_cached(size, shift)) {
+		c = be_alloc_mag_get(a, tx, size);
+		if (c != NULL) {
+			memset(&c->bac_mem, 0, size);
+			m0_be_tx_capture(tx, &M0_BE_REG(a->ba_seg, size,
+							&c->bac_mem));
+			*ptr = &c->bac_mem;
+			M0_LOG(M0_DEBUG, "allocator=%p size=%lu c=%p "
+			       "c->bac_size=%lu ptr=%p (magazine)",
+			       a, size, c, c->bac_size, *ptr);
+			M0_POST(m0_addr_is_aligned(&c->bac_mem, shift));
+			m0_be_op_done(op);
+			return;
+		}
+	}
+
 	m0_mutex_lock(&a->ba_lock);
 	M0_PRE_EX(m0_be_allocator__invariant(a));
 
@@ -1101,11 +1475,7 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 				    struct m0_be_op *op,
 				    void *ptr)
 {
-	enum m0_be_alloc_zone_type  ztype;
-	struct be_alloc_chunk      *c;
-	struct be_alloc_chunk      *prev;
-	struct be_alloc_chunk      *next;
-	bool		            chunks_were_merged;
+	struct be_alloc_chunk *c;
 
 	M0_PRE(ptr != NULL);
 	M0_PRE(m0_reduce(z, M0_BAP_NR, 0,
@@ -1113,32 +1483,21 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
-	m0_mutex_lock(&a->ba_lock);
-	M0_PRE_EX(m0_be_allocator__invariant(a));
-
 	c = be_alloc_chunk_addr(ptr);
-	M0_PRE(be_alloc_chunk_invariant(a, c));
+	M0_PRE(c->bac_magic0 == M0_BE_ALLOC_MAGIC0);
+	M0_PRE(c->bac_magic1 == M0_BE_ALLOC_MAGIC1);
 	M0_PRE(!c->bac_free);
-	ztype = c->bac_zone;
 	M0_LOG(M0_DEBUG, "allocator=%p c=%p c->bac_size=%lu zone=%d "
 			"data=%p", a, c, c->bac_size, c->bac_zone, &c->bac_mem);
-	/* algorithm starts here */
-	be_alloc_chunk_mark_free(a, ztype, tx, c);
-	/* update stats before c->bac_size gets modified due to merge */
-	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
-			c->bac_size, false, false);
-	prev = be_alloc_chunk_prev(a, ztype, c);
-	next = be_alloc_chunk_next(a, ztype, c);
-	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
-			prev, c);
-	if (chunks_were_merged)
-		c = prev;
-	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
-	be_allocator_stats_capture(a, ztype, tx);
-	/* and ends here */
-	M0_POST(c->bac_free);
-	M0_POST(c->bac_size > 0);
-	M0_POST(be_alloc_chunk_invariant(a, c));
+	if (be_alloc_mag_put(a, tx, c)) {
+		m0_be_op_done(op);
+		return;
+	}
+
+	m0_mutex_lock(&a->ba_lock);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+
+	be_alloc_chunk_free(a, c->bac_zone, tx, c);
 
 	M0_POST_EX(m0_be_allocator__invariant(a));
 	m0_mutex_unlock(&a->ba_lock);
@@ -47,6 +47,30 @@ enum {
 	M0_BE_ALLOC_SHIFT_MIN  = 3,
 };
 
+enum {
+	/**
+	 * Number of magazine sets. Every set is shared by the threads running
+	 * on the processors with the same index modulo this value.
+	 */
+	M0_BE_ALLOC_MAG_LOC_NR   = 8,
+	/** Number of size classes served from magazines. */
+	M0_BE_ALLOC_MAG_CLASS_NR = 32,
+	/**
+	 * Size class i holds chunks of (i + 1) * M0_BE_ALLOC_MAG_STEP bytes.
+	 * The step is the granularity of the free lists allocations, so a
+	 * chunk taken from a magazine is never larger than the chunk the free
+	 * lists would give for the same request.
+	 */
+	M0_BE_ALLOC_MAG_STEP     = 1UL << M0_BE_ALLOC_SHIFT_MIN,
+	/** Maximum number of chunks cached in a magazine. */
+	M0_BE_ALLOC_MAG_CAP      = 4,
+	/** Number of chunks taken from the free lists by a single refill. */
+	M0_BE_ALLOC_MAG_REFILL   = M0_BE_ALLOC_MAG_CAP,
+	/** Total number of magazines in an allocator zone. */
+	M0_BE_ALLOC_MAG_NR       = M0_BE_ALLOC_MAG_LOC_NR *
+				   M0_BE_ALLOC_MAG_CLASS_NR,
+};
+
 struct m0_be_allocator_call_stat {
 	unsigned long bcs_nr;
 	m0_bcount_t   bcs_size;
@@ -127,6 +151,7 @@ struct m0_be_allocator_stats {
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 struct m0_be_allocator_header;
+struct m0_be_alloc_mag;
 
 /** @brief Allocator */
 struct m0_be_allocator {
@@ -141,8 +166,22 @@ struct m0_be_allocator {
 	 * (but not allocated memory).
 	 */
 	struct m0_mutex		       ba_lock;
+	/**
+	 * Locks for magazine sets. ba_mag_lock[i] protects magazines
+	 * ba_mag[i * M0_BE_ALLOC_MAG_CLASS_NR ...].
+	 * Lock ordering: ba_mag_lock[i] is taken before ba_lock.
+	 */
+	struct m0_mutex                ba_mag_lock[M0_BE_ALLOC_MAG_LOC_NR];
 	/** Internal allocator data. It is stored inside the segment. */
 	struct m0_be_allocator_header *ba_h[M0_BAP_NR];
+	/**
+	 * M0_BE_ALLOC_MAG_NR magazines of M0_BAP_NORMAL zone, indexed by
+	 * (set * M0_BE_ALLOC_MAG_CLASS_NR + class). They are stored inside
+	 * the segment after m0_be_seg_hdr. NULL if the segment has no space
+	 * reserved for magazines (M0_BE_SEG_HDR_FORMAT_VERSION_1), all
+	 * allocations are served from the free lists then.
+	 */
+	struct m0_be_alloc_mag        *ba_mag;
 };
 
 /**
@@ -94,6 +94,28 @@ struct m0_be_alloc_zone {
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 
+/**
+ * @brief Magazine of cached chunks.
+ *
+ * Chunks in a magazine are not free from the allocator point of view: they
+ * are marked as used and are linked through be_alloc_chunk::bac_linkage_free,
+ * which is unused for used chunks. They are handed out by m0_be_alloc() and
+ * taken back by m0_be_free() without touching m0_be_allocator::ba_lock.
+ * Magazines are persistent, so cached chunks are not lost after a restart.
+ *
+ * Magazines are stored in the segment right after m0_be_seg_hdr, in the area
+ * reserved since M0_BE_SEG_HDR_FORMAT_VERSION_2. They are not a part of
+ * m0_be_allocator_header, so the BE xcode protocol is not changed and
+ * segments of M0_BE_SEG_HDR_FORMAT_VERSION_1 are still usable (without
+ * magazines).
+ */
+struct m0_be_alloc_mag {
+	/** Cached chunks. */
+	struct m0_be_list bam_chunks;
+	/** Number of chunks in bam_chunks. */
+	uint64_t          bam_nr;
+};
+
 /**
  * @brief Allocator header.
  *
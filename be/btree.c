@@ -31,7 +31,9 @@
 
 #include "lib/errno.h"
 #include "lib/finject.h"       /* M0_FI_ENABLED() */
+#include "lib/hash.h"          /* m0_hash */
 #include "lib/misc.h"          /* offsetof */
+#include "lib/rwlock.h"
 #include "be/alloc.h"
 #include "be/btree.h"
 #include "be/btree_internal.h" /* m0_be_bnode */
@@ -41,6 +43,8 @@
 /* btree constants */
 enum {
 	BTREE_ALLOC_SHIFT = 0,
+	/** Number of leaf latches, see m0_be_btree_mod_init(). */
+	BTREE_LATCH_NR    = 512,
 };
 
 enum btree_save_optype {
@@ -52,8 +56,13 @@ enum btree_save_optype {
 struct btree_node_pos {
 	struct m0_be_bnode *bnp_node;
 	unsigned int        bnp_index;
+	/** Leaf latch held by be_btree_get_btree_node(), or NULL. */
+	struct m0_rwlock   *bnp_latch;
 };
 
+/** Leaf latches shared by all trees, indexed by btree_latch(). */
+static struct m0_rwlock btree_latches[BTREE_LATCH_NR];
+
 M0_INTERNAL const struct m0_fid_type m0_btree_fid_type = {
 	.ft_id   = 'b',
 	.ft_name = "btree fid",
@@ -61,6 +70,8 @@ M0_INTERNAL const struct m0_fid_type m0_btree_fid_type = {
 
 static struct m0_be_op__btree *op_tree(struct m0_be_op *op);
 static struct m0_rwlock *btree_rwlock(struct m0_be_btree *tree);
+static struct m0_rwlock *btree_latch(const struct m0_be_bnode *leaf);
+static struct m0_rwlock *btree_leaf_read_lock(const struct m0_be_bnode *leaf);
 
 static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
 						void *key);
@@ -183,6 +194,130 @@ static inline int key_eq(const struct m0_be_btree *btree,
 {
 	return be_btree_compare(btree, key0, key1) ==  0;
 }
+
+static uint64_t be_btree_kprefix(const struct m0_be_btree *btree,
+				 const void *key)
+{
+	const struct m0_be_btree_kv_ops *ops = btree->bb_ops;
+
+	return ops->ko_prefix != NULL ? ops->ko_prefix(key) : 0;
+}
+
+static uint32_t node_version(const struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &node->bt_header);
+	return tag.ot_version;
+}
+
+/**
+ * True iff @node has m0_be_bnode::bt_kprefix_arr[].
+ *
+ * Trees created before M0_BE_BNODE_FORMAT_VERSION_2 keep their version 1
+ * nodes, new nodes are always allocated in the current format, so a tree can
+ * have nodes of both versions.
+ */
+static bool node_has_kprefix(const struct m0_be_bnode *node)
+{
+	return node_version(node) >= M0_BE_BNODE_FORMAT_VERSION_2;
+}
+
+/**
+ * Footer of @node. Its offset depends on the node format version and is
+ * taken from the node header.
+ */
+static struct m0_format_footer *node_footer(struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &node->bt_header);
+	return (void *)node + tag.ot_footer_offset;
+}
+
+/** Prefix of the key at @index of @node, computed for version 1 nodes. */
+static uint64_t node_kprefix(const struct m0_be_btree *btree,
+			     const struct m0_be_bnode *node,
+			     unsigned int              index)
+{
+	return node_has_kprefix(node) ? node->bt_kprefix_arr[index] :
+		be_btree_kprefix(btree, node->bt_kv_arr[index].btree_key);
+}
+
+/** Stores @kv having key prefix @kprefix at @index of @node. */
+static void node_kv_set(struct m0_be_bnode            *node,
+			unsigned int                   index,
+			const struct be_btree_key_val *kv,
+			uint64_t                       kprefix)
+{
+	node->bt_kv_arr[index] = *kv;
+	if (node_has_kprefix(node))
+		node->bt_kprefix_arr[index] = kprefix;
+}
+
+/** Copies the entry at @src_index of @src to @dst_index of @dst. */
+static void node_kv_copy(const struct m0_be_btree *btree,
+			 struct m0_be_bnode       *dst,
+			 unsigned int              dst_index,
+			 const struct m0_be_bnode *src,
+			 unsigned int              src_index)
+{
+	dst->bt_kv_arr[dst_index] = src->bt_kv_arr[src_index];
+	if (node_has_kprefix(dst))
+		dst->bt_kprefix_arr[dst_index] =
+			node_kprefix(btree, src, src_index);
+}
+
+/**
+ * Compares @key having prefix @kprefix with the key at @index of @node.
+ *
+ * Keys are only dereferenced when prefixes are equal.
+ */
+static int be_btree_kv_cmp(const struct m0_be_btree *btree,
+			   const void               *key,
+			   uint64_t                  kprefix,
+			   const struct m0_be_bnode *node,
+			   unsigned int              index)
+{
+	uint64_t nprefix = node_kprefix(btree, node, index);
+
+	if (kprefix != nprefix)
+		return kprefix < nprefix ? -1 : 1;
+	return be_btree_compare(btree, key, node->bt_kv_arr[index].btree_key);
+}
+
+/**
+ * Binary search of @key in @node.
+ *
+ * @return index of the first key in the node which is not less than @key.
+ *         *found is set if that key is equal to @key.
+ */
+static unsigned int be_btree_node_search(const struct m0_be_btree *btree,
+					 const struct m0_be_bnode *node,
+					 const void               *key,
+					 uint64_t                  kprefix,
+					 bool                     *found)
+{
+	unsigned int lo = 0;
+	unsigned int hi = node->bt_num_active_key;
+	unsigned int mid;
+	int          cmp;
+
+	*found = false;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		cmp = be_btree_kv_cmp(btree, key, kprefix, node, mid);
+		if (cmp == 0) {
+			*found = true;
+			return mid;
+		}
+		if (cmp > 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
 
 /* ------------------------------------------------------------------
  * Btree internals implementation
@@ -206,7 +341,7 @@ static void btree_pair_release(struct m0_be_btree *btree,
 
 static struct btree_node_pos be_btree_get_btree_node(
 					struct m0_be_btree_cursor *it,
-					const void *key, bool slant);
+					const void *key, bool slant, bool latch);
 
 static void be_btree_delete_key_from_node(struct m0_be_btree *tree,
 					  struct m0_be_tx *tx,
@@ -264,6 +399,8 @@ static bool btree_node_invariant(const struct m0_be_btree *btree,
 {
 	return
 		_0C(node->bt_header.hd_magic != 0) &&
+		_0C(M0_IN(node_version(node), (M0_BE_BNODE_FORMAT_VERSION_1,
+					       M0_BE_BNODE_FORMAT_VERSION_2))) &&
 		_0C(m0_format_footer_verify(&node->bt_header, true) == 0) &&
 		_0C(btree_backlink_invariant(&node->bt_backlink, btree->bb_seg,
 					     &btree->bb_cookie_gen)) &&
@@ -283,7 +420,10 @@ static bool btree_node_invariant(const struct m0_be_btree *btree,
 						 btree_key) &&
 			      m0_be_seg_contains(btree->bb_seg,
 						 node->bt_kv_arr[i].
-						 btree_val))) &&
+						 btree_val) &&
+			      node_kprefix(btree, node, i) ==
+			      be_btree_kprefix(btree,
+					       node->bt_kv_arr[i].btree_key))) &&
 		_0C(ergo(!node->bt_isleaf,
 			 m0_forall(i, node->bt_num_active_key + 1,
 				   node->bt_child_arr[i] != NULL &&
@@ -353,9 +493,13 @@ static void btree_node_update(struct m0_be_bnode       *node,
 		mem_update(btree, tx, node->bt_child_arr,
 			   sizeof(*node->bt_child_arr) *
 			   (node->bt_num_active_key + 1));
+		if (node_has_kprefix(node))
+			mem_update(btree, tx, node->bt_kprefix_arr,
+				   sizeof(*node->bt_kprefix_arr) *
+				   node->bt_num_active_key);
 	}
 
-	mem_update(btree, tx, &node->bt_footer, sizeof(node->bt_footer));
+	mem_update(btree, tx, node_footer(node), sizeof(node->bt_footer));
 }
 
 static void btree_node_keyval_update(struct m0_be_bnode       *node,
@@ -366,7 +510,10 @@ static void btree_node_keyval_update(struct m0_be_bnode       *node,
 	m0_format_footer_update(node);
 	mem_update(btree, tx, &node->bt_kv_arr[index],
 			   sizeof node->bt_kv_arr[index]);
-	mem_update(btree, tx, &node->bt_footer, sizeof node->bt_footer);
+	if (node_has_kprefix(node))
+		mem_update(btree, tx, &node->bt_kprefix_arr[index],
+			   sizeof node->bt_kprefix_arr[index]);
+	mem_update(btree, tx, node_footer(node), sizeof node->bt_footer);
 }
 
 /**
@@ -475,7 +622,7 @@ static void be_btree_split_child(struct m0_be_btree *btree,
 	/* Copy the latter half keys from the current child to the new child */
 	i = 0;
 	while (i < new_child->bt_num_active_key) {
-		new_child->bt_kv_arr[i] = child->bt_kv_arr[i + BTREE_FAN_OUT];
+		node_kv_copy(btree, new_child, i, child, i + BTREE_FAN_OUT);
 		i++;
 	}
 
@@ -500,12 +647,12 @@ static void be_btree_split_child(struct m0_be_btree *btree,
 	/* In the parent node's arr, make space for the new child */
 	for (i = parent->bt_num_active_key + 1; i > index + 1; i--) {
 		parent->bt_child_arr[i] = parent->bt_child_arr[i - 1];
-		parent->bt_kv_arr[i - 1] = parent->bt_kv_arr[i - 2];
+		node_kv_copy(btree, parent, i - 1, parent, i - 2);
 	}
 
 	/*  Update parent */
 	parent->bt_child_arr[index + 1] = new_child;
-	parent->bt_kv_arr[index] = child->bt_kv_arr[BTREE_FAN_OUT - 1];
+	node_kv_copy(btree, parent, index, child, BTREE_FAN_OUT - 1);
 	parent->bt_num_active_key++;
 
 	/* re-calculate checksum after all fields has been updated */
@@ -517,6 +664,33 @@ static void be_btree_split_child(struct m0_be_btree *btree,
 	btree_node_update(new_child, btree, tx);
 }
 
+/**
+ * Inserts @kv entry with key prefix @kprefix at position @index of the
+ * non-full leaf @node.
+ */
+static void be_btree_leaf_insert(struct m0_be_btree      *btree,
+				 struct m0_be_tx         *tx,
+				 struct m0_be_bnode      *node,
+				 unsigned int             index,
+				 struct be_btree_key_val *kv,
+				 uint64_t                 kprefix)
+{
+	unsigned int i;
+
+	M0_PRE(node->bt_isleaf);
+	M0_PRE(node->bt_num_active_key < KV_NR);
+	M0_PRE(index <= node->bt_num_active_key);
+
+	for (i = node->bt_num_active_key; i > index; --i)
+		node_kv_copy(btree, node, i, node, i - 1);
+	node_kv_set(node, index, kv, kprefix);
+	node->bt_num_active_key++;
+
+	m0_format_footer_update(node);
+	/* Update affected memory regions */
+	btree_node_update(node, btree, tx);
+}
+
 /**
  * Inserts @kv entry into the non-full @node.
  *
@@ -524,43 +698,35 @@ static void be_btree_split_child(struct m0_be_btree *btree,
  * @param tx     the pointer to tx
  * @param node   the non-full node where the kv is to be inserted
  * @param kv     the key value to be inserted
+ * @param kprefix prefix of the key of @kv
  * @return       none
  */
 static void be_btree_insert_into_nonfull(struct m0_be_btree      *btree,
 					 struct m0_be_tx         *tx,
 					 struct m0_be_bnode      *node,
-					 struct be_btree_key_val *kv)
+					 struct be_btree_key_val *kv,
+					 uint64_t                 kprefix)
 {
-	void *key = kv->btree_key;
-	int i = node->bt_num_active_key - 1;
+	void         *key = kv->btree_key;
+	unsigned int  i;
+	bool          found;
 
 	while (!node->bt_isleaf)
 	{
-		while (i >= 0 &&
-		       key_lt(btree, key, node->bt_kv_arr[i].btree_key))
-			i--;
-		i++;
+		i = be_btree_node_search(btree, node, key, kprefix, &found);
+		M0_ASSERT(!found);
 
 		if (node->bt_child_arr[i]->bt_num_active_key == KV_NR) {
 			be_btree_split_child(btree, tx, node, i);
-			if (key_gt(btree, key, node->bt_kv_arr[i].btree_key))
+			if (be_btree_kv_cmp(btree, key, kprefix, node, i) > 0)
 				i++;
 		}
 		node = node->bt_child_arr[i];
-		i = node->bt_num_active_key - 1;
 	}
 
-	while (i >= 0 &&
-	       key_lt(btree, key, node->bt_kv_arr[i].btree_key)) {
-		node->bt_kv_arr[i + 1] = node->bt_kv_arr[i];
-		i--;
-	}
-	node->bt_kv_arr[i + 1] = *kv;
-	node->bt_num_active_key++;
-
-	m0_format_footer_update(node);
-	/* Update affected memory regions */
-	btree_node_update(node, btree, tx);
+	i = be_btree_node_search(btree, node, key, kprefix, &found);
+	M0_ASSERT(!found);
+	be_btree_leaf_insert(btree, tx, node, i, kv, kprefix);
 }
 
 /**
@@ -569,11 +735,13 @@ static void be_btree_insert_into_nonfull(struct m0_be_btree      *btree,
  * @param btree  the btree where the kv is to be inserted
  * @param tx     the pointer to tx
  * @param kv     the key value to be inserted
+ * @param kprefix prefix of the key of @kv
  * @return       none
  */
 static void be_btree_insert_newkey(struct m0_be_btree      *btree,
 				   struct m0_be_tx         *tx,
-				   struct be_btree_key_val *kv)
+				   struct be_btree_key_val *kv,
+				   uint64_t                 kprefix)
 {
 	struct m0_be_bnode *old_root;
 	struct m0_be_bnode *new_root;
@@ -585,7 +753,7 @@ static void be_btree_insert_newkey(struct m0_be_btree      *btree,
 
 	old_root = btree->bb_root;
 	if (old_root->bt_num_active_key != KV_NR) {
-		be_btree_insert_into_nonfull(btree, tx, old_root, kv);
+		be_btree_insert_into_nonfull(btree, tx, old_root, kv, kprefix);
 	} else {
 		new_root = be_btree_node_alloc(btree, tx);
 		M0_ASSERT(new_root != NULL);
@@ -597,7 +765,7 @@ static void be_btree_insert_newkey(struct m0_be_btree      *btree,
 		new_root->bt_child_arr[0] = old_root;
 		m0_format_footer_update(new_root);
 		be_btree_split_child(btree, tx, new_root, 0);
-		be_btree_insert_into_nonfull(btree, tx, new_root, kv);
+		be_btree_insert_into_nonfull(btree, tx, new_root, kv, kprefix);
 
 		/* Update tree structure itself */
 		mem_update(btree, tx, btree, sizeof(struct m0_be_btree));
@@ -645,20 +813,21 @@ static void be_btree_get_min_key_pos(struct m0_be_bnode    *node,
 	pos->bnp_index = 0;
 }
 
-static void be_btree_shift_key_vals(struct m0_be_bnode *dest,
-				    struct m0_be_bnode *src,
-				    unsigned int        start_index,
-				    unsigned int        key_src_offset,
-				    unsigned int        key_dest_offset,
-				    unsigned int        child_src_offset,
-				    unsigned int        child_dest_offset,
-				    unsigned int        stop_index)
+static void be_btree_shift_key_vals(const struct m0_be_btree *btree,
+				    struct m0_be_bnode       *dest,
+				    struct m0_be_bnode       *src,
+				    unsigned int              start_index,
+				    unsigned int              key_src_offset,
+				    unsigned int              key_dest_offset,
+				    unsigned int              child_src_offset,
+				    unsigned int              child_dest_offset,
+				    unsigned int              stop_index)
 {
 	unsigned int i = start_index;
 	while (i < stop_index)
 	{
-		dest->bt_kv_arr[i + key_dest_offset] =
-					src->bt_kv_arr[i + key_src_offset];
+		node_kv_copy(btree, dest, i + key_dest_offset,
+			     src, i + key_src_offset);
 		dest->bt_child_arr[i + child_dest_offset ] =
 				src->bt_child_arr[i + child_src_offset];
 		++i;
@@ -693,11 +862,12 @@ be_btree_merge_siblings(struct m0_be_tx    *tx,
 	node1 = parent->bt_child_arr[idx];
 	node2 = parent->bt_child_arr[idx + 1];
 
-	node1->bt_kv_arr[node1->bt_num_active_key++] = parent->bt_kv_arr[idx];
+	node_kv_copy(tree, node1, node1->bt_num_active_key++, parent, idx);
 
 	M0_ASSERT(node1->bt_num_active_key + node2->bt_num_active_key <= KV_NR);
 
-	be_btree_shift_key_vals(node1, node2, 0, 0, node1->bt_num_active_key, 0,
+	be_btree_shift_key_vals(tree, node1, node2, 0, 0,
+				node1->bt_num_active_key, 0,
 				node1->bt_num_active_key,
 				node2->bt_num_active_key);
 
@@ -709,7 +879,7 @@ be_btree_merge_siblings(struct m0_be_tx    *tx,
 	m0_format_footer_update(node1);
 
 	/* update parent */
-	be_btree_shift_key_vals(parent, parent, idx, 1, 0, 2, 1,
+	be_btree_shift_key_vals(tree, parent, parent, idx, 1, 0, 2, 1,
 				parent->bt_num_active_key - 1);
 
 	parent->bt_num_active_key--;
@@ -734,45 +904,47 @@ be_btree_merge_siblings(struct m0_be_tx    *tx,
 }
 
 
-static void be_btree_move_parent_key_to_right_child(struct m0_be_bnode *parent,
-						    struct m0_be_bnode *lch,
-						    struct m0_be_bnode *rch,
-						    unsigned int        idx)
+static void
+be_btree_move_parent_key_to_right_child(const struct m0_be_btree *btree,
+					struct m0_be_bnode       *parent,
+					struct m0_be_bnode       *lch,
+					struct m0_be_bnode       *rch,
+					unsigned int              idx)
 {
 	unsigned int i = rch->bt_num_active_key;
 
 	while (i > 0) {
-		rch->bt_kv_arr[i] = rch->bt_kv_arr[i - 1];
+		node_kv_copy(btree, rch, i, rch, i - 1);
 		rch->bt_child_arr[i + 1] = rch->bt_child_arr[i];
 		--i;
 	}
 	rch->bt_child_arr[1] = rch->bt_child_arr[0];
-	rch->bt_kv_arr[0] = parent->bt_kv_arr[idx];
+	node_kv_copy(btree, rch, 0, parent, idx);
 	rch->bt_child_arr[0] =
 			lch->bt_child_arr[lch->bt_num_active_key];
 	lch->bt_child_arr[lch->bt_num_active_key] = NULL;
-	parent->bt_kv_arr[idx] =
-			lch->bt_kv_arr[lch->bt_num_active_key-1];
+	node_kv_copy(btree, parent, idx, lch, lch->bt_num_active_key - 1);
 	lch->bt_num_active_key--;
 	rch->bt_num_active_key++;
 }
 
-static void be_btree_move_parent_key_to_left_child(struct m0_be_bnode *parent,
-						   struct m0_be_bnode *lch,
-						   struct m0_be_bnode *rch,
-						   unsigned int        idx)
+static void
+be_btree_move_parent_key_to_left_child(const struct m0_be_btree *btree,
+				       struct m0_be_bnode       *parent,
+				       struct m0_be_bnode       *lch,
+				       struct m0_be_bnode       *rch,
+				       unsigned int              idx)
 {
 	unsigned int i;
 
-	lch->bt_kv_arr[lch->bt_num_active_key] =
-					parent->bt_kv_arr[idx];
+	node_kv_copy(btree, lch, lch->bt_num_active_key, parent, idx);
 	lch->bt_child_arr[lch->bt_num_active_key + 1] =
 					rch->bt_child_arr[0];
 	lch->bt_num_active_key++;
-	parent->bt_kv_arr[idx] = rch->bt_kv_arr[0];
+	node_kv_copy(btree, parent, idx, rch, 0);
 	i = 0;
 	while (i < rch->bt_num_active_key - 1) {
-		rch->bt_kv_arr[i] = rch->bt_kv_arr[i + 1];
+		node_kv_copy(btree, rch, i, rch, i + 1);
 		rch->bt_child_arr[i] = rch->bt_child_arr[i + 1];
 		++i;
 	}
@@ -810,9 +982,11 @@ static void be_btree_move_parent_key(struct m0_be_btree	  *tree,
 	rch = parent->bt_child_arr[idx + 1];
 
 	if (pos == P_LEFT)
-		be_btree_move_parent_key_to_left_child(parent, lch, rch, idx);
+		be_btree_move_parent_key_to_left_child(tree, parent, lch, rch,
+						       idx);
 	else
-		be_btree_move_parent_key_to_right_child(parent, lch, rch, idx);
+		be_btree_move_parent_key_to_right_child(tree, parent, lch, rch,
+							idx);
 
 	/* re-calculate checksum after all fields has been updated */
 	m0_format_footer_update(lch);
@@ -849,7 +1023,7 @@ void be_btree_delete_key_from_node(struct m0_be_btree	 *tree,
 		btree_pair_release(tree, tx, &bnode->bt_kv_arr[idx]);
 
 		while (idx < bnode->bt_num_active_key - 1) {
-			bnode->bt_kv_arr[idx] = bnode->bt_kv_arr[idx+1];
+			node_kv_copy(tree, bnode, idx, bnode, idx + 1);
 			++idx;
 		}
 		/*
@@ -863,6 +1037,11 @@ void be_btree_delete_key_from_node(struct m0_be_btree	 *tree,
 				   &bnode->bt_kv_arr[bnode_pos->bnp_index],
 				   sizeof
 				   bnode->bt_kv_arr[bnode_pos->bnp_index]);
+			if (node_has_kprefix(bnode))
+				mem_update(tree, tx,
+					   &bnode->bt_kprefix_arr[bnode_pos->
+								  bnp_index],
+					   sizeof *bnode->bt_kprefix_arr);
 		}
 
 		bnode->bt_num_active_key--;
@@ -885,12 +1064,15 @@ static void btree_node_child_delete(struct m0_be_btree    *btree,
 				    struct btree_node_pos *child,
 				    bool		   left)
 {
+	struct be_btree_key_val kv = node->bt_kv_arr[index];
+	uint64_t                kprefix = node_kprefix(btree, node, index);
+
 	M0_ASSERT(child->bnp_node->bt_isleaf);
 	M0_LOG(M0_DEBUG, "swap%s with n=%p i=%d", left ? "L" : "R",
 						  child->bnp_node,
 						  child->bnp_index);
-	M0_SWAP(child->bnp_node->bt_kv_arr[child->bnp_index],
-		node->bt_kv_arr[index]);
+	node_kv_copy(btree, node, index, child->bnp_node, child->bnp_index);
+	node_kv_set(child->bnp_node, child->bnp_index, &kv, kprefix);
 	/*
 	 * Update checksum for parent, for child it will be updated
 	 * in delete_key_from_node().
@@ -922,6 +1104,8 @@ static int be_btree_delete_key(struct m0_be_btree *tree,
 	int			rc = -1;
 	unsigned int		iter;
 	unsigned int		idx;
+	uint64_t		kprefix = be_btree_kprefix(tree, key);
+	bool			found;
 
 	M0_PRE(btree_invariant(tree));
 	M0_PRE(btree_node_invariant(tree, tree->bb_root, true));
@@ -939,17 +1123,12 @@ static int be_btree_delete_key(struct m0_be_btree *tree,
 
 			/*  Retrieve index of the key equal to or greater than*/
 			/*  key being searched */
-			iter = 0;
-			while (iter < bnode->bt_num_active_key &&
-			       key_gt(tree, key,
-				      bnode->bt_kv_arr[iter].btree_key))
-				iter++;
-
+			iter = be_btree_node_search(tree, bnode, key, kprefix,
+						    &found);
 			idx = iter;
 
 			/* check if key is found */
-			if (iter < bnode->bt_num_active_key &&
-			    key_eq(tree, key, bnode->bt_kv_arr[iter].btree_key))
+			if (found)
 				break;
 
 			/* Reached leaf node, nothing left to search */
@@ -1096,30 +1275,34 @@ static struct m0_be_bnode *node_pop(struct m0_be_btree_cursor *it, int *idx)
 *   @param key pointer to key which is used to search node.
 *   @param slant bool to decide searching needs to be on leaf node.
 *                if true, search leaf node, else search in non-leaf node
+*   @param latch if true, the leaf reached by the search is latched in read
+*                mode and returned in btree_node_pos::bnp_latch, which the
+*                caller releases after it is done with the found key-value.
+*                Needed when the tree is not locked exclusively.
 *   @return struct btree_node_pos.
 */
 struct btree_node_pos
-be_btree_get_btree_node(struct m0_be_btree_cursor *it, const void *key, bool slant)
+be_btree_get_btree_node(struct m0_be_btree_cursor *it, const void *key,
+			bool slant, bool latch)
 {
 	int 			 idx;
 	struct m0_be_btree 	*tree = it->bc_tree;
 	struct m0_be_bnode 	*bnode = tree->bb_root;
 	struct btree_node_pos    bnode_pos = { .bnp_node = NULL };
+	uint64_t                 kprefix = be_btree_kprefix(tree, key);
+	bool                     found;
 
 	it->bc_stack_pos = 0;
 
 	while (true) {
+		if (latch && bnode->bt_isleaf)
+			bnode_pos.bnp_latch = btree_leaf_read_lock(bnode);
 		/*  Retrieve index of the key equal to or greater than */
 		/*  the key being searched */
-		idx = 0;
-		while (idx < bnode->bt_num_active_key &&
-		       key_gt(tree, key, bnode->bt_kv_arr[idx].btree_key)) {
-			idx++;
-		}
+		idx = be_btree_node_search(tree, bnode, key, kprefix, &found);
 
 		/*  If key is found, copy key-value pair */
-		if (idx < bnode->bt_num_active_key &&
-		    key_eq(tree, key, bnode->bt_kv_arr[idx].btree_key)) {
+		if (found) {
 			bnode_pos.bnp_node = bnode;
 			bnode_pos.bnp_index = idx;
 			break;
@@ -1300,7 +1483,7 @@ static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
 	struct be_btree_key_val   *key_val = NULL;
 
 	btree_cursor.bc_tree = btree;
-	node_pos = be_btree_get_btree_node(&btree_cursor, key, false);
+	node_pos = be_btree_get_btree_node(&btree_cursor, key, false, false);
 
 	if (node_pos.bnp_node)
 		key_val = &node_pos.bnp_node->bt_kv_arr[node_pos.bnp_index];
@@ -1318,13 +1501,17 @@ static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
 */
 static void *be_btree_get_max_key(struct m0_be_btree *tree)
 {
-	struct btree_node_pos node;
+	struct btree_node_pos  node;
+	struct m0_rwlock      *latch;
+	void                  *key = NULL;
 
 	be_btree_get_max_key_pos(tree->bb_root, &node);
-	if (node.bnp_node->bt_num_active_key == 0)
-		return NULL;
-	else
-		return node.bnp_node->bt_kv_arr[node.bnp_index].btree_key;
+	latch = btree_leaf_read_lock(node.bnp_node);
+	if (node.bnp_node->bt_num_active_key > 0)
+		key = node.bnp_node->bt_kv_arr[node.bnp_node->
+					       bt_num_active_key - 1].btree_key;
+	m0_rwlock_read_unlock(latch);
+	return key;
 }
 
 /**
@@ -1337,13 +1524,16 @@ static void *be_btree_get_max_key(struct m0_be_btree *tree)
 */
 static void *be_btree_get_min_key(struct m0_be_btree *tree)
 {
-	struct btree_node_pos node;
+	struct btree_node_pos  node;
+	struct m0_rwlock      *latch;
+	void                  *key = NULL;
 
 	be_btree_get_min_key_pos(tree->bb_root, &node);
-	if (node.bnp_node->bt_num_active_key == 0)
-		return NULL;
-	else
-		return node.bnp_node->bt_kv_arr[0].btree_key;
+	latch = btree_leaf_read_lock(node.bnp_node);
+	if (node.bnp_node->bt_num_active_key > 0)
+		key = node.bnp_node->bt_kv_arr[0].btree_key;
+	m0_rwlock_read_unlock(latch);
+	return key;
 }
 
 static void btree_pair_release(struct m0_be_btree *btree, struct m0_be_tx *tx,
@@ -1352,6 +1542,92 @@ static void btree_pair_release(struct m0_be_btree *btree, struct m0_be_tx *tx,
 	mem_free(btree, tx, kv->btree_key);
 }
 
+/**
+ * Allocates the memory for a new key-value pair and fills @kv.
+ *
+ * If @val is NULL, the value is left for the user and its address is returned
+ * in @anchor.
+ */
+static void btree_kv_make(struct m0_be_btree        *tree,
+			  struct m0_be_tx           *tx,
+			  const struct m0_buf       *key,
+			  const struct m0_buf       *val,
+			  struct m0_be_btree_anchor *anchor,
+			  m0_bcount_t                vsz,
+			  uint64_t                   zonemask,
+			  struct be_btree_key_val   *kv)
+{
+	m0_bcount_t ksz;
+
+	/* Avoid CPU alignment overhead on values. */
+	ksz = m0_align(key->b_nob, sizeof(void*));
+	kv->btree_key = mem_alloc(tree, tx, ksz + vsz, zonemask);
+	kv->btree_val = kv->btree_key + ksz;
+	memcpy(kv->btree_key, key->b_addr, key->b_nob);
+	memset(kv->btree_key + key->b_nob, 0, ksz - key->b_nob);
+	if (val != NULL) {
+		memcpy(kv->btree_val, val->b_addr, vsz);
+		mem_update(tree, tx, kv->btree_key, ksz + vsz);
+	} else {
+		mem_update(tree, tx, kv->btree_key, ksz);
+		anchor->ba_value.b_addr = kv->btree_val;
+	}
+}
+
+/**
+ * Inserts a new key-value pair with the tree lock held in read mode.
+ *
+ * Internal nodes do not change while the tree lock is held in read mode, so
+ * they are searched without latches. Only the target leaf is latched, in
+ * write mode. A full leaf has to be split, which changes the parent, so such
+ * an insertion is left to the caller to repeat with the tree lock held in
+ * write mode.
+ *
+ * @retval -EEXIST the key is already in the tree.
+ * @retval -EAGAIN the leaf is full.
+ */
+static int btree_insert_shared(struct m0_be_btree  *tree,
+			       struct m0_be_tx     *tx,
+			       const struct m0_buf *key,
+			       const struct m0_buf *val,
+			       uint64_t             zonemask)
+{
+	struct m0_be_bnode      *node = tree->bb_root;
+	struct m0_rwlock        *latch;
+	struct be_btree_key_val  new_kv;
+	uint64_t                 kprefix = be_btree_kprefix(tree, key->b_addr);
+	unsigned int             idx;
+	bool                     found;
+	int                      rc;
+
+	while (!node->bt_isleaf) {
+		idx = be_btree_node_search(tree, node, key->b_addr, kprefix,
+					   &found);
+		if (found)
+			return -EEXIST;
+		node = node->bt_child_arr[idx];
+	}
+
+	latch = btree_latch(node);
+	m0_rwlock_write_lock(latch);
+	M0_ASSERT(btree_node_invariant(tree, node, node == tree->bb_root));
+	idx = be_btree_node_search(tree, node, key->b_addr, kprefix, &found);
+	if (found)
+		rc = -EEXIST;
+	else if (node->bt_num_active_key == KV_NR)
+		rc = -EAGAIN;
+	else {
+		btree_kv_make(tree, tx, key, val, NULL, val->b_nob, zonemask,
+			      &new_kv);
+		be_btree_leaf_insert(tree, tx, node, idx, &new_kv, kprefix);
+		M0_ASSERT(btree_node_invariant(tree, node,
+					       node == tree->bb_root));
+		rc = 0;
+	}
+	m0_rwlock_write_unlock(latch);
+	return rc;
+}
+
 /**
  * Inserts or updates value by key
  * @param tree The btree
@@ -1371,11 +1647,13 @@ static void btree_save(struct m0_be_btree        *tree,
 		       enum btree_save_optype     optype,
 		       uint64_t                   zonemask)
 {
-	m0_bcount_t        ksz;
 	m0_bcount_t        vsz;
 	struct be_btree_key_val   new_kv;
 	struct be_btree_key_val  *cur_kv;
+	uint64_t           kprefix = be_btree_kprefix(tree, key->b_addr);
 	bool               val_overflow = false;
+	bool               fi_exists;
+	int                rc;
 
 	M0_ENTRY("tree=%p", tree);
 
@@ -1398,6 +1676,17 @@ static void btree_save(struct m0_be_btree        *tree,
 		      M0_BBO_UPDATE : M0_BBO_INSERT, NULL);
 
 	m0_be_op_active(op);
+	fi_exists = M0_FI_ENABLED("already_exists");
+	if (optype == BTREE_SAVE_INSERT && anchor == NULL && !fi_exists) {
+		m0_rwlock_read_lock(btree_rwlock(tree));
+		rc = btree_insert_shared(tree, tx, key, val, zonemask);
+		m0_rwlock_read_unlock(btree_rwlock(tree));
+		if (rc != -EAGAIN) {
+			op_tree(op)->t_rc = rc;
+			goto out;
+		}
+	}
+
 	m0_rwlock_write_lock(btree_rwlock(tree));
 	if (anchor != NULL) {
 		anchor->ba_tree = tree;
@@ -1407,7 +1696,7 @@ static void btree_save(struct m0_be_btree        *tree,
 	} else
 		vsz = val->b_nob;
 
-	if (M0_FI_ENABLED("already_exists"))
+	if (fi_exists)
 		goto fi_exist;
 
 	op_tree(op)->t_rc = 0;
@@ -1447,34 +1736,21 @@ static void btree_save(struct m0_be_btree        *tree,
 
 		if (op_tree(op)->t_rc == 0 &&
 		    (cur_kv == NULL || val_overflow)) {
-			/* Avoid CPU alignment overhead on values. */
-			ksz = m0_align(key->b_nob, sizeof(void*));
-			new_kv.btree_key =
-				      mem_alloc(tree, tx, ksz + vsz, zonemask);
-			new_kv.btree_val = new_kv.btree_key + ksz;
-			memcpy(new_kv.btree_key, key->b_addr, key->b_nob);
-			memset(new_kv.btree_key + key->b_nob, 0,
-							ksz - key->b_nob);
-			if (val != NULL) {
-				memcpy(new_kv.btree_val, val->b_addr, vsz);
-				mem_update(tree, tx,
-						new_kv.btree_key, ksz + vsz);
-			} else {
-				mem_update(tree, tx, new_kv.btree_key, ksz);
-				anchor->ba_value.b_addr = new_kv.btree_val;
-			}
-
-			be_btree_insert_newkey(tree, tx, &new_kv);
+			btree_kv_make(tree, tx, key, val, anchor, vsz,
+				      zonemask, &new_kv);
+			be_btree_insert_newkey(tree, tx, &new_kv, kprefix);
 		}
 	} else {
 fi_exist:
 		op_tree(op)->t_rc = -EEXIST;
-		M0_LOG(M0_NOTICE, "the key entry at %p already exist",
-			key->b_addr);
 	}
 
 	if (anchor == NULL)
 		m0_rwlock_write_unlock(btree_rwlock(tree));
+out:
+	if (op_tree(op)->t_rc == -EEXIST)
+		M0_LOG(M0_NOTICE, "the key entry at %p already exist",
+		       key->b_addr);
 	m0_be_op_done(op);
 	M0_LEAVE("tree=%p", tree);
 }
@@ -1601,6 +1877,10 @@ static void btree_node_update_credit(struct m0_be_tx_credit *accum,
 	/* struct m0_be_bnode update x2 */
 	m0_be_tx_credit_mac(&cred,
 			    &M0_BE_TX_CREDIT_TYPE(struct m0_be_bnode), 2);
+	/* key prefixes of a version 2 node are captured separately */
+	m0_be_tx_credit_add(&cred, &M0_BE_TX_CREDIT(1,
+				M0_MEMBER_SIZE(struct m0_be_bnode,
+					       bt_kprefix_arr)));
 
 	m0_be_tx_credit_mac(accum, &cred, nr);
 }
@@ -2005,7 +2285,8 @@ static void be_btree_lookup(struct m0_be_btree *tree,
 
 	it.bc_tree = tree;
 	kp = be_btree_get_btree_node(&it, key_in->b_addr,
-			    /* slant: */ key_out == NULL ? false : true);
+			    /* slant: */ key_out == NULL ? false : true,
+			    /* latch: */ true);
 	if (kp.bnp_node) {
 		kv = &kp.bnp_node->bt_kv_arr[kp.bnp_index];
 
@@ -2025,6 +2306,8 @@ static void be_btree_lookup(struct m0_be_btree *tree,
 	} else
 		op_tree(op)->t_rc = -ENOENT;
 
+	if (kp.bnp_latch != NULL)
+		m0_rwlock_read_unlock(kp.bnp_latch);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 	M0_LEAVE("rc=%d", op_tree(op)->t_rc);
@@ -2154,7 +2437,9 @@ M0_INTERNAL void m0_be_btree_lookup_inplace(struct m0_be_btree        *tree,
 					    const struct m0_buf       *key,
 					    struct m0_be_btree_anchor *anchor)
 {
-	struct be_btree_key_val  *kv;
+	struct m0_be_btree_cursor  it;
+	struct btree_node_pos      kp;
+	struct be_btree_key_val   *kv;
 
 	M0_ENTRY("tree=%p", tree);
 	M0_PRE(tree->bb_root != NULL && tree->bb_ops != NULL);
@@ -2166,12 +2451,23 @@ M0_INTERNAL void m0_be_btree_lookup_inplace(struct m0_be_btree        *tree,
 
 	anchor->ba_tree = tree;
 	anchor->ba_write = false;
-	kv = be_btree_search(tree, key->b_addr);
-	if (kv == NULL)
+	it.bc_tree = tree;
+	kp = be_btree_get_btree_node(&it, key->b_addr, false, true);
+	if (kp.bnp_node == NULL)
 		op_tree(op)->t_rc = -ENOENT;
-	else
+	else {
+		/*
+		 * The value stays in place after the leaf latch is released:
+		 * concurrent insertions only move key-value descriptors, and
+		 * deletions are excluded by the read lock kept till
+		 * m0_be_btree_release().
+		 */
+		kv = &kp.bnp_node->bt_kv_arr[kp.bnp_index];
 		m0_buf_init(&anchor->ba_value, kv->btree_val,
 			    be_btree_vsize(tree, kv->btree_val));
+	}
+	if (kp.bnp_latch != NULL)
+		m0_rwlock_read_unlock(kp.bnp_latch);
 
 	m0_be_op_done(op);
 	M0_LEAVE();
@@ -2305,7 +2601,7 @@ M0_INTERNAL void m0_be_btree_cursor_get(struct m0_be_btree_cursor *cur,
 	m0_be_op_active(op);
 	m0_rwlock_read_lock(btree_rwlock(tree));
 
-	last = be_btree_get_btree_node(cur, key->b_addr, slant);
+	last = be_btree_get_btree_node(cur, key->b_addr, slant, true);
 
 	if (last.bnp_node == NULL) {
 		M0_SET0(&op_tree(op)->t_out_val);
@@ -2324,6 +2620,8 @@ M0_INTERNAL void m0_be_btree_cursor_get(struct m0_be_btree_cursor *cur,
 		op_tree(op)->t_rc = 0;
 	}
 
+	if (last.bnp_latch != NULL)
+		m0_rwlock_read_unlock(last.bnp_latch);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -2361,6 +2659,7 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 	struct m0_be_op    *op   = &cur->bc_op;
 	struct m0_be_btree *tree = cur->bc_tree;
 	struct m0_be_bnode *node;
+	struct m0_rwlock   *latch = NULL;
 
 	btree_op_fill(op, tree, NULL, M0_BBO_CURSOR_NEXT, NULL);
 
@@ -2376,6 +2675,7 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 	/* cursor move */
 	++cur->bc_pos;
 	if (node->bt_isleaf) {
+		latch = btree_leaf_read_lock(node);
 		while (node && cur->bc_pos >= node->bt_num_active_key)
 			node = node_pop(cur, &cur->bc_pos);
 	} else {
@@ -2386,6 +2686,7 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 			if (node->bt_isleaf)
 				break;
 		}
+		latch = btree_leaf_read_lock(node);
 	}
 
 	if (node == NULL) {
@@ -2404,6 +2705,8 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 	m0_buf_init(&op_tree(op)->t_out_key, kv->btree_key,
 		    be_btree_ksize(tree, kv->btree_key));
 out:
+	if (latch != NULL)
+		m0_rwlock_read_unlock(latch);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -2414,6 +2717,7 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 	struct m0_be_op    *op   = &cur->bc_op;
 	struct m0_be_btree *tree = cur->bc_tree;
 	struct m0_be_bnode *node;
+	struct m0_rwlock   *latch = NULL;
 
 	btree_op_fill(op, tree, NULL, M0_BBO_CURSOR_PREV, NULL);
 
@@ -2424,6 +2728,7 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 
 	/* cursor move */
 	if (node->bt_isleaf) {
+		latch = btree_leaf_read_lock(node);
 		--cur->bc_pos;
 		while (node && cur->bc_pos < 0) {
 			node = node_pop(cur, &cur->bc_pos);
@@ -2434,6 +2739,7 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 			node_push(cur, node, cur->bc_pos);
 			node = node->bt_child_arr[cur->bc_pos];
 			if (node->bt_isleaf) {
+				latch = btree_leaf_read_lock(node);
 				cur->bc_pos = node->bt_num_active_key - 1;
 				break;
 			} else
@@ -2457,6 +2763,8 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 	m0_buf_init(&op_tree(op)->t_out_key, kv->btree_key,
 		    be_btree_ksize(tree, kv->btree_key));
 out:
+	if (latch != NULL)
+		m0_rwlock_read_unlock(latch);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -2518,6 +2826,37 @@ static struct m0_rwlock *btree_rwlock(struct m0_be_btree *tree)
 	return &tree->bb_lock.bl_u.rwlock;
 }
 
+static struct m0_rwlock *btree_latch(const struct m0_be_bnode *leaf)
+{
+	M0_PRE(leaf->bt_isleaf);
+	return &btree_latches[m0_hash((uint64_t)leaf) % BTREE_LATCH_NR];
+}
+
+static struct m0_rwlock *btree_leaf_read_lock(const struct m0_be_bnode *leaf)
+{
+	struct m0_rwlock *latch = btree_latch(leaf);
+
+	m0_rwlock_read_lock(latch);
+	return latch;
+}
+
+M0_INTERNAL int m0_be_btree_mod_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(btree_latches); ++i)
+		m0_rwlock_init(&btree_latches[i]);
+	return 0;
+}
+
+M0_INTERNAL void m0_be_btree_mod_fini(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(btree_latches); ++i)
+		m0_rwlock_fini(&btree_latches[i]);
+}
+
 /** @} end of be group */
 #undef M0_TRACE_SUBSYSTEM
 
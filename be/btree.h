@@ -70,7 +70,15 @@ struct m0_be_btree {
 	/*
 	 * volatile-only fields
 	 */
-	/** The lock to acquire when performing operations on the tree. */
+	/**
+	 * The lock to acquire when performing operations on the tree.
+	 *
+	 * Taken in read mode by the operations which do not change the
+	 * shape of the tree: lookups, cursor moves and insertions into a
+	 * non-full leaf. Contents of leaf nodes are protected by leaf
+	 * latches in that mode, see m0_be_btree_mod_init(). Taken in write
+	 * mode by node splits, deletions, updates and in-place operations.
+	 */
 	struct m0_be_rwlock              bb_lock;
 	/** The segment where we are stored. */
 	struct m0_be_seg                *bb_seg;
@@ -92,6 +100,20 @@ enum m0_be_btree_format_version {
 struct m0_table;
 struct m0_table_ops;
 
+/**
+ * Initialises the table of leaf latches shared by all trees.
+ *
+ * Concurrent operations holding m0_be_btree::bb_lock in read mode see the
+ * internal nodes of the tree immutable, so only leaves need protection.
+ * A leaf is covered by one of a fixed number of rwlocks selected by the
+ * hash of its address: lookups and cursors take it in read mode, insertions
+ * into a non-full leaf take it in write mode. A thread never holds more
+ * than one latch, which makes latch collisions between unrelated trees
+ * harmless.
+ */
+M0_INTERNAL int  m0_be_btree_mod_init(void);
+M0_INTERNAL void m0_be_btree_mod_fini(void);
+
 /** Btree operations vector. */
 struct m0_be_btree_kv_ops {
 	uint64_t      ko_type; /**< m0_be_btree_type */
@@ -111,6 +133,21 @@ struct m0_be_btree_kv_ops {
 	 * XXX RENAMEME? s/ko_compare/ko_key_cmp/
 	 */
 	int         (*ko_compare)(const void *key0, const void *key1);
+
+	/**
+	 * Order-preserving key prefix. Optional.
+	 *
+	 * Must be monotonic with respect to ko_compare():
+	 * ko_compare(key0, key1) < 0 implies
+	 * ko_prefix(key0) <= ko_prefix(key1). The prefix is stored next to
+	 * the key pointer in the node and ko_compare() is only called when the
+	 * prefixes of two keys are equal. For memcmp(3)-ordered keys it is the
+	 * first 8 bytes of the key in big-endian order.
+	 *
+	 * If NULL, every key has prefix 0 and all comparisons go through
+	 * ko_compare().
+	 */
+	uint64_t    (*ko_prefix)(const void *key);
 };
 
 /** Stored in m0_be_btree_backlink::bl_type */
@@ -56,19 +56,31 @@ struct m0_be_bnode {
 	char                         bt_pad[7];  /* Used to padd */
 	struct be_btree_key_val      bt_kv_arr[KV_NR]; /* Array of key-vals */
 	struct m0_be_bnode          *bt_child_arr[KV_NR + 1]; /* childnode array */
+	/**
+	 * Order-preserving prefixes of the keys in bt_kv_arr[], see
+	 * m0_be_btree_kv_ops::ko_prefix(). Kept inline in the node so that
+	 * node search resolves most comparisons without dereferencing
+	 * btree_key.
+	 *
+	 * Added in M0_BE_BNODE_FORMAT_VERSION_2. Version 1 nodes end here:
+	 * their footer is where this array starts, all preceding fields have
+	 * the same layout in both versions.
+	 */
+	uint64_t                     bt_kprefix_arr[KV_NR];
 	struct m0_format_footer      bt_footer;  /* Footer of node */
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 M0_BASSERT(sizeof(bool) == 1);
 
 enum m0_be_bnode_format_version {
 	M0_BE_BNODE_FORMAT_VERSION_1 = 1,
+	/** m0_be_bnode::bt_kprefix_arr[] is added. */
+	M0_BE_BNODE_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_BE_BNODE_FORMAT_VERSION */
-	/*M0_BE_BNODE_FORMAT_VERSION_2,*/
 	/*M0_BE_BNODE_FORMAT_VERSION_3,*/
 
 	/** Current version, should point to the latest version present */
-	M0_BE_BNODE_FORMAT_VERSION = M0_BE_BNODE_FORMAT_VERSION_1
+	M0_BE_BNODE_FORMAT_VERSION = M0_BE_BNODE_FORMAT_VERSION_2
 };
 
 /** @} end of be group */
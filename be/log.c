@@ -85,6 +85,7 @@ static int be_log_level_enter(struct m0_module *module)
 		log->lg_prev_record      = 0;
 		log->lg_prev_record_size = 0;
 		log->lg_unplaced_exists  = false;
+		M0_SET0(&log->lg_prefetch);
 		m0_mutex_init(&log->lg_record_state_lock);
 		record_tlist_init(&log->lg_records);
 		m0_be_op_init(&log->lg_header_read_op);
@@ -1001,35 +1002,222 @@ M0_INTERNAL int m0_be_log_header_read(struct m0_be_log            *log,
 	return M0_RC_INFO(rc, "log_hdr="BFLH_F, BFLH_P(log_hdr));
 }
 
-static int be_log_read_plain(struct m0_be_log *log,
+static int be_log_io_prepare(struct m0_be_log *log,
+			     struct m0_be_io  *bio,
 			     m0_bindex_t       pos,
 			     m0_bcount_t       size,
 			     void             *out)
 {
-	struct m0_be_io        bio    = {};
 	struct m0_be_io_credit iocred = M0_BE_IO_CREDIT(1, size, 1);
 	int                    rc;
 
 	be_log_io_credit(log, &iocred);
-	rc = m0_be_io_init(&bio);
+	rc = m0_be_io_init(bio);
 	if (rc != 0)
-		goto out;
-	rc = m0_be_io_allocate(&bio, &iocred);
+		return rc;
+	rc = m0_be_io_allocate(bio, &iocred);
+	if (rc != 0) {
+		m0_be_io_fini(bio);
+		return rc;
+	}
+	m0_be_io_add_nostob(bio, out, 0, size);
+	m0_be_log_store_io_translate(&log->lg_store, pos, bio);
+	m0_be_io_configure(bio, SIO_READ);
+	return 0;
+}
+
+static void be_log_io_release(struct m0_be_io *bio)
+{
+	m0_be_io_deallocate(bio);
+	m0_be_io_fini(bio);
+}
+
+static int be_log_read_plain(struct m0_be_log *log,
+			     m0_bindex_t       pos,
+			     m0_bcount_t       size,
+			     void             *out)
+{
+	struct m0_be_io bio = {};
+	int             rc;
+
+	rc = be_log_io_prepare(log, &bio, pos, size, out);
 	if (rc == 0) {
-		m0_be_io_add_nostob(&bio, out, 0, size);
-		m0_be_log_store_io_translate(&log->lg_store, pos, &bio);
-		m0_be_io_configure(&bio, SIO_READ);
 		rc = M0_BE_OP_SYNC_RET(op, m0_be_io_launch(&bio, &op),
 				       bo_sm.sm_rc);
-		m0_be_io_deallocate(&bio);
+		be_log_io_release(&bio);
 	}
-	m0_be_io_fini(&bio);
-out:
 	if (rc != 0)
 		m0_be_io_err_send(-rc, M0_BE_LOC_LOG, SIO_READ);
 	return rc;
 }
 
+/* Starts reading of the log from pos into the window. */
+static int be_log_window_launch(struct m0_be_log        *log,
+				struct m0_be_log_window *w,
+				m0_bindex_t              pos)
+{
+	struct m0_be_log_prefetch *lp = &log->lg_prefetch;
+	int                        rc;
+
+	M0_PRE(!w->lw_busy);
+
+	w->lw_pos   = pos;
+	w->lw_valid = false;
+	rc = be_log_io_prepare(log, &w->lw_io, pos, lp->lp_size, w->lw_buf);
+	if (rc != 0)
+		return rc;
+	m0_be_op_init(&w->lw_op);
+	m0_be_io_launch(&w->lw_io, &w->lw_op);
+	w->lw_busy = true;
+	++lp->lp_io_nr;
+	return 0;
+}
+
+/* Waits for the read launched by be_log_window_launch(), if any. */
+static int be_log_window_wait(struct m0_be_log_window *w)
+{
+	int rc;
+
+	if (!w->lw_busy)
+		return w->lw_valid ? 0 : -EIO;
+	m0_be_op_wait(&w->lw_op);
+	rc = w->lw_op.bo_sm.sm_rc;
+	m0_be_op_fini(&w->lw_op);
+	be_log_io_release(&w->lw_io);
+	w->lw_busy  = false;
+	w->lw_valid = rc == 0;
+	return rc;
+}
+
+/* True iff [pos, pos + size) is or is being read into the window. */
+static bool be_log_window_has(const struct m0_be_log_prefetch *lp,
+			      const struct m0_be_log_window   *w,
+			      m0_bindex_t                      pos,
+			      m0_bcount_t                      size)
+{
+	return (w->lw_valid || w->lw_busy) &&
+		w->lw_pos <= pos && pos + size <= w->lw_pos + lp->lp_size;
+}
+
+/* Starts reading the window next to the current one in the scan direction. */
+static void be_log_readahead(struct m0_be_log *log)
+{
+	struct m0_be_log_prefetch *lp  = &log->lg_prefetch;
+	struct m0_be_log_window   *cur = &lp->lp_win[lp->lp_cur];
+	struct m0_be_log_window   *ra  = &lp->lp_win[1 - lp->lp_cur];
+	m0_bindex_t                pos;
+
+	M0_PRE(cur->lw_valid && !ra->lw_busy);
+
+	if (lp->lp_backward && cur->lw_pos == 0)
+		return;
+	if (lp->lp_backward)
+		pos = cur->lw_pos > lp->lp_size ? cur->lw_pos - lp->lp_size : 0;
+	else
+		pos = cur->lw_pos + lp->lp_size;
+	/* Read-ahead is an optimisation, a failed one is retried on demand. */
+	(void)be_log_window_launch(log, ra, pos);
+}
+
+M0_INTERNAL int m0_be_log_prefetch_init(struct m0_be_log *log,
+					m0_bcount_t       size)
+{
+	struct m0_be_log_prefetch *lp     = &log->lg_prefetch;
+	uint32_t                   bshift = m0_be_log_bshift(log);
+	int                        i;
+
+	M0_PRE(lp->lp_win[0].lw_buf == NULL);
+
+	size = min_check(m0_align(size, 1ULL << bshift),
+			 m0_be_log_store_buf_size(&log->lg_store));
+	*lp = (struct m0_be_log_prefetch){ .lp_size = size };
+	for (i = 0; i < ARRAY_SIZE(lp->lp_win); ++i) {
+		lp->lp_win[i].lw_buf = m0_alloc_aligned(size, bshift);
+		if (lp->lp_win[i].lw_buf == NULL) {
+			m0_be_log_prefetch_fini(log);
+			return M0_ERR(-ENOMEM);
+		}
+	}
+	return 0;
+}
+
+M0_INTERNAL void m0_be_log_prefetch_fini(struct m0_be_log *log)
+{
+	struct m0_be_log_prefetch *lp = &log->lg_prefetch;
+	struct m0_be_log_window   *w;
+	int                        i;
+
+	M0_LOG(M0_DEBUG, "io_nr=%"PRIu64" hit_nr=%"PRIu64,
+	       lp->lp_io_nr, lp->lp_hit_nr);
+	for (i = 0; i < ARRAY_SIZE(lp->lp_win); ++i) {
+		w = &lp->lp_win[i];
+		if (w->lw_buf == NULL)
+			continue;
+		(void)be_log_window_wait(w);
+		m0_free_aligned(w->lw_buf, lp->lp_size, m0_be_log_bshift(log));
+		w->lw_buf = NULL;
+	}
+}
+
+/*
+ * Reads [pos, pos + size) from the log through the read-ahead window.
+ *
+ * @param end End of the log record being read or 0 if it is not known yet.
+ *
+ * Log is scanned forward from the last logged record first and then backward
+ * to the last discarded one. The window is refilled starting from pos when
+ * moving forward. When moving backward it is refilled so that it ends at the
+ * end of the record, so that its header and footer are read by a single I/O
+ * and the preceding records are likely to be in the window too.
+ *
+ * Every time the window is refilled, the read of the next window in the scan
+ * direction is started, so that it overlaps with processing of the records in
+ * the current one. When a read hits the next window, the windows are swapped.
+ */
+static int be_log_read(struct m0_be_log *log,
+		       m0_bindex_t       pos,
+		       m0_bcount_t       size,
+		       m0_bindex_t       end,
+		       void             *out)
+{
+	struct m0_be_log_prefetch *lp  = &log->lg_prefetch;
+	struct m0_be_log_window   *cur = &lp->lp_win[lp->lp_cur];
+	struct m0_be_log_window   *ra  = &lp->lp_win[1 - lp->lp_cur];
+	m0_bindex_t                start;
+	int                        rc;
+
+	if (cur->lw_buf == NULL || size > lp->lp_size) {
+		++lp->lp_io_nr;
+		return be_log_read_plain(log, pos, size, out);
+	}
+	if (!be_log_window_has(lp, cur, pos, size) &&
+	    be_log_window_has(lp, ra, pos, size) &&
+	    be_log_window_wait(ra) == 0) {
+		lp->lp_cur = 1 - lp->lp_cur;
+		M0_SWAP(cur, ra);
+		be_log_readahead(log);
+	}
+	if (be_log_window_has(lp, cur, pos, size)) {
+		++lp->lp_hit_nr;
+	} else {
+		lp->lp_backward = cur->lw_valid && pos < cur->lw_pos &&
+				  end >= pos + size;
+		start = !lp->lp_backward ? pos : end > lp->lp_size ?
+			min_check(end - lp->lp_size, pos) : 0;
+		/* Read-ahead of the other window is not needed anymore. */
+		(void)be_log_window_wait(ra);
+		rc = be_log_window_launch(log, cur, start) ?:
+		     be_log_window_wait(cur);
+		if (rc != 0) {
+			m0_be_io_err_send(-rc, M0_BE_LOC_LOG, SIO_READ);
+			return rc;
+		}
+		be_log_readahead(log);
+	}
+	memcpy(out, cur->lw_buf + (pos - cur->lw_pos), size);
+	return 0;
+}
+
 M0_INTERNAL bool m0_be_fmt_log_record_header__invariant(
 				struct m0_be_fmt_log_record_header *header,
 				struct m0_be_log                   *log)
@@ -1071,7 +1259,8 @@ static void be_log_record_header_copy(struct m0_be_fmt_log_record_header *dest,
 
 static int be_log_record_iter_read(struct m0_be_log             *log,
 				   struct m0_be_log_record_iter *iter,
-				   m0_bindex_t                   pos)
+				   m0_bindex_t                   pos,
+				   m0_bindex_t                   end)
 {
 	struct m0_be_fmt_log_record_footer *footer;
 	struct m0_be_fmt_log_record_header *header;
@@ -1096,7 +1285,7 @@ static int be_log_record_iter_read(struct m0_be_log             *log,
 	bvec     = M0_BUFVEC_INIT_BUF(&addr_fmt, &size_fmt);
 	m0_bufvec_cursor_init(&cur, &bvec);
 	pos &= ~((m0_bindex_t)align - 1);
-	rc   = be_log_read_plain(log, pos, size, data);
+	rc   = be_log_read(log, pos, size, end, data);
 	rc   = rc ?: m0_be_fmt_log_record_header_decode(&header, &cur,
 						M0_BE_FMT_DECODE_CFG_DEFAULT);
 	if (rc == -EPROTO)
@@ -1114,8 +1303,8 @@ static int be_log_record_iter_read(struct m0_be_log             *log,
 		addr_fmt = data + size - size_fmt;
 		bvec     = M0_BUFVEC_INIT_BUF(&addr_fmt, &size_fmt);
 		m0_bufvec_cursor_init(&cur, &bvec);
-		rc = be_log_read_plain(log, pos + header->lrh_size - size,
-				       size, data);
+		rc = be_log_read(log, pos + header->lrh_size - size, size,
+				 pos + header->lrh_size, data);
 		rc = rc ?: m0_be_fmt_log_record_footer_decode(&footer, &cur,
 					      M0_BE_FMT_DECODE_CFG_DEFAULT);
 		if (rc == 0) {
@@ -1155,7 +1344,7 @@ M0_INTERNAL int m0_be_log_record_initial(struct m0_be_log             *log,
 	int         rc;
 
 	rc = (pos == 0 && size == 0) ? -ENOENT : 0;
-	rc = rc ?: be_log_record_iter_read(log, curr, pos);
+	rc = rc ?: be_log_record_iter_read(log, curr, pos, pos + size);
 	if (rc == 0 && curr->lri_header.lrh_size != size)
 		rc = -EBADF;
 	return rc;
@@ -1166,7 +1355,8 @@ M0_INTERNAL int m0_be_log_record_next(struct m0_be_log                   *log,
 				      struct m0_be_log_record_iter       *next)
 {
 	int rc = be_log_record_iter_read(log, next, curr->lri_header.lrh_pos +
-						    curr->lri_header.lrh_size);
+						    curr->lri_header.lrh_size,
+					 0);
 	if (rc == 0 && curr->lri_header.lrh_pos >= next->lri_header.lrh_pos)
 		rc = -ENOENT;
 	return rc;
@@ -1177,7 +1367,9 @@ M0_INTERNAL int m0_be_log_record_prev(struct m0_be_log                   *log,
 				      struct m0_be_log_record_iter       *prev)
 {
 	int rc = be_log_record_iter_read(log, prev,
-					 curr->lri_header.lrh_prev_pos);
+					 curr->lri_header.lrh_prev_pos,
+					 curr->lri_header.lrh_prev_pos +
+					 curr->lri_header.lrh_prev_size);
 	if (rc == 0 && curr->lri_header.lrh_pos <= prev->lri_header.lrh_pos)
 		rc = -ENOENT;
 	return rc;
@@ -257,6 +257,44 @@ struct m0_be_log_cfg {
 	bool                        lc_skip_recovery;
 };
 
+/** Buffer of m0_be_log_prefetch. */
+struct m0_be_log_window {
+	char            *lw_buf;
+	/** Log position of the first byte of lw_buf. */
+	m0_bindex_t      lw_pos;
+	/** lw_buf contains log data starting from lw_pos. */
+	bool             lw_valid;
+	/** Read into lw_buf is in flight, lw_io and lw_op are in use. */
+	bool             lw_busy;
+	struct m0_be_io  lw_io;
+	struct m0_be_op  lw_op;
+};
+
+/**
+ * Read-ahead window for log record iteration.
+ *
+ * Recovery scans the log reading header and footer of every log record. When
+ * the window is set up these small reads are served from a large buffer which
+ * is filled by a single I/O. There are two such buffers: while reads are
+ * served from one of them, the other one is being read asynchronously from
+ * the log store in the direction of the scan.
+ *
+ * @see m0_be_log_prefetch_init()
+ */
+struct m0_be_log_prefetch {
+	struct m0_be_log_window lp_win[2];
+	/** Index of lp_win[] reads are served from. */
+	int                     lp_cur;
+	/** Size of each buffer. */
+	m0_bcount_t             lp_size;
+	/** The log is scanned towards lower positions. */
+	bool                    lp_backward;
+	/** Number of reads from log store. */
+	uint64_t                lp_io_nr;
+	/** Number of reads served from the buffers. */
+	uint64_t                lp_hit_nr;
+};
+
 /** This structure encapsulates internals of transactional log. */
 struct m0_be_log {
 	struct m0_be_log_cfg     lg_cfg;
@@ -275,6 +313,7 @@ struct m0_be_log {
 	/** Scheduler */
 	struct m0_be_log_sched   lg_sched;
 	struct m0_be_recovery    lg_recovery;
+	struct m0_be_log_prefetch lg_prefetch;
 	struct m0_be_fmt_log_header lg_header;
 	/** List of all non-discarded log_records. TODO remove it as unneeded */
 	struct m0_tl             lg_records;
@@ -496,6 +535,15 @@ M0_INTERNAL int m0_be_log_record_next(struct m0_be_log                   *log,
 M0_INTERNAL int m0_be_log_record_prev(struct m0_be_log *log,
 				      const struct m0_be_log_record_iter *curr,
 				      struct m0_be_log_record_iter       *prev);
+/**
+ * Sets up read-ahead window of the given size for log record iteration.
+ * Two buffers of this size are allocated, see m0_be_log_prefetch.
+ * The window is used by m0_be_log_record_initial(), m0_be_log_record_next()
+ * and m0_be_log_record_prev() until m0_be_log_prefetch_fini() is called.
+ */
+M0_INTERNAL int m0_be_log_prefetch_init(struct m0_be_log *log,
+					m0_bcount_t       size);
+M0_INTERNAL void m0_be_log_prefetch_fini(struct m0_be_log *log);
 M0_INTERNAL bool m0_be_fmt_log_record_header__invariant(
 				struct m0_be_fmt_log_record_header *header,
 				struct m0_be_log                   *log);
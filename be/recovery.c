@@ -28,6 +28,9 @@
 #include "lib/arith.h"          /* max_check */
 #include "lib/errno.h"          /* -ENOSYS */
 #include "lib/memory.h"
+#include "lib/time.h"           /* m0_time_now */
+#include "addb2/addb2.h"        /* M0_ADDB2_ADD */
+#include "be/addb2.h"           /* M0_AVI_BE_RECOVERY_SCAN */
 #include "be/fmt.h"
 #include "be/log.h"
 #include "motr/magic.h"         /* M0_BE_RECOVERY_MAGIC */
@@ -140,6 +143,15 @@
  *
  * <b>Iterative interface for looking over groups that need to be re-applied</b>
  * Recovery provides interface for pick next group for re-applying.
+ *
+ * <b>Log read-ahead</b>
+ * Scanning reads header and footer of every log record. Recovery sets up a
+ * read-ahead window for the log (m0_be_log_prefetch_init()), so the scanning
+ * is done by a few large reads instead of two small reads per record. The
+ * next window is read while records of the current one are processed.
+ *
+ * Duration of the scanning and of every stage of group re-applying are
+ * reported via addb2 (M0_AVI_BE_RECOVERY_SCAN, M0_AVI_BE_RECOVERY_GROUP).
  */
 
 M0_TL_DESCR_DEFINE(log_record_iter, "m0_be_log_record_iter list in recovery",
@@ -190,6 +202,7 @@ M0_INTERNAL int m0_be_recovery_run(struct m0_be_recovery *rvr)
 	m0_bindex_t                   last_discarded;
 	m0_bindex_t                   log_discarded;
 	m0_bindex_t                   next_pos = M0_BINDEX_MAX;
+	m0_time_t                     start    = m0_time_now();
 	int                           rc;
 
 	/* TODO avoid reading of header from disk, log reads it during init */
@@ -199,6 +212,11 @@ M0_INTERNAL int m0_be_recovery_run(struct m0_be_recovery *rvr)
 	M0_ASSERT(rc == 0);
 	log_discarded = log_hdr.flh_discarded;
 
+	rc = m0_be_log_prefetch_init(log, rvr->brec_cfg.brc_prefetch_size ?:
+					  M0_BE_RECOVERY_PREFETCH_SIZE);
+	if (rc != 0)
+		goto out_hdr;
+
 	rc = be_recovery_log_record_iter_new(&iter);
 	rc = rc ?: m0_be_log_record_initial(log, iter);
 	while (rc == 0) {
@@ -268,6 +286,11 @@ empty:
 	rvr->brec_discarded        = log_discarded;
 	M0_POST(log_record_iter_tlist_is_empty(&rvr->brec_iters));
 out:
+	M0_ADDB2_ADD(M0_AVI_BE_RECOVERY_SCAN, m0_time_now() - start,
+		     log_record_iter_tlist_length(&rvr->brec_iters),
+		     log->lg_prefetch.lp_io_nr, log->lg_prefetch.lp_hit_nr);
+	m0_be_log_prefetch_fini(log);
+out_hdr:
 	m0_be_fmt_log_header_fini(&log_hdr);
 	return rc;
 }
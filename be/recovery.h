@@ -56,8 +56,18 @@
 struct m0_be_log;
 struct m0_be_log_record_iter;
 
+enum {
+	/** Default size of the log read-ahead window used for log scanning. */
+	M0_BE_RECOVERY_PREFETCH_SIZE = 1 << 22,
+};
+
 struct m0_be_recovery_cfg {
 	struct m0_be_log *brc_log;
+	/**
+	 * Size of the log read-ahead window.
+	 * M0_BE_RECOVERY_PREFETCH_SIZE is used if it's 0.
+	 */
+	m0_bcount_t       brc_prefetch_size;
 };
 
 struct m0_be_recovery {
@@ -36,6 +36,7 @@
 #include "stob/stob.h"        /* m0_stob, m0_stob_fd */
 
 #include "be/seg_internal.h"  /* m0_be_seg_hdr */
+#include "be/alloc_internal.h" /* m0_be_alloc_mag */
 #include "be/io.h"            /* m0_be_io */
 
 #include <sys/mman.h>         /* mmap */
@@ -77,6 +78,16 @@ static int be_seg_hdr_size(void)
 	return sizeof(struct m0_be_seg_hdr);
 }
 
+M0_INTERNAL m0_bcount_t m0_be_seg_hdr_reserved(const struct m0_be_seg_hdr *hdr)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &hdr->bh_header);
+	return be_seg_hdr_size() +
+	       (tag.ot_version >= M0_BE_SEG_HDR_FORMAT_VERSION_2 ?
+		sizeof(struct m0_be_alloc_mag) * M0_BE_ALLOC_MAG_NR : 0);
+}
+
 static int be_seg_hdr_create(struct m0_stob *stob, struct m0_be_seg_hdr *hdr)
 {
 	struct m0_be_seg_geom *geom = hdr->bh_items;
@@ -374,7 +385,7 @@ M0_INTERNAL int m0_be_seg_open(struct m0_be_seg *seg)
 	/* rc = be_seg_read_all(seg, &hdr); */
 	rc = 0;
 	if (rc == 0) {
-		seg->bs_reserved = be_seg_hdr_size();
+		seg->bs_reserved = m0_be_seg_hdr_reserved(hdr);
 		seg->bs_size     = g->sg_size;
 		seg->bs_addr     = g->sg_addr;
 		seg->bs_offset   = g->sg_offset;
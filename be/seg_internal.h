@@ -59,15 +59,25 @@ struct m0_be_seg_hdr {
 
 enum m0_be_seg_hdr_format_version {
 	M0_BE_SEG_HDR_FORMAT_VERSION_1 = 1,
+	/**
+	 * Allocator magazines (m0_be_alloc_mag) are stored right after the
+	 * header. m0_be_seg_hdr itself is not changed.
+	 */
+	M0_BE_SEG_HDR_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_BE_SEG_HDR_FORMAT_VERSION */
-	/*M0_BE_SEG_HDR_FORMAT_VERSION_2,*/
 	/*M0_BE_SEG_HDR_FORMAT_VERSION_3,*/
 
 	/** Current version, should point to the latest version present */
-	M0_BE_SEG_HDR_FORMAT_VERSION = M0_BE_SEG_HDR_FORMAT_VERSION_1
+	M0_BE_SEG_HDR_FORMAT_VERSION = M0_BE_SEG_HDR_FORMAT_VERSION_2
 };
 
+/**
+ * Size of the segment area reserved for the header and the data stored next
+ * to it. Depends on the header format version.
+ */
+M0_INTERNAL m0_bcount_t m0_be_seg_hdr_reserved(const struct m0_be_seg_hdr *hdr);
+
 /** @} end of be group */
 #endif /* __MOTR_BE_SEG_INTERNAL_H__ */
 
@@ -795,7 +795,7 @@ static void seg_get(FILE *fp, struct m0_be_seg *out)
 	if (seg_hdr_get(fp, &seg_hdr)) {
 		g = &seg_hdr.bh_items[0];
 
-		seg.bs_reserved = sizeof(seg_hdr);
+		seg.bs_reserved = m0_be_seg_hdr_reserved(&seg_hdr);
 		seg.bs_size     = g->sg_size;
 		seg.bs_addr     = g->sg_addr;
 		seg.bs_offset   = g->sg_offset;
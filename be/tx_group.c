@@ -461,6 +461,12 @@ M0_INTERNAL void m0_be_tx_group_log_read(struct m0_be_tx_group *gr,
 	return m0_be_group_format_log_read(&gr->tg_od, op);
 }
 
+M0_INTERNAL m0_bindex_t
+m0_be_tx_group_log_position(const struct m0_be_tx_group *gr)
+{
+	return m0_be_group_format_log_position(&gr->tg_od);
+}
+
 M0_INTERNAL int m0_be_tx_group_decode(struct m0_be_tx_group *gr)
 {
 	return m0_be_group_format_decode(&gr->tg_od);
@@ -222,6 +222,9 @@ M0_INTERNAL void m0_be_tx_group_recovery_prepare(struct m0_be_tx_group *gr,
 						 struct m0_be_log      *log);
 M0_INTERNAL void m0_be_tx_group_log_read(struct m0_be_tx_group *gr,
 					 struct m0_be_op       *op);
+/** Log position of the group being recovered. */
+M0_INTERNAL m0_bindex_t
+m0_be_tx_group_log_position(const struct m0_be_tx_group *gr);
 M0_INTERNAL int m0_be_tx_group_decode(struct m0_be_tx_group *gr);
 M0_INTERNAL int m0_be_tx_group_reconstruct(struct m0_be_tx_group *gr,
 					   struct m0_sm_group    *sm_grp);
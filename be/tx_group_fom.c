@@ -27,7 +27,9 @@
 
 #include "lib/misc.h"        /* M0_BITS */
 #include "rpc/rpc_opcodes.h" /* M0_BE_TX_GROUP_OPCODE */
+#include "addb2/addb2.h"     /* M0_ADDB2_ADD */
 
+#include "be/addb2.h"        /* M0_AVI_BE_RECOVERY_GROUP */
 #include "be/tx_group.h"
 #include "be/tx_service.h"   /* m0_be_txs_stype */
 
@@ -146,6 +148,31 @@ const static struct m0_sm_conf tx_group_fom_conf = {
 	.scf_state     = tx_group_fom_states,
 };
 
+/*
+ * Finishes the current recovery stage and starts the next one. Durations of
+ * all stages are reported when the group is placed.
+ */
+static void
+tx_group_fom_recovery_stage(struct m0_be_tx_group_fom              *m,
+			    enum m0_be_tx_group_fom_recovery_stage  stage)
+{
+	m0_time_t now = m0_time_now();
+
+	M0_PRE(m->tgf_recovery_mode);
+
+	if (stage != M0_BE_TGRS_LOG_READ)
+		m->tgf_recovery_time[stage - 1] = now - m->tgf_recovery_start;
+	m->tgf_recovery_start = now;
+	if (stage == M0_BE_TGRS_NR) {
+		M0_ADDB2_ADD(M0_AVI_BE_RECOVERY_GROUP,
+			     m0_be_tx_group_log_position(m->tgf_group),
+			     m->tgf_recovery_time[M0_BE_TGRS_LOG_READ],
+			     m->tgf_recovery_time[M0_BE_TGRS_RECONSTRUCT],
+			     m->tgf_recovery_time[M0_BE_TGRS_REAPPLY],
+			     m->tgf_recovery_time[M0_BE_TGRS_PLACE]);
+	}
+}
+
 static int tx_group_fom_tick(struct m0_fom *fom)
 {
 	enum tx_group_fom_state    phase = m0_fom_phase(fom);
@@ -176,6 +203,7 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 	case TGS_LOGGING:
 		m0_be_op_reset(op);
 		if (m->tgf_recovery_mode) {
+			tx_group_fom_recovery_stage(m, M0_BE_TGRS_LOG_READ);
 			m0_be_tx_group_log_read(gr, op);
 			return m0_be_op_tick_ret(op, fom, TGS_RECONSTRUCT);
 		} else {
@@ -184,6 +212,7 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 			return m0_be_op_tick_ret(op, fom, TGS_PLACING);
 		}
 	case TGS_RECONSTRUCT:
+		tx_group_fom_recovery_stage(m, M0_BE_TGRS_RECONSTRUCT);
 		rc = m0_be_tx_group_decode(gr);
 		M0_ASSERT_INFO(rc == 0, "rc = %d", rc); /* XXX notify engine */
 		rc = m0_be_tx_group_reconstruct(gr,
@@ -202,17 +231,22 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 		m0_fom_phase_set(fom, TGS_REAPPLY);
 		return M0_FSO_AGAIN;
 	case TGS_REAPPLY:
+		tx_group_fom_recovery_stage(m, M0_BE_TGRS_REAPPLY);
 		m0_be_op_reset(op);
 		rc = m0_be_tx_group_reapply(gr, op);
 		M0_ASSERT_INFO(rc == 0, "rc = %d", rc); /* XXX notify engine */
 		return m0_be_op_tick_ret(op, fom, TGS_PLACING);
 	case TGS_PLACING:
+		if (m->tgf_recovery_mode)
+			tx_group_fom_recovery_stage(m, M0_BE_TGRS_PLACE);
 		m0_be_tx_group__tx_state_post(gr, M0_BTS_LOGGED, false);
 		m0_be_op_reset(op);
 		m0_be_tx_group_seg_place_prepare(gr);
 		m0_be_tx_group_seg_place(gr, op);
 		return m0_be_op_tick_ret(op, fom, TGS_PLACED);
 	case TGS_PLACED:
+		if (m->tgf_recovery_mode)
+			tx_group_fom_recovery_stage(m, M0_BE_TGRS_NR);
 		m0_be_tx_group__tx_state_post(gr, M0_BTS_PLACED, true);
 		m0_fom_phase_set(fom, TGS_STABILIZING);
 		return M0_FSO_AGAIN;
@@ -26,6 +26,7 @@
 
 #include "lib/types.h"          /* bool */
 #include "lib/semaphore.h"      /* m0_semaphore */
+#include "lib/time.h"           /* m0_time_t */
 
 #include "fop/fom.h"            /* m0_fom */
 #include "sm/sm.h"              /* m0_sm_ast */
@@ -40,6 +41,15 @@ struct m0_reqh;
  * @{
  */
 
+/** Stages of group recovery, timed and reported via addb2. */
+enum m0_be_tx_group_fom_recovery_stage {
+	M0_BE_TGRS_LOG_READ,
+	M0_BE_TGRS_RECONSTRUCT,
+	M0_BE_TGRS_REAPPLY,
+	M0_BE_TGRS_PLACE,
+	M0_BE_TGRS_NR,
+};
+
 struct m0_be_tx_group_fom {
 	/** generic fom */
 	struct m0_fom          tgf_gen;
@@ -62,6 +72,10 @@ struct m0_be_tx_group_fom {
 	struct m0_semaphore    tgf_start_sem;
 	struct m0_semaphore    tgf_finish_sem;
 	bool                   tgf_recovery_mode;
+	/** Start time of the current recovery stage. */
+	m0_time_t              tgf_recovery_start;
+	/** Durations of the recovery stages of the group. */
+	m0_time_t              tgf_recovery_time[M0_BE_TGRS_NR];
 };
 
 /** @todo XXX TODO s/gf/m/ in function parameters */
@@ -481,6 +481,12 @@ m0_be_group_format_recovery_prepare(struct m0_be_group_format *gft,
 	m0_be_log_record_io_prepare(record, SIO_READ, 0);
 }
 
+M0_INTERNAL m0_bindex_t
+m0_be_group_format_log_position(const struct m0_be_group_format *gft)
+{
+	return gft->gft_log_record.lgr_position;
+}
+
 M0_INTERNAL void m0_be_group_format_log_write(struct m0_be_group_format *gft,
 					      struct m0_be_op           *op)
 {
@@ -187,6 +187,9 @@ m0_be_group_format_log_use(struct m0_be_group_format *gft,
 M0_INTERNAL void
 m0_be_group_format_recovery_prepare(struct m0_be_group_format *gft,
 				    struct m0_be_log          *log);
+/** Log position of the log record of the group. */
+M0_INTERNAL m0_bindex_t
+m0_be_group_format_log_position(const struct m0_be_group_format *gft);
 
 M0_INTERNAL void m0_be_group_format_log_write(struct m0_be_group_format *gft,
 					      struct m0_be_op           *op);
@@ -196,19 +196,90 @@ static void be_reg_d_arr_first_subreg(struct m0_be_reg_d **rd_arr,
 	*size = arr[1] - arr[0];
 }
 
+/** Node of m0_be_reg_d tree. */
+struct m0_be_rdt_node {
+	struct m0_be_reg_d     rn_rd;
+	struct m0_be_rdt_node *rn_left;
+	struct m0_be_rdt_node *rn_right;
+	struct m0_be_rdt_node *rn_parent;
+	/** Treap priority, not less than priorities of the children. */
+	uint64_t               rn_prio;
+};
+
+static struct m0_be_rdt_node *be_rdt_node(const struct m0_be_reg_d *rd)
+{
+	return container_of(rd, struct m0_be_rdt_node, rn_rd);
+}
+
 static bool be_rdt_contains(const struct m0_be_reg_d_tree *rdt,
 			    const struct m0_be_reg_d      *rd)
 {
-	return &rdt->brt_r[0] <= rd && rd < &rdt->brt_r[rdt->brt_size];
+	const struct m0_be_rdt_node *node = be_rdt_node(rd);
+
+	return &rdt->brt_nodes[0] <= node &&
+	       node < &rdt->brt_nodes[rdt->brt_used];
+}
+
+static struct m0_be_rdt_node *be_rdt_min(struct m0_be_rdt_node *node)
+{
+	while (node != NULL && node->rn_left != NULL)
+		node = node->rn_left;
+	return node;
+}
+
+/** In-order successor. */
+static struct m0_be_rdt_node *be_rdt_succ(struct m0_be_rdt_node *node)
+{
+	if (node->rn_right != NULL)
+		return be_rdt_min(node->rn_right);
+	while (node->rn_parent != NULL && node->rn_parent->rn_right == node)
+		node = node->rn_parent;
+	return node->rn_parent;
+}
+
+static bool be_rdt_node_is_valid(const struct m0_be_rdt_node *node)
+{
+	const struct m0_be_rdt_node *l = node->rn_left;
+	const struct m0_be_rdt_node *r = node->rn_right;
+
+	return m0_be_reg_d__invariant(&node->rn_rd) &&
+	       _0C(ergo(l != NULL, l->rn_parent == node &&
+			l->rn_prio <= node->rn_prio)) &&
+	       _0C(ergo(r != NULL, r->rn_parent == node &&
+			r->rn_prio <= node->rn_prio));
+}
+
+/** Checks ordering, non-overlapping and linkage of all tree nodes. */
+static bool be_rdt_nodes_are_valid(const struct m0_be_reg_d_tree *rdt)
+{
+	struct m0_be_rdt_node *node;
+	struct m0_be_rdt_node *next;
+	size_t                 nr = 0;
+
+	for (node = be_rdt_min(rdt->brt_root); node != NULL; node = next) {
+		next = be_rdt_succ(node);
+		if (!be_rdt_node_is_valid(node) ||
+		    !_0C(ergo(next != NULL,
+			      node->rn_rd.rd_reg.br_addr <
+			      next->rn_rd.rd_reg.br_addr &&
+			      !be_reg_d_are_overlapping(&node->rn_rd,
+							&next->rn_rd))))
+			return false;
+		++nr;
+	}
+	return _0C(nr == rdt->brt_size);
 }
 
 #define ARRAY_ALLOC_NZ(arr, nr) ((arr) = m0_alloc_nz((nr) * sizeof ((arr)[0])))
 
 M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max)
 {
-	rdt->brt_size_max = size_max;
-	ARRAY_ALLOC_NZ(rdt->brt_r, rdt->brt_size_max);
-	if (rdt->brt_r == NULL)
+	*rdt = (struct m0_be_reg_d_tree){
+		.brt_size_max = size_max,
+		.brt_seed     = 1,
+	};
+	ARRAY_ALLOC_NZ(rdt->brt_nodes, rdt->brt_size_max);
+	if (rdt->brt_nodes == NULL)
 		return M0_ERR(-ENOMEM);
 
 	M0_POST(m0_be_rdt__invariant(rdt));
@@ -218,24 +289,19 @@ M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max)
 M0_INTERNAL void m0_be_rdt_fini(struct m0_be_reg_d_tree *rdt)
 {
 	M0_PRE(m0_be_rdt__invariant(rdt));
-	m0_free(rdt->brt_r);
+	m0_free(rdt->brt_nodes);
 }
 
 M0_INTERNAL bool m0_be_rdt__invariant(const struct m0_be_reg_d_tree *rdt)
 {
 	return _0C(rdt != NULL) &&
-	       _0C(rdt->brt_r != NULL || rdt->brt_size == 0) &&
-	       _0C(rdt->brt_size <= rdt->brt_size_max) &&
-	       M0_CHECK_EX(m0_forall(i, rdt->brt_size,
-				     m0_be_reg_d__invariant(&rdt->brt_r[i]))) &&
-	       M0_CHECK_EX(m0_forall(i,
-				     rdt->brt_size == 0 ? 0 : rdt->brt_size - 1,
-				     _0C(rdt->brt_r[i].rd_reg.br_addr <
-					 rdt->brt_r[i + 1].rd_reg.br_addr))) &&
-	       M0_CHECK_EX(m0_forall(i,
-				     rdt->brt_size == 0 ? 0 : rdt->brt_size - 1,
-		     _0C(!be_reg_d_are_overlapping(&rdt->brt_r[i],
-						   &rdt->brt_r[i + 1]))));
+	       _0C(rdt->brt_nodes != NULL || rdt->brt_size == 0) &&
+	       _0C(rdt->brt_size <= rdt->brt_used) &&
+	       _0C(rdt->brt_used <= rdt->brt_size_max) &&
+	       _0C(equi(rdt->brt_root == NULL, rdt->brt_size == 0)) &&
+	       _0C(ergo(rdt->brt_root != NULL,
+			rdt->brt_root->rn_parent == NULL)) &&
+	       M0_CHECK_EX(be_rdt_nodes_are_valid(rdt));
 }
 
 M0_INTERNAL size_t m0_be_rdt_size(const struct m0_be_reg_d_tree *rdt)
@@ -243,68 +309,81 @@ M0_INTERNAL size_t m0_be_rdt_size(const struct m0_be_reg_d_tree *rdt)
 	return rdt->brt_size;
 }
 
-/** Time complexity is O(1) */
-static bool be_rdt_check_i(const struct m0_be_reg_d_tree *rdt,
-			   void                          *addr,
-			   size_t                         index)
-{
-	struct m0_be_reg_d *r    = rdt->brt_r;
-	size_t              size = m0_be_rdt_size(rdt);
-
-	return  (size == 0 && index == 0) ||
-		(size != 0 &&
-		 ((index == size && !m0_be_reg_d_is_in(&r[size - 1], addr) &&
-		   addr > r[size - 1].rd_reg.br_addr) ||
-		  (index == 0 && (m0_be_reg_d_is_in(&r[0], addr) ||
-				  addr < r[0].rd_reg.br_addr)) ||
-		  (index < size && m0_be_reg_d_is_in(&r[index], addr)) ||
-		  (index < size && index > 0 &&
-		   !m0_be_reg_d_is_in(&r[index - 1], addr) &&
-		   addr < r[index].rd_reg.br_addr &&
-		   addr > r[index - 1].rd_reg.br_addr)));
-}
-
-/** Time complexity is O(log(m0_be_rdt_size(rdt) + 1)) */
-static size_t be_rdt_find_i(const struct m0_be_reg_d_tree *rdt, void *addr)
-{
-	size_t begin = 0;
-	size_t mid;
-	size_t end   = m0_be_rdt_size(rdt);
-	size_t res   = m0_be_rdt_size(rdt) + 1;
-	size_t size  = m0_be_rdt_size(rdt);
-
-	while (begin + 1 < end) {
-		mid = (begin + end) / 2;
-		M0_ASSERT_INFO(mid > begin && mid < end,
-			       "begin = %zu, mid = %zu, end = %zu",
-			       begin, mid, end);
-		if (rdt->brt_r[mid].rd_reg.br_addr < addr) {
-			begin = mid;
+/** Puts @new in place of @old in the parent of @old. */
+static void be_rdt_replace(struct m0_be_reg_d_tree *rdt,
+			   struct m0_be_rdt_node   *old,
+			   struct m0_be_rdt_node   *new)
+{
+	struct m0_be_rdt_node *parent = old->rn_parent;
+
+	if (parent == NULL)
+		rdt->brt_root = new;
+	else if (parent->rn_left == old)
+		parent->rn_left = new;
+	else
+		parent->rn_right = new;
+	if (new != NULL)
+		new->rn_parent = parent;
+}
+
+/** Makes the right child of @x the parent of @x, keeping in-order sequence. */
+static void be_rdt_rotate_left(struct m0_be_reg_d_tree *rdt,
+			       struct m0_be_rdt_node   *x)
+{
+	struct m0_be_rdt_node *y = x->rn_right;
+
+	be_rdt_replace(rdt, x, y);
+	x->rn_right = y->rn_left;
+	if (x->rn_right != NULL)
+		x->rn_right->rn_parent = x;
+	y->rn_left = x;
+	x->rn_parent = y;
+}
+
+/* Mirror image of be_rdt_rotate_left(). */
+static void be_rdt_rotate_right(struct m0_be_reg_d_tree *rdt,
+				struct m0_be_rdt_node   *x)
+{
+	struct m0_be_rdt_node *y = x->rn_left;
+
+	be_rdt_replace(rdt, x, y);
+	x->rn_left = y->rn_right;
+	if (x->rn_left != NULL)
+		x->rn_left->rn_parent = x;
+	y->rn_right = x;
+	x->rn_parent = y;
+}
+
+/** Time complexity is O(log(m0_be_rdt_size(rdt))) expected. */
+static struct m0_be_rdt_node *
+be_rdt_find_node(const struct m0_be_reg_d_tree *rdt, void *addr)
+{
+	struct m0_be_rdt_node *node = rdt->brt_root;
+	struct m0_be_rdt_node *le   = NULL;
+	struct m0_be_rdt_node *gt   = NULL;
+
+	while (node != NULL) {
+		if (be_reg_d_fb(&node->rn_rd) <= addr) {
+			le   = node;
+			node = node->rn_right;
 		} else {
-			end   = mid;
+			gt   = node;
+			node = node->rn_left;
 		}
 	}
-	res = be_rdt_check_i(rdt, addr, begin) ? begin : res;
-	res = be_rdt_check_i(rdt, addr, end)   ? end   : res;
-
-	M0_ASSERT_INFO(size == 0 || res <= size, "size = %zu, res = %zu",
-		       size, res);
-	M0_POST(m0_be_rdt__invariant(rdt));
-	M0_POST(be_rdt_check_i(rdt, addr, res));
-	return res;
+	return le != NULL && m0_be_reg_d_is_in(&le->rn_rd, addr) ? le : gt;
 }
 
-
 M0_INTERNAL struct m0_be_reg_d *
 m0_be_rdt_find(const struct m0_be_reg_d_tree *rdt, void *addr)
 {
-	struct m0_be_reg_d *rd;
-	size_t		    i;
+	struct m0_be_rdt_node *node;
+	struct m0_be_reg_d    *rd;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 
-	i = be_rdt_find_i(rdt, addr);
-	rd = i == rdt->brt_size ? NULL : &rdt->brt_r[i];
+	node = be_rdt_find_node(rdt, addr);
+	rd = node == NULL ? NULL : &node->rn_rd;
 
 	M0_POST(ergo(rd != NULL, be_rdt_contains(rdt, rd)));
 	return rd;
@@ -313,33 +392,71 @@ m0_be_rdt_find(const struct m0_be_reg_d_tree *rdt, void *addr)
 M0_INTERNAL struct m0_be_reg_d *
 m0_be_rdt_next(const struct m0_be_reg_d_tree *rdt, struct m0_be_reg_d *prev)
 {
-	struct m0_be_reg_d *rd;
+	struct m0_be_rdt_node *node;
+	struct m0_be_reg_d    *rd;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(prev != NULL);
 	M0_PRE(be_rdt_contains(rdt, prev));
 
-	rd = prev == &rdt->brt_r[rdt->brt_size - 1] ? NULL : ++prev;
+	node = be_rdt_succ(be_rdt_node(prev));
+	rd = node == NULL ? NULL : &node->rn_rd;
 
 	M0_POST(ergo(rd != NULL, be_rdt_contains(rdt, rd)));
 	return rd;
 }
 
+static struct m0_be_rdt_node *be_rdt_node_alloc(struct m0_be_reg_d_tree *rdt)
+{
+	struct m0_be_rdt_node *node = rdt->brt_free;
+
+	if (node != NULL) {
+		rdt->brt_free = node->rn_right;
+	} else {
+		M0_ASSERT(rdt->brt_used < rdt->brt_size_max);
+		node = &rdt->brt_nodes[rdt->brt_used++];
+	}
+	return node;
+}
+
+static void be_rdt_node_free(struct m0_be_reg_d_tree *rdt,
+			     struct m0_be_rdt_node   *node)
+{
+	node->rn_right = rdt->brt_free;
+	rdt->brt_free  = node;
+}
+
 M0_INTERNAL void m0_be_rdt_ins(struct m0_be_reg_d_tree  *rdt,
 			       const struct m0_be_reg_d *rd)
 {
-	size_t index;
-	size_t i;
+	struct m0_be_rdt_node **link = &rdt->brt_root;
+	struct m0_be_rdt_node  *parent = NULL;
+	struct m0_be_rdt_node  *node;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(m0_be_rdt_size(rdt) < rdt->brt_size_max);
 	M0_PRE(rd->rd_reg.br_size > 0);
 
-	index = be_rdt_find_i(rdt, be_reg_d_fb(rd));
+	while (*link != NULL) {
+		parent = *link;
+		link = be_reg_d_fb(rd) < be_reg_d_fb(&parent->rn_rd) ?
+			&parent->rn_left : &parent->rn_right;
+	}
+	node = be_rdt_node_alloc(rdt);
+	*node = (struct m0_be_rdt_node){
+		.rn_rd     = *rd,
+		.rn_parent = parent,
+		.rn_prio   = m0_rnd64(&rdt->brt_seed),
+	};
+	*link = node;
+	while (node->rn_parent != NULL &&
+	       node->rn_parent->rn_prio < node->rn_prio) {
+		if (node->rn_parent->rn_left == node)
+			be_rdt_rotate_right(rdt, node->rn_parent);
+		else
+			be_rdt_rotate_left(rdt, node->rn_parent);
+	}
 	++rdt->brt_size;
-	for (i = rdt->brt_size - 1; i > index; --i)
-		rdt->brt_r[i] = rdt->brt_r[i - 1];
-	rdt->brt_r[index] = *rd;
 
 	M0_POST(m0_be_rdt__invariant(rdt));
 }
@@ -347,21 +464,29 @@ M0_INTERNAL void m0_be_rdt_ins(struct m0_be_reg_d_tree  *rdt,
 M0_INTERNAL struct m0_be_reg_d *m0_be_rdt_del(struct m0_be_reg_d_tree  *rdt,
 					      const struct m0_be_reg_d *rd)
 {
-	size_t index;
-	size_t i;
+	struct m0_be_rdt_node *node;
+	struct m0_be_rdt_node *next;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(m0_be_rdt_size(rdt) > 0);
 
-	index = be_rdt_find_i(rdt, be_reg_d_fb(rd));
-	M0_ASSERT(m0_be_reg_eq(&rdt->brt_r[index].rd_reg, &rd->rd_reg));
-
-	for (i = index; i + 1 < rdt->brt_size; ++i)
-		rdt->brt_r[i] = rdt->brt_r[i + 1];
+	node = be_rdt_find_node(rdt, be_reg_d_fb(rd));
+	M0_ASSERT(node != NULL && m0_be_reg_eq(&node->rn_rd.rd_reg,
+					       &rd->rd_reg));
+	next = be_rdt_succ(node);
+	/* Rotate the node down until it has at most one child. */
+	while (node->rn_left != NULL && node->rn_right != NULL) {
+		if (node->rn_left->rn_prio > node->rn_right->rn_prio)
+			be_rdt_rotate_right(rdt, node);
+		else
+			be_rdt_rotate_left(rdt, node);
+	}
+	be_rdt_replace(rdt, node, node->rn_left ?: node->rn_right);
+	be_rdt_node_free(rdt, node);
 	--rdt->brt_size;
 
 	M0_POST(m0_be_rdt__invariant(rdt));
-	return index == m0_be_rdt_size(rdt) ? NULL : &rdt->brt_r[index];
+	return next == NULL ? NULL : &next->rn_rd;
 }
 
 M0_INTERNAL void m0_be_rdt_reset(struct m0_be_reg_d_tree *rdt)
@@ -369,6 +494,9 @@ M0_INTERNAL void m0_be_rdt_reset(struct m0_be_reg_d_tree *rdt)
 	M0_PRE(m0_be_rdt__invariant(rdt));
 
 	rdt->brt_size = 0;
+	rdt->brt_used = 0;
+	rdt->brt_free = NULL;
+	rdt->brt_root = NULL;
 
 	M0_POST(m0_be_rdt_size(rdt) == 0);
 	M0_POST(m0_be_rdt__invariant(rdt));
@@ -68,11 +68,21 @@ struct m0_be_reg_d {
 		{ .rd_reg = (reg), .rd_buf = (buf) }
 #define M0_BE_REG_D_CREDIT(rd) M0_BE_TX_CREDIT(1, (rd)->rd_reg.br_size)
 
+struct m0_be_rdt_node;
+
 /** Regions tree. */
 struct m0_be_reg_d_tree {
-	size_t              brt_size;
-	size_t              brt_size_max;
-	struct m0_be_reg_d *brt_r;
+	size_t                 brt_size;
+	size_t                 brt_size_max;
+	/** Preallocated tree nodes, brt_size_max of them. */
+	struct m0_be_rdt_node *brt_nodes;
+	/** Number of brt_nodes elements that have ever been used. */
+	size_t                 brt_used;
+	/** Freed nodes, linked through their right child pointers. */
+	struct m0_be_rdt_node *brt_free;
+	struct m0_be_rdt_node *brt_root;
+	/** State of the node priority generator. */
+	uint64_t               brt_seed;
 };
 
 struct m0_be_regmap_ops {
@@ -110,8 +120,13 @@ M0_INTERNAL bool m0_be_reg_d_is_in(const struct m0_be_reg_d *rd, void *ptr);
  *
  * Region is from the tree iff it is returned by m0_be_rdt_find(),
  * m0_be_rdt_next(), m0_be_rdt_del().
- * @note Current implementation is based on array, so technically it is not
- * a tree. Optimizations should be made to make it a real tree.
+ *
+ * The tree is a treap: a binary search tree ordered by region start address
+ * that is also a heap on random node priorities. m0_be_rdt_find(),
+ * m0_be_rdt_ins() and m0_be_rdt_del() take O(log(size)) expected time,
+ * m0_be_rdt_next() takes O(1) amortised time. A region stays at the same
+ * address while it is in the tree, so callers may modify m0_be_reg_d::rd_reg
+ * of a region from the tree as long as the order of regions is not changed.
  */
 M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max);
 /** Finalize m0_be_reg_d tree. Free all memory allocated */
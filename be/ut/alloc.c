@@ -36,6 +36,7 @@
 #include "be/ut/helper.h"       /* m0_be_ut_backend */
 #include "be/op.h"              /* m0_be_op */
 #include "be/alloc_internal.h"  /* be_alloc_chunk */
+#include "be/seg_internal.h"    /* m0_be_seg_hdr */
 
 enum {
 	BE_UT_ALLOC_SEG_SIZE = 0x40000,
@@ -236,6 +237,136 @@ M0_INTERNAL void m0_be_ut_alloc_info(void)
 	M0_SET0(&be_ut_alloc_backend);
 }
 
+enum {
+	BE_UT_ALLOC_MAG_PTR_NR = 0x40,
+};
+
+/* Returns number of chunks cached in magazines. */
+static uint64_t be_ut_alloc_mag_check(struct m0_be_allocator *a)
+{
+	uint64_t nr = 0;
+	int      i;
+
+	if (a->ba_mag == NULL)
+		return 0;
+	for (i = 0; i < M0_BE_ALLOC_MAG_NR; ++i) {
+		M0_UT_ASSERT(a->ba_mag[i].bam_nr <= M0_BE_ALLOC_MAG_CAP);
+		nr += a->ba_mag[i].bam_nr;
+	}
+	return nr;
+}
+
+/*
+ * Allocates and frees small objects of different sizes. Returns number of
+ * chunks cached in magazines after the last round.
+ */
+static uint64_t be_ut_alloc_mag_rounds(struct m0_be_ut_backend *ut_be,
+				       struct m0_be_allocator  *a)
+{
+	struct be_alloc_chunk *c;
+	m0_bcount_t            size;
+	m0_bcount_t            size_aligned;
+	void                  *ptrs[BE_UT_ALLOC_MAG_PTR_NR] = {};
+	int                    round;
+	int                    i;
+
+	for (round = 0; round < 2; ++round) {
+		for (i = 0; i < ARRAY_SIZE(ptrs); ++i) {
+			size = i * 7 % (M0_BE_ALLOC_MAG_CLASS_NR *
+					M0_BE_ALLOC_MAG_STEP) + 1;
+			M0_BE_UT_TRANSACT(ut_be, tx, cred,
+				m0_be_allocator_credit(a, M0_BAO_ALLOC, size,
+						       0, &cred),
+				M0_BE_OP_SYNC(op, m0_be_alloc(a, tx, &op,
+							      &ptrs[i], size)));
+			M0_UT_ASSERT(ptrs[i] != NULL);
+			M0_UT_ASSERT(m0_forall(j, size,
+					       ((char *)ptrs[i])[j] == 0));
+			/*
+			 * Magazines don't round the size up more than the
+			 * free lists do.
+			 */
+			c = container_of(ptrs[i], struct be_alloc_chunk,
+					 bac_mem);
+			size_aligned = m0_align(size,
+						1UL << M0_BE_ALLOC_SHIFT_MIN);
+			M0_UT_ASSERT(c->bac_size >= size_aligned);
+			M0_UT_ASSERT(c->bac_size <= size_aligned + sizeof *c);
+		}
+		M0_UT_ASSERT(be_ut_alloc_mag_check(a) <=
+			     M0_BE_ALLOC_MAG_NR * M0_BE_ALLOC_MAG_CAP);
+		for (i = 0; i < ARRAY_SIZE(ptrs); ++i) {
+			M0_BE_UT_TRANSACT(ut_be, tx, cred,
+				m0_be_allocator_credit(a, M0_BAO_FREE, 0, 0,
+						       &cred),
+				M0_BE_OP_SYNC(op, m0_be_free(a, tx, &op,
+							     ptrs[i])));
+		}
+	}
+	return be_ut_alloc_mag_check(a);
+}
+
+M0_INTERNAL void m0_be_ut_alloc_magazine(void)
+{
+	struct m0_be_ut_backend *ut_be = &be_ut_alloc_backend;
+	struct m0_be_allocator  *a;
+	struct m0_be_ut_seg      ut_seg;
+
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(&ut_seg, ut_be, BE_UT_ALLOC_SEG_SIZE);
+	m0_be_ut_seg_allocator_init(&ut_seg, ut_be);
+	a = m0_be_seg_allocator(ut_seg.bus_seg);
+	M0_UT_ASSERT(a->ba_mag != NULL);
+
+	/* freed chunks are cached until magazines are full */
+	M0_UT_ASSERT(be_ut_alloc_mag_rounds(ut_be, a) > 0);
+
+	/* m0_be_allocator_destroy() returns cached chunks to free lists */
+	m0_be_ut_seg_allocator_fini(&ut_seg, ut_be);
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	M0_SET0(ut_be);
+}
+
+static void be_ut_alloc_seg_hdr_version_set(struct m0_be_seg *seg,
+					    uint32_t          version)
+{
+	struct m0_be_seg_hdr *hdr = seg->bs_addr;
+	struct m0_format_tag  tag;
+
+	m0_format_header_unpack(&tag, &hdr->bh_header);
+	tag.ot_version = version;
+	m0_format_header_pack(&hdr->bh_header, &tag);
+}
+
+/*
+ * Segment with M0_BE_SEG_HDR_FORMAT_VERSION_1 header has no space for
+ * magazines. The allocator works without them.
+ */
+M0_INTERNAL void m0_be_ut_alloc_magazine_v1(void)
+{
+	struct m0_be_ut_backend *ut_be = &be_ut_alloc_backend;
+	struct m0_be_allocator  *a;
+	struct m0_be_ut_seg      ut_seg;
+
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(&ut_seg, ut_be, BE_UT_ALLOC_SEG_SIZE);
+	be_ut_alloc_seg_hdr_version_set(ut_seg.bus_seg,
+					M0_BE_SEG_HDR_FORMAT_VERSION_1);
+	m0_be_ut_seg_allocator_init(&ut_seg, ut_be);
+	a = m0_be_seg_allocator(ut_seg.bus_seg);
+	M0_UT_ASSERT(a->ba_mag == NULL);
+
+	M0_UT_ASSERT(be_ut_alloc_mag_rounds(ut_be, a) == 0);
+
+	m0_be_ut_seg_allocator_fini(&ut_seg, ut_be);
+	be_ut_alloc_seg_hdr_version_set(ut_seg.bus_seg,
+					M0_BE_SEG_HDR_FORMAT_VERSION);
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	M0_SET0(ut_be);
+}
+
 /* segment and memory allocation sizes to test */
 enum {
 	BE_UT_OOM_SEG_START     = 0x1900,
@@ -25,12 +25,15 @@
 
 #include "be/tx_group_fom.h"
 #include "be/btree.h"
+#include "be/btree_internal.h" /* m0_be_bnode */
 #include "lib/types.h"     /* m0_uint128_eq */
 #include "lib/misc.h"      /* M0_BITS, M0_IN */
 #include "lib/memory.h"    /* M0_ALLOC_PTR */
 #include "lib/errno.h"     /* ENOENT */
+#include "lib/time.h"      /* m0_time_now */
 #include "be/ut/helper.h"
 #include "ut/ut.h"
+#include "ut/threads.h"    /* M0_UT_THREADS_DEFINE */
 #ifndef __KERNEL__
 #include <stdio.h>	   /* sscanf */
 #endif
@@ -51,11 +54,23 @@ static m0_bcount_t tree_kv_size(const void *kv)
 	return kv != NULL ? strlen(kv) + 1 : 0;
 }
 
+static uint64_t tree_prefix(const void *key)
+{
+	const unsigned char *s      = key;
+	uint64_t             prefix = 0;
+	int                  i;
+
+	for (i = 0; i < sizeof prefix; ++i)
+		prefix = (prefix << 8) | (*s != 0 ? *s++ : 0);
+	return prefix;
+}
+
 static const struct m0_be_btree_kv_ops kv_ops = {
 	.ko_type    = M0_BBT_UT_KV_OPS,
 	.ko_ksize   = tree_kv_size,
 	.ko_vsize   = tree_kv_size,
-	.ko_compare = tree_cmp
+	.ko_compare = tree_cmp,
+	.ko_prefix  = tree_prefix
 };
 
 enum {
@@ -65,12 +80,29 @@ enum {
 	TXN_OPS_NR = 7,
 };
 
+enum {
+	MT_THREADS_MAX = 8,
+	MT_KEYS_NR     = BTREE_FAN_OUT * 16,
+	/* "RRTTNNNNNN": round, thread and key number. */
+	MT_KSIZE       = 11,
+	MT_TXN_OPS_NR  = 16,
+};
+
+struct btree_mt_ctx {
+	struct m0_be_btree *bmc_tree;
+	int                 bmc_round;
+	int                 bmc_index;
+};
+
 static void check(struct m0_be_btree *tree);
 
 static struct m0_be_btree *create_tree(void);
 
 static void destroy_tree(struct m0_be_btree *tree);
 static void truncate_tree(struct m0_be_btree *tree);
+static int btree_save(struct m0_be_btree *tree, struct m0_buf *k,
+		      struct m0_buf *v, bool overwrite);
+static int btree_delete(struct m0_be_btree *t, struct m0_buf *k, int nr_left);
 
 
 void m0_be_ut_btree_create_truncate(void)
@@ -138,6 +170,316 @@ void m0_be_ut_btree_create_destroy(void)
 	M0_LEAVE();
 }
 
+static void btree_mt_key(char *buf, int round, int index, int i)
+{
+	sprintf(buf, "%02d%02d%0*d", round, index, MT_KSIZE - 5, i);
+}
+
+/**
+ * Inserts MT_KEYS_NR keys private to the thread and looks them up.
+ *
+ * Threads of the same round insert into adjacent key ranges of the same tree,
+ * the way foms of different localities update a shared catalogue.
+ */
+static void btree_mt_thread(struct btree_mt_ctx *ctx)
+{
+	struct m0_be_btree     *tree = ctx->bmc_tree;
+	struct m0_be_tx_credit  cred = {};
+	struct m0_be_tx        *tx;
+	struct m0_buf           key;
+	struct m0_buf           val;
+	char                    k[MT_KSIZE];
+	char                    v[MT_KSIZE];
+	int                     rc;
+	int                     i;
+
+	M0_ALLOC_PTR(tx);
+	M0_UT_ASSERT(tx != NULL);
+	m0_be_btree_insert_credit2(tree, MT_TXN_OPS_NR, MT_KSIZE, MT_KSIZE,
+				   &cred);
+	m0_buf_init(&key, k, sizeof k);
+	m0_buf_init(&val, k, sizeof k);
+	for (i = 0; i < MT_KEYS_NR; ++i) {
+		if (i % MT_TXN_OPS_NR == 0) {
+			M0_SET0(tx);
+			m0_be_ut_tx_init(tx, ut_be);
+			m0_be_tx_prep(tx, &cred);
+			rc = m0_be_tx_open_sync(tx);
+			M0_UT_ASSERT(rc == 0);
+		}
+		btree_mt_key(k, ctx->bmc_round, ctx->bmc_index, i);
+		rc = M0_BE_OP_SYNC_RET(op,
+				       m0_be_btree_insert(tree, tx, &op,
+							  &key, &val),
+				       bo_u.u_btree.t_rc);
+		M0_UT_ASSERT(rc == 0);
+		if ((i + 1) % MT_TXN_OPS_NR == 0 || i == MT_KEYS_NR - 1) {
+			m0_be_tx_close_sync(tx);
+			m0_be_tx_fini(tx);
+		}
+	}
+	m0_free(tx);
+
+	m0_buf_init(&val, v, sizeof v);
+	for (i = 0; i < MT_KEYS_NR; ++i) {
+		btree_mt_key(k, ctx->bmc_round, ctx->bmc_index, i);
+		rc = M0_BE_OP_SYNC_RET(op,
+				       m0_be_btree_lookup(tree, &op,
+							  &key, &val),
+				       bo_u.u_btree.t_rc);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(strcmp(k, v) == 0);
+	}
+	m0_be_ut_backend_thread_exit(ut_be);
+}
+
+M0_UT_THREADS_DEFINE(be_ut_btree_mt, &btree_mt_thread);
+
+static struct m0_be_btree *btree_mt_create(void)
+{
+	struct m0_be_tx_credit  cred = {};
+	struct m0_be_btree     *tree;
+	struct m0_be_tx        *tx;
+	int                     rc;
+
+	{
+		struct m0_be_btree t = { .bb_seg = seg };
+		m0_be_btree_create_credit(&t, 1, &cred);
+	}
+	M0_BE_ALLOC_CREDIT_PTR(tree, seg, &cred);
+
+	M0_ALLOC_PTR(tx);
+	M0_UT_ASSERT(tx != NULL);
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_UT_ASSERT(rc == 0);
+
+	M0_BE_ALLOC_PTR_SYNC(tree, seg, tx);
+	m0_be_btree_init(tree, seg, &kv_ops);
+	M0_BE_OP_SYNC(op, m0_be_btree_create(tree, tx, &op,
+					     &M0_FID_TINIT('b', 0, 2)));
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	m0_free(tx);
+	return tree;
+}
+
+/**
+ * Runs btree_mt_thread() in 1, 2, ... MT_THREADS_MAX threads and logs the
+ * throughput of every round. Insertions into non-full leaves and lookups do
+ * not exclude each other, so the throughput is expected to grow with the
+ * number of threads until the tree lock is taken for node splits.
+ */
+void m0_be_ut_btree_concurrent(void)
+{
+	struct btree_mt_ctx        ctx[MT_THREADS_MAX];
+	struct m0_be_btree_cursor *cursor;
+	struct m0_be_btree        *tree;
+	m0_time_t                  start;
+	m0_time_t                  elapsed;
+	int                        total = 0;
+	int                        round;
+	int                        nr;
+	int                        rc;
+	int                        i;
+
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 26);
+	seg = ut_seg->bus_seg;
+
+	tree = btree_mt_create();
+	for (nr = 1, round = 0; nr <= MT_THREADS_MAX; nr *= 2, ++round) {
+		for (i = 0; i < nr; ++i) {
+			ctx[i] = (struct btree_mt_ctx) {
+				.bmc_tree  = tree,
+				.bmc_round = round,
+				.bmc_index = i,
+			};
+		}
+		start = m0_time_now();
+		M0_UT_THREADS_START(be_ut_btree_mt, nr, ctx);
+		M0_UT_THREADS_STOP(be_ut_btree_mt);
+		elapsed = m0_time_sub(m0_time_now(), start);
+		total += nr * MT_KEYS_NR;
+		M0_LOG(M0_INFO, "threads=%d ops=%d time=%"PRIu64" ms "
+		       "ops/s=%"PRIu64, nr, 2 * nr * MT_KEYS_NR,
+		       elapsed / M0_TIME_ONE_MSEC,
+		       2 * nr * MT_KEYS_NR * M0_TIME_ONE_SECOND /
+		       max64u(elapsed, 1));
+	}
+
+	/* the structure is too large for kernel stack to be local */
+	M0_ALLOC_PTR(cursor);
+	M0_UT_ASSERT(cursor != NULL);
+	m0_be_btree_cursor_init(cursor, tree);
+	for (i = 0, rc = m0_be_btree_cursor_first_sync(cursor); rc == 0;
+	     ++i, rc = m0_be_btree_cursor_next_sync(cursor))
+		;
+	M0_UT_ASSERT(rc == -ENOENT);
+	M0_UT_ASSERT(i == total);
+	m0_be_btree_cursor_fini(cursor);
+	m0_free(cursor);
+
+	m0_be_btree_fini(tree);
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+enum {
+	V1_KEYS_NR = BTREE_FAN_OUT * 4,
+	/* "NNNNNN" */
+	V1_KSIZE   = INSERT_KSIZE,
+};
+
+static uint32_t btree_node_version(const struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &node->bt_header);
+	return tag.ot_version;
+}
+
+/**
+ * Rewrites @node and its subtree in M0_BE_BNODE_FORMAT_VERSION_1 layout, the
+ * way the nodes of a tree created by the old code look: the footer follows
+ * bt_child_arr[] and there are no key prefixes. The area which used to hold
+ * the prefixes is poisoned, so that reading it shows up as a wrong search.
+ */
+static void btree_node_v1_make(struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+	unsigned int         i;
+
+	if (!node->bt_isleaf) {
+		for (i = 0; i <= node->bt_num_active_key; ++i)
+			btree_node_v1_make(node->bt_child_arr[i]);
+	}
+	M0_UT_ASSERT(btree_node_version(node) == M0_BE_BNODE_FORMAT_VERSION);
+	memset(node->bt_kprefix_arr, 0xff, sizeof node->bt_kprefix_arr);
+	m0_format_header_unpack(&tag, &node->bt_header);
+	tag.ot_version = M0_BE_BNODE_FORMAT_VERSION_1;
+	tag.ot_footer_offset = offsetof(struct m0_be_bnode, bt_kprefix_arr);
+	m0_format_header_pack(&node->bt_header, &tag);
+	m0_format_footer_update(node);
+}
+
+static void btree_v1_key(char *buf, int i)
+{
+	sprintf(buf, "%0*d", V1_KSIZE - 1, i);
+}
+
+/** Checks that every i-th key, i % @step == @rem, is in @tree (or not). */
+static void btree_v1_check(struct m0_be_btree *tree, int step, int rem,
+			   bool present)
+{
+	struct m0_buf key;
+	struct m0_buf val;
+	char          k[V1_KSIZE];
+	char          v[V1_KSIZE];
+	int           rc;
+	int           i;
+
+	m0_buf_init(&key, k, sizeof k);
+	m0_buf_init(&val, v, sizeof v);
+	for (i = rem; i < V1_KEYS_NR; i += step) {
+		btree_v1_key(k, i);
+		memset(v, 0, sizeof v);
+		rc = M0_BE_OP_SYNC_RET(op,
+				       m0_be_btree_lookup(tree, &op,
+							  &key, &val),
+				       bo_u.u_btree.t_rc);
+		if (present) {
+			M0_UT_ASSERT(rc == 0);
+			M0_UT_ASSERT(strcmp(k, v) == 0);
+		} else
+			M0_UT_ASSERT(rc == -ENOENT);
+	}
+}
+
+/**
+ * Trees with nodes of M0_BE_BNODE_FORMAT_VERSION_1 are read and updated in
+ * place. New nodes get the current format, so after the updates the tree has
+ * nodes of both versions.
+ */
+void m0_be_ut_btree_format_v1(void)
+{
+	struct m0_be_btree_cursor *cursor;
+	struct m0_be_btree        *tree;
+	struct m0_be_bnode        *root;
+	struct m0_buf              key;
+	char                       k[V1_KSIZE];
+	int                        rc;
+	int                        i;
+
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 24);
+	seg = ut_seg->bus_seg;
+
+	tree = btree_mt_create();
+	m0_buf_init(&key, k, sizeof k);
+	for (i = 0; i < V1_KEYS_NR; i += 2) {
+		btree_v1_key(k, i);
+		rc = btree_save(tree, &key, &key, false);
+		M0_UT_ASSERT(rc == 0);
+	}
+	M0_UT_ASSERT(!tree->bb_root->bt_isleaf);
+	btree_node_v1_make(tree->bb_root);
+
+	btree_v1_check(tree, 2, 0, true);
+	btree_v1_check(tree, 2, 1, false);
+
+	/* Inserts split version 1 leaves. */
+	for (i = 1; i < V1_KEYS_NR; i += 2) {
+		btree_v1_key(k, i);
+		rc = btree_save(tree, &key, &key, false);
+		M0_UT_ASSERT(rc == 0);
+	}
+	btree_v1_check(tree, 1, 0, true);
+	root = tree->bb_root;
+	M0_UT_ASSERT(btree_node_version(root) == M0_BE_BNODE_FORMAT_VERSION_1);
+	M0_UT_ASSERT(m0_exists(j, root->bt_num_active_key + 1,
+			       btree_node_version(root->bt_child_arr[j]) ==
+			       M0_BE_BNODE_FORMAT_VERSION));
+
+	/* Deletes merge and rebalance nodes of different versions. */
+	for (i = 0; i < V1_KEYS_NR; i += 3) {
+		btree_v1_key(k, i);
+		rc = btree_delete(tree, &key, i + 3 < V1_KEYS_NR);
+		M0_UT_ASSERT(rc == 0);
+	}
+	btree_v1_check(tree, 3, 0, false);
+	btree_v1_check(tree, 3, 1, true);
+	btree_v1_check(tree, 3, 2, true);
+
+	M0_ALLOC_PTR(cursor);
+	M0_UT_ASSERT(cursor != NULL);
+	m0_be_btree_cursor_init(cursor, tree);
+	for (i = 0, rc = m0_be_btree_cursor_first_sync(cursor); rc == 0;
+	     ++i, rc = m0_be_btree_cursor_next_sync(cursor))
+		;
+	M0_UT_ASSERT(rc == -ENOENT);
+	M0_UT_ASSERT(i == V1_KEYS_NR - (V1_KEYS_NR + 2) / 3);
+	m0_be_btree_cursor_fini(cursor);
+	m0_free(cursor);
+
+	m0_be_btree_fini(tree);
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
 static int
 btree_insert(struct m0_be_btree *t, struct m0_buf *k, struct m0_buf *v,
 	     int nr_left)
@@ -140,10 +140,14 @@ extern void m0_be_ut_alloc_concurrent(void);
 extern void m0_be_ut_alloc_oom(void);
 extern void m0_be_ut_alloc_info(void);
 extern void m0_be_ut_alloc_spare(void);
+extern void m0_be_ut_alloc_magazine(void);
+extern void m0_be_ut_alloc_magazine_v1(void);
 
 extern void m0_be_ut_list(void);
 extern void m0_be_ut_btree_create_destroy(void);
 extern void m0_be_ut_btree_create_truncate(void);
+extern void m0_be_ut_btree_concurrent(void);
+extern void m0_be_ut_btree_format_v1(void);
 extern void m0_be_ut_emap(void);
 extern void m0_be_ut_seg_dict(void);
 extern void m0_be_ut_seg0_test(void);
@@ -260,12 +264,16 @@ struct m0_ut_suite be_ut = {
 		{ "alloc-oom",               m0_be_ut_alloc_oom               },
 		{ "alloc-info",              m0_be_ut_alloc_info              },
 		{ "alloc-spare",             m0_be_ut_alloc_spare             },
+		{ "alloc-magazine",          m0_be_ut_alloc_magazine          },
+		{ "alloc-magazine-v1",       m0_be_ut_alloc_magazine_v1       },
 		{ "obj",                     m0_be_ut_obj_test                },
 		{ "actrec",                  m0_be_ut_actrec_test             },
 #endif /* __KERNEL__ */
 		{ "list",                    m0_be_ut_list                    },
 		{ "btree-create_destroy",    m0_be_ut_btree_create_destroy    },
 		{ "btree-create_truncate",   m0_be_ut_btree_create_truncate   },
+		{ "btree-concurrent",        m0_be_ut_btree_concurrent        },
+		{ "btree-format-v1",         m0_be_ut_btree_format_v1         },
 		{ "seg_dict",                m0_be_ut_seg_dict                },
 #ifndef __KERNEL__
 		{ "seg0",                    m0_be_ut_seg0_test               },
@@ -47,6 +47,7 @@ struct be_ut_recovery_ctx {
 	struct m0_mutex          burc_lock;
 	struct m0_stob_domain   *burc_sdom;
 	struct m0_be_log_record *burc_records;
+	m0_bcount_t              burc_prefetch_size;
 };
 
 static void be_ut_log_got_space_cb(struct m0_be_log *log)
@@ -55,7 +56,8 @@ static void be_ut_log_got_space_cb(struct m0_be_log *log)
 
 static void be_ut_recovery_log_cfg_set(struct m0_be_log_cfg  *log_cfg,
 				       struct m0_stob_domain *sdom,
-				       struct m0_mutex       *lock)
+				       struct m0_mutex       *lock,
+				       m0_bcount_t            prefetch_size)
 {
 	*log_cfg = (struct m0_be_log_cfg){
 		.lc_store_cfg = {
@@ -69,6 +71,9 @@ static void be_ut_recovery_log_cfg_set(struct m0_be_log_cfg  *log_cfg,
 			.lsc_stob_create_cfg = NULL,
 			.lsc_rbuf_nr         = BE_UT_RECOVERY_LOG_RBUF_NR,
 		},
+		.lc_recovery_cfg = {
+			.brc_prefetch_size = prefetch_size,
+		},
 		.lc_got_space_cb = &be_ut_log_got_space_cb,
 		.lc_lock         = lock,
 	};
@@ -89,7 +94,8 @@ static void be_ut_recovery_log_init(struct be_ut_recovery_ctx *ctx)
 				   be_ut_recovery_log_sdom_create_cfg,
 				   &ctx->burc_sdom);
 	M0_UT_ASSERT(rc == 0);
-	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock);
+	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock,
+				   ctx->burc_prefetch_size);
 	rc = m0_be_log_create(&ctx->burc_log, &log_cfg);
 	M0_UT_ASSERT(rc == 0);
 }
@@ -109,7 +115,8 @@ static void be_ut_recovery_log_open(struct be_ut_recovery_ctx *ctx)
 	struct m0_be_log_cfg log_cfg;
 	int                  rc;
 
-	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock);
+	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock,
+				   ctx->burc_prefetch_size);
 	rc = m0_be_log_open(&ctx->burc_log, &log_cfg);
 	M0_UT_ASSERT(rc == 0);
 }
@@ -227,9 +234,9 @@ static int be_ut_recovery_iter_count(struct be_ut_recovery_ctx *ctx)
 	return count;
 }
 
-void m0_be_ut_recovery(void)
+static void be_ut_recovery_with(m0_bcount_t prefetch_size)
 {
-	struct be_ut_recovery_ctx ctx = {};
+	struct be_ut_recovery_ctx ctx = { .burc_prefetch_size = prefetch_size };
 	int                       count;
 	int                       nr;
 
@@ -252,6 +259,9 @@ void m0_be_ut_recovery(void)
 	nr = BE_UT_RECOVERY_LOG_SIZE / BE_UT_RECOVERY_LOG_RESERVE_SIZE * 2;
 	be_ut_recovery_log_fill(&ctx, nr, nr - 5, false);
 	be_ut_recovery_log_reopen(&ctx);
+	/* the window holds several records, so log scanning hits it */
+	M0_UT_ASSERT(ergo(prefetch_size != 1,
+			  ctx.burc_log.lg_prefetch.lp_hit_nr > 0));
 	count = be_ut_recovery_iter_count(&ctx);
 	M0_UT_ASSERT(count == 5);
 
@@ -262,6 +272,16 @@ void m0_be_ut_recovery(void)
 	be_ut_recovery_log_fini(&ctx);
 }
 
+void m0_be_ut_recovery(void)
+{
+	/* default read-ahead window */
+	be_ut_recovery_with(0);
+	/* window of a single block */
+	be_ut_recovery_with(1);
+	/* window smaller than the log, refilled in both directions */
+	be_ut_recovery_with(BE_UT_RECOVERY_LOG_RESERVE_SIZE * 4);
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -28,6 +28,9 @@
 #include "lib/arith.h"          /* m0_rnd64 */
 #include "lib/misc.h"           /* M0_SET0 */
 #include "lib/string.h"         /* memcpy */
+#include "lib/memory.h"         /* M0_ALLOC_ARR */
+#include "lib/errno.h"          /* ENOMEM */
+#include "lib/ub.h"             /* m0_ub_set */
 
 #include "be/ut/helper.h"	/* m0_be_ut_seg */
 
@@ -1039,6 +1042,132 @@ void m0_be_ut_reg_area_merge(void)
 	m0_be_ut_seg_fini(&ut_seg);
 }
 
+/* ----------------------------------------------------------------
+ * Micro-benchmarks
+ * ---------------------------------------------------------------- */
+
+enum {
+	/* Number of regions captured by each benchmark. */
+	UB_ITER       = 100000,
+	UB_REG_SIZE   = 8,
+	/* Leave a gap between regions so that they are never merged. */
+	UB_REG_STRIDE = UB_REG_SIZE * 2,
+};
+
+static struct m0_be_reg_area  ub_reg_area;
+static char                  *ub_buf;
+static uint32_t              *ub_order;
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	uint64_t seed = 0;
+	uint32_t tmp;
+	uint32_t j;
+	uint32_t i;
+	int      rc;
+
+	M0_ALLOC_ARR(ub_buf, UB_ITER * UB_REG_STRIDE);
+	M0_ALLOC_ARR(ub_order, UB_ITER);
+	if (ub_buf == NULL || ub_order == NULL) {
+		rc = -ENOMEM;
+		goto err;
+	}
+	for (i = 0; i < UB_ITER; ++i)
+		ub_order[i] = i;
+	for (i = UB_ITER - 1; i > 0; --i) {
+		j = m0_rnd64(&seed) % (i + 1);
+		tmp = ub_order[i];
+		ub_order[i] = ub_order[j];
+		ub_order[j] = tmp;
+	}
+	rc = m0_be_reg_area_init(&ub_reg_area,
+				 &M0_BE_TX_CREDIT(UB_ITER,
+						  UB_ITER * UB_REG_SIZE),
+				 M0_BE_REG_AREA_DATA_COPY);
+	if (rc == 0)
+		return 0;
+err:
+	m0_free(ub_order);
+	m0_free(ub_buf);
+	return rc;
+}
+
+static void ub_fini(void)
+{
+	m0_be_reg_area_fini(&ub_reg_area);
+	m0_free(ub_order);
+	m0_free(ub_buf);
+}
+
+static void ub_reset(void)
+{
+	m0_be_reg_area_reset(&ub_reg_area);
+}
+
+static struct m0_be_reg_d ub_reg_d(uint32_t i)
+{
+	return (struct m0_be_reg_d) {
+		.rd_reg = M0_BE_REG(NULL, UB_REG_SIZE,
+				    ub_buf + i * UB_REG_STRIDE),
+	};
+}
+
+static void ub_capture_seq(int i)
+{
+	struct m0_be_reg_d rd = ub_reg_d(i);
+
+	m0_be_reg_area_capture(&ub_reg_area, &rd);
+}
+
+static void ub_capture_rand(int i)
+{
+	struct m0_be_reg_d rd = ub_reg_d(ub_order[i]);
+
+	m0_be_reg_area_capture(&ub_reg_area, &rd);
+}
+
+static void ub_find(int i)
+{
+	struct m0_be_reg_d rd = ub_reg_d(ub_order[i]);
+
+	M0_ASSERT(m0_be_rdt_find(&ub_reg_area.bra_map.br_rdt,
+				 rd.rd_reg.br_addr) != NULL);
+}
+
+static void ub_uncapture_rand(int i)
+{
+	struct m0_be_reg_d rd = ub_reg_d(ub_order[i]);
+
+	m0_be_reg_area_uncapture(&ub_reg_area, &rd);
+}
+
+struct m0_ub_set m0_be_regmap_ub = {
+	.us_name = "be-regmap-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "capture-seq",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_reset,
+		  .ub_round = ub_capture_seq },
+
+		{ .ub_name  = "capture-rand",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_reset,
+		  .ub_round = ub_capture_rand },
+
+		{ .ub_name  = "find",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_find },
+
+		{ .ub_name  = "uncapture-rand",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_uncapture_rand },
+
+		{ .ub_name = NULL }
+	}
+};
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
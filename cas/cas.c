@@ -63,7 +63,8 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 			 .xt        = m0_cas_op_xc,
 			 .fom_ops   = fom_ops,
 			 .sm        = sm_conf,
-			 .svc_type  = svctype);
+			 .svc_type  = svctype,
+			 .fom_class = M0_FSC_INTERACTIVE);
 	M0_FOP_TYPE_INIT(&cas_put_fopt,
 			 .name      = "cas-put",
 			 .opcode    = M0_CAS_PUT_FOP_OPCODE,
@@ -89,7 +90,8 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 			 .xt        = m0_cas_op_xc,
 			 .fom_ops   = fom_ops,
 			 .sm        = sm_conf,
-			 .svc_type  = svctype);
+			 .svc_type  = svctype,
+			 .fom_class = M0_FSC_INTERACTIVE);
 	M0_FOP_TYPE_INIT(&cas_rep_fopt,
 			 .name      = "cas-rep",
 			 .opcode    = M0_CAS_REP_FOP_OPCODE,
@@ -175,14 +177,21 @@ M0_INTERNAL int m0_cas_module_init(void)
 	struct m0_sm_conf            *sm_conf;
 	const struct m0_fom_type_ops *fom_ops;
 	struct m0_reqh_service_type  *svctype;
+	int                           rc;
 
 	m0_fid_type_register(&m0_cas_index_fid_type);
 	m0_fid_type_register(&m0_cctg_fid_type);
 	m0_fid_type_register(&m0_dix_fid_type);
-	m0_cas_svc_init();
 	m0_cas_svc_fop_args(&sm_conf, &fom_ops, &svctype);
-	return cas_fops_init(sm_conf, fom_ops, svctype) ?:
-		m0_cas_sm_conf_init();
+	rc = m0_cas_svc_init();
+	if (rc != 0)
+		return M0_ERR(rc);
+	rc = cas_fops_init(sm_conf, fom_ops, svctype);
+	if (rc != 0) {
+		m0_cas_svc_fini();
+		return M0_ERR(rc);
+	}
+	return m0_cas_sm_conf_init();
 }
 
 M0_INTERNAL void m0_cas_module_fini(void)
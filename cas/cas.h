@@ -359,7 +359,7 @@ extern    struct m0_fop_type m0_fop_fsync_cas_fopt;
  * service-specific fields in CAS FOP types.
  */
 #ifndef __KERNEL__
-M0_INTERNAL void m0_cas_svc_init(void);
+M0_INTERNAL int  m0_cas_svc_init(void);
 M0_INTERNAL void m0_cas_svc_fini(void);
 M0_INTERNAL void m0_cas_svc_fop_args(struct m0_sm_conf            **sm_conf,
 				     const struct m0_fom_type_ops **fom_ops,
@@ -369,7 +369,7 @@ M0_INTERNAL void m0_cas__ut_svc_be_set(struct m0_reqh_service *svc,
 M0_INTERNAL struct m0_be_domain *
 m0_cas__ut_svc_be_get(struct m0_reqh_service *svc);
 #else
-#define m0_cas_svc_init()
+#define m0_cas_svc_init() (0)
 #define m0_cas_svc_fini()
 #define m0_cas_svc_fop_args(sm_conf, fom_ops, svctype) \
 do {                                                   \
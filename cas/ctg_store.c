@@ -28,6 +28,7 @@
 #include "lib/assert.h"
 #include "lib/errno.h"               /* ENOMEM, EPROTO */
 #include "lib/ext.h"                 /* m0_ext */
+#include "lib/byteorder.h"           /* m0_byteorder_be64_to_cpu */
 #include "be/domain.h"               /* m0_be_domain_seg_first */
 #include "be/op.h"
 #include "module/instance.h"
@@ -125,6 +126,7 @@ static void ctg_store_release(struct m0_ref *ref);
 static m0_bcount_t ctg_ksize (const void *key);
 static m0_bcount_t ctg_vsize (const void *val);
 static int         ctg_cmp   (const void *key0, const void *key1);
+static uint64_t    ctg_prefix(const void *key);
 
 
 /**
@@ -238,6 +240,20 @@ static int ctg_cmp(const void *key0, const void *key1)
 		M0_3WAY(knob0, knob1);
 }
 
+/**
+ * First (up to) 8 bytes of the key, zero-padded, as a big-endian number.
+ * Monotonic with respect to ctg_cmp().
+ */
+static uint64_t ctg_prefix(const void *key)
+{
+	m0_bcount_t knob   = ctg_ksize(key);
+	uint64_t    prefix = 0;
+
+	M0_ASSERT(knob >= 8);
+	memcpy(&prefix, key + 8, min_check(knob - 8, (m0_bcount_t)8));
+	return m0_byteorder_be64_to_cpu(prefix);
+}
+
 static void ctg_init(struct m0_cas_ctg *ctg, struct m0_be_seg *seg)
 {
 	m0_format_header_pack(&ctg->cc_head, &(struct m0_format_tag){
@@ -1850,7 +1866,8 @@ static const struct m0_be_btree_kv_ops cas_btree_ops = {
 	.ko_type    = M0_BBT_CAS_CTG,
 	.ko_ksize   = &ctg_ksize,
 	.ko_vsize   = &ctg_vsize,
-	.ko_compare = &ctg_cmp
+	.ko_compare = &ctg_cmp,
+	.ko_prefix  = &ctg_prefix
 };
 
 #undef M0_TRACE_SUBSYSTEM
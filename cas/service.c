@@ -30,6 +30,7 @@
 #include "lib/misc.h"                /* M0_IN */
 #include "lib/errno.h"               /* ENOMEM, EPROTO */
 #include "lib/ext.h"
+#include "lib/objpool.h"
 #include "fop/fom_long_lock.h"
 #include "fop/fom_generic.h"
 #include "fop/fom_interpose.h"
@@ -503,8 +504,22 @@ static const struct m0_fom_type_ops          cas_fom_type_ops;
 static       struct m0_sm_conf               cas_sm_conf;
 static       struct m0_sm_state_descr        cas_fom_phases[];
 
-M0_INTERNAL void m0_cas_svc_init(void)
+enum {
+	/** Maximal number of free cas foms cached per locality. */
+	CAS_FOM_POOL_CAP = 256
+};
+
+/** Pool of cas foms, every CAS request allocates one. */
+static struct m0_objpool cas_fom_pool;
+
+M0_INTERNAL int m0_cas_svc_init(void)
 {
+	int rc;
+
+	rc = M0_OBJPOOL_INIT(&cas_fom_pool, struct cas_fom, "cas-fom",
+			     CAS_FOM_POOL_CAP, NULL, NULL);
+	if (rc != 0)
+		return M0_ERR(rc);
 	m0_sm_conf_extend(m0_generic_conf.scf_state, cas_fom_phases,
 			  m0_generic_conf.scf_nr_states);
 	m0_sm_conf_trans_extend(&m0_generic_conf, &cas_sm_conf);
@@ -515,6 +530,7 @@ M0_INTERNAL void m0_cas_svc_init(void)
 	m0_sm_conf_init(&cas_sm_conf);
 	m0_reqh_service_type_register(&m0_cas_service_type);
 	m0_cas_gc_init();
+	return 0;
 }
 
 M0_INTERNAL void m0_cas_svc_fini(void)
@@ -522,6 +538,7 @@ M0_INTERNAL void m0_cas_svc_fini(void)
 	m0_cas_gc_fini();
 	m0_reqh_service_type_unregister(&m0_cas_service_type);
 	m0_sm_conf_fini(&cas_sm_conf);
+	m0_objpool_fini(&cas_fom_pool);
 }
 
 M0_INTERNAL void m0_cas_svc_fop_args(struct m0_sm_conf            **sm_conf,
@@ -637,7 +654,7 @@ static int cas_fom_create(struct m0_fop *fop,
 	if (!cas_service_started(fop, reqh))
 		return M0_ERR(-EAGAIN);
 
-	M0_ALLOC_PTR(fom);
+	fom = m0_objpool_alloc(&cas_fom_pool);
 	/**
 	 * @todo Validity (cas_is_valid()) of input records is not checked here,
 	 * so "out_nr" can be bogus. Cannot check validity at this point,
@@ -688,7 +705,7 @@ static int cas_fom_create(struct m0_fop *fop,
 		m0_free(ikv);
 		m0_free(repfop);
 		m0_free(repv);
-		m0_free(fom);
+		m0_objpool_free(&cas_fom_pool, fom);
 		return M0_ERR(-ENOMEM);
 	}
 }
@@ -1613,7 +1630,7 @@ static void cas_fom_fini(struct m0_fom *fom0)
 	m0_long_lock_link_fini(&fom->cf_dead_index);
 	m0_long_lock_link_fini(&fom->cf_del_lock);
 	m0_fom_fini(fom0);
-	m0_free(fom);
+	m0_objpool_free(&cas_fom_pool, fom);
 	if (cas_in_ut() && cas__ut_cb_fini != NULL)
 		cas__ut_cb_fini(fom0);
 }
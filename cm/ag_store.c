@@ -513,6 +513,7 @@ M0_INTERNAL void m0_cm_ag_store_init(struct m0_cm_type *cmtype)
 	m0_fom_type_init(&cmtype->ct_ag_store_fomt, cmtype->ct_fom_id + 3,
 			 &ag_store_update_fom_type_ops,
 			 &cmtype->ct_stype, &ag_store_update_conf);
+	cmtype->ct_ag_store_fomt.ft_class = M0_FSC_BACKGROUND;
 }
 
 M0_INTERNAL void m0_cm_ag_store_complete(struct m0_cm_ag_store *store)
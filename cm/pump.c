@@ -415,6 +415,7 @@ M0_INTERNAL void m0_cm_cp_pump_init(struct m0_cm_type *cmtype)
 	m0_fom_type_init(&cmtype->ct_pump_fomt, cmtype->ct_fom_id + 2,
 			 &cm_cp_pump_fom_type_ops,
 			 &cmtype->ct_stype, &cm_cp_pump_conf);
+	cmtype->ct_pump_fomt.ft_class = M0_FSC_BACKGROUND;
 }
 
 M0_INTERNAL void m0_cm_cp_pump_prepare(struct m0_cm *cm)
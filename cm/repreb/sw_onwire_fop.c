@@ -58,7 +58,8 @@ void m0_cm_repreb_sw_onwire_fop_init(struct m0_fop_type *ft,
 			 .rpc_flags = rpc_flags,
 			 .fom_ops   = fomt_ops,
 			 .sm        = &m0_cm_repreb_sw_onwire_conf,
-			 .svc_type  = &cmt->ct_stype);
+			 .svc_type  = &cmt->ct_stype,
+			 .fom_class = M0_FSC_BACKGROUND);
 }
 
 M0_INTERNAL void m0_cm_repreb_sw_onwire_fop_fini(struct m0_fop_type *ft)
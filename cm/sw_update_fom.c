@@ -152,6 +152,7 @@ M0_INTERNAL void m0_cm_sw_update_init(struct m0_cm_type *cmtype)
 	m0_fom_type_init(&cmtype->ct_swu_fomt, cmtype->ct_fom_id + 1,
 			 &cm_sw_update_fom_type_ops,
 			 &cmtype->ct_stype, &cm_sw_update_conf);
+	cmtype->ct_swu_fomt.ft_class = M0_FSC_BACKGROUND;
 }
 
 M0_INTERNAL void m0_cm_sw_update_start(struct m0_cm *cm)
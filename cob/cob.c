@@ -345,11 +345,17 @@ static m0_bcount_t ns_vsize(const void *val)
 	return sizeof(struct m0_cob_nsrec);
 }
 
+static uint64_t ns_prefix(const void *key)
+{
+	return ((const struct m0_cob_nskey *)key)->cnk_pfid.f_container;
+}
+
 static const struct m0_be_btree_kv_ops cob_ns_ops = {
 	.ko_type    = M0_BBT_COB_NAMESPACE,
 	.ko_ksize   = ns_ksize,
 	.ko_vsize   = ns_vsize,
-	.ko_compare = ns_cmp
+	.ko_compare = ns_cmp,
+	.ko_prefix  = ns_prefix
 };
 
 /**
@@ -373,11 +379,17 @@ static m0_bcount_t oi_ksize(const void *key)
 	return sizeof(struct m0_cob_oikey);
 }
 
+static uint64_t oi_prefix(const void *key)
+{
+	return ((const struct m0_cob_oikey *)key)->cok_fid.f_container;
+}
+
 static const struct m0_be_btree_kv_ops cob_oi_ops = {
 	.ko_type    = M0_BBT_COB_OBJECT_INDEX,
 	.ko_ksize   = oi_ksize,
 	.ko_vsize   = ns_ksize,
-	.ko_compare = oi_cmp
+	.ko_compare = oi_cmp,
+	.ko_prefix  = oi_prefix
 };
 
 /**
@@ -35,7 +35,13 @@
  * @defgroup conf_dlspec_cache Configuration Cache (lspec)
  *
  * The implementation of m0_conf_cache::ca_registry is based on linked
- * list data structure.
+ * list data structure. The list is indexed by object identity with
+ * m0_conf_cache::ca_hash hash table; both are updated together by
+ * m0_conf_cache_add() and m0_conf_cache_del().
+ *
+ * m0_conf_cache::ca_pinned_nr is maintained by m0_conf_obj_get() and
+ * m0_conf_obj_put(), which lets m0_conf_cache_pinned() return immediately
+ * when nothing is pinned.
  *
  * @see @ref conf, @ref conf-lspec
  *
@@ -47,6 +53,31 @@ M0_TL_DESCR_DEFINE(m0_conf_cache, "registered m0_conf_obj-s", ,
 		   M0_CONF_OBJ_MAGIC, M0_CONF_CACHE_MAGIC);
 M0_TL_DEFINE(m0_conf_cache, M0_INTERNAL, struct m0_conf_obj);
 
+enum {
+	/**
+	 * Number of m0_conf_cache::ca_hash buckets.
+	 * Configuration of a large cluster has tens of thousands of objects.
+	 */
+	CONF_CACHE_HASH_BUCKETS = 1024
+};
+
+static uint64_t conf_cache_hash(const struct m0_htable *htable,
+				const struct m0_fid    *fid)
+{
+	return m0_fid_hash(fid) % htable->h_bucket_nr;
+}
+
+static bool conf_cache_hash_eq(const struct m0_fid *a, const struct m0_fid *b)
+{
+	return m0_fid_eq(a, b);
+}
+
+M0_HT_DESCR_DEFINE(conf_cache_hash, "m0_conf_obj-s by fid", static,
+		   struct m0_conf_obj, co_hash_link, co_gen_magic,
+		   M0_CONF_OBJ_MAGIC, M0_CONF_CACHE_HASH_MAGIC,
+		   co_id, conf_cache_hash, conf_cache_hash_eq);
+M0_HT_DEFINE(conf_cache_hash, static, struct m0_conf_obj, struct m0_fid);
+
 M0_INTERNAL void m0_conf_cache_lock(struct m0_conf_cache *cache)
 {
 	m0_mutex_lock(cache->ca_lock);
@@ -62,17 +93,24 @@ M0_INTERNAL bool m0_conf_cache_is_locked(const struct m0_conf_cache *cache)
 	return m0_mutex_is_locked(cache->ca_lock);
 }
 
-M0_INTERNAL void
+M0_INTERNAL int
 m0_conf_cache_init(struct m0_conf_cache *cache, struct m0_mutex *lock)
 {
+	int rc;
+
 	M0_ENTRY();
 
+	rc = conf_cache_hash_htable_init(&cache->ca_hash,
+					 CONF_CACHE_HASH_BUCKETS);
+	if (rc != 0)
+		return M0_ERR(rc);
 	m0_conf_cache_tlist_init(&cache->ca_registry);
 	cache->ca_lock = lock;
 	cache->ca_ver  = 0;
 	cache->ca_fid_counter = 0;
+	cache->ca_pinned_nr = 0;
 
-	M0_LEAVE();
+	return M0_RC(0);
 }
 
 M0_INTERNAL int
@@ -88,6 +126,8 @@ m0_conf_cache_add(struct m0_conf_cache *cache, struct m0_conf_obj *obj)
 	if (x != NULL)
 		return M0_ERR(-EEXIST);
 	m0_conf_cache_tlist_add(&cache->ca_registry, obj);
+	conf_cache_hash_tlink_init(obj);
+	conf_cache_hash_htable_add(&cache->ca_hash, obj);
 	return M0_RC(0);
 }
 
@@ -106,14 +146,15 @@ M0_INTERNAL struct m0_conf_obj *
 m0_conf_cache_lookup(const struct m0_conf_cache *cache,
 		     const struct m0_fid *id)
 {
-	return m0_tl_find(m0_conf_cache, obj, &cache->ca_registry,
-			  m0_fid_eq(&obj->co_id, id));
+	return conf_cache_hash_htable_lookup(&cache->ca_hash, id);
 }
 
 static void _obj_del(struct m0_conf_obj *obj)
 {
 	M0_ENTRY("obj="FID_F, FID_P(&obj->co_id));
 
+	conf_cache_hash_htable_del(&obj->co_cache->ca_hash, obj);
+	conf_cache_hash_tlink_fini(obj);
 	m0_conf_cache_tlist_del(obj);
 	m0_conf_obj_delete(obj);
 
@@ -186,7 +227,9 @@ M0_INTERNAL void m0_conf_cache_fini(struct m0_conf_cache *cache)
 
 	m0_conf_cache_lock(cache);
 	m0_conf_cache_clean(cache, NULL);
+	M0_ASSERT(cache->ca_pinned_nr == 0);
 	m0_conf_cache_tlist_fini(&cache->ca_registry);
+	conf_cache_hash_htable_fini(&cache->ca_hash);
 	m0_conf_cache_unlock(cache);
 
 	M0_LEAVE();
@@ -319,8 +362,9 @@ M0_INTERNAL struct m0_conf_obj *
 m0_conf_cache_pinned(const struct m0_conf_cache *cache)
 {
 	M0_PRE(m0_conf_cache_is_locked(cache));
-	return m0_tl_find(m0_conf_cache, obj, &cache->ca_registry,
-			  obj->co_nrefs != 0);
+	return cache->ca_pinned_nr == 0 ? NULL :
+		m0_tl_find(m0_conf_cache, obj, &cache->ca_registry,
+			   obj->co_nrefs != 0);
 }
 
 /** @} conf_dlspec_cache */
@@ -25,6 +25,7 @@
 
 #include "conf/obj.h"
 #include "lib/tlist.h"  /* M0_TL_DESCR_DECLARE */
+#include "lib/hash.h"   /* m0_htable */
 
 struct m0_mutex;
 
@@ -51,6 +52,10 @@ M0_TL_DECLARE(m0_conf_cache, M0_INTERNAL, struct m0_conf_obj);
  *     m0_conf_cache_fini() frees all configuration objects that are
  *     registered. No sophisticated DAG traversal is needed.
  *
+ * The registry is indexed by object identity (m0_conf_cache::ca_hash),
+ * so that m0_conf_cache_lookup() does not depend on the size of the
+ * configuration.
+ *
  * @note Configuration consumers should not #include "conf/cache.h".
  *       This is "internal" API, used by confc and confd
  *       implementations.
@@ -98,6 +103,20 @@ struct m0_conf_cache {
 	 */
 	struct m0_tl     ca_registry;
 
+	/**
+	 * Index of ca_registry by m0_conf_obj::co_id.
+	 * Hash of m0_conf_obj-s, linked through m0_conf_obj::co_hash_link.
+	 */
+	struct m0_htable ca_hash;
+
+	/**
+	 * Number of objects of this cache with non-zero
+	 * m0_conf_obj::co_nrefs.
+	 *
+	 * @see m0_conf_cache_pinned()
+	 */
+	uint64_t         ca_pinned_nr;
+
 	/** Cache lock. */
 	struct m0_mutex *ca_lock;
 
@@ -112,8 +131,8 @@ struct m0_conf_cache {
 };
 
 /** Initialises configuration cache. */
-M0_INTERNAL void m0_conf_cache_init(struct m0_conf_cache *cache,
-				    struct m0_mutex *lock);
+M0_INTERNAL int m0_conf_cache_init(struct m0_conf_cache *cache,
+				   struct m0_mutex *lock);
 
 /**
  * Finalises configuration cache.
@@ -212,6 +231,8 @@ M0_INTERNAL int m0_conf_version(struct m0_conf_cache *cache);
  * Searches the configuration cache for a pinned object.
  * Returns NULL if none is found.
  *
+ * The registry is not scanned when m0_conf_cache::ca_pinned_nr is 0.
+ *
  * @pre  m0_conf_cache_is_locked(cache)
  */
 M0_INTERNAL struct m0_conf_obj *
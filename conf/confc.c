@@ -468,8 +468,6 @@ static int confc_cache_create(struct m0_confc *confc,
 	M0_ENTRY("confc=%p", confc);
 	M0_PRE(confc_is_locked(confc));
 
-	m0_conf_cache_init(&confc->cc_cache, &confc->cc_lock);
-
 	/* Create stub for root object */
 	rc = m0_conf_obj_find(&confc->cc_cache, &M0_CONF_ROOT_FID,
 	                      &confc->cc_root);
@@ -524,6 +522,11 @@ M0_INTERNAL int m0_confc_init_wait(struct m0_confc       *confc,
 	M0_LOG(M0_DEBUG, "confd=%s lconf=%s", confd_addr, local_conf);
 
 	m0_mutex_init(&confc->cc_lock);
+	rc = m0_conf_cache_init(&confc->cc_cache, &confc->cc_lock);
+	if (rc != 0) {
+		m0_mutex_fini(&confc->cc_lock);
+		return M0_ERR(rc);
+	}
 	confc_lock(confc);
 	rc = confc_cache_create(confc, local_conf);
 	confc_unlock(confc);
@@ -522,7 +522,11 @@ M0_INTERNAL int m0_confd_cache_create(struct m0_conf_cache **out,
 	M0_ALLOC_PTR(*out);
 	if (*out == NULL)
 		return M0_ERR(-ENOMEM);
-	m0_conf_cache_init(*out, cache_lock);
+	rc = m0_conf_cache_init(*out, cache_lock);
+	if (rc != 0) {
+		m0_free0(out);
+		return M0_ERR(rc);
+	}
 	m0_conf_cache_lock(*out);
 	rc = confd_cache_preload(*out, confstr);
 	m0_conf_cache_unlock(*out);
@@ -80,6 +80,7 @@ M0_INTERNAL int m0_conf_fops_init(void)
 			 .fom_ops   = &confd_fom_ops,
 			 .svc_type  = &m0_confd_stype,
 			 .sm        = &m0_generic_conf,
+			 .fom_class = M0_FSC_INTERACTIVE,
 #endif
 			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST);
 	M0_FOP_TYPE_INIT(&m0_conf_fetch_resp_fopt,
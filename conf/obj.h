@@ -28,6 +28,7 @@
 #include "layout/pdclust.h" /* m0_pdclust_attr */
 #include "lib/protocol.h"   /* m0_protocol_id */
 #include "lib/bob.h"
+#include "lib/hash.h"         /* m0_hlink */
 #include "fid/fid.h"          /* m0_fid */
 #include "conf/schema.h"      /* m0_conf_service_type */
 #include "fdmi/filter.h"      /* m0_fdmi_filter */
@@ -252,6 +253,9 @@ struct m0_conf_obj {
 	/** Linkage to m0_conf_cache::ca_registry. */
 	struct m0_tlink               co_cache_link;
 
+	/** Linkage to m0_conf_cache::ca_hash. */
+	struct m0_hlink               co_hash_link;
+
 	/** Linkage to m0_conf_dir::cd_items. */
 	struct m0_tlink               co_dir_link;
 
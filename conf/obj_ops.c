@@ -191,6 +191,8 @@ M0_INTERNAL void m0_conf_obj_get(struct m0_conf_obj *obj)
 	M0_PRE(m0_conf_cache_is_locked(obj->co_cache));
 	M0_PRE(obj->co_status == M0_CS_READY);
 
+	if (obj->co_nrefs == 0)
+		M0_CNT_INC(obj->co_cache->ca_pinned_nr);
 	M0_CNT_INC(obj->co_nrefs);
 	M0_LEAVE();
 }
@@ -211,8 +213,10 @@ M0_INTERNAL void m0_conf_obj_put(struct m0_conf_obj *obj)
 	M0_PRE(obj->co_status == M0_CS_READY);
 
 	M0_CNT_DEC(obj->co_nrefs);
-	if (obj->co_nrefs == 0)
+	if (obj->co_nrefs == 0) {
+		M0_CNT_DEC(obj->co_cache->ca_pinned_nr);
 		m0_chan_broadcast(&obj->co_chan);
+	}
 	M0_LEAVE();
 }
 
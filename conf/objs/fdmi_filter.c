@@ -25,6 +25,9 @@
 #include "conf/objs/common.h"
 #include "conf/onwire_xc.h"     /* m0_confx_fdmi_filter_xc */
 #include "fdmi/filter.h"
+#ifndef __KERNEL__
+#include "fdmi/flt_eval.h"      /* m0_fdmi_flt_compile */
+#endif
 #include "motr/magic.h"         /* M0_CONF_FDMI_FILTER_MAGIC */
 #include "lib/memory.h"         /* m0_free */
 #include "lib/buf.h"            /* m0_buf_strdup */
@@ -81,6 +84,16 @@ fdmi_filter_decode(struct m0_conf_obj *dest, const struct m0_confx_obj *src)
 		d->ff_filter_id = s->xf_filter_id;
 		d->ff_node = M0_CONF_CAST(node, m0_conf_node);
 		rc = m0_bufs_to_strings(&d->ff_endpoints, &s->xf_endpoints);
+#ifndef __KERNEL__
+		/*
+		 * Filters are evaluated by the source dock in user space
+		 * only. Failure to compile is not fatal: such filter is
+		 * evaluated by walking the tree.
+		 */
+		if (rc == 0 && m0_fdmi_flt_compile(&d->ff_filter) != 0)
+			M0_LOG(M0_WARN, "Filter "FID_F" is not compiled",
+			       FID_P(&dest->co_id));
+#endif
 	} else {
 		M0_ASSERT(d->ff_filter.ff_root == flt_root);
 		m0_free0(&d->ff_filter.ff_root);
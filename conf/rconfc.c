@@ -867,9 +867,11 @@ static int _confc_phony_cache_append(struct m0_confc      *confc,
 	 * that pin while iterating the cache
 	 */
 	obj->co_nrefs  = 1;
+	M0_CNT_INC(cache->ca_pinned_nr);
 	rc = m0_conf_cache_add(cache, obj);
 	if (rc != 0) {
 		obj->co_nrefs  = 0;
+		M0_CNT_DEC(cache->ca_pinned_nr);
 		m0_conf_obj_delete(obj);
 	}
 out:
@@ -893,6 +895,7 @@ static void _confc_phony_cache_remove(struct m0_confc     *confc,
 	M0_ASSERT(!m0_conf_obj_is_stub(obj));
 	obj->co_status = M0_CS_MISSING;
 	obj->co_nrefs  = 0;
+	M0_CNT_DEC(cache->ca_pinned_nr);
 	m0_conf_cache_del(cache, obj);
 	m0_conf_cache_unlock(cache);
 	M0_LEAVE();
@@ -30,6 +30,7 @@
 #include "lib/errno.h"     /* ENOENT */
 #include "lib/fs.h"        /* m0_file_read */
 #include "lib/memory.h"    /* m0_free0 */
+#include "lib/ub.h"        /* m0_ub_set */
 #include "ut/misc.h"       /* M0_UT_PATH */
 #include "ut/ut.h"
 
@@ -183,6 +184,28 @@ static void test_obj_fill(void)
 	m0_confx_free(enc);
 }
 
+static void test_pinned(void)
+{
+	struct m0_conf_obj *root;
+
+	m0_conf_cache_lock(&m0_conf_ut_cache);
+	M0_UT_ASSERT(m0_conf_cache_pinned(&m0_conf_ut_cache) == NULL);
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_pinned_nr == 0);
+
+	root = m0_conf_cache_lookup(&m0_conf_ut_cache, &M0_CONF_ROOT_FID);
+	M0_UT_ASSERT(root != NULL && root->co_status == M0_CS_READY);
+	m0_conf_obj_get(root);
+	m0_conf_obj_get(root);
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_pinned_nr == 1);
+	M0_UT_ASSERT(m0_conf_cache_pinned(&m0_conf_ut_cache) == root);
+	m0_conf_obj_put(root);
+	M0_UT_ASSERT(m0_conf_cache_pinned(&m0_conf_ut_cache) == root);
+	m0_conf_obj_put(root);
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_pinned_nr == 0);
+	M0_UT_ASSERT(m0_conf_cache_pinned(&m0_conf_ut_cache) == NULL);
+	m0_conf_cache_unlock(&m0_conf_ut_cache);
+}
+
 struct m0_ut_suite conf_ut = {
 	.ts_name  = "conf-ut",
 	.ts_init  = m0_conf_ut_cache_init,
@@ -192,7 +215,88 @@ struct m0_ut_suite conf_ut = {
 		{ "cache",       test_cache     },
 		{ "obj-find",    test_obj_find  },
 		{ "obj-fill",    test_obj_fill  },
+		{ "pinned",      test_pinned    },
 		{ "dir-add-del", test_dir_add_del },
 		{ NULL, NULL }
 	}
 };
+
+/* ----------------------------------------------------------------
+ * Micro-benchmarks
+ * ---------------------------------------------------------------- */
+
+enum {
+	/* Number of objects in the generated configuration. */
+	UB_ITER = 50000
+};
+
+static struct m0_mutex      ub_lock;
+static struct m0_conf_cache ub_cache;
+
+static struct m0_fid ub_fid(int i)
+{
+	return M0_FID_TINIT(M0_CONF_SDEV_TYPE.cot_ftype.ft_id, 1, i);
+}
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	int rc;
+
+	m0_mutex_init(&ub_lock);
+	rc = m0_conf_cache_init(&ub_cache, &ub_lock);
+	if (rc != 0)
+		m0_mutex_fini(&ub_lock);
+	else
+		m0_conf_cache_lock(&ub_cache);
+	return rc;
+}
+
+static void ub_fini(void)
+{
+	m0_conf_cache_unlock(&ub_cache);
+	m0_conf_cache_fini(&ub_cache);
+	m0_mutex_fini(&ub_lock);
+}
+
+static void ub_find(int i)
+{
+	struct m0_fid       fid = ub_fid(i);
+	struct m0_conf_obj *obj;
+	int                 rc;
+
+	rc = m0_conf_obj_find(&ub_cache, &fid, &obj);
+	M0_ASSERT(rc == 0);
+}
+
+static void ub_lookup(int i)
+{
+	struct m0_fid fid = ub_fid(UB_ITER - 1 - i);
+
+	M0_ASSERT(m0_conf_cache_lookup(&ub_cache, &fid) != NULL);
+}
+
+static void ub_pinned(int i M0_UNUSED)
+{
+	M0_ASSERT(m0_conf_cache_pinned(&ub_cache) == NULL);
+}
+
+struct m0_ub_set m0_conf_ub = {
+	.us_name = "conf-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "find",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_find },
+
+		{ .ub_name  = "lookup",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_lookup },
+
+		{ .ub_name  = "pinned",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_pinned },
+
+		{ .ub_name = NULL }
+	}
+};
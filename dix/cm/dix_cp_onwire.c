@@ -43,7 +43,8 @@ M0_INTERNAL void m0_dix_cpx_init(struct m0_fop_type *ft,
 			 .rpc_flags = rpc_flags,
 			 .fom_ops   = fomt_ops,
 			 .sm        = &m0_generic_conf,
-			 .svc_type  = &cmt->ct_stype);
+			 .svc_type  = &cmt->ct_stype,
+			 .fom_class = M0_FSC_BACKGROUND);
 	m0_fop_type_addb2_instrument(ft);
 }
 
@@ -1411,6 +1411,7 @@ M0_INTERNAL void m0_dix_cm_iter_type_register(struct m0_dix_cm_type *dcmt)
 	m0_fom_type_init(&dcmt->dct_iter_fomt, fom_id,
 			 &dix_cm_iter_fom_type_ops, &dcmt->dct_base->ct_stype,
 			 &dix_cm_iter_sm_conf);
+	dcmt->dct_iter_fomt.ft_class = M0_FSC_BACKGROUND;
 }
 
 M0_INTERNAL int m0_dix_cm_iter_start(struct m0_dix_cm_iter *iter,
@@ -42,6 +42,7 @@ M0_INTERNAL void m0_fdmi_filter_init(struct m0_fdmi_filter    *flt)
 	M0_PRE(flt != NULL);
 
 	flt->ff_root = NULL;
+	flt->ff_prog = NULL;
 
 	M0_LEAVE();
 }
@@ -52,6 +53,8 @@ M0_INTERNAL void m0_fdmi_filter_root_set(struct m0_fdmi_filter    *flt,
 	M0_ENTRY();
 	M0_PRE(flt != NULL);
 	M0_PRE(root != NULL);
+	/* Compiled program refers to the nodes of the previous tree. */
+	m0_free0(&flt->ff_prog);
 	flt->ff_root = root;
 	M0_LEAVE();
 }
@@ -114,6 +117,8 @@ M0_INTERNAL void m0_fdmi_filter_fini(struct m0_fdmi_filter *flt)
 {
 	M0_ENTRY("flt=%p", flt);
 
+	/* Compiled program is a single allocation. */
+	m0_free0(&flt->ff_prog);
 	if (flt->ff_root != NULL)
 		free_flt_node(flt->ff_root);
 
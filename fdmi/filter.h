@@ -103,11 +103,18 @@ enum m0_fdmi_flt_op_code {
 	M0_FFO_TOTAL_OPS_CNT
 };
 
+struct m0_fdmi_flt_prog;
+
 /**
  * FDMI filter expression
  */
 struct m0_fdmi_filter {
 	struct m0_fdmi_flt_node    *ff_root; /**< Root of the expression tree */
+	/**
+	 * Compiled expression tree, NULL if the filter is not compiled.
+	 * @see m0_fdmi_flt_compile()
+	 */
+	struct m0_fdmi_flt_prog    *ff_prog;
 };
 
 /**
@@ -25,6 +25,8 @@
 
 #include "lib/types.h"
 #include "lib/errno.h"
+#include "lib/memory.h"
+#include "lib/misc.h"    /* M0_SET0 */
 
 #include "fdmi/filter.h"
 #include "fdmi/flt_eval.h"
@@ -90,10 +92,15 @@ static int eval_gt(struct m0_fdmi_flt_operands *opnds,
 	return M0_RC(rc);
 }
 
+static const m0_fdmi_flt_op_cb_t std_operation_handlers[] = {
+	[M0_FFO_OR] = eval_or,
+	[M0_FFO_GT] = eval_gt,
+};
+
 static void init_std_operation_handlers(m0_fdmi_flt_op_cb_t *handlers)
 {
-	handlers[M0_FFO_OR] = eval_or;
-	handlers[M0_FFO_GT] = eval_gt;
+	handlers[M0_FFO_OR] = std_operation_handlers[M0_FFO_OR];
+	handlers[M0_FFO_GT] = std_operation_handlers[M0_FFO_GT];
 }
 
 M0_INTERNAL int m0_fdmi_eval_add_op_cb(struct m0_fdmi_eval_ctx *ctx,
@@ -133,6 +140,35 @@ M0_INTERNAL void m0_fdmi_eval_init(struct m0_fdmi_eval_ctx *ctx)
 	M0_LEAVE();
 }
 
+/**
+ * Retrieves value of the variable, consulting the cache of values already
+ * retrieved for the record first.
+ */
+static int eval_var(struct m0_fdmi_eval_var_info *var_info,
+		    struct m0_fdmi_flt_var_node  *var,
+		    struct m0_fdmi_flt_operand   *res)
+{
+	uint32_t i;
+	int      rc;
+
+	if (var_info == NULL || var_info->get_value_cb == NULL)
+		return M0_ERR(-EINVAL);
+	M0_PRE(var_info->vi_cached_nr <= M0_FDMI_EVAL_VAR_CACHE_NR);
+	for (i = 0; i < var_info->vi_cached_nr; ++i) {
+		if (m0_buf_eq(var_info->vi_cached_var[i], &var->ffvn_data)) {
+			*res = var_info->vi_cached_val[i];
+			return 0;
+		}
+	}
+	rc = var_info->get_value_cb(var_info->user_data, var, res);
+	if (rc == 0 && i < M0_FDMI_EVAL_VAR_CACHE_NR) {
+		var_info->vi_cached_var[i] = &var->ffvn_data;
+		var_info->vi_cached_val[i] = *res;
+		var_info->vi_cached_nr++;
+	}
+	return rc;
+}
+
 static int eval_flt_node(struct m0_fdmi_eval_ctx    *ctx,
                          struct m0_fdmi_flt_node    *node,
                          struct m0_fdmi_flt_operand *res,
@@ -166,11 +202,7 @@ static int eval_flt_node(struct m0_fdmi_eval_ctx    *ctx,
 		rc = 0;
 		break;
 	case M0_FLT_VARIABLE_NODE:
-		if (var_info->get_value_cb != NULL)
-			rc = var_info->get_value_cb(var_info->user_data,
-						    &node->ffn_u.ffn_var, res);
-		else
-			rc = -EINVAL;
+		rc = eval_var(var_info, &node->ffn_u.ffn_var, res);
 		break;
 	default:
 		M0_ASSERT(false);
@@ -179,6 +211,55 @@ static int eval_flt_node(struct m0_fdmi_eval_ctx    *ctx,
 	return M0_RC(rc);
 }
 
+static const struct m0_fdmi_flt_operand *
+flt_prog_reg(const struct m0_fdmi_flt_prog    *prog,
+	     const struct m0_fdmi_flt_operand *reg,
+	     uint32_t                          idx)
+{
+	return prog->fp_insn[idx].fi_type == M0_FFI_CONST ?
+		&prog->fp_insn[idx].fi_value : &reg[idx];
+}
+
+static int eval_flt_prog(struct m0_fdmi_eval_ctx      *ctx,
+			 const struct m0_fdmi_flt_prog *prog,
+			 struct m0_fdmi_flt_operand   *res,
+			 struct m0_fdmi_eval_var_info *var_info)
+{
+	/* Results of instructions, constants are not copied here. */
+	struct m0_fdmi_flt_operand     reg[M0_FDMI_FLT_PROG_NR_MAX];
+	struct m0_fdmi_flt_operands    operands;
+	const struct m0_fdmi_flt_insn *insn;
+	uint32_t                       i;
+	uint32_t                       j;
+	int                            rc = 0;
+
+	M0_PRE(prog->fp_nr > 0 && prog->fp_nr <= M0_FDMI_FLT_PROG_NR_MAX);
+	M0_PRE(prog->fp_root < prog->fp_nr);
+
+	for (i = 0; i < prog->fp_nr && rc == 0; ++i) {
+		insn = &prog->fp_insn[i];
+		switch (insn->fi_type) {
+		case M0_FFI_CONST:
+			break;
+		case M0_FFI_VAR:
+			rc = eval_var(var_info, insn->fi_var, &reg[i]);
+			break;
+		case M0_FFI_OP:
+			operands.ffp_count = insn->fi_opnds_nr;
+			for (j = 0; j < insn->fi_opnds_nr; ++j)
+				operands.ffp_operands[j] = *flt_prog_reg(prog,
+						reg, insn->fi_opnds[j]);
+			rc = ctx->opers[insn->fi_op_code](&operands, &reg[i]);
+			break;
+		default:
+			M0_IMPOSSIBLE("Wrong instruction type.");
+		}
+	}
+	if (rc == 0)
+		*res = *flt_prog_reg(prog, reg, prog->fp_root);
+	return M0_RC(rc);
+}
+
 M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx *ctx,
                                  struct m0_fdmi_filter   *flt,
                                  struct m0_fdmi_eval_var_info *var_info)
@@ -188,7 +269,9 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx *ctx,
 
 	M0_ENTRY();
 
-	rc = eval_flt_node(ctx, flt->ff_root, &res, var_info);
+	rc = flt->ff_prog != NULL ?
+		eval_flt_prog(ctx, flt->ff_prog, &res, var_info) :
+		eval_flt_node(ctx, flt->ff_root, &res, var_info);
 
 	if (rc == 0) {
 		M0_ASSERT(res.ffo_type == M0_FF_OPND_BOOL);
@@ -199,6 +282,158 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx *ctx,
 	return M0_RC(rc);
 }
 
+static bool flt_operand_eq(const struct m0_fdmi_flt_operand *a,
+			   const struct m0_fdmi_flt_operand *b)
+{
+	const struct m0_fdmi_flt_opnd_pld *pa = &a->ffo_data;
+	const struct m0_fdmi_flt_opnd_pld *pb = &b->ffo_data;
+
+	if (a->ffo_type != b->ffo_type || pa->fpl_type != pb->fpl_type)
+		return false;
+	switch (pa->fpl_type) {
+	case M0_FF_OPND_PLD_INT:
+		return pa->fpl_pld.fpl_integer == pb->fpl_pld.fpl_integer;
+	case M0_FF_OPND_PLD_UINT:
+		return pa->fpl_pld.fpl_uinteger == pb->fpl_pld.fpl_uinteger;
+	case M0_FF_OPND_PLD_BOOL:
+		return pa->fpl_pld.fpl_boolean == pb->fpl_pld.fpl_boolean;
+	case M0_FF_OPND_PLD_BUF:
+		return m0_buf_eq(&pa->fpl_pld.fpl_buf, &pb->fpl_pld.fpl_buf);
+	default:
+		return false;
+	}
+}
+
+static bool flt_insn_eq(const struct m0_fdmi_flt_insn *a,
+			const struct m0_fdmi_flt_insn *b)
+{
+	if (a->fi_type != b->fi_type)
+		return false;
+	switch (a->fi_type) {
+	case M0_FFI_CONST:
+		return flt_operand_eq(&a->fi_value, &b->fi_value);
+	case M0_FFI_VAR:
+		return m0_buf_eq(&a->fi_var->ffvn_data, &b->fi_var->ffvn_data);
+	case M0_FFI_OP:
+		return a->fi_op_code == b->fi_op_code &&
+		       a->fi_opnds_nr == b->fi_opnds_nr &&
+		       memcmp(a->fi_opnds, b->fi_opnds,
+			      a->fi_opnds_nr * sizeof a->fi_opnds[0]) == 0;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Computes operation on constants during compilation. Only built-in
+ * operations are folded: handlers of other operations are known at evaluation
+ * time only. If the operation fails, it is left in the program, so that the
+ * error is reported on evaluation, like it is done by the tree walk.
+ */
+static void flt_insn_fold(struct m0_fdmi_flt_prog *prog,
+			  struct m0_fdmi_flt_insn *insn)
+{
+	struct m0_fdmi_flt_operands operands;
+	struct m0_fdmi_flt_operand  res;
+	m0_fdmi_flt_op_cb_t         op;
+	uint32_t                    i;
+
+	if (insn->fi_op_code >= ARRAY_SIZE(std_operation_handlers))
+		return;
+	op = std_operation_handlers[insn->fi_op_code];
+	if (op == NULL)
+		return;
+	for (i = 0; i < insn->fi_opnds_nr; ++i) {
+		if (prog->fp_insn[insn->fi_opnds[i]].fi_type != M0_FFI_CONST)
+			return;
+		operands.ffp_operands[i] =
+			prog->fp_insn[insn->fi_opnds[i]].fi_value;
+	}
+	operands.ffp_count = insn->fi_opnds_nr;
+	if (op(&operands, &res) == 0) {
+		insn->fi_type  = M0_FFI_CONST;
+		insn->fi_value = res;
+	}
+}
+
+/**
+ * Appends instructions computing the sub-tree rooted at the node to the
+ * program in post-order and returns index of the instruction computing the
+ * node in *out. Instruction identical to an already emitted one is not
+ * appended, index of the existing instruction is returned instead.
+ */
+static int flt_compile_node(struct m0_fdmi_flt_prog *prog,
+			    struct m0_fdmi_flt_node *node,
+			    uint32_t                *out)
+{
+	struct m0_fdmi_flt_op_node *on = &node->ffn_u.ffn_oper;
+	struct m0_fdmi_flt_insn     insn;
+	uint32_t                    i;
+	int                         rc;
+
+	M0_SET0(&insn);
+	switch (node->ffn_type) {
+	case M0_FLT_OPERATION_NODE:
+		if (on->ffon_opnds.fno_cnt < 0 ||
+		    on->ffon_opnds.fno_cnt > FDMI_FLT_MAX_OPNDS_NR)
+			return M0_ERR(-E2BIG);
+		for (i = 0; i < on->ffon_opnds.fno_cnt; ++i) {
+			rc = flt_compile_node(prog, on->ffon_opnds.fno_opnds[i].
+					      ffnp_ptr, &insn.fi_opnds[i]);
+			if (rc != 0)
+				return rc;
+		}
+		insn.fi_type     = M0_FFI_OP;
+		insn.fi_op_code  = on->ffon_op_code;
+		insn.fi_opnds_nr = on->ffon_opnds.fno_cnt;
+		flt_insn_fold(prog, &insn);
+		break;
+	case M0_FLT_OPERAND_NODE:
+		insn.fi_type  = M0_FFI_CONST;
+		insn.fi_value = node->ffn_u.ffn_operand;
+		break;
+	case M0_FLT_VARIABLE_NODE:
+		insn.fi_type = M0_FFI_VAR;
+		insn.fi_var  = &node->ffn_u.ffn_var;
+		break;
+	default:
+		M0_IMPOSSIBLE("Wrong node type.");
+	}
+	for (i = 0; i < prog->fp_nr; ++i) {
+		if (flt_insn_eq(&prog->fp_insn[i], &insn)) {
+			*out = i;
+			return 0;
+		}
+	}
+	if (prog->fp_nr == M0_FDMI_FLT_PROG_NR_MAX)
+		return M0_ERR(-E2BIG);
+	*out = prog->fp_nr;
+	prog->fp_insn[prog->fp_nr++] = insn;
+	return 0;
+}
+
+M0_INTERNAL int m0_fdmi_flt_compile(struct m0_fdmi_filter *flt)
+{
+	struct m0_fdmi_flt_prog *prog;
+	int                      rc;
+
+	M0_ENTRY("flt=%p", flt);
+	M0_PRE(flt->ff_root != NULL);
+
+	prog = m0_alloc(sizeof *prog +
+			M0_FDMI_FLT_PROG_NR_MAX * sizeof prog->fp_insn[0]);
+	if (prog == NULL)
+		return M0_ERR(-ENOMEM);
+	rc = flt_compile_node(prog, flt->ff_root, &prog->fp_root);
+	if (rc != 0) {
+		m0_free(prog);
+		return M0_ERR(rc);
+	}
+	m0_free(flt->ff_prog);
+	flt->ff_prog = prog;
+	return M0_RC(0);
+}
+
 M0_INTERNAL void m0_fdmi_eval_fini(struct m0_fdmi_eval_ctx *ctx)
 {
 	M0_ENTRY("ctx=%p", ctx);
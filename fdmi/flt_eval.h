@@ -59,14 +59,66 @@ struct m0_fdmi_eval_ctx {
 	m0_fdmi_flt_op_cb_t  opers[M0_FFO_TOTAL_OPS_CNT];
 };
 
+enum {
+	/** Maximum number of variable values cached per record. */
+	M0_FDMI_EVAL_VAR_CACHE_NR = 8,
+	/** Maximum number of instructions in compiled filter. */
+	M0_FDMI_FLT_PROG_NR_MAX   = 32,
+};
+
 /**
  * Structure provided by user to retrieve values from variable nodes
+ *
+ * Values of variables are cached in the structure, so when it is used to
+ * evaluate several filters against the same record, every variable is
+ * retrieved once. The structure must be zeroed before it is used for another
+ * record.
  */
 struct m0_fdmi_eval_var_info {
 	void *user_data;
 	int (*get_value_cb)(void                        *user_data,
 	                    struct m0_fdmi_flt_var_node *value_desc,
 	                    struct m0_fdmi_flt_operand  *value);
+	uint32_t                    vi_cached_nr;
+	const struct m0_buf        *vi_cached_var[M0_FDMI_EVAL_VAR_CACHE_NR];
+	struct m0_fdmi_flt_operand  vi_cached_val[M0_FDMI_EVAL_VAR_CACHE_NR];
+};
+
+/** Types of instructions of compiled filter. */
+enum m0_fdmi_flt_insn_type {
+	/** Constant, fi_value holds it. */
+	M0_FFI_CONST,
+	/** Value of the variable fi_var. */
+	M0_FFI_VAR,
+	/** Operation fi_op_code on results of fi_opnds instructions. */
+	M0_FFI_OP,
+};
+
+/** Instruction of compiled filter. */
+struct m0_fdmi_flt_insn {
+	/** @ref m0_fdmi_flt_insn_type */
+	uint32_t                      fi_type;
+	/** @ref m0_fdmi_flt_op_code */
+	uint32_t                      fi_op_code;
+	uint32_t                      fi_opnds_nr;
+	/** Indices of instructions computing the operands. */
+	uint32_t                      fi_opnds[FDMI_FLT_MAX_OPNDS_NR];
+	struct m0_fdmi_flt_var_node  *fi_var;
+	struct m0_fdmi_flt_operand    fi_value;
+};
+
+/**
+ * Compiled filter.
+ *
+ * Expression tree is flattened into the array of instructions in the order
+ * of evaluation. It is a DAG rather than a tree: identical sub-expressions are
+ * computed by a single instruction.
+ */
+struct m0_fdmi_flt_prog {
+	uint32_t                fp_nr;
+	/** Index of the instruction computing result of the filter. */
+	uint32_t                fp_root;
+	struct m0_fdmi_flt_insn fp_insn[0];
 };
 
 /**
@@ -119,6 +171,22 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx *ctx,
                                  struct m0_fdmi_filter   *flt,
                                  struct m0_fdmi_eval_var_info *var_info);
 
+/**
+ * Compiles filter expression tree.
+ *
+ * Once the filter is compiled m0_fdmi_eval_flt() executes the compiled program
+ * instead of walking the tree. Identical sub-expressions are computed once and
+ * sub-expressions without variables are computed during compilation when they
+ * use built-in operations.
+ *
+ * The program refers to the tree nodes, so the tree must not be changed after
+ * compilation. The program is freed by m0_fdmi_filter_fini().
+ *
+ * @return -E2BIG if the tree has more than M0_FDMI_FLT_PROG_NR_MAX distinct
+ *         nodes; such filter is evaluated by walking the tree.
+ */
+M0_INTERNAL int m0_fdmi_flt_compile(struct m0_fdmi_filter *flt);
+
 /**
  * Finalize FDMI evaluator
  *
@@ -39,9 +39,10 @@ static int sd_fom_send_record(struct fdmi_sd_fom *sd_fom,
 			      const char         *ep);
 static int sd_fom_process_matched_filters(struct m0_fdmi_src_dock *sd_ctx,
 					  struct m0_fdmi_src_rec  *src_rec);
-static int fdmi_filter_calc(struct fdmi_sd_fom         *sd_fom,
-			    struct m0_fdmi_src_rec     *src_rec,
-			    struct m0_conf_fdmi_filter *fdmi_filter);
+static int fdmi_filter_calc(struct fdmi_sd_fom           *sd_fom,
+			    struct m0_fdmi_src_rec       *src_rec,
+			    struct m0_conf_fdmi_filter   *fdmi_filter,
+			    struct m0_fdmi_eval_var_info *var_info);
 
 static int fdmi_rr_fom_create(struct m0_fop *fop, struct m0_fom **out,
 			      struct m0_reqh *reqh);
@@ -287,12 +288,19 @@ static size_t fdmi_sd_fom_locality(const struct m0_fom *fom)
 static int apply_filters(struct fdmi_sd_fom     *sd_fom,
 			 struct m0_fdmi_src_rec *src_rec)
 {
-	struct m0_fom              *fom = &sd_fom->fsf_fom;
-	struct m0_filterc_ctx      *filterc = &sd_fom->fsf_filter_ctx;
-	struct m0_conf_fdmi_filter *fdmi_filter;
-	int                         matched;
-	int                         rc = 0;
-	int                         ret;
+	struct m0_fom               *fom = &sd_fom->fsf_fom;
+	struct m0_filterc_ctx       *filterc = &sd_fom->fsf_filter_ctx;
+	struct m0_conf_fdmi_filter  *fdmi_filter;
+	/*
+	 * Shared by all filters, so that every record field is retrieved
+	 * once. Cached values refer to variable nodes of filters, which stay
+	 * in conf cache while the filter group directory is pinned by the
+	 * iterator.
+	 */
+	struct m0_fdmi_eval_var_info var_info = {};
+	int                          matched;
+	int                          rc = 0;
+	int                          ret;
 
 	M0_ENTRY("sd_fom %p, src_rec %p", sd_fom, src_rec);
 	M0_PRE(m0_fdmi__record_is_valid(src_rec));
@@ -305,7 +313,7 @@ static int apply_filters(struct fdmi_sd_fom     *sd_fom,
 		m0_fom_block_leave(fom);
 		if (ret > 0) {
 			matched = fdmi_filter_calc(sd_fom, src_rec,
-						   fdmi_filter);
+						   fdmi_filter, &var_info);
 			src_rec->fsr_matched = (matched > 0);
 			if (matched < 0) {
 				/**
@@ -630,22 +638,21 @@ static int node_eval(void                        *data,
 	return src_rec->fsr_src->fs_node_eval(src_rec, value_desc, value);
 }
 
-static int fdmi_filter_calc(struct fdmi_sd_fom         *sd_fom,
-			    struct m0_fdmi_src_rec     *src_rec,
-			    struct m0_conf_fdmi_filter *fdmi_filter)
+static int fdmi_filter_calc(struct fdmi_sd_fom           *sd_fom,
+			    struct m0_fdmi_src_rec       *src_rec,
+			    struct m0_conf_fdmi_filter   *fdmi_filter,
+			    struct m0_fdmi_eval_var_info *var_info)
 {
-	struct m0_fdmi_eval_var_info get_var_info;
-
 	M0_ENTRY("sd_fom %p, src_rec %p, fdmi_filter %p",
 		 sd_fom, src_rec, fdmi_filter);
 	M0_PRE(m0_fdmi__record_is_valid(src_rec));
 
-	get_var_info.user_data    = src_rec;
-	get_var_info.get_value_cb = node_eval;
+	var_info->user_data    = src_rec;
+	var_info->get_value_cb = node_eval;
 
 	return M0_RC(m0_fdmi_eval_flt(&sd_fom->fsf_flt_eval,
 				      &fdmi_filter->ff_filter,
-				      &get_var_info));
+				      var_info));
 }
 
 static int fdmi_sd_fom_tick(struct m0_fom *fom)
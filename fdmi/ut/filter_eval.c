@@ -48,6 +48,10 @@ static int flt_eval_binary_operator(enum m0_fdmi_flt_op_code  op_code,
 
 	rc = m0_fdmi_eval_flt(eval_ctx, &flt, NULL);
 
+	/* Compiled filter must give the same result. */
+	M0_UT_ASSERT(m0_fdmi_flt_compile(&flt) == 0);
+	M0_UT_ASSERT(m0_fdmi_eval_flt(eval_ctx, &flt, NULL) == rc);
+
 	m0_fdmi_filter_fini(&flt);
 
 	return rc;
@@ -222,6 +226,122 @@ static void flt_set_op_cb(void)
 	m0_fdmi_eval_fini(&eval_ctx);
 }
 
+/* ------------------------------------------------------------------
+ * Test Case: compiled filters
+ * ------------------------------------------------------------------ */
+
+static int flt_test_var_fetched;
+
+static int flt_test_var_cb(void                        *user_data,
+			   struct m0_fdmi_flt_var_node *value_desc,
+			   struct m0_fdmi_flt_operand  *value)
+{
+	M0_UT_ASSERT(m0_buf_streq(&value_desc->ffvn_data, "x"));
+	flt_test_var_fetched++;
+	value->ffo_type = M0_FF_OPND_UINT;
+	value->ffo_data.fpl_type = M0_FF_OPND_PLD_UINT;
+	value->ffo_data.fpl_pld.fpl_uinteger = *(uint64_t *)user_data;
+	return 0;
+}
+
+static struct m0_fdmi_flt_node *flt_test_var_create(void)
+{
+	struct m0_buf data;
+
+	M0_UT_ASSERT(m0_buf_copy(&data, &M0_BUF_INITS("x")) == 0);
+	return m0_fdmi_flt_var_node_create(&data);
+}
+
+/* Creates "x > value". */
+static struct m0_fdmi_flt_node *flt_test_gt_create(uint64_t value)
+{
+	return m0_fdmi_flt_op_node_create(M0_FFO_GT, flt_test_var_create(),
+					  m0_fdmi_flt_uint_node_create(value));
+}
+
+static void flt_compiled(void)
+{
+	struct m0_fdmi_eval_ctx       eval_ctx;
+	struct m0_fdmi_eval_var_info  var_info;
+	struct m0_fdmi_filter         flt[2];
+	struct m0_fdmi_flt_node      *root;
+	uint64_t                      x = 4;
+	int                           i;
+
+	m0_fdmi_eval_init(&eval_ctx);
+
+	/* (x > 5) || (x > 3): variable is retrieved by a single instruction. */
+	m0_fdmi_filter_init(&flt[0]);
+	m0_fdmi_filter_root_set(&flt[0], m0_fdmi_flt_op_node_create(M0_FFO_OR,
+				flt_test_gt_create(5), flt_test_gt_create(3)));
+	M0_UT_ASSERT(m0_fdmi_flt_compile(&flt[0]) == 0);
+	M0_UT_ASSERT(flt[0].ff_prog->fp_nr == 6);
+	M0_UT_ASSERT(m0_count(i, flt[0].ff_prog->fp_nr,
+			      flt[0].ff_prog->fp_insn[i].fi_type ==
+			      M0_FFI_VAR) == 1);
+	/* x > 10 */
+	m0_fdmi_filter_init(&flt[1]);
+	m0_fdmi_filter_root_set(&flt[1], flt_test_gt_create(10));
+	M0_UT_ASSERT(m0_fdmi_flt_compile(&flt[1]) == 0);
+
+	/* Value is retrieved once for both filters. */
+	M0_SET0(&var_info);
+	var_info.user_data    = &x;
+	var_info.get_value_cb = flt_test_var_cb;
+	flt_test_var_fetched  = 0;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[0], &var_info) == true);
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[1], &var_info) == false);
+	M0_UT_ASSERT(flt_test_var_fetched == 1);
+
+	/* Next record. */
+	x = 11;
+	M0_SET0(&var_info);
+	var_info.user_data    = &x;
+	var_info.get_value_cb = flt_test_var_cb;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[1], &var_info) == true);
+	M0_UT_ASSERT(flt_test_var_fetched == 2);
+
+	/* Variable cannot be retrieved without callback. */
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[1], NULL) == -EINVAL);
+	m0_fdmi_filter_fini(&flt[1]);
+	m0_fdmi_filter_fini(&flt[0]);
+
+	/* (true || false) || (2 > 1) is computed by the compiler. */
+	m0_fdmi_filter_init(&flt[0]);
+	m0_fdmi_filter_root_set(&flt[0], m0_fdmi_flt_op_node_create(M0_FFO_OR,
+			m0_fdmi_flt_op_node_create(M0_FFO_OR,
+				m0_fdmi_flt_bool_node_create(true),
+				m0_fdmi_flt_bool_node_create(false)),
+			m0_fdmi_flt_op_node_create(M0_FFO_GT,
+				m0_fdmi_flt_int_node_create(2),
+				m0_fdmi_flt_int_node_create(1))));
+	M0_UT_ASSERT(m0_fdmi_flt_compile(&flt[0]) == 0);
+	M0_UT_ASSERT(flt[0].ff_prog->fp_insn[flt[0].ff_prog->fp_root].fi_type ==
+		     M0_FFI_CONST);
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[0], NULL) == true);
+	m0_fdmi_filter_fini(&flt[0]);
+
+	/* Too large filter is evaluated by walking the tree. */
+	root = flt_test_gt_create(0);
+	for (i = 1; i < M0_FDMI_FLT_PROG_NR_MAX; ++i)
+		root = m0_fdmi_flt_op_node_create(M0_FFO_OR, root,
+						  flt_test_gt_create(i));
+	m0_fdmi_filter_init(&flt[0]);
+	m0_fdmi_filter_root_set(&flt[0], root);
+	M0_UT_ASSERT(m0_fdmi_flt_compile(&flt[0]) == -E2BIG);
+	M0_UT_ASSERT(flt[0].ff_prog == NULL);
+	x = 0;
+	M0_SET0(&var_info);
+	var_info.user_data    = &x;
+	var_info.get_value_cb = flt_test_var_cb;
+	flt_test_var_fetched  = 0;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &flt[0], &var_info) == false);
+	M0_UT_ASSERT(flt_test_var_fetched == 1);
+	m0_fdmi_filter_fini(&flt[0]);
+
+	m0_fdmi_eval_fini(&eval_ctx);
+}
+
 /* ------------------------------------------------------------------
  * Test Case: XCode conversions
  * ------------------------------------------------------------------ */
@@ -398,6 +518,7 @@ struct m0_ut_suite fdmi_filter_eval_ut = {
 		{ "simple-or",        flt_eval_simple_or },
 		{ "simple-gt",        flt_eval_simple_gt },
 		{ "callback",         flt_set_op_cb },
+		{ "compiled",         flt_compiled },
 		/** @todo Move to filter tests */
 		{ "filter-xcode-str", flt_eval_flt_xcode_str },
 		{ "filter-str-ops",   flt_str_ops },
@@ -225,7 +225,7 @@ void prepare_rpc_env(struct test_rpc_env         *env,
 	}
 
 	conn_state_set(env->tre_conn, M0_RPC_CONN_ACTIVE);
-	env->tre_conn->c_sender_id = 0xFEFE;
+	m0_rpc_machine_conn_sender_id_set(env->tre_conn, 0xFEFE);
 	m0_rpc_machine_unlock(&env->tre_rpc_machine);
 	M0_ASSERT(rc == 0);
 
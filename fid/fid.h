@@ -38,7 +38,7 @@
 struct m0_fid {
 	uint64_t f_container;
 	uint64_t f_key;
-} M0_XCA_RECORD M0_XCA_DOMAIN(conf|rpc);
+} M0_XCA_RECORD M0_XCA_DOMAIN(conf|rpc) M0_XCA_COMPILED;
 
 struct m0_fid_arr {
 	uint32_t       af_count;
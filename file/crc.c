@@ -122,6 +122,357 @@ static bool md_crc32_cksum_check(void *data, uint64_t len, uint64_t *cksum)
 	return *cksum == md_crc32_cksum(data, len, cksum);
 }
 
+/**
+ * CRC32C (Castagnoli) and xxHash64.
+ *
+ * CRC32C has a dedicated instruction on x86-64 (SSE4.2), so it is the cheap
+ * choice for per-block data integrity. Three variants are provided:
+ *
+ * - slice-by-8 table implementation, used in kernel and on other CPUs;
+ * - a single stream of crc32 instructions;
+ * - three interleaved streams of crc32 instructions, which hides the 3-cycle
+ *   latency of the instruction. Stream checksums are folded together with a
+ *   carry-less multiplication (PCLMULQDQ) by x^(8 * lane - 33) mod P.
+ *
+ * xxHash64 is not a CRC, but it runs at memory speed everywhere, including
+ * kernel and non-x86 CPUs.
+ */
+
+#define CRC32C_POLY       0x82F63B78
+#define CRC32C_SLICE_NR   8
+
+static uint32_t crc32c_table[CRC32C_SLICE_NR][CRC_TABLE_SIZE];
+static bool     crc32c_is_table = false;
+
+static void crc32c_mktable(void)
+{
+	uint32_t crc;
+	int      i;
+	int      j;
+
+	for (i = 0; i < CRC_TABLE_SIZE; i++) {
+		crc = i;
+		for (j = 0; j < CRC_SLICE_SIZE; j++)
+			crc = (crc >> 1) ^ (CRC32C_POLY & -(crc & 1));
+		crc32c_table[0][i] = crc;
+	}
+	for (i = 0; i < CRC_TABLE_SIZE; i++) {
+		crc = crc32c_table[0][i];
+		for (j = 1; j < CRC32C_SLICE_NR; j++) {
+			crc = (crc >> 8) ^ crc32c_table[0][crc & 0xff];
+			crc32c_table[j][i] = crc;
+		}
+	}
+}
+
+static uint32_t crc32c_byte(uint32_t crc, uint8_t byte)
+{
+	return (crc >> 8) ^ crc32c_table[0][(crc ^ byte) & 0xff];
+}
+
+static uint32_t crc32c_scalar(uint32_t crc, const uint8_t *data, uint64_t len)
+{
+	uint64_t word;
+
+	if (!crc32c_is_table) {
+		crc32c_mktable();
+		crc32c_is_table = true;
+	}
+	for (; len > 0 && ((unsigned long)data & 7) != 0; len--)
+		crc = crc32c_byte(crc, *data++);
+	for (; len >= sizeof word; len -= sizeof word, data += sizeof word) {
+		memcpy(&word, data, sizeof word);
+		word ^= crc;
+		crc = crc32c_table[7][word & 0xff] ^
+		      crc32c_table[6][(word >> 8) & 0xff] ^
+		      crc32c_table[5][(word >> 16) & 0xff] ^
+		      crc32c_table[4][(word >> 24) & 0xff] ^
+		      crc32c_table[3][(word >> 32) & 0xff] ^
+		      crc32c_table[2][(word >> 40) & 0xff] ^
+		      crc32c_table[1][(word >> 48) & 0xff] ^
+		      crc32c_table[0][word >> 56];
+	}
+	while (len-- > 0)
+		crc = crc32c_byte(crc, *data++);
+	return crc;
+}
+
+#if defined(__x86_64__) && !defined(__KERNEL__)
+#include <immintrin.h>
+
+enum {
+	/** Lane lengths of the interleaved implementation, in bytes. */
+	CRC32C_LANE_LONG  = 8192,
+	CRC32C_LANE_SHORT = 256,
+};
+
+/** Folding constants: x^(8 * lane - 33) mod P for each lane length. */
+static uint32_t crc32c_k_long;
+static uint32_t crc32c_k_short;
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t *data, uint64_t len)
+{
+	uint64_t c = crc;
+	uint64_t word;
+
+	for (; len > 0 && ((unsigned long)data & 7) != 0; len--)
+		c = _mm_crc32_u8(c, *data++);
+	for (; len >= sizeof word; len -= sizeof word, data += sizeof word) {
+		memcpy(&word, data, sizeof word);
+		c = _mm_crc32_u64(c, word);
+	}
+	while (len-- > 0)
+		c = _mm_crc32_u8(c, *data++);
+	return c;
+}
+
+/** Returns crc of (data || 0^lane) given crc of data, k is lane constant. */
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_shift(uint32_t crc, uint32_t k)
+{
+	__m128i prod = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crc),
+					    _mm_cvtsi32_si128(k), 0);
+
+	return _mm_crc32_u64(0, _mm_cvtsi128_si64(prod));
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_pclmul(uint32_t crc, const uint8_t *data, uint64_t len)
+{
+	const struct {
+		uint64_t lane;
+		uint32_t k;
+	} step[] = {
+		{ CRC32C_LANE_LONG,  crc32c_k_long },
+		{ CRC32C_LANE_SHORT, crc32c_k_short },
+	};
+	uint64_t       c0 = crc;
+	uint64_t       c1;
+	uint64_t       c2;
+	uint64_t       w[3];
+	const uint8_t *end;
+	uint64_t       lane;
+	int            i;
+
+	for (; len > 0 && ((unsigned long)data & 7) != 0; len--)
+		c0 = _mm_crc32_u8(c0, *data++);
+	for (i = 0; i < ARRAY_SIZE(step); i++) {
+		lane = step[i].lane;
+		while (len >= 3 * lane) {
+			c1 = c2 = 0;
+			end = data + lane;
+			do {
+				memcpy(&w[0], data, sizeof w[0]);
+				memcpy(&w[1], data + lane, sizeof w[1]);
+				memcpy(&w[2], data + 2 * lane, sizeof w[2]);
+				c0 = _mm_crc32_u64(c0, w[0]);
+				c1 = _mm_crc32_u64(c1, w[1]);
+				c2 = _mm_crc32_u64(c2, w[2]);
+				data += sizeof w[0];
+			} while (data < end);
+			c0 = crc32c_shift(c0, step[i].k) ^ c1;
+			c0 = crc32c_shift(c0, step[i].k) ^ c2;
+			data += 2 * lane;
+			len  -= 3 * lane;
+		}
+	}
+	return crc32c_sse42(c0, data, len);
+}
+
+/** x^n mod P, bit-reflected. */
+static uint32_t crc32c_xpow(uint64_t n)
+{
+	uint32_t p = M0_BITS(31);
+
+	while (n-- > 0)
+		p = (p >> 1) ^ (CRC32C_POLY & -(p & 1));
+	return p;
+}
+#endif
+
+typedef uint32_t (*crc32c_t)(uint32_t crc, const uint8_t *data, uint64_t len);
+
+static const crc32c_t crc32c_impls[M0_CRC32C_NR] = {
+	[M0_CRC32C_SCALAR] = crc32c_scalar,
+#if defined(__x86_64__) && !defined(__KERNEL__)
+	[M0_CRC32C_SSE42]  = crc32c_sse42,
+	[M0_CRC32C_PCLMUL] = crc32c_pclmul,
+#endif
+};
+
+static enum m0_crc32c_impl crc32c_best = M0_CRC32C_SCALAR;
+static enum m0_crc32c_impl crc32c_impl = M0_CRC32C_SCALAR;
+
+static enum m0_crc32c_impl crc32c_impl_detect(void)
+{
+#if defined(__x86_64__) && !defined(__KERNEL__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.2")) {
+		if (__builtin_cpu_supports("pclmul"))
+			return M0_CRC32C_PCLMUL;
+		return M0_CRC32C_SSE42;
+	}
+#endif
+	return M0_CRC32C_SCALAR;
+}
+
+M0_INTERNAL bool m0_crc32c_impl_set(enum m0_crc32c_impl impl)
+{
+	M0_PRE(impl < M0_CRC32C_NR);
+
+	if (impl > crc32c_best)
+		return false;
+	crc32c_impl = impl;
+	return true;
+}
+
+M0_INTERNAL enum m0_crc32c_impl m0_crc32c_impl_get(void)
+{
+	return crc32c_impl;
+}
+
+M0_INTERNAL enum m0_crc32c_impl m0_crc32c_impl_best(void)
+{
+	return crc32c_best;
+}
+
+M0_INTERNAL void m0_crc32c(const void *data, uint64_t len, uint64_t *cksum)
+{
+	M0_PRE(data != NULL);
+	M0_PRE(cksum != NULL);
+
+	cksum[0] = ~crc32c_impls[crc32c_impl](~0, data, len);
+}
+
+#define XXH_PRIME_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME_3 0x165667B19E3779F9ULL
+#define XXH_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t xxh_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t in)
+{
+	return xxh_rotl(acc + in * XXH_PRIME_2, 31) * XXH_PRIME_1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t v)
+{
+	return (acc ^ xxh_round(0, v)) * XXH_PRIME_1 + XXH_PRIME_4;
+}
+
+static inline uint64_t xxh_read64(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+static inline uint32_t xxh_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+/** xxHash64 with zero seed; little-endian input words, as in the reference. */
+static uint64_t xxh64(const uint8_t *p, uint64_t len)
+{
+	const uint8_t *end = p + len;
+	uint64_t       v[4];
+	uint64_t       h;
+
+	if (len >= 32) {
+		v[0] = XXH_PRIME_1 + XXH_PRIME_2;
+		v[1] = XXH_PRIME_2;
+		v[2] = 0;
+		v[3] = -XXH_PRIME_1;
+		do {
+			v[0] = xxh_round(v[0], xxh_read64(p));
+			v[1] = xxh_round(v[1], xxh_read64(p + 8));
+			v[2] = xxh_round(v[2], xxh_read64(p + 16));
+			v[3] = xxh_round(v[3], xxh_read64(p + 24));
+			p += 32;
+		} while (p + 32 <= end);
+		h = xxh_rotl(v[0], 1) + xxh_rotl(v[1], 7) +
+		    xxh_rotl(v[2], 12) + xxh_rotl(v[3], 18);
+		h = xxh_merge(h, v[0]);
+		h = xxh_merge(h, v[1]);
+		h = xxh_merge(h, v[2]);
+		h = xxh_merge(h, v[3]);
+	} else
+		h = XXH_PRIME_5;
+	h += len;
+	for (; p + 8 <= end; p += 8)
+		h = xxh_rotl(h ^ xxh_round(0, xxh_read64(p)), 27) *
+			XXH_PRIME_1 + XXH_PRIME_4;
+	if (p + 4 <= end) {
+		h = xxh_rotl(h ^ (xxh_read32(p) * XXH_PRIME_1), 23) *
+			XXH_PRIME_2 + XXH_PRIME_3;
+		p += 4;
+	}
+	for (; p < end; p++)
+		h = xxh_rotl(h ^ (*p * XXH_PRIME_5), 11) * XXH_PRIME_1;
+	h ^= h >> 33;
+	h *= XXH_PRIME_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME_3;
+	h ^= h >> 32;
+	return h;
+}
+
+M0_INTERNAL void m0_xxhash64(const void *data, uint64_t len, uint64_t *cksum)
+{
+	M0_PRE(data != NULL);
+	M0_PRE(cksum != NULL);
+
+	cksum[0] = xxh64(data, len);
+}
+
+static const struct m0_cksum_type cksum_types[M0_CKSUM_NR] = {
+	[M0_CKSUM_CRC32] = {
+		.ct_name = "crc32",
+		.ct_sum  = m0_crc32,
+	},
+	[M0_CKSUM_CRC32C] = {
+		.ct_name = "crc32c",
+		.ct_sum  = m0_crc32c,
+	},
+	[M0_CKSUM_XXHASH64] = {
+		.ct_name = "xxhash64",
+		.ct_sum  = m0_xxhash64,
+	},
+};
+
+M0_INTERNAL const struct m0_cksum_type *m0_cksum_type_get(enum m0_cksum algo)
+{
+	M0_PRE(IS_IN_ARRAY(algo, cksum_types));
+
+	return &cksum_types[algo];
+}
+
+M0_INTERNAL void m0_cksum_init(void)
+{
+	if (!crc32c_is_table) {
+		crc32c_mktable();
+		crc32c_is_table = true;
+	}
+#if defined(__x86_64__) && !defined(__KERNEL__)
+	crc32c_k_long  = crc32c_xpow(8 * CRC32C_LANE_LONG - 33);
+	crc32c_k_short = crc32c_xpow(8 * CRC32C_LANE_SHORT - 33);
+#endif
+	crc32c_best = crc32c_impl_detect();
+	crc32c_impl = crc32c_best;
+	M0_LOG(M0_INFO, "crc32c implementation: %d", crc32c_impl);
+}
+
 /** @} end of data_integrity */
 
 /*
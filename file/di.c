@@ -67,9 +67,9 @@ static void	file_checksum(void (*checksum)(const void *data,
 			      const struct m0_indexvec *io_info,
 			      struct di_info *di,
 			      struct m0_bufvec *di_vec);
-static bool	file_checksum_check(bool (*checksum)(const void *data,
+static bool	file_checksum_check(void (*checksum)(const void *data,
 						     m0_bcount_t bsize,
-						     const uint64_t *csum),
+						     uint64_t *csum),
 				    const struct m0_bufvec *in_vec,
 				    const struct m0_indexvec *io_info,
 				    struct di_info *di,
@@ -90,6 +90,21 @@ static struct m0_di_type file_di_crc = {
 	.dt_name = "crc32-4k+t10-ref-tag",
 };
 
+static struct m0_di_type file_di_crc32c = {
+	.dt_name = "crc32c-4k+t10-ref-tag",
+};
+
+static struct m0_di_type file_di_xxhash64 = {
+	.dt_name = "xxhash64-4k+t10-ref-tag",
+};
+
+/** Block attribute holding the checksum of each algorithm. */
+static const enum m0_battr_id cksum_battr[M0_CKSUM_NR] = {
+	[M0_CKSUM_CRC32]    = M0_BI_CKSUM_CRC_32,
+	[M0_CKSUM_CRC32C]   = M0_BI_CKSUM_CRC_32C,
+	[M0_CKSUM_XXHASH64] = M0_BI_CKSUM_XXHASH_64,
+};
+
 static struct m0_di_type file_di_none_type = {
 	.dt_name = "di-none",
 };
@@ -128,6 +143,7 @@ static uint64_t file_di_none_out_shift(const struct m0_file *file)
 static const struct m0_di_ops di_ops[M0_DI_NR] = {
 	[M0_DI_NONE] = {
 		.do_type      = &file_di_none_type,
+		.do_cksum     = M0_CKSUM_CRC32,
 		.do_mask      = file_di_none_mask,
 		.do_in_shift  = file_di_none_in_shift,
 		.do_out_shift = file_di_none_out_shift,
@@ -137,6 +153,27 @@ static const struct m0_di_ops di_ops[M0_DI_NR] = {
 
 	[M0_DI_CRC32_4K] = {
 		.do_type      = &file_di_crc,
+		.do_cksum     = M0_CKSUM_CRC32,
+		.do_mask      = file_di_crc_mask,
+		.do_in_shift  = file_di_crc_in_shift,
+		.do_out_shift = file_di_crc_out_shift,
+		.do_sum       = file_di_crc_sum,
+		.do_check     = file_di_crc_check,
+	},
+
+	[M0_DI_CRC32C_4K] = {
+		.do_type      = &file_di_crc32c,
+		.do_cksum     = M0_CKSUM_CRC32C,
+		.do_mask      = file_di_crc_mask,
+		.do_in_shift  = file_di_crc_in_shift,
+		.do_out_shift = file_di_crc_out_shift,
+		.do_sum       = file_di_crc_sum,
+		.do_check     = file_di_crc_check,
+	},
+
+	[M0_DI_XXHASH64_4K] = {
+		.do_type      = &file_di_xxhash64,
+		.do_cksum     = M0_CKSUM_XXHASH64,
 		.do_mask      = file_di_crc_mask,
 		.do_in_shift  = file_di_crc_in_shift,
 		.do_out_shift = file_di_crc_out_shift,
@@ -147,7 +184,7 @@ static const struct m0_di_ops di_ops[M0_DI_NR] = {
 
 static uint64_t file_di_crc_mask(const struct m0_file *file)
 {
-	return M0_BITS(M0_BI_CKSUM_CRC_32, M0_BI_REF_TAG);
+	return M0_BITS(cksum_battr[file->fi_di_ops->do_cksum], M0_BI_REF_TAG);
 }
 
 static uint64_t file_di_crc_in_shift(const struct m0_file *file)
@@ -174,7 +211,8 @@ static void file_di_crc_sum(const struct m0_file *file,
 
 	file_di_info_setup(file, io_info, &di);
 
-	file_checksum(&m0_crc32, in_vec, io_info, &di, di_vec);
+	file_checksum(m0_cksum_type_get(file->fi_di_ops->do_cksum)->ct_sum,
+		      in_vec, io_info, &di, di_vec);
 	di.d_pos += M0_DI_CRC32_LEN;
 	t10_ref_tag_compute(io_info, &di, di_vec);
 }
@@ -266,8 +304,9 @@ static bool file_di_crc_check(const struct m0_file *file,
 	M0_PRE(io_info != NULL);
 
 	file_di_info_setup(file, io_info, &di);
-	check = file_checksum_check(&m0_crc32_chk, in_vec, io_info, &di,
-				    di_vec);
+	check = file_checksum_check(
+			m0_cksum_type_get(file->fi_di_ops->do_cksum)->ct_sum,
+			in_vec, io_info, &di, di_vec);
 	if (check) {
 		di.d_pos += M0_DI_CRC32_LEN;
 		return t10_ref_tag_check(io_info, &di, di_vec);
@@ -287,9 +326,9 @@ static bool file_di_crc_check(const struct m0_file *file,
  *		    and block size of the data.
  *  @param di_vec   Di data to be verified.
  */
-static bool file_checksum_check(bool (*checksum)(const void *data,
+static bool file_checksum_check(void (*checksum)(const void *data,
 						 m0_bcount_t bsize,
-						 const uint64_t *csum),
+						 uint64_t *csum),
 				const struct m0_bufvec *in_vec,
 				const struct m0_indexvec *io_info,
 				struct di_info *di,
@@ -300,6 +339,7 @@ static bool file_checksum_check(bool (*checksum)(const void *data,
         struct m0_bufvec_cursor  cksum_cur;
 	uint8_t			*blk_data;
 	uint64_t		*cksum;
+	uint64_t		 computed;
 
 	M0_ENTRY();
 	M0_PRE(file_di_invariant(in_vec, di_vec, io_info, di));
@@ -309,8 +349,8 @@ static bool file_checksum_check(bool (*checksum)(const void *data,
 	cksum = m0_bufvec_cursor_addr(&cksum_cur);
 	for (i = 0; i < di->d_blks_nr; i++) {
 		blk_data = m0_bufvec_cursor_addr(&data_cur);
-		if (!checksum(blk_data, di->d_bsize,
-			      cksum + current_pos(di, i)))
+		checksum(blk_data, di->d_bsize, &computed);
+		if (computed != cksum[current_pos(di, i)])
 			return M0_RC(false);
 		m0_bufvec_cursor_move(&data_cur, di->d_bsize);
 	}
@@ -369,6 +409,29 @@ M0_INTERNAL const struct m0_di_ops *m0_di_ops_get(enum m0_di_types di_type)
 	return &di_ops[di_type];
 }
 
+M0_INTERNAL bool m0_di_type_is_supported(uint32_t di_type)
+{
+	return di_type < ARRAY_SIZE(di_ops) && di_ops[di_type].do_type != NULL;
+}
+
+M0_INTERNAL enum m0_di_types m0_file_di_type(const struct m0_file *file)
+{
+	M0_PRE(file->fi_di_ops >= di_ops &&
+	       file->fi_di_ops < di_ops + ARRAY_SIZE(di_ops));
+
+	return file->fi_di_ops - di_ops;
+}
+
+M0_INTERNAL void m0_di_cksum(const struct m0_file *file, const void *data,
+			     uint64_t len, uint64_t *cksum)
+{
+	M0_PRE(file != NULL);
+
+	m0_cksum_type_get(file->fi_di_ops != NULL ?
+			  file->fi_di_ops->do_cksum :
+			  M0_CKSUM_CRC32)->ct_sum(data, len, cksum);
+}
+
 M0_INTERNAL void m0_md_di_set(void *addr, m0_bcount_t nob,
 			      uint64_t *cksum_field)
 {
@@ -77,9 +77,19 @@ enum m0_di_types {
 	M0_DI_CRC32_64K,
 	/** T10 tag for block size data of 4k. */
 	M0_DI_T10_DIF,
+	/** CRC32C checksum for block size data of 4k. */
+	M0_DI_CRC32C_4K,
+	/** xxHash64 checksum for block size data of 4k. */
+	M0_DI_XXHASH64_4K,
 	M0_DI_NR
 };
 
+/**
+ * Di type of files, for which no other type is selected. A client object can
+ * select its own type (m0_obj_attr::oa_di_type), which is sent with each io
+ * fop (m0_fop_cob_rw::crw_di_type) and used by the ioservice to verify the
+ * data.
+ */
 enum {
 	M0_DI_DEFAULT_TYPE =
 #ifdef ENABLE_DATA_INTEGRITY
@@ -89,8 +99,34 @@ enum {
 #endif
 };
 
+/** Checksum algorithms, usable for data blocks and for in-memory buffers. */
+enum m0_cksum {
+	M0_CKSUM_CRC32,
+	M0_CKSUM_CRC32C,
+	M0_CKSUM_XXHASH64,
+	M0_CKSUM_NR
+};
+
+struct m0_cksum_type {
+	const char *ct_name;
+	/** Computes the checksum of "len" bytes of "data" into cksum[0]. */
+	void      (*ct_sum)(const void *data, uint64_t len, uint64_t *cksum);
+};
+
+/** Implementations of m0_crc32c(), in order of increasing speed. */
+enum m0_crc32c_impl {
+	M0_CRC32C_SCALAR,
+	/** crc32 instruction, single stream. */
+	M0_CRC32C_SSE42,
+	/** Three crc32 streams folded with carry-less multiplication. */
+	M0_CRC32C_PCLMUL,
+	M0_CRC32C_NR
+};
+
 struct m0_di_ops {
 	const struct m0_di_type *do_type;
+	/** Checksum algorithm applied to each input block. */
+	enum m0_cksum            do_cksum;
 	/**
 	 * Returns the mask of block attributes (stob/battr.h), used by this
 	 * di type.
@@ -137,6 +173,15 @@ struct m0_di_ops {
 /** Returns di ops for a given di_type. */
 M0_INTERNAL const struct m0_di_ops *m0_di_ops_get(enum m0_di_types di_type);
 
+/**
+ * True iff di ops are implemented for di_type. Used to validate di types
+ * coming from applications and from the network.
+ */
+M0_INTERNAL bool m0_di_type_is_supported(uint32_t di_type);
+
+/** Returns the di type with which the file was initialised. */
+M0_INTERNAL enum m0_di_types m0_file_di_type(const struct m0_file *file);
+
 /**
  * Computes the checksum for the region excluding checksum field and
  * sets this value in the checksum field.
@@ -188,6 +233,38 @@ M0_INTERNAL void m0_crc32(const void *data, uint64_t len,
 M0_INTERNAL bool m0_crc32_chk(const void *data, uint64_t len,
 			      const uint64_t *cksum);
 
+/**
+ * Computes crc32c (Castagnoli) checksum for data of length "len" and stores it
+ * in "cksum". Uses the best implementation supported by the CPU.
+ */
+M0_INTERNAL void m0_crc32c(const void *data, uint64_t len, uint64_t *cksum);
+
+/** Computes xxHash64 of data of length "len" and stores it in "cksum". */
+M0_INTERNAL void m0_xxhash64(const void *data, uint64_t len, uint64_t *cksum);
+
+/**
+ * Switches m0_crc32c() to the given implementation.
+ *
+ * @retval false the implementation is not supported, nothing is changed.
+ */
+M0_INTERNAL bool m0_crc32c_impl_set(enum m0_crc32c_impl impl);
+M0_INTERNAL enum m0_crc32c_impl m0_crc32c_impl_get(void);
+/** The best implementation supported by the CPU. */
+M0_INTERNAL enum m0_crc32c_impl m0_crc32c_impl_best(void);
+
+/** Returns the checksum algorithm descriptor. */
+M0_INTERNAL const struct m0_cksum_type *m0_cksum_type_get(enum m0_cksum algo);
+
+/**
+ * Computes the checksum of a buffer using the algorithm of the file di type.
+ * Files without di ops use crc32, as M0_DI_NONE does.
+ */
+M0_INTERNAL void m0_di_cksum(const struct m0_file *file, const void *data,
+			     uint64_t len, uint64_t *cksum);
+
+/** Builds tables and selects the crc32c implementation. */
+M0_INTERNAL void m0_cksum_init(void);
+
 M0_INTERNAL m0_bcount_t m0_di_size_get(const struct m0_file *file,
 				       const m0_bcount_t size);
 
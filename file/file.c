@@ -571,6 +571,7 @@ const struct m0_fid_type m0_file_fid_type = {
 M0_INTERNAL int m0_file_mod_init(void)
 {
 	m0_fid_type_register(&m0_file_fid_type);
+	m0_cksum_init();
 	return 0;
 }
 
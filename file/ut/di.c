@@ -31,6 +31,8 @@ extern const struct m0_rm_resource_type_ops file_lock_type_ops;
 enum {
 	BUFFER_SIZE = 4096,
 	SEGS_NR	    = 16,
+	/** Covers both lane lengths of the interleaved crc32c. */
+	CRC32C_LANE_LONG_UT = 8192,
 };
 
 struct m0_file		   file;
@@ -85,10 +87,68 @@ void file_checksum_test(void)
 	struct m0_bufvec cksum_data = M0_BUFVEC_INIT_BUF(&di_data, &size);
 
 	file_checksum(&m0_crc32, &data, &io_vec, &di_param, &cksum_data);
-	M0_UT_ASSERT(file_checksum_check(&m0_crc32_chk, &data, &io_vec, &di_param,
+	M0_UT_ASSERT(file_checksum_check(&m0_crc32, &data, &io_vec, &di_param,
 		     &cksum_data));
 }
 
+static uint32_t crc32c_bitwise(const uint8_t *data, uint64_t len)
+{
+	uint32_t crc = ~0;
+	int	 i;
+
+	while (len-- > 0) {
+		crc ^= *data++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (CRC32C_POLY & -(crc & 1));
+	}
+	return ~crc;
+}
+
+void file_cksum_algo_test(void)
+{
+	static const char    check[] = "123456789";
+	uint8_t		    *buf;
+	uint64_t	     cksum;
+	uint64_t	     len;
+	uint64_t	     off;
+	enum m0_crc32c_impl  impl;
+	enum m0_crc32c_impl  saved = m0_crc32c_impl_get();
+	int		     i;
+
+	/* Reference check values of the algorithms. */
+	m0_crc32c(check, sizeof check - 1, &cksum);
+	M0_UT_ASSERT(cksum == 0xe3069283);
+	m0_xxhash64("", 0, &cksum);
+	M0_UT_ASSERT(cksum == 0xef46db3751d8e999ULL);
+	m0_xxhash64("abc", 3, &cksum);
+	M0_UT_ASSERT(cksum == 0x44bc2cf5ad770999ULL);
+
+	/*
+	 * Every crc32c implementation, on unaligned heads, lane-sized bodies
+	 * and short tails, matches the bitwise definition.
+	 */
+	buf = m0_alloc(3 * CRC32C_LANE_LONG_UT + 8);
+	M0_UT_ASSERT(buf != NULL);
+	for (i = 0; i < 3 * CRC32C_LANE_LONG_UT + 8; i++)
+		buf[i] = i * 37 + (i >> 8);
+	for (impl = 0; impl <= m0_crc32c_impl_best(); impl++) {
+		M0_UT_ASSERT(m0_crc32c_impl_set(impl));
+		for (off = 0; off < 8; off += 3) {
+			for (len = 0; len < 3 * CRC32C_LANE_LONG_UT;
+			     len = len * 3 + 1) {
+				m0_crc32c(buf + off, len, &cksum);
+				M0_UT_ASSERT(cksum ==
+					     crc32c_bitwise(buf + off, len));
+			}
+		}
+		m0_crc32c(buf, 3 * CRC32C_LANE_LONG_UT, &cksum);
+		M0_UT_ASSERT(cksum ==
+			     crc32c_bitwise(buf, 3 * CRC32C_LANE_LONG_UT));
+	}
+	m0_crc32c_impl_set(saved);
+	m0_free(buf);
+}
+
 void file_ref_tag_test(void)
 {
 	struct m0_bufvec cksum_data = M0_BUFVEC_INIT_BUF(&di_data, &size);
@@ -108,6 +168,34 @@ void file_di_test(void)
 		     &cksum_data));
 }
 
+void file_di_types_test(void)
+{
+	struct m0_bufvec cksum_data = M0_BUFVEC_INIT_BUF(&di_data, &size);
+	enum m0_di_types types[] = { M0_DI_CRC32C_4K, M0_DI_XXHASH64_4K };
+	uint8_t		 saved;
+	int		 i;
+
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		m0_file_fini(&file);
+		m0_fid_set(&fid, 1, 2 + i);
+		m0_file_init(&file, &fid, &res_dom, types[i]);
+		M0_UT_ASSERT(m0_di_type_is_supported(types[i]));
+		M0_UT_ASSERT(m0_file_di_type(&file) == types[i]);
+		M0_UT_ASSERT(m0_di_size_get(&file, BUFFER_SIZE * SEGS_NR) <=
+			     size);
+
+		file.fi_di_ops->do_sum(&file, &io_vec, &data, &cksum_data);
+		M0_UT_ASSERT(file.fi_di_ops->do_check(&file, &io_vec, &data,
+						      &cksum_data));
+		/* A flipped byte is detected. */
+		saved = ((uint8_t *)data.ov_buf[3])[100];
+		((uint8_t *)data.ov_buf[3])[100] ^= 0x10;
+		M0_UT_ASSERT(!file.fi_di_ops->do_check(&file, &io_vec, &data,
+						       &cksum_data));
+		((uint8_t *)data.ov_buf[3])[100] = saved;
+	}
+}
+
 void file_di_none_test(void)
 {
 	struct m0_bufvec cksum_data = M0_BUFVEC_INIT_BUF(&di_data, &size);
@@ -115,6 +203,9 @@ void file_di_none_test(void)
 	m0_file_fini(&file);
 	m0_fid_set(&fid, 1, 1);
 	m0_file_init(&file, &fid, &res_dom, M0_DI_NONE);
+	M0_UT_ASSERT(file.fi_di_ops->do_cksum == M0_CKSUM_CRC32);
+	M0_UT_ASSERT(!m0_di_type_is_supported(M0_DI_T10_DIF));
+	M0_UT_ASSERT(!m0_di_type_is_supported(M0_DI_NR));
 
 	file.fi_di_ops->do_sum(&file, &io_vec, &data, &cksum_data);
 
@@ -136,8 +227,10 @@ struct m0_ut_suite di_ut = {
 	.ts_tests = {
 		{ "di-init", file_di_init},
 		{ "di-cksum-test", file_checksum_test},
+		{ "di-cksum-algo-test", file_cksum_algo_test},
 		{ "di-ref-tag-test", file_ref_tag_test},
 		{ "di-test", file_di_test},
+		{ "di-types-test", file_di_types_test},
 		{ "di-none-test", file_di_none_test},
 		{ "di-fini", file_di_fini},
 		{ NULL, NULL },
@@ -130,11 +130,43 @@
  * Thread state transitions, associated lists and counters are protected by
  * the group mutex.
  *
+ * <b>Scheduling classes</b>
+ *
+ * The run-queue of a locality is split by scheduling class
+ * (m0_fom_sched_class). fom_dequeue() uses stride scheduling: each class has a
+ * virtual time (m0_fom_runq::rq_pass), advanced by SCHED_STRIDE / weight when a
+ * fom of the class is dequeued. The non-empty class with the smallest pass is
+ * served next, so that over time classes get shares proportional to their
+ * weights. A class that becomes non-empty catches its pass up with the
+ * locality (m0_fom_locality::fl_pass), so that an idle class does not
+ * accumulate credit. Deadlines (m0_fom::fo_deadline) override shares: an
+ * expired fom at the head of a class queue is dequeued first.
+ *
+ * <b>Fom stealing</b>
+ *
+ * A fom is executed in its home locality (m0_fom_ops::fo_home_locality()). With
+ * a skewed distribution of home localities this leaves some cores idle, while
+ * others are overloaded. If m0_fom_domain::fd_steal is set, idle localities
+ * take over ready foms of types marked m0_fom_type::ft_migratable.
+ *
+ * Because a handler thread keeps the group lock all the time, an idle locality
+ * cannot take foms directly from the run-queue of a busy one. Instead, the
+ * idle handler sets m0_fom_locality::fl_hungry before going to sleep and a busy
+ * handler, after executing a phase transition, hands the newest migratable fom
+ * from its run-queue over to a hungry locality (fom_steal()). The fom is
+ * detached from the busy locality and the hand-over completes in an ast
+ * executed by the new locality (stealit()). While the fom is in flight, it is
+ * accounted in m0_fom_domain::fd_migrating.
+ *
  * @{
  */
 
 enum {
 	LOC_IDLE_NR = 1,
+	/** Minimal run-queue length at which a locality gives foms away. */
+	LOC_STEAL_MIN = 2,
+	/** Pass increment of a class with weight 1, see fom_dequeue(). */
+	SCHED_STRIDE = 1 << 16,
 	HUNG_FOP_SEC_PERIOD   = 5,
 	HUNG_FOP_TIME_SEC_MAX = 2*60,
 	HUNG_FOP_TIME_SEC_IEM = 5*60,
@@ -231,9 +263,19 @@ M0_INTERNAL bool m0_fom_group_is_locked(const struct m0_fom *fom)
 	return m0_mutex_is_locked(&fom->fo_loc->fl_group.s_lock);
 }
 
+M0_BASSERT(M0_AVI_RUNQ_BACKGROUND - M0_AVI_RUNQ_BULK + 1 == M0_FSC_NR);
+M0_BASSERT(M0_AVI_RUNQ_WAIT_BACKGROUND - M0_AVI_RUNQ_WAIT_BULK + 1 ==
+	   M0_FSC_NR);
+
+static struct m0_fom_runq *fom_runq(const struct m0_fom *fom)
+{
+	M0_PRE(fom->fo_type->ft_class < M0_FSC_NR);
+	return &fom->fo_loc->fl_runq[fom->fo_type->ft_class];
+}
+
 static bool is_in_runq(const struct m0_fom *fom)
 {
-	return runq_tlist_contains(&fom->fo_loc->fl_runq, fom);
+	return runq_tlist_contains(&fom_runq(fom)->rq_foms, fom);
 }
 
 static bool is_in_wail(const struct m0_fom *fom)
@@ -268,14 +310,21 @@ M0_INTERNAL bool m0_locality_invariant(const struct m0_fom_locality *loc)
 	return
 		_0C(loc != NULL && loc->fl_dom != NULL) &&
 		_0C(m0_mutex_is_locked(&loc->fl_group.s_lock)) &&
-		_0C(M0_CHECK_EX(m0_tlist_invariant(&runq_tl, &loc->fl_runq))) &&
+		_0C(m0_forall(c, M0_FSC_NR,
+			M0_CHECK_EX(m0_tlist_invariant(&runq_tl,
+						&loc->fl_runq[c].rq_foms)))) &&
+		_0C(loc->fl_runq_nr ==
+		    m0_reduce(c, M0_FSC_NR, (size_t)0,
+			      + loc->fl_runq[c].rq_nr)) &&
 		_0C(M0_CHECK_EX(m0_tlist_invariant(&wail_tl, &loc->fl_wail))) &&
 		_0C(m0_tl_forall(thr, t, &loc->fl_threads,
 			     t->lt_loc == loc && thread_invariant(t))) &&
 		_0C(ergo(loc->fl_handler != NULL,
 		     thr_tlist_contains(&loc->fl_threads, loc->fl_handler))) &&
-		_0C(M0_CHECK_EX(m0_tl_forall(runq, fom, &loc->fl_runq,
-					 fom->fo_loc == loc))) &&
+		_0C(m0_forall(c, M0_FSC_NR,
+			M0_CHECK_EX(m0_tl_forall(runq, fom,
+						 &loc->fl_runq[c].rq_foms,
+						 fom->fo_loc == loc)))) &&
 		_0C(M0_CHECK_EX(m0_tl_forall(wail, fom, &loc->fl_wail,
 					 fom->fo_loc == loc)));
 }
@@ -402,6 +451,34 @@ static bool fom_wait_time_is_out(const struct m0_fom_domain *dom,
 	return hung_fom_notify(fom);
 }
 
+static void runq_add(struct m0_fom_locality *loc, struct m0_fom *fom)
+{
+	struct m0_fom_runq *rq    = fom_runq(fom);
+	bool                empty = loc->fl_runq_nr == 0;
+
+	if (rq->rq_nr == 0)
+		rq->rq_pass = max64u(rq->rq_pass, loc->fl_pass);
+	fom->fo_runq_epoch = m0_time_now();
+	runq_tlist_add_tail(&rq->rq_foms, fom);
+	M0_CNT_INC(rq->rq_nr);
+	M0_CNT_INC(loc->fl_runq_nr);
+	m0_addb2_hist_mod(&rq->rq_len, rq->rq_nr);
+	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	if (empty)
+		m0_chan_signal(&loc->fl_runrun);
+}
+
+static void runq_del(struct m0_fom_locality *loc, struct m0_fom *fom)
+{
+	struct m0_fom_runq *rq = fom_runq(fom);
+
+	runq_tlist_del(fom);
+	M0_CNT_DEC(rq->rq_nr);
+	M0_CNT_DEC(loc->fl_runq_nr);
+	m0_addb2_hist_mod(&rq->rq_len, rq->rq_nr);
+	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+}
+
 /**
  * Enqueues fom into locality runq list and increments
  * number of items in runq, m0_fom_locality::fl_runq_nr.
@@ -412,17 +489,8 @@ static bool fom_wait_time_is_out(const struct m0_fom_domain *dom,
  */
 static void fom_ready(struct m0_fom *fom)
 {
-	struct m0_fom_locality *loc;
-	bool                    empty;
-
 	fom_state_set(fom, M0_FOS_READY);
-	loc = fom->fo_loc;
-	empty = runq_tlist_is_empty(&loc->fl_runq);
-	runq_tlist_add_tail(&loc->fl_runq, fom);
-	M0_CNT_INC(loc->fl_runq_nr);
-	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
-	if (empty)
-		m0_chan_signal(&loc->fl_runrun);
+	runq_add(fom->fo_loc, fom);
 	M0_POST(m0_fom_invariant(fom));
 }
 
@@ -632,6 +700,9 @@ M0_INTERNAL void m0_fom_queue(struct m0_fom *fom)
 	loc_idx = fom->fo_ops->fo_home_locality(fom) % dom->fd_localities_nr;
 	M0_ASSERT(loc_idx < dom->fd_localities_nr);
 	fom->fo_loc = dom->fd_localities[loc_idx];
+	if (fom->fo_deadline == 0 && fom->fo_type->ft_deadline != 0)
+		fom->fo_deadline = m0_time_add(m0_time_now(),
+					       fom->fo_type->ft_deadline);
 	m0_fom_sm_init(fom);
 	fom->fo_cb.fc_ast.sa_cb = &queueit;
 	m0_sm_ast_post(&fom->fo_loc->fl_group, &fom->fo_cb.fc_ast);
@@ -844,17 +915,137 @@ static void fom_exec(struct m0_fom *fom)
  */
 static struct m0_fom *fom_dequeue(struct m0_fom_locality *loc)
 {
-	struct m0_fom *fom;
-
-	fom = runq_tlist_pop(&loc->fl_runq);
-	if (fom != NULL) {
-		M0_ASSERT(fom->fo_loc == loc);
-		M0_CNT_DEC(loc->fl_runq_nr);
-		m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	const uint32_t     *weight = loc->fl_dom->fd_class_weight;
+	struct m0_fom_runq *rq     = NULL;
+	struct m0_fom      *fom    = NULL;
+	struct m0_fom      *head;
+	m0_time_t           now;
+	int                 c;
+
+	if (loc->fl_runq_nr == 0)
+		return NULL;
+	now = m0_time_now();
+	/* An expired deadline wins. */
+	for (c = 0; c < M0_FSC_NR; ++c) {
+		head = runq_tlist_head(&loc->fl_runq[c].rq_foms);
+		if (head != NULL && head->fo_deadline != 0 &&
+		    head->fo_deadline <= now &&
+		    (fom == NULL || head->fo_deadline < fom->fo_deadline))
+			fom = head;
 	}
+	if (fom == NULL) {
+		for (c = 0; c < M0_FSC_NR; ++c) {
+			if (loc->fl_runq[c].rq_nr > 0 &&
+			    (rq == NULL ||
+			     loc->fl_runq[c].rq_pass < rq->rq_pass))
+				rq = &loc->fl_runq[c];
+		}
+		fom = runq_tlist_head(&rq->rq_foms);
+	}
+	M0_ASSERT(fom->fo_loc == loc);
+	rq = fom_runq(fom);
+	loc->fl_pass = rq->rq_pass;
+	rq->rq_pass += SCHED_STRIDE / max32u(weight[fom->fo_type->ft_class], 1);
+	runq_del(loc, fom);
+	m0_addb2_hist_mod(&rq->rq_wait,
+			  m0_time_sub(now, fom->fo_runq_epoch) >> 10);
 	return fom;
 }
 
+/**
+ * Re-binds per-locality addb2 state machine counters of a moved fom to the
+ * current locality.
+ */
+static void fom_addb2_rebind(struct m0_fom *fom)
+{
+	const struct m0_sm_conf *conf = fom->fo_sm_phase.sm_conf;
+
+	if (conf->scf_addb2_key > 0)
+		fom->fo_sm_phase.sm_addb2_stats =
+			m0_locality_data(conf->scf_addb2_key - 1);
+	conf = fom->fo_sm_state.sm_conf;
+	fom->fo_sm_state.sm_addb2_stats =
+		m0_locality_data((conf->scf_addb2_key > 0 ?
+				  conf->scf_addb2_key :
+				  fom_states_conf.scf_addb2_key) - 1);
+}
+
+/**
+ * Completes the hand-over started by fom_steal() in the new locality.
+ */
+static void stealit(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	struct m0_fom          *fom = container_of(ast, struct m0_fom, fo_cb.fc_ast);
+	struct m0_fom_locality *loc = fom->fo_loc;
+	struct m0_fom_domain   *dom = loc->fl_dom;
+
+	M0_PRE(grp == &loc->fl_group);
+	M0_PRE(fom->fo_sm_state.sm_state == M0_FOS_READY);
+
+	m0_fom_locality_inc(fom);
+	/* Order matters, see m0_fom_domain_is_idle(). */
+	m0_atomic64_inc(&dom->fd_migrated);
+	m0_atomic64_dec(&dom->fd_migrating);
+	fom_addb2_rebind(fom);
+	++loc->fl_stolen;
+	runq_add(loc, fom);
+	M0_POST(m0_fom_invariant(fom));
+}
+
+static bool fom_is_migratable(const struct m0_fom *fom)
+{
+	return fom->fo_type->ft_migratable && fom->fo_pending == NULL &&
+		fom->fo_cb.fc_state == M0_FCS_DONE;
+}
+
+/**
+ * Hands a ready migratable fom over from a busy locality to a hungry one. See
+ * the "Fom stealing" section.
+ */
+static void fom_steal(struct m0_fom_locality *loc)
+{
+	struct m0_fom_domain   *dom = loc->fl_dom;
+	struct m0_fom_locality *thief = NULL;
+	struct m0_fom          *fom;
+	size_t                  i;
+
+	if (loc->fl_runq_nr < LOC_STEAL_MIN)
+		return;
+	for (i = 1; i < dom->fd_localities_nr && thief == NULL; ++i) {
+		thief = dom->fd_localities[(loc->fl_idx + i) %
+					   dom->fd_localities_nr];
+		if (!thief->fl_hungry)
+			thief = NULL;
+	}
+	if (thief == NULL)
+		return;
+	/* Take the newest fom: it is the least likely to be cache-hot. */
+	for (i = 0, fom = NULL; i < M0_FSC_NR && fom == NULL; ++i) {
+		struct m0_tl *q = &loc->fl_runq[i].rq_foms;
+
+		for (fom = runq_tlist_tail(q);
+		     fom != NULL && !fom_is_migratable(fom);
+		     fom = runq_tlist_prev(q, fom))
+			;
+	}
+	if (fom == NULL)
+		return;
+	thief->fl_hungry = false;
+	m0_addb2_hist_mod(&loc->fl_steal_counter, loc->fl_runq_nr);
+	runq_del(loc, fom);
+	/*
+	 * The fom is still counted in fd_migrating, no need to wake up
+	 * m0_reqh_idle_wait_for().
+	 */
+	m0_atomic64_inc(&dom->fd_migrating);
+	(void)m0_fom_locality_dec(fom);
+	fom->fo_loc = thief;
+	m0_sm_regroup(&fom->fo_sm_phase, &thief->fl_group);
+	m0_sm_regroup(&fom->fo_sm_state, &thief->fl_group);
+	fom->fo_cb.fc_ast.sa_cb = &stealit;
+	m0_sm_ast_post(&thief->fl_group, &fom->fo_cb.fc_ast);
+}
+
 /**
  * Locality handler thread. See the "Locality internals" section.
  */
@@ -921,18 +1112,23 @@ static void loc_handler_thread(struct m0_loc_thread *th)
 				    m0_locality_chores_run(&loc->fl_locality));
 			fom = fom_dequeue(loc);
 			if (fom != NULL) {
+				loc->fl_hungry = false;
 				fom_addb2_push(fom);
 				fom_exec(fom);
 				m0_addb2_pop(M0_AVI_FOM);
+				if (loc->fl_dom->fd_steal)
+					fom_steal(loc);
 			} else if (loc->fl_shutdown)
 				break;
-			else
+			else {
+				loc->fl_hungry = loc->fl_dom->fd_steal;
 				/*
 				 * Yes, sleep with the lock held. Knock on
 				 * &loc->fl_runrun or &loc->fl_group.s_clink to
 				 * wake.
 				 */
 				m0_chan_wait(clink);
+			}
 		}
 		loc->fl_handler = NULL;
 		th->lt_state = IDLE;
@@ -1013,6 +1209,7 @@ static void loc_addb2_fini(struct m0_fom_locality *loc)
 static void loc_fini(struct m0_fom_locality *loc)
 {
 	struct m0_loc_thread *th;
+	int                   i;
 
 	loc->fl_shutdown = true;
 	m0_clink_signal(&loc->fl_group.s_clink);
@@ -1028,7 +1225,10 @@ static void loc_fini(struct m0_fom_locality *loc)
 	}
 	group_unlock(loc);
 
-	runq_tlist_fini(&loc->fl_runq);
+	for (i = 0; i < M0_FSC_NR; ++i) {
+		runq_tlist_fini(&loc->fl_runq[i].rq_foms);
+		M0_ASSERT(loc->fl_runq[i].rq_nr == 0);
+	}
 	M0_ASSERT(loc->fl_runq_nr == 0);
 	wail_tlist_fini(&loc->fl_wail);
 	M0_ASSERT(loc->fl_wail_nr == 0);
@@ -1060,6 +1260,7 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		    size_t idx)
 {
 	int                   res;
+	int                   i;
 	struct m0_addb2_mach *orig = m0_thread_tls()->tls_addb2_mach;
 
 	M0_PRE(loc != NULL);
@@ -1073,7 +1274,8 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		goto err;
 	}
 
-	runq_tlist_init(&loc->fl_runq);
+	for (i = 0; i < M0_FSC_NR; ++i)
+		runq_tlist_init(&loc->fl_runq[i].rq_foms);
 	loc->fl_runq_nr = 0;
 	wail_tlist_init(&loc->fl_wail);
 	loc->fl_wail_nr = 0;
@@ -1086,6 +1288,15 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 	m0_addb2_hist_add(&loc->fl_fom_active,   1, 30, M0_AVI_FOM_ACTIVE, -1);
 	m0_addb2_hist_add(&loc->fl_runq_counter, 1, 30, M0_AVI_RUNQ, -1);
 	m0_addb2_hist_add(&loc->fl_wail_counter, 1, 30, M0_AVI_WAIL, -1);
+	m0_addb2_hist_add(&loc->fl_steal_counter, 1, 30, M0_AVI_FOM_STEAL, -1);
+	if (idx == 0)
+		m0_memory_addb2_add(&loc->fl_mem_total, &loc->fl_mem_class);
+	for (i = 0; i < M0_FSC_NR; ++i) {
+		m0_addb2_hist_add(&loc->fl_runq[i].rq_len, 1, 30,
+				  M0_AVI_RUNQ_BULK + i, -1);
+		m0_addb2_hist_add_auto(&loc->fl_runq[i].rq_wait, 1000,
+				       M0_AVI_RUNQ_WAIT_BULK + i, -1);
+	}
 	m0_addb2_hist_add_auto(&loc->fl_grp_addb2.ga_forq_hist, 1000,
 			       M0_AVI_LOCALITY_FORQ, -1);
 	m0_addb2_hist_add_auto(&loc->fl_chan_addb2.ca_wait_hist, 1000,
@@ -1109,8 +1320,6 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 
 	res = m0_bitmap_init(&loc->fl_processors, dom->fd_localities_nr);
 	if (res == 0) {
-		int i;
-
 		m0_bitmap_set(&loc->fl_processors, idx, true);
 		/* create a pool of idle threads plus the handler thread. */
 		group_lock(loc);
@@ -1157,9 +1366,11 @@ static void hung_foms_notify(struct m0_locality_chore *chore,
 	struct m0_fom_locality *floc = container_of(loc, struct m0_fom_locality,
 						    fl_locality);
 	const struct m0_fom_domain *dom = floc->fl_dom;
+	int                         c;
 
-	(void)m0_tl_forall(runq, fom, &floc->fl_runq,
-			   dom->fd_ops->fdo_time_is_out(dom, fom));
+	for (c = 0; c < M0_FSC_NR; ++c)
+		(void)m0_tl_forall(runq, fom, &floc->fl_runq[c].rq_foms,
+				   dom->fd_ops->fdo_time_is_out(dom, fom));
 	(void)m0_tl_forall(wail, fom, &floc->fl_wail,
 			   dom->fd_ops->fdo_time_is_out(dom, fom));
 }
@@ -1191,6 +1402,11 @@ M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **out)
 		return M0_ERR(-ENOMEM);
 	}
 	dom->fd_ops = &m0_fom_dom_ops;
+	m0_atomic64_set(&dom->fd_migrating, 0);
+	m0_atomic64_set(&dom->fd_migrated, 0);
+	dom->fd_class_weight[M0_FSC_BULK]        = 4;
+	dom->fd_class_weight[M0_FSC_INTERACTIVE] = 8;
+	dom->fd_class_weight[M0_FSC_BACKGROUND]  = 2;
 
 	result = m0_addb2_sys_init(&dom->fd_addb2_sys,
 				   &(struct m0_addb2_config) {
@@ -1271,18 +1487,47 @@ static bool is_loc_locker_empty(struct m0_fom_locality *loc, uint32_t key)
 	return m0_locality_lockers_is_empty(&loc->fl_locality, key);
 }
 
+M0_INTERNAL void m0_fom_sched_class_weight_set(struct m0_fom_domain *dom,
+					       enum m0_fom_sched_class c,
+					       uint32_t weight)
+{
+	M0_PRE(c < M0_FSC_NR);
+	M0_PRE(weight > 0);
+	/* Read by handler threads without locking, see fom_dequeue(). */
+	dom->fd_class_weight[c] = weight;
+}
+
+/**
+ * Checks that no fom was in flight between localities (fom_steal()) while
+ * localities were scanned by the caller. "done" is the value of
+ * m0_fom_domain::fd_migrated sampled before the scan.
+ */
+static bool dom_is_settled(const struct m0_fom_domain *dom, int64_t done)
+{
+	return m0_atomic64_get(&dom->fd_migrating) == 0 &&
+		m0_atomic64_get(&dom->fd_migrated) == done;
+}
+
 M0_INTERNAL bool m0_fom_domain_is_idle_for(const struct m0_reqh_service *svc)
 {
 	struct m0_fom_domain *dom = m0_fom_dom();
-	return m0_forall(i, dom->fd_localities_nr,
-			 is_loc_locker_empty(dom->fd_localities[i],
-					     svc->rs_fom_key));
+	int64_t               done = m0_atomic64_get(&dom->fd_migrated);
+
+	return dom_is_settled(dom, done) &&
+		m0_forall(i, dom->fd_localities_nr,
+			  is_loc_locker_empty(dom->fd_localities[i],
+					      svc->rs_fom_key)) &&
+		dom_is_settled(dom, done);
 }
 
 M0_INTERNAL bool m0_fom_domain_is_idle(const struct m0_fom_domain *dom)
 {
-	return m0_forall(i, dom->fd_localities_nr,
-			 dom->fd_localities[i]->fl_foms == 0);
+	int64_t done = m0_atomic64_get(&dom->fd_migrated);
+
+	return dom_is_settled(dom, done) &&
+		m0_forall(i, dom->fd_localities_nr,
+			  dom->fd_localities[i]->fl_foms == 0) &&
+		dom_is_settled(dom, done);
 }
 
 M0_INTERNAL void m0_fom_locality_inc(struct m0_fom *fom)
@@ -1375,6 +1620,7 @@ void m0_fom_init(struct m0_fom *fom, const struct m0_fom_type *fom_type,
 	fom->fo_ops	    = ops;
 	fom->fo_transitions = 0;
 	fom->fo_local	    = false;
+	fom->fo_deadline    = 0;
 	m0_fom_callback_init(&fom->fo_cb);
 	runq_tlink_init(fom);
 
@@ -233,6 +233,44 @@ struct m0_long_lock;
 /* defined in fom.c */
 struct m0_loc_thread;
 
+/**
+ * Scheduling classes of foms.
+ *
+ * Each locality keeps a separate run-queue for every class. Ready foms are
+ * taken from the class queues in proportion to class weights
+ * (m0_fom_domain::fd_class_weight), so that no class is starved. A fom with an
+ * expired deadline (m0_fom::fo_deadline) at the head of its class queue is
+ * taken before anything else.
+ *
+ * @see m0_fom_type::ft_class
+ */
+enum m0_fom_sched_class {
+	/** Default class: client data i/o and unclassified foms. */
+	M0_FSC_BULK,
+	/** Short latency-sensitive foms: metadata lookups, conf, ha. */
+	M0_FSC_INTERACTIVE,
+	/** Copy machine (repair, rebalance) and other background activity. */
+	M0_FSC_BACKGROUND,
+	M0_FSC_NR
+};
+
+/** Part of a locality run-queue holding foms of a scheduling class. */
+struct m0_fom_runq {
+	struct m0_tl                   rq_foms;
+	size_t                         rq_nr;
+	/**
+	 * Virtual time of the class (stride scheduling). Advanced by a stride
+	 * inversely proportional to the class weight every time a fom of the
+	 * class is dequeued, the non-empty class with the smallest pass goes
+	 * next.
+	 */
+	uint64_t                       rq_pass;
+	/** Queue length histogram. */
+	struct m0_addb2_hist           rq_len;
+	/** Time spent in the run-queue by a fom, in microseconds. */
+	struct m0_addb2_hist           rq_wait;
+};
+
 #define FOM_PHASE_DEBUG (1)
 
 /**
@@ -255,9 +293,12 @@ struct m0_loc_thread;
 struct m0_fom_locality {
 	struct m0_fom_domain          *fl_dom;
 
-	/** Run-queue */
-	struct m0_tl		       fl_runq;
+	/** Run-queue, one per scheduling class. */
+	struct m0_fom_runq             fl_runq[M0_FSC_NR];
+	/** Total number of foms in the run-queue. */
 	size_t			       fl_runq_nr;
+	/** Pass of the most recently dequeued class. */
+	uint64_t                       fl_pass;
 
 	/** Wait list */
 	struct m0_tl		       fl_wail;
@@ -298,6 +339,22 @@ struct m0_fom_locality {
 	struct m0_addb2_hist           fl_fom_active;
 	struct m0_addb2_hist           fl_runq_counter;
 	struct m0_addb2_hist           fl_wail_counter;
+	/** Run-queue length of this locality when a fom is stolen from it. */
+	struct m0_addb2_hist           fl_steal_counter;
+	/** Number of foms this locality stole from other localities. */
+	uint64_t                       fl_stolen;
+	/**
+	 * Process-wide memory accounting sensors, added to locality 0 only,
+	 * see m0_memory_addb2_add().
+	 */
+	struct m0_addb2_sensor         fl_mem_total;
+	struct m0_addb2_sensor         fl_mem_class;
+	/**
+	 * Set by the handler thread when the run-queue is empty, cleared by
+	 * a busy locality that hands a fom over, see fom_steal(). Accessed
+	 * without locking, a spurious hand-over is harmless.
+	 */
+	bool                           fl_hungry;
 	struct m0_addb2_sensor         fl_clock;
 	struct m0_locality             fl_locality;
 	struct m0_sm_group_addb2       fl_grp_addb2;
@@ -336,8 +393,32 @@ struct m0_fom_domain {
 	/** Long living foms detecting chore. */
 	struct m0_locality_chore        fd_hung_foms_chore;
 	struct m0_addb2_sys            *fd_addb2_sys;
+	/**
+	 * If true, idle localities steal migratable (m0_fom_type::ft_migratable)
+	 * foms from busy ones. Off by default.
+	 */
+	bool                            fd_steal;
+	/** Number of foms being moved between localities. */
+	struct m0_atomic64              fd_migrating;
+	/** Number of completed moves, see m0_fom_domain_is_idle(). */
+	struct m0_atomic64              fd_migrated;
+	/**
+	 * Relative shares of scheduling classes, see m0_fom_sched_class and
+	 * m0_fom_sched_class_weight_set().
+	 */
+	uint32_t                        fd_class_weight[M0_FSC_NR];
 };
 
+/**
+ * Sets the share of a scheduling class in all localities of the domain.
+ *
+ * Decreasing the weight of M0_FSC_BACKGROUND throttles repair and rebalance
+ * in favour of client i/o. A class with a non-zero weight is never starved.
+ */
+M0_INTERNAL void m0_fom_sched_class_weight_set(struct m0_fom_domain *dom,
+					       enum m0_fom_sched_class c,
+					       uint32_t weight);
+
 /** Operations vector attached to a domain. */
 struct m0_fom_domain_ops {
 	/**
@@ -527,6 +608,14 @@ struct m0_fom {
 	 * Stack of pending call-backs.
 	 */
 	struct m0_fom_callback   *fo_pending;
+	/**
+	 * Absolute time by which the fom should be scheduled, 0 if none.
+	 * Initialised from m0_fom_type::ft_deadline by m0_fom_queue(), can be
+	 * changed by the fom while it is running.
+	 */
+	m0_time_t                 fo_deadline;
+	/** Time the fom was put in the run-queue. */
+	m0_time_t                 fo_runq_epoch;
 #if FOM_PHASE_DEBUG
 	int                       fo_log[32];
 #endif
@@ -614,6 +703,20 @@ struct m0_fom_type {
 	      struct m0_sm_conf            ft_conf;
 	      struct m0_sm_conf            ft_state_conf;
 	const struct m0_reqh_service_type *ft_rstype;
+	/**
+	 * Foms of this type can be executed in any locality and can be moved
+	 * to another locality when ready (m0_fom_domain::fd_steal). Such a fom
+	 * must not keep locality-local state or call-backs armed across
+	 * phase transitions.
+	 */
+	bool                               ft_migratable;
+	/** Scheduling class of foms of this type. */
+	enum m0_fom_sched_class            ft_class;
+	/**
+	 * If non-zero, foms of this type are queued with m0_fom::fo_deadline
+	 * that much time in the future.
+	 */
+	m0_time_t                          ft_deadline;
 };
 
 /**
@@ -272,6 +272,7 @@ void m0_fop_type_init(struct m0_fop_type *ft,
 
 	m0_fom_type_init(&ft->ft_fom_type, args->opcode,
 			 args->fom_ops, args->svc_type, args->sm);
+	ft->ft_fom_type.ft_class = args->fom_class;
 	m0_rpc_item_type_register(rpc_type);
 	m0_mutex_lock(&fop_types_lock);
 	ft_tlink_init_at(ft, &fop_types_list);
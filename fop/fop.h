@@ -293,6 +293,8 @@ struct __m0_fop_type_init_args {
 	const struct m0_rpc_item_type_ops *rpc_ops;
 	const struct m0_sm_conf           *sm;
 	const struct m0_reqh_service_type *svc_type;
+	/** Scheduling class of the fom type, M0_FSC_BULK by default. */
+	enum m0_fom_sched_class            fom_class;
 };
 
 void m0_fop_type_init(struct m0_fop_type *ft,
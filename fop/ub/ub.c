@@ -37,6 +37,8 @@ static char                    g_mem[8 * (1 << 20)];
 static struct m0_mutex        *g_mutexes;
 static size_t                  g_mutexes_nr;
 static struct m0_long_lock     g_long_lock;
+/* If true, all FOMs have the same home locality. */
+static bool                    g_skewed;
 
 /** Benchmark presets. */
 enum {
@@ -332,7 +334,7 @@ static size_t ub_fom_home_locality(const struct m0_fom *fom)
 	static size_t locality = 0;
 
 	M0_PRE(fom != NULL);
-	return locality++;
+	return g_skewed ? 0 : locality++;
 }
 
 static const struct m0_fom_ops ub_fom_ops = {
@@ -389,6 +391,36 @@ static void reqh_test(struct m0_reqh *reqh, enum scenario test)
 	m0_reqh_idle_wait(reqh);
 }
 
+/**
+ * Runs "mem-KB" scenario with all FOMs homed in the same locality, with or
+ * without fom stealing between localities.
+ */
+static void skewed_test(struct m0_reqh *reqh, bool steal)
+{
+	struct m0_fom_domain *dom = m0_fom_dom();
+	uint64_t              stolen = 0;
+	size_t                i;
+
+	g_skewed = true;
+	dom->fd_steal = steal;
+	reqh_test(reqh, SC_MEM_KB);
+	dom->fd_steal = false;
+	g_skewed = false;
+	for (i = 0; i < dom->fd_localities_nr; ++i)
+		stolen += dom->fd_localities[i]->fl_stolen;
+	M0_LOG(M0_DEBUG, "stolen: %"PRIu64, stolen);
+}
+
+static void ub_fom_skewed(int iter)
+{
+	skewed_test(&g_reqh, false);
+}
+
+static void ub_fom_skewed_steal(int iter)
+{
+	skewed_test(&g_reqh, true);
+}
+
 #define _UB_ROUND_DEFINE(name, test) \
 static void name(int iter)           \
 {                                    \
@@ -420,6 +452,8 @@ static int _init(const char *opts M0_UNUSED)
 
 	m0_fom_type_init(&ub_fom_type, M0_UB_FOM_OPCODE,
 			 &ub_fom_type_ops, &ub_fom_stype, &m0_generic_conf);
+	/* Only matters when stealing is enabled, see skewed_test(). */
+	ub_fom_type.ft_migratable = true;
 
 	/* This benchmark doesn't need network, database and some other
 	 * subsystems for its operation.  Simplistic initialisation
@@ -492,6 +526,12 @@ struct m0_ub_set m0_fom_ub = {
 		{ .ub_name  = "long-lock",
 		  .ub_iter  = 1,
 		  .ub_round = ub_fom_long_lock },
+		{ .ub_name  = "skewed",
+		  .ub_iter  = 1,
+		  .ub_round = ub_fom_skewed },
+		{ .ub_name  = "skewed-steal",
+		  .ub_iter  = 1,
+		  .ub_round = ub_fom_skewed_steal },
 #ifndef ENABLE_PROFILER
 		{ .ub_name  = "block",
 		  .ub_iter  = 1,
@@ -0,0 +1,354 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2017-2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/**
+ * @file
+ *
+ * Tests of locality run-queue scheduling classes and deadlines.
+ *
+ * A "blocker" fom occupies the locality handler, while test foms are queued.
+ * Their queueing asts are executed in one batch when the blocker is released,
+ * so that all test foms are in the run-queue before the first of them is
+ * dequeued. The order in which the foms are executed is recorded and checked.
+ */
+
+#include "lib/errno.h"
+#include "lib/memory.h"
+#include "lib/semaphore.h"
+#include "lib/locality.h"              /* m0_fom_dom */
+#include "rpc/rpc_opcodes.h"
+#include "fop/fom.h"
+#include "reqh/reqh.h"
+#include "reqh/reqh_service.h"
+#include "ut/ut.h"
+
+enum {
+	SC_FOM_NR = 24,
+	/** Foms taken into account by the proportional share test. */
+	SC_SHARE_NR = 12
+};
+
+struct sc_fom {
+	struct m0_fom sc_fom;
+	int           sc_idx;
+};
+
+static struct m0_sm_state_descr sc_fom_phases[] = {
+	[M0_FOM_PHASE_INIT] = {
+		.sd_flags   = M0_SDF_INITIAL,
+		.sd_name    = "init",
+		.sd_allowed = M0_BITS(M0_FOM_PHASE_FINISH)
+	},
+	[M0_FOM_PHASE_FINISH] = {
+		.sd_name    = "finish",
+		.sd_flags   = M0_SDF_TERMINAL,
+	}
+};
+
+static struct m0_sm_conf sc_sm_conf = {
+	.scf_name      = "sc_fom",
+	.scf_nr_states = ARRAY_SIZE(sc_fom_phases),
+	.scf_state     = sc_fom_phases,
+};
+
+static struct m0_fom_type sc_fomt[M0_FSC_NR];
+
+static struct m0_reqh          screqh;
+static struct m0_reqh_service *scsvc;
+
+static struct sc_fom       sc_blocker;
+static struct sc_fom       sc_foms[SC_FOM_NR];
+static struct m0_semaphore sc_blocker_started;
+static struct m0_semaphore sc_blocker_release;
+static struct m0_semaphore sc_fini_sem;
+/** Indices of test foms (sc_foms[]) in the order they were executed. */
+static int                 sc_order[SC_FOM_NR];
+static int                 sc_order_nr;
+
+static void   sc_fom_fini(struct m0_fom *fom);
+static int    sc_fom_tick(struct m0_fom *fom);
+static size_t sc_fom_home_locality(const struct m0_fom *fom);
+
+static const struct m0_fom_ops sc_fom_ops = {
+	.fo_fini          = sc_fom_fini,
+	.fo_tick          = sc_fom_tick,
+	.fo_home_locality = sc_fom_home_locality
+};
+
+static const struct m0_fom_type_ops sc_fom_type_ops = {
+	.fto_create = NULL
+};
+
+/*************************************************/
+/*                  UT service                   */
+/*************************************************/
+
+static int scsvc_start(struct m0_reqh_service *svc)
+{
+	return 0;
+}
+
+static void scsvc_stop(struct m0_reqh_service *svc)
+{
+}
+
+static void scsvc_fini(struct m0_reqh_service *svc)
+{
+	m0_free(svc);
+}
+
+static const struct m0_reqh_service_ops scsvc_ops = {
+	.rso_start_async = &m0_reqh_service_async_start_simple,
+	.rso_start       = &scsvc_start,
+	.rso_stop        = &scsvc_stop,
+	.rso_fini        = &scsvc_fini
+};
+
+static int scsvc_type_allocate(struct m0_reqh_service            **svc,
+			       const struct m0_reqh_service_type  *stype)
+{
+	M0_ALLOC_PTR(*svc);
+	M0_UT_ASSERT(*svc != NULL);
+	(*svc)->rs_type = stype;
+	(*svc)->rs_ops = &scsvc_ops;
+	return 0;
+}
+
+static const struct m0_reqh_service_type_ops scsvc_type_ops = {
+	.rsto_service_allocate = &scsvc_type_allocate
+};
+
+static struct m0_reqh_service_type ut_sc_service_type = {
+	.rst_name     = "sched_ut",
+	.rst_ops      = &scsvc_type_ops,
+	.rst_level    = M0_RS_LEVEL_NORMAL,
+	.rst_typecode = M0_CST_DS1
+};
+
+/*************************************************/
+/*                 FOM routines                  */
+/*************************************************/
+
+static size_t sc_fom_home_locality(const struct m0_fom *fom)
+{
+	return 1;
+}
+
+static int sc_fom_tick(struct m0_fom *fom0)
+{
+	struct sc_fom *fom = M0_AMB(fom, fom0, sc_fom);
+
+	if (fom == &sc_blocker) {
+		m0_semaphore_up(&sc_blocker_started);
+		/* Keep the handler busy while test foms are queued. */
+		m0_semaphore_down(&sc_blocker_release);
+	} else {
+		M0_UT_ASSERT(sc_order_nr < SC_FOM_NR);
+		sc_order[sc_order_nr++] = fom->sc_idx;
+	}
+	m0_fom_phase_set(fom0, M0_FOM_PHASE_FINISH);
+	return M0_FSO_WAIT;
+}
+
+static void sc_fom_fini(struct m0_fom *fom)
+{
+	m0_fom_fini(fom);
+	m0_semaphore_up(&sc_fini_sem);
+}
+
+static void sc_fom_init(struct sc_fom *fom, enum m0_fom_sched_class c,
+			int idx)
+{
+	M0_SET0(fom);
+	fom->sc_idx = idx;
+	m0_fom_init(&fom->sc_fom, &sc_fomt[c], &sc_fom_ops, NULL, NULL,
+		    &screqh);
+}
+
+static enum m0_fom_sched_class sc_class(int idx)
+{
+	return sc_foms[idx].sc_fom.fo_type->ft_class;
+}
+
+/*************************************************/
+/*                 REQH routines                 */
+/*************************************************/
+
+static void sc_reqh_init(void)
+{
+	int rc;
+
+	rc = M0_REQH_INIT(&screqh,
+			  .rhia_dtm     = (void *)1,
+			  .rhia_mdstore = (void *)1,
+			  .rhia_fid     = &g_process_fid);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_reqh_service_allocate(&scsvc, &ut_sc_service_type, NULL);
+	M0_UT_ASSERT(rc == 0);
+	m0_reqh_service_init(scsvc, &screqh, NULL);
+	m0_reqh_service_start(scsvc);
+	m0_reqh_start(&screqh);
+}
+
+static void sc_reqh_fini(void)
+{
+	m0_reqh_service_prepare_to_stop(scsvc);
+	m0_reqh_idle_wait_for(&screqh, scsvc);
+	m0_reqh_service_stop(scsvc);
+	m0_reqh_service_fini(scsvc);
+	m0_reqh_services_terminate(&screqh);
+	m0_reqh_fini(&screqh);
+}
+
+/**
+ * Occupies the locality with the blocker, lets "queue" add test foms and
+ * releases the blocker. Returns after all the foms are finalised.
+ */
+static void sc_run(void (*queue)(void), int nr)
+{
+	int i;
+
+	sc_order_nr = 0;
+	m0_semaphore_init(&sc_blocker_started, 0);
+	m0_semaphore_init(&sc_blocker_release, 0);
+	m0_semaphore_init(&sc_fini_sem, 0);
+	sc_reqh_init();
+	sc_fom_init(&sc_blocker, M0_FSC_INTERACTIVE, -1);
+	m0_fom_queue(&sc_blocker.sc_fom);
+	m0_semaphore_down(&sc_blocker_started);
+	queue();
+	m0_semaphore_up(&sc_blocker_release);
+	for (i = 0; i < nr + 1; ++i)
+		m0_semaphore_down(&sc_fini_sem);
+	sc_reqh_fini();
+	m0_semaphore_fini(&sc_fini_sem);
+	m0_semaphore_fini(&sc_blocker_release);
+	m0_semaphore_fini(&sc_blocker_started);
+	M0_UT_ASSERT(sc_order_nr == nr);
+}
+
+/*************************************************/
+/*                    Test cases                 */
+/*************************************************/
+
+static void share_queue(void)
+{
+	int i;
+
+	/* Interleave classes, so that the queueing order does not matter. */
+	for (i = 0; i < SC_FOM_NR; ++i) {
+		sc_fom_init(&sc_foms[i],
+			    i % 2 == 0 ? M0_FSC_BULK : M0_FSC_BACKGROUND, i);
+		m0_fom_queue(&sc_foms[i].sc_fom);
+	}
+}
+
+/**
+ * With bulk weight 3 times the background weight, bulk foms take 3/4 of the
+ * locality while both classes are ready.
+ */
+static void proportional_share(void)
+{
+	struct m0_fom_domain *dom = m0_fom_dom();
+	uint32_t              bulk = dom->fd_class_weight[M0_FSC_BULK];
+	uint32_t              bg   = dom->fd_class_weight[M0_FSC_BACKGROUND];
+	int                   nr   = 0;
+	int                   i;
+
+	m0_fom_sched_class_weight_set(dom, M0_FSC_BULK, 3);
+	m0_fom_sched_class_weight_set(dom, M0_FSC_BACKGROUND, 1);
+	sc_run(&share_queue, SC_FOM_NR);
+	m0_fom_sched_class_weight_set(dom, M0_FSC_BULK, bulk);
+	m0_fom_sched_class_weight_set(dom, M0_FSC_BACKGROUND, bg);
+
+	for (i = 0; i < SC_SHARE_NR; ++i)
+		nr += sc_class(sc_order[i]) == M0_FSC_BULK;
+	/* 9 bulk foms out of 12, allow for rounding of the start. */
+	M0_UT_ASSERT(nr >= SC_SHARE_NR * 3 / 4 - 1 &&
+		     nr <= SC_SHARE_NR * 3 / 4 + 1);
+	/* Background foms are not starved. */
+	M0_UT_ASSERT(nr < SC_SHARE_NR);
+}
+
+static void deadline_queue(void)
+{
+	int i;
+
+	for (i = 0; i < SC_FOM_NR - 1; ++i) {
+		sc_fom_init(&sc_foms[i], M0_FSC_BULK, i);
+		m0_fom_queue(&sc_foms[i].sc_fom);
+	}
+	/* Queued last, in the class with the smallest weight. */
+	sc_fom_init(&sc_foms[i], M0_FSC_BACKGROUND, i);
+	sc_foms[i].sc_fom.fo_deadline = m0_time_now();
+	m0_fom_queue(&sc_foms[i].sc_fom);
+}
+
+/** A fom with an expired deadline is executed before anything else. */
+static void deadline_first(void)
+{
+	sc_run(&deadline_queue, SC_FOM_NR);
+	M0_UT_ASSERT(sc_order[0] == SC_FOM_NR - 1);
+}
+
+static int sc_suite_init(void)
+{
+	static const uint64_t opcode[M0_FSC_NR] = {
+		[M0_FSC_BULK]        = M0_UT_SCHED_BULK_FOM_OPCODE,
+		[M0_FSC_INTERACTIVE] = M0_UT_SCHED_INTERACTIVE_FOM_OPCODE,
+		[M0_FSC_BACKGROUND]  = M0_UT_SCHED_BACKGROUND_FOM_OPCODE
+	};
+	int c;
+
+	for (c = 0; c < M0_FSC_NR; ++c) {
+		m0_fom_type_init(&sc_fomt[c], opcode[c], &sc_fom_type_ops,
+				 &ut_sc_service_type, &sc_sm_conf);
+		sc_fomt[c].ft_class = c;
+	}
+	return 0;
+}
+
+struct m0_ut_suite fom_sched_ut = {
+	.ts_name = "fom-sched-ut",
+	.ts_init = sc_suite_init,
+	.ts_fini = NULL,
+	.ts_tests = {
+		{ "proportional-share", proportional_share },
+		{ "deadline-first",     deadline_first     },
+		{ NULL, NULL }
+	}
+};
+
+M0_EXPORTED(fom_sched_ut);
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -50,7 +50,8 @@ M0_INTERNAL int m0_ha_state_fop_init(void)
 			 .fom_ops   = m0_ha_state_get_fom_type_ops,
 			 .sm        = &m0_generic_conf,
 			 .svc_type  = &m0_rpc_service_type,
-			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST);
+			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST,
+			 .fom_class = M0_FSC_INTERACTIVE);
 	M0_FOP_TYPE_INIT(&m0_ha_state_get_rep_fopt,
 			 .name      = "HA State Get Reply",
 			 .opcode    = M0_HA_NOTE_GET_REP_OPCODE,
@@ -64,7 +65,8 @@ M0_INTERNAL int m0_ha_state_fop_init(void)
 			 .fom_ops   = m0_ha_state_set_fom_type_ops,
 			 .sm        = &m0_generic_conf,
 			 .svc_type  = &m0_rpc_service_type,
-			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST);
+			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST,
+			 .fom_class = M0_FSC_INTERACTIVE);
 	return 0;
 }
 
@@ -27,6 +27,7 @@
 #include "lib/assert.h"
 #include "lib/misc.h"    /* M0_BITS */
 #include "lib/finject.h"
+#include "lib/objpool.h"
 #include "net/net_internal.h"
 #include "net/buffer_pool.h"
 #include "fop/fop.h"
@@ -49,6 +50,7 @@
 #include "ioservice/fid_convert.h" /* m0_fid_convert_cob2stob */
 #include "balloc/balloc.h"         /* M0_BALLOC_NORMAL_ZONE */
 #include "stob/addb2.h"            /* M0_AVI_STOB_IO_REQ */
+#include "file/di.h"               /* m0_di_ops_get */
 
 /**
    @page DLD-bulk-server DLD of Bulk Server
@@ -592,6 +594,25 @@ M0_INTERNAL struct m0_fop_cob_rw_reply *io_rw_rep_get(struct m0_fop *fop);
 M0_INTERNAL bool m0_is_cob_create_fop(const struct m0_fop *fop);
 M0_INTERNAL bool m0_is_cob_delete_fop(const struct m0_fop *fop);
 
+enum {
+	/** Maximal number of free io foms cached per locality. */
+	IO_FOM_POOL_CAP = 256
+};
+
+/** Pool of io foms, every read or write request allocates one. */
+static struct m0_objpool io_fom_pool;
+
+M0_INTERNAL int m0_io_foms_init(void)
+{
+	return M0_OBJPOOL_INIT(&io_fom_pool, struct m0_io_fom_cob_rw,
+			       "io-fom", IO_FOM_POOL_CAP, NULL, NULL);
+}
+
+M0_INTERNAL void m0_io_foms_fini(void)
+{
+	m0_objpool_fini(&io_fom_pool);
+}
+
 static int m0_io_fom_cob_rw_create(struct m0_fop *fop, struct m0_fom **out,
 				   struct m0_reqh *reqh);
 static int m0_io_fom_cob_rw_tick(struct m0_fom *fom);
@@ -1140,7 +1161,7 @@ static int m0_io_fom_cob_rw_create(struct m0_fop *fop, struct m0_fom **out,
 
 	M0_ENTRY("fop=%p", fop);
 
-	M0_ALLOC_PTR(fom_obj);
+	fom_obj = m0_objpool_alloc(&io_fom_pool);
 	if (fom_obj == NULL)
 		return M0_RC(-ENOMEM);
 
@@ -1148,7 +1169,7 @@ static int m0_io_fom_cob_rw_create(struct m0_fop *fop, struct m0_fom **out,
 		    m0_fop_reply_alloc(fop, &m0_fop_cob_readv_rep_fopt) :
 		    m0_fop_reply_alloc(fop, &m0_fop_cob_writev_rep_fopt);
 	if (rep_fop == NULL) {
-		m0_free(fom_obj);
+		m0_objpool_free(&io_fom_pool, fom_obj);
 		return M0_RC(-ENOMEM);
 	}
 
@@ -1690,6 +1711,7 @@ static int io_launch(struct m0_fom *fom)
 	struct m0_net_buffer    *nb;
 	struct m0_fop_cob_rw    *rwfop;
 	struct m0_file          *file = NULL;
+	struct m0_file           di_file;
 	uint32_t                 index;
 
 	M0_PRE(fom != NULL);
@@ -1708,9 +1730,24 @@ static int io_launch(struct m0_fom *fom)
 	fop   = fom->fo_fop;
 	rwfop = io_rw_get(fop);
 
+	if (!m0_di_type_is_supported(rwfop->crw_di_type)) {
+		rc = M0_ERR(-EPROTO);
+		goto out;
+	}
 	rc = io_fom_cob2file(fom, &rwfop->crw_fid, &file);
 	if (rc != 0)
 		goto out;
+	/* Di data of the fop are computed with the di type of the client. */
+	di_file = (struct m0_file) {
+		.fi_fid    = file->fi_fid,
+		.fi_di_ops = m0_di_ops_get(rwfop->crw_di_type)
+	};
+	if (m0_is_write_fop(fop) && rwfop->crw_di_data.b_nob <
+	    m0_di_size_get(&di_file, m0_io_count(&rwfop->crw_ivec))) {
+		m0_cob_put(container_of(file, struct m0_cob, co_file));
+		rc = M0_ERR(-EPROTO);
+		goto out;
+	}
 
 	/*
 	  Since the upper layer IO block size could differ with IO block size
@@ -1769,8 +1806,9 @@ static int io_launch(struct m0_fom *fom)
 		}
 
 		if (m0_is_write_fop(fop)) {
-			uint32_t di_size = m0_di_size_get(file, ivec_count);
-			uint32_t curr_pos = m0_di_size_get(file,
+			uint32_t di_size = m0_di_size_get(&di_file,
+							  ivec_count);
+			uint32_t curr_pos = m0_di_size_get(&di_file,
 						fom_obj->fcrw_curr_size);
 
 			di_buf = &rwfop->crw_di_data;
@@ -1780,7 +1818,7 @@ static int io_launch(struct m0_fom *fom)
 				cksum_data = (struct m0_bufvec)
 					M0_BUFVEC_INIT_BUF(&buf.b_addr,
 							   &buf.b_nob);
-				M0_ASSERT(file->fi_di_ops->do_check(file,
+				M0_ASSERT(di_file.fi_di_ops->do_check(&di_file,
 					  mem_ivec, &nb->nb_buffer,
 					  &cksum_data));
 			}
@@ -2326,7 +2364,7 @@ static void m0_io_fom_cob_rw_fini(struct m0_fom *fom)
 	if (fom_obj->fcrw_stio != NULL)
 		stob_io_destroy(fom);
 	m0_fom_fini(fom);
-	m0_free(fom_obj);
+	m0_objpool_free(&io_fom_pool, fom_obj);
 }
 
 /**
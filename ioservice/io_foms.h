@@ -271,6 +271,10 @@ struct m0_io_fom_cob_rw_state_transition {
  */
 M0_INTERNAL const char *m0_io_fom_cob_rw_service_name(struct m0_fom *fom);
 
+/** Initialises the pool of read-write foms. */
+M0_INTERNAL int  m0_io_foms_init(void);
+M0_INTERNAL void m0_io_foms_fini(void);
+
 M0_INTERNAL int m0_io_cob_create(struct m0_cob_domain *cdom,
 				 struct m0_fid *fid,
 				 struct m0_fid *pver,
@@ -1403,6 +1403,7 @@ static int io_fop_di_prepare(struct m0_fop *fop)
 #else
 	file    = m0_fop_to_file(fop);
 #endif
+	rw->crw_di_type = m0_file_di_type(file);
 	if (file->fi_di_ops->do_out_shift(file) == 0)
 		return M0_RC(rc);
 	rc = m0_indexvec_wire2mem(io_info, io_info->ci_nr, 0, &io_vec);
@@ -405,6 +405,11 @@ struct m0_fop_cob_rw {
 	uint64_t                  crw_flags;
 	/** Checksum and tag values for the input data blocks. */
 	struct m0_buf		  crw_di_data;
+	/**
+	 * Di type (enum m0_di_types) with which crw_di_data were computed,
+	 * M0_DI_NONE if there are none.
+	 */
+	uint32_t		  crw_di_type;
 } M0_XCA_RECORD M0_XCA_DOMAIN(rpc);
 
 /**
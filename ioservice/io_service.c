@@ -40,6 +40,7 @@
 #include "reqh/reqh.h"
 #include "ioservice/io_fops.h"
 #include "ioservice/io_service.h"
+#include "ioservice/io_foms.h"         /* m0_io_foms_init */
 #include "ioservice/ios_start_sm.h"
 #include "pool/pool.h"
 #include "net/lnet/lnet.h"
@@ -159,9 +160,14 @@ M0_INTERNAL int m0_ios_register(void)
 {
 	int rc;
 
-	rc = m0_ioservice_fop_init();
+	rc = m0_io_foms_init();
 	if (rc != 0)
+		return M0_ERR(rc);
+	rc = m0_ioservice_fop_init();
+	if (rc != 0) {
+		m0_io_foms_fini();
 		return M0_ERR_INFO(rc, "Unable to initialize fops");
+	}
 	m0_reqh_service_type_register(&m0_ios_type);
 	m0_get()->i_ios_cdom_key = m0_reqh_lockers_allot();
 	ios_mds_conn_key = m0_reqh_lockers_allot();
@@ -178,6 +184,7 @@ M0_INTERNAL void m0_ios_unregister(void)
 
 	m0_reqh_service_type_unregister(&m0_ios_type);
 	m0_ioservice_fop_fini();
+	m0_io_foms_fini();
 }
 
 M0_INTERNAL bool m0_reqh_io_service_invariant(const struct m0_reqh_io_service
@@ -96,7 +96,7 @@ static void bulkio_stob_fom_fini(struct m0_fom *fom)
 	fom_obj = container_of(fom, struct m0_io_fom_cob_rw, fcrw_gen);
 	m0_stob_put(fom_obj->fcrw_stob);
 	m0_fom_fini(fom);
-	m0_free(fom);
+	m0_objpool_free(&io_fom_pool, fom_obj);
 }
 
 struct m0_net_buffer_pool * ut_get_buffer_pool(struct m0_fom *fom)
@@ -1752,6 +1752,13 @@ static void bulkio_init(void)
 	 */
 	m0_fi_enable("io_fop_di_prepare", "skip_di_for_ut");
 
+	/*
+	 * io_foms.c is included above, so the foms created by this suite
+	 * come from its own copy of the fom pool, not the io service one.
+	 */
+	rc = m0_io_foms_init();
+	M0_UT_ASSERT(rc == 0);
+
 	M0_ALLOC_PTR(bp);
 	M0_ASSERT(bp != NULL);
 	bulkio_params_init(bp);
@@ -1777,6 +1784,7 @@ static void bulkio_fini(void)
 	bulkio_server_stop(bp->bp_sctx);
 	bulkio_params_fini(bp);
 	m0_free(bp);
+	m0_io_foms_fini();
 
 	m0_fi_disable("io_fop_di_prepare", "skip_di_for_ut");
 }
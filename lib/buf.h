@@ -37,7 +37,7 @@
 struct m0_buf {
 	m0_bcount_t b_nob;
 	void       *b_addr;
-} M0_XCA_SEQUENCE M0_XCA_DOMAIN(conf|rpc);
+} M0_XCA_SEQUENCE M0_XCA_DOMAIN(conf|rpc) M0_XCA_COMPILED;
 
 /** Sequence of memory buffers. */
 struct m0_bufs {
@@ -135,6 +135,12 @@ M0_INTERNAL int m0_arch_pagesize_get(void)
 	return PAGE_SIZE;
 }
 
+M0_INTERNAL unsigned m0_arch_memory_stripe(void)
+{
+	/* Preemption only affects which stripe is updated, not correctness. */
+	return raw_smp_processor_id();
+}
+
 /** @} end of memory group */
 
 /*
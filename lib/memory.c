@@ -35,6 +35,8 @@
 #include "lib/memory.h"
 #include "lib/finject.h"
 #include "lib/misc.h"   /* m0_round_down */
+#include "addb2/addb2.h"
+#include "addb2/identifier.h"
 
 enum { U_POISON_BYTE = 0x5f };
 
@@ -96,18 +98,51 @@ M0_INTERNAL int    m0_arch_pagesize_get(void);
 M0_INTERNAL int    m0_arch_dont_dump(void *p, size_t size);
 M0_INTERNAL int    m0_arch_memory_init (void);
 M0_INTERNAL void   m0_arch_memory_fini (void);
+M0_INTERNAL unsigned m0_arch_memory_stripe(void);
+
+enum {
+	/**
+	 * Number of accounting stripes. A stripe is selected by
+	 * m0_arch_memory_stripe(): by cpu in the kernel and by thread in user
+	 * space, so that concurrent allocations mostly update different cache
+	 * lines.
+	 */
+	MEM_STRIPE_NR = 64
+};
+
+/**
+ * Accounting counters of a stripe. "allocated" of an individual stripe can go
+ * negative, when memory is freed by a thread other than the allocating one.
+ */
+struct mem_stripe {
+	struct m0_atomic64 ms_allocated;
+	struct m0_atomic64 ms_alloc;
+	struct m0_atomic64 ms_free;
+	struct m0_atomic64 ms_class[M0_MEM_CLASS_NR];
+} __attribute__((aligned(128)));
+
+static struct mem_stripe stripes[MEM_STRIPE_NR];
 
-static struct m0_atomic64 allocated;
-static struct m0_atomic64 cumulative_alloc;
-static struct m0_atomic64 cumulative_free;
+static struct mem_stripe *stripe(void)
+{
+	return &stripes[m0_arch_memory_stripe() % MEM_STRIPE_NR];
+}
+
+static unsigned size_class(size_t size)
+{
+	return min_type(unsigned, max_type(unsigned, m0_log2(size), 4) - 4,
+			M0_MEM_CLASS_NR - 1);
+}
 
 static void alloc_tail(void *area, size_t size)
 {
 	if (DEV_MODE && area != NULL) {
-		size_t asize = m0_arch_alloc_size(area);
+		struct mem_stripe *s     = stripe();
+		size_t             asize = m0_arch_alloc_size(area);
 
-		m0_atomic64_add(&allocated, asize);
-		m0_atomic64_add(&cumulative_alloc, asize);
+		m0_atomic64_add(&s->ms_allocated, asize);
+		m0_atomic64_add(&s->ms_alloc, asize);
+		m0_atomic64_inc(&s->ms_class[size_class(size)]);
 	}
 }
 
@@ -150,8 +185,10 @@ void m0_free(void *data)
 		M0_LOG(M0_DEBUG, "%p", data);
 
 		if (DEV_MODE) {
-			m0_atomic64_sub(&allocated, size);
-			m0_atomic64_add(&cumulative_free, size);
+			struct mem_stripe *s = stripe();
+
+			m0_atomic64_sub(&s->ms_allocated, size);
+			m0_atomic64_add(&s->ms_free, size);
 		}
 		poison_before_free(data, size);
 		m0_arch_free(data);
@@ -211,24 +248,88 @@ M0_INTERNAL void m0_free_wired(void *data, size_t size, unsigned shift)
 	}
 }
 
+static int64_t stripes_sum(size_t offset)
+{
+	int64_t sum = 0;
+	int     i;
+
+	for (i = 0; i < MEM_STRIPE_NR; ++i)
+		sum += m0_atomic64_get((void *)&stripes[i] + offset);
+	return sum;
+}
+
+#define STRIPES_SUM(field) stripes_sum(offsetof(struct mem_stripe, field))
+
 M0_INTERNAL size_t m0_allocated(void)
 {
-	return m0_atomic64_get(&allocated);
+	return STRIPES_SUM(ms_allocated);
 }
 M0_EXPORTED(m0_allocated);
 
 M0_INTERNAL size_t m0_allocated_total(void)
 {
-	return m0_atomic64_get(&cumulative_alloc);
+	return STRIPES_SUM(ms_alloc);
 }
 M0_EXPORTED(m0_allocated_total);
 
 M0_INTERNAL size_t m0_freed_total(void)
 {
-	return m0_atomic64_get(&cumulative_free);
+	return STRIPES_SUM(ms_free);
 }
 M0_EXPORTED(m0_freed_total);
 
+M0_INTERNAL void m0_memory_stats_get(struct m0_memory_stats *stats)
+{
+	int i;
+
+	stats->ms_allocated = STRIPES_SUM(ms_allocated);
+	stats->ms_alloc     = STRIPES_SUM(ms_alloc);
+	stats->ms_free      = STRIPES_SUM(ms_free);
+	for (i = 0; i < M0_MEM_CLASS_NR; ++i)
+		stats->ms_class[i] = STRIPES_SUM(ms_class[i]);
+}
+
+#undef STRIPES_SUM
+
+static void mem_total_snapshot(struct m0_addb2_sensor *s, uint64_t *area)
+{
+	struct m0_memory_stats stats;
+
+	m0_memory_stats_get(&stats);
+	area[0] = stats.ms_allocated;
+	area[1] = stats.ms_alloc;
+	area[2] = stats.ms_free;
+}
+
+static void mem_class_snapshot(struct m0_addb2_sensor *s, uint64_t *area)
+{
+	struct m0_memory_stats stats;
+
+	m0_memory_stats_get(&stats);
+	memcpy(area, stats.ms_class, sizeof stats.ms_class);
+}
+
+static void mem_sensor_fini(struct m0_addb2_sensor *s)
+{;}
+
+static const struct m0_addb2_sensor_ops mem_total_ops = {
+	.so_snapshot = &mem_total_snapshot,
+	.so_fini     = &mem_sensor_fini
+};
+
+static const struct m0_addb2_sensor_ops mem_class_ops = {
+	.so_snapshot = &mem_class_snapshot,
+	.so_fini     = &mem_sensor_fini
+};
+
+M0_INTERNAL void m0_memory_addb2_add(struct m0_addb2_sensor *total,
+				     struct m0_addb2_sensor *classes)
+{
+	m0_addb2_sensor_add(total, M0_AVI_MEM, 3, -1, &mem_total_ops);
+	m0_addb2_sensor_add(classes, M0_AVI_MEM_CLASS, M0_MEM_CLASS_NR, -1,
+			    &mem_class_ops);
+}
+
 M0_INTERNAL int m0_pagesize_get(void)
 {
 	return m0_arch_pagesize_get();
@@ -244,18 +345,18 @@ M0_INTERNAL int m0_dont_dump(void *p, size_t size)
 
 M0_INTERNAL int m0_memory_init(void)
 {
-	m0_atomic64_set(&allocated, 0);
-	m0_atomic64_set(&cumulative_alloc, 0);
-	m0_atomic64_set(&cumulative_free, 0);
+	M0_SET_ARR0(stripes);
 	return m0_arch_memory_init();
 }
 
 M0_INTERNAL void m0_memory_fini(void)
 {
+	struct m0_memory_stats stats;
+
+	m0_memory_stats_get(&stats);
 	M0_LOG(M0_DEBUG, "allocated=%"PRIu64" cumulative_alloc=%"PRIu64" "
-	       "cumulative_free=%"PRIu64, m0_atomic64_get(&allocated),
-	       m0_atomic64_get(&cumulative_alloc),
-	       m0_atomic64_get(&cumulative_free));
+	       "cumulative_free=%"PRIu64, stats.ms_allocated,
+	       stats.ms_alloc, stats.ms_free);
 	m0_arch_memory_fini();
 }
 
@@ -145,6 +145,39 @@ M0_INTERNAL size_t m0_allocated_total(void);
  */
 M0_INTERNAL size_t m0_freed_total(void);
 
+enum {
+	/**
+	 * Number of allocation size classes. Class i counts allocations of
+	 * [2^(i + 4), 2^(i + 5)) bytes, the first and the last classes are
+	 * open-ended.
+	 */
+	M0_MEM_CLASS_NR = 12
+};
+
+/** Memory accounting, maintained in ENABLE_DEV_MODE builds only. */
+struct m0_memory_stats {
+	uint64_t ms_allocated;
+	uint64_t ms_alloc;
+	uint64_t ms_free;
+	/** Number of m0_alloc() calls per size class. */
+	uint64_t ms_class[M0_MEM_CLASS_NR];
+};
+
+/**
+ * Aggregates per-cpu accounting counters. The result is a snapshot, it is not
+ * atomic with respect to concurrent allocations.
+ */
+M0_INTERNAL void m0_memory_stats_get(struct m0_memory_stats *stats);
+
+struct m0_addb2_sensor;
+
+/**
+ * Adds addb2 sensors, periodically reporting memory totals (M0_AVI_MEM) and
+ * the size class histogram (M0_AVI_MEM_CLASS) in the current addb2 context.
+ */
+M0_INTERNAL void m0_memory_addb2_add(struct m0_addb2_sensor *total,
+				     struct m0_addb2_sensor *classes);
+
 /**
  * Same as system getpagesize(3).
  * Used in the code shared between user and kernel.
@@ -0,0 +1,224 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_LIB
+#include "lib/trace.h"
+#include "lib/objpool.h"
+#include "lib/memory.h"
+#include "lib/mutex.h"
+#include "lib/errno.h"
+#include "lib/locality.h"   /* m0_locality_here */
+#include "lib/misc.h"       /* M0_SET0 */
+#include "motr/magic.h"
+
+/**
+ * @addtogroup objpool
+ *
+ * Every object is preceded by a header, which links the object into a free
+ * list and identifies pool objects in m0_objpool_free().
+ *
+ * @{
+ */
+
+struct objpool_hdr {
+	struct objpool_hdr *oh_next;
+	uint64_t            oh_magic;
+};
+
+/** Free list of a locality. */
+struct objpool_loc {
+	struct m0_mutex     ol_lock;
+	struct objpool_hdr *ol_free;
+	uint32_t            ol_nr;
+	uint64_t            ol_alloc;
+	uint64_t            ol_hit;
+	uint64_t            ol_free_nr;
+	uint64_t            ol_release;
+};
+
+static struct objpool_loc *loc_here(struct m0_objpool *pool)
+{
+	return &pool->op_loc[m0_locality_here()->lo_idx % M0_OBJPOOL_LOC_NR];
+}
+
+static void *hdr2obj(struct objpool_hdr *hdr)
+{
+	return hdr + 1;
+}
+
+static struct objpool_hdr *obj2hdr(void *obj)
+{
+	return (struct objpool_hdr *)obj - 1;
+}
+
+static void obj_release(struct m0_objpool *pool, struct objpool_hdr *hdr)
+{
+	if (pool->op_dtor != NULL)
+		pool->op_dtor(hdr2obj(hdr));
+	m0_free(hdr);
+}
+
+M0_INTERNAL int m0_objpool_init(struct m0_objpool *pool, const char *name,
+				size_t size, uint32_t cap,
+				void (*ctor)(void *obj),
+				void (*dtor)(void *obj))
+{
+	int i;
+
+	M0_PRE(size > 0);
+
+	*pool = (struct m0_objpool) {
+		.op_name = name,
+		.op_size = size,
+		.op_cap  = cap,
+		.op_ctor = ctor,
+		.op_dtor = dtor
+	};
+	M0_ALLOC_ARR(pool->op_loc, M0_OBJPOOL_LOC_NR);
+	if (pool->op_loc == NULL)
+		return M0_ERR(-ENOMEM);
+	for (i = 0; i < M0_OBJPOOL_LOC_NR; ++i)
+		m0_mutex_init(&pool->op_loc[i].ol_lock);
+	return M0_RC(0);
+}
+
+M0_INTERNAL void m0_objpool_fini(struct m0_objpool *pool)
+{
+	struct m0_objpool_stats st;
+	struct objpool_loc     *loc;
+	struct objpool_hdr     *hdr;
+	int                     i;
+
+	m0_objpool_stats_get(pool, &st);
+	M0_LOG(M0_DEBUG, "%s: alloc=%"PRIu64" hit=%"PRIu64" free=%"PRIu64
+	       " release=%"PRIu64, pool->op_name, st.ops_alloc, st.ops_hit,
+	       st.ops_free, st.ops_release);
+	M0_ASSERT_INFO(st.ops_alloc == st.ops_free, "%s: %"PRIu64" objects "
+		       "are not returned", pool->op_name,
+		       st.ops_alloc - st.ops_free);
+	for (i = 0; i < M0_OBJPOOL_LOC_NR; ++i) {
+		loc = &pool->op_loc[i];
+		while ((hdr = loc->ol_free) != NULL) {
+			loc->ol_free = hdr->oh_next;
+			obj_release(pool, hdr);
+		}
+		m0_mutex_fini(&loc->ol_lock);
+	}
+	m0_free(pool->op_loc);
+	M0_SET0(pool);
+}
+
+M0_INTERNAL void *m0_objpool_alloc(struct m0_objpool *pool)
+{
+	struct objpool_loc *loc = loc_here(pool);
+	struct objpool_hdr *hdr;
+
+	m0_mutex_lock(&loc->ol_lock);
+	++loc->ol_alloc;
+	hdr = loc->ol_free;
+	if (hdr != NULL) {
+		loc->ol_free = hdr->oh_next;
+		--loc->ol_nr;
+		++loc->ol_hit;
+	}
+	m0_mutex_unlock(&loc->ol_lock);
+
+	if (hdr != NULL) {
+		M0_ASSERT(hdr->oh_magic == M0_LIB_OBJPOOL_MAGIC);
+		if (pool->op_ctor == NULL)
+			memset(hdr2obj(hdr), 0, pool->op_size);
+	} else {
+		hdr = m0_alloc(sizeof *hdr + pool->op_size);
+		if (hdr == NULL) {
+			m0_mutex_lock(&loc->ol_lock);
+			--loc->ol_alloc;
+			m0_mutex_unlock(&loc->ol_lock);
+			return NULL;
+		}
+		hdr->oh_magic = M0_LIB_OBJPOOL_MAGIC;
+		if (pool->op_ctor != NULL)
+			pool->op_ctor(hdr2obj(hdr));
+	}
+	hdr->oh_next = NULL;
+	return hdr2obj(hdr);
+}
+
+M0_INTERNAL void m0_objpool_free(struct m0_objpool *pool, void *obj)
+{
+	struct objpool_loc *loc;
+	struct objpool_hdr *hdr;
+	bool                cache;
+
+	if (obj == NULL)
+		return;
+	hdr = obj2hdr(obj);
+	M0_PRE(hdr->oh_magic == M0_LIB_OBJPOOL_MAGIC);
+	loc = loc_here(pool);
+	m0_mutex_lock(&loc->ol_lock);
+	++loc->ol_free_nr;
+	cache = loc->ol_nr < pool->op_cap;
+	if (cache) {
+		hdr->oh_next = loc->ol_free;
+		loc->ol_free = hdr;
+		++loc->ol_nr;
+	} else
+		++loc->ol_release;
+	m0_mutex_unlock(&loc->ol_lock);
+	if (!cache)
+		obj_release(pool, hdr);
+}
+
+M0_INTERNAL void m0_objpool_stats_get(const struct m0_objpool *pool,
+				      struct m0_objpool_stats *stats)
+{
+	struct objpool_loc *loc;
+	int                 i;
+
+	M0_SET0(stats);
+	for (i = 0; i < M0_OBJPOOL_LOC_NR; ++i) {
+		loc = &pool->op_loc[i];
+		m0_mutex_lock(&loc->ol_lock);
+		stats->ops_alloc   += loc->ol_alloc;
+		stats->ops_hit     += loc->ol_hit;
+		stats->ops_free    += loc->ol_free_nr;
+		stats->ops_release += loc->ol_release;
+		stats->ops_cached  += loc->ol_nr;
+		m0_mutex_unlock(&loc->ol_lock);
+	}
+}
+
+#undef M0_TRACE_SUBSYSTEM
+
+/** @} end of objpool group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
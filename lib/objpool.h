@@ -0,0 +1,129 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_LIB_OBJPOOL_H__
+#define __MOTR_LIB_OBJPOOL_H__
+
+#include "lib/types.h"
+
+/**
+ * @defgroup objpool Object pool
+ *
+ * Cache of free objects of a fixed size, used for objects that are allocated
+ * and freed on every request.
+ *
+ * Freed objects are kept on a free list of the locality, where they are freed
+ * (m0_locality_here()), up to m0_objpool::op_cap objects per locality; the
+ * excess is returned to the general purpose allocator. m0_objpool_alloc()
+ * takes an object from the free list of the current locality, so that in
+ * steady state request processing does not call m0_alloc().
+ *
+ * Constructor and destructor are optional. The constructor is called when an
+ * object is obtained from m0_alloc(), the destructor before the object is
+ * returned to m0_free(). When a constructor is supplied, the user must return
+ * objects to the pool in the constructed state, and m0_objpool_alloc() does
+ * not zero them. Without a constructor, m0_objpool_alloc() returns zeroed
+ * objects, like M0_ALLOC_PTR().
+ *
+ * Objects allocated from a pool must be freed with m0_objpool_free() to the
+ * same pool, never with m0_free().
+ *
+ * @code
+ * static struct m0_objpool foo_pool;
+ *
+ * rc = M0_OBJPOOL_INIT(&foo_pool, struct foo, "foo", 256, NULL, NULL);
+ * ...
+ * foo = m0_objpool_alloc(&foo_pool);
+ * ...
+ * m0_objpool_free(&foo_pool, foo);
+ * ...
+ * m0_objpool_fini(&foo_pool);
+ * @endcode
+ *
+ * @{
+ */
+
+struct objpool_loc;
+
+enum {
+	/** Number of per-locality free lists in a pool. */
+	M0_OBJPOOL_LOC_NR = 64
+};
+
+/** Pool statistics, summed over localities. */
+struct m0_objpool_stats {
+	/** Calls to m0_objpool_alloc(). */
+	uint64_t ops_alloc;
+	/** Allocations served from a free list. */
+	uint64_t ops_hit;
+	/** Calls to m0_objpool_free(). */
+	uint64_t ops_free;
+	/** Objects returned to m0_free(), because a free list was full. */
+	uint64_t ops_release;
+	/** Objects currently on the free lists. */
+	uint64_t ops_cached;
+};
+
+struct m0_objpool {
+	const char          *op_name;
+	size_t               op_size;
+	/** Maximal number of free objects cached per locality. */
+	uint32_t             op_cap;
+	void               (*op_ctor)(void *obj);
+	void               (*op_dtor)(void *obj);
+	struct objpool_loc  *op_loc;
+};
+
+M0_INTERNAL int  m0_objpool_init(struct m0_objpool *pool, const char *name,
+				 size_t size, uint32_t cap,
+				 void (*ctor)(void *obj),
+				 void (*dtor)(void *obj));
+/** Releases cached objects. All objects must have been returned. */
+M0_INTERNAL void m0_objpool_fini(struct m0_objpool *pool);
+
+/** Returns NULL if the pool is empty and memory cannot be allocated. */
+M0_INTERNAL void *m0_objpool_alloc(struct m0_objpool *pool);
+M0_INTERNAL void  m0_objpool_free(struct m0_objpool *pool, void *obj);
+
+M0_INTERNAL void m0_objpool_stats_get(const struct m0_objpool *pool,
+				      struct m0_objpool_stats *stats);
+
+#define M0_OBJPOOL_INIT(pool, type, name, cap, ctor, dtor)	\
+	m0_objpool_init((pool), (name), sizeof(type), (cap), (ctor), (dtor))
+
+/** @} end of objpool group */
+#endif /* __MOTR_LIB_OBJPOOL_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -28,6 +28,7 @@
 #include "lib/arith.h"   /* min_type, m0_is_po2 */
 #include "lib/assert.h"
 #include "lib/memory.h"
+#include "lib/atomic.h"
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_MEMORY
 #include "lib/trace.h"
@@ -216,6 +217,20 @@ M0_INTERNAL int m0_arch_pagesize_get()
 	return getpagesize();
 }
 
+/**
+ * Threads are assigned accounting stripes round-robin, on their first
+ * accounted allocation.
+ */
+M0_INTERNAL unsigned m0_arch_memory_stripe(void)
+{
+	static struct m0_atomic64 next;
+	static __thread unsigned  stripe = 0;
+
+	if (stripe == 0)
+		stripe = m0_atomic64_add_return(&next, 1);
+	return stripe;
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /** @} end of memory group */
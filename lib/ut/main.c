@@ -37,6 +37,7 @@ extern void test_getopts(void);
 extern void test_list(void);
 extern void test_lockers(void);
 extern void test_memory(void);
+extern void test_objpool(void);
 extern void m0_test_misc(void);
 extern void test_mutex(void);
 extern void test_processor(void);
@@ -81,6 +82,7 @@ struct m0_ut_suite libm0_ut = {
 		{ "lockers",          test_lockers       },
 		{ "memory",           test_memory        },
 		{ "misc",             m0_test_misc       },
+		{ "objpool",          test_objpool       },
 		{ "mutex",            test_mutex         },
 		{ "rwlock",           test_rw            },
 		{ "processor",        test_processor     },
@@ -32,13 +32,23 @@ struct test1 {
 
 void test_memory(void)
 {
-	void         *ptr1;
-	struct test1 *ptr2;
-	size_t        allocated;
-	int           i;
+	void                  *ptr1;
+	struct test1          *ptr2;
+	size_t                 allocated;
+	int                    i;
+	struct m0_memory_stats before;
+	struct m0_memory_stats after;
+
 	allocated = m0_allocated();
+	m0_memory_stats_get(&before);
 	ptr1 = m0_alloc(100);
 	M0_UT_ASSERT(ptr1 != NULL);
+	m0_memory_stats_get(&after);
+#ifdef ENABLE_DEV_MODE
+	/* 100 bytes fall into [64, 128) class. */
+	M0_UT_ASSERT(after.ms_class[2] > before.ms_class[2]);
+	M0_UT_ASSERT(after.ms_alloc >= before.ms_alloc + 100);
+#endif
 
 	M0_ALLOC_PTR(ptr2);
 	M0_UT_ASSERT(ptr2 != NULL);
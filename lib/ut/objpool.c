@@ -0,0 +1,119 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "ut/ut.h"
+#include "lib/objpool.h"
+#include "lib/misc.h"           /* M0_SET_ARR0 */
+
+enum {
+	OBJ_CAP = 4,
+	OBJ_NR  = 10
+};
+
+struct obj {
+	uint64_t o_state;
+	char     o_payload[100];
+};
+
+static int ctor_nr;
+static int dtor_nr;
+
+static void obj_ctor(void *o)
+{
+	((struct obj *)o)->o_state = 0xc0;
+	++ctor_nr;
+}
+
+static void obj_dtor(void *o)
+{
+	M0_UT_ASSERT(((struct obj *)o)->o_state == 0xc0);
+	++dtor_nr;
+}
+
+void test_objpool(void)
+{
+	struct m0_objpool       pool;
+	struct m0_objpool_stats st;
+	struct obj             *objs[OBJ_NR];
+	struct obj             *o;
+	int                     rc;
+	int                     i;
+
+	/* Without constructor objects are zeroed. */
+	rc = M0_OBJPOOL_INIT(&pool, struct obj, "ut", OBJ_CAP, NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+	o = m0_objpool_alloc(&pool);
+	M0_UT_ASSERT(o != NULL);
+	o->o_state = 1;
+	m0_objpool_free(&pool, o);
+	o = m0_objpool_alloc(&pool);
+	M0_UT_ASSERT(o != NULL && o->o_state == 0);
+	m0_objpool_free(&pool, o);
+	m0_objpool_stats_get(&pool, &st);
+	/*
+	 * The thread can migrate to another locality between calls, so the
+	 * number of hits is not checked exactly here and below.
+	 */
+	M0_UT_ASSERT(st.ops_alloc == 2 && st.ops_hit <= 1 &&
+		     st.ops_free == 2 && st.ops_cached + st.ops_release == 2);
+	m0_objpool_fini(&pool);
+
+	/* Constructed objects are reused, free lists are capped. */
+	ctor_nr = dtor_nr = 0;
+	rc = M0_OBJPOOL_INIT(&pool, struct obj, "ut-ctor", OBJ_CAP,
+			     &obj_ctor, &obj_dtor);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < OBJ_NR; ++i) {
+		objs[i] = m0_objpool_alloc(&pool);
+		M0_UT_ASSERT(objs[i] != NULL && objs[i]->o_state == 0xc0);
+	}
+	M0_UT_ASSERT(ctor_nr == OBJ_NR);
+	for (i = 0; i < OBJ_NR; ++i)
+		m0_objpool_free(&pool, objs[i]);
+	M0_UT_ASSERT(dtor_nr <= OBJ_NR - OBJ_CAP);
+	m0_objpool_stats_get(&pool, &st);
+	M0_UT_ASSERT(st.ops_release == dtor_nr &&
+		     st.ops_cached == OBJ_NR - dtor_nr);
+	for (i = 0; i < OBJ_CAP; ++i)
+		objs[i] = m0_objpool_alloc(&pool);
+	for (i = 0; i < OBJ_CAP; ++i)
+		m0_objpool_free(&pool, objs[i]);
+	m0_objpool_stats_get(&pool, &st);
+	M0_UT_ASSERT(st.ops_alloc == OBJ_NR + OBJ_CAP &&
+		     st.ops_hit + ctor_nr == st.ops_alloc &&
+		     st.ops_cached + st.ops_release == ctor_nr);
+	m0_objpool_fini(&pool);
+	M0_UT_ASSERT(dtor_nr == ctor_nr);
+}
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
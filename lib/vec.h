@@ -615,7 +615,7 @@ struct m0_ioseg {
 struct m0_io_indexvec {
 	uint32_t         ci_nr;
 	struct m0_ioseg *ci_iosegs;
-} M0_XCA_SEQUENCE M0_XCA_DOMAIN(rpc);
+} M0_XCA_SEQUENCE M0_XCA_DOMAIN(rpc) M0_XCA_COMPILED;
 
 /**
  * Represents sequence of index vector, one per network buffer.
@@ -716,6 +716,14 @@ struct m0_obj_attr {
 
 	/** Pool version fid */
 	struct m0_fid oa_pver;
+
+	/**
+	 * Data integrity type (enum m0_di_types) of the object IO, 0 selects
+	 * the default type. Ignored, unless motr is built with data integrity.
+	 * It is not stored with the object, so it must be set every time the
+	 * object is initialised.
+	 */
+	uint32_t      oa_di_type;
 };
 
 /**
@@ -894,6 +902,19 @@ struct m0_config {
  	 * ADDB size
  	 */
 	m0_bcount_t mc_addb_size;
+
+	/**
+	 * Memory budget of the client read cache in bytes, 0 disables the
+	 * cache. See @ref client_io_cache.
+	 */
+	m0_bcount_t mc_read_cache_size;
+
+	/**
+	 * Number of client threads computing parity of the parity groups of
+	 * a write in parallel. 0 computes parity in the context of the
+	 * operation. Ignored in the kernel.
+	 */
+	uint32_t    mc_parity_threads;
 };
 
 /** The identifier of the root of realm hierarchy. */
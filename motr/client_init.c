@@ -1604,6 +1604,24 @@ int m0_client_init(struct m0_client **m0c_p,
 	/* Init the hash-table for RM contexts */
 	rm_ctx_htable_init(&m0c->m0c_rm_ctxs, M0_RM_HBUCKET_NR);
 
+	m0_io_cache_init(&m0c->m0c_read_cache, conf->mc_read_cache_size);
+
+#ifndef __KERNEL__
+	m0_mutex_init(&m0c->m0c_parity_lock);
+	if (conf->mc_parity_threads > 0) {
+		rc = m0_parallel_pool_init(&m0c->m0c_parity_pool,
+					   conf->mc_parity_threads,
+					   conf->mc_parity_threads *
+					   M0_PARITY_POOL_JOBS_PER_THREAD);
+		if (rc == 0)
+			m0c->m0c_parity_pool_on = true;
+		else
+			M0_LOG(M0_WARN, "Parallel parity is disabled: rc=%d",
+			       rc);
+		rc = 0;
+	}
+#endif
+
 	if (conf->mc_is_addb_init) {
 		char buf[64];
 		/* Default client addb record file size set to 128M */
@@ -1650,6 +1668,16 @@ void m0_client_fini(struct m0_client *m0c, bool fini_m0)
 	/* Finalize hash-table for RM contexts */
 	rm_ctx_htable_fini(&m0c->m0c_rm_ctxs);
 
+	m0_io_cache_fini(&m0c->m0c_read_cache);
+
+#ifndef __KERNEL__
+	if (m0c->m0c_parity_pool_on) {
+		m0_parallel_pool_terminate_wait(&m0c->m0c_parity_pool);
+		m0_parallel_pool_fini(&m0c->m0c_parity_pool);
+	}
+	m0_mutex_fini(&m0c->m0c_parity_lock);
+#endif
+
 	/* shut down this client instance */
 	m0_sm_group_lock(&m0c->m0c_sm_group);
 
@@ -60,6 +60,10 @@
 #include "motr/idx.h"  /* m0_idx_* */
 #include "motr/pg.h"          /* nwxfer and friends */
 #include "motr/sync.h"        /* sync_request */
+#include "motr/io_cache.h"    /* m0_io_cache */
+#ifndef __KERNEL__
+#include "lib/thread_pool.h"  /* m0_parallel_pool */
+#endif
 #include "fop/fop.h"
 
 struct m0_idx_service_ctx;
@@ -324,12 +328,20 @@ struct m0_op_io {
 	uint32_t                         ioo_dgmap_nr;
 	bool                             ioo_dgmode_io_sent;
 
+	/** m0_io_cache::ic_gen when the read cache was consulted. */
+	uint64_t                         ioo_cache_gen;
+	/** Number of parity groups served from the read cache. */
+	uint64_t                         ioo_cached_nr;
+
 	/**
 	 * Used by copy_{to,from}_application to indicate progress in
 	 * log messages
 	 */
 	uint64_t                         ioo_copied_nr;
 
+	/** Number of data pages using application memory (zero copy). */
+	uint64_t                         ioo_zcopy_nr;
+
 	/** Cached map index value from ioreq_iosm_handle_* functions */
 	uint64_t                         ioo_map_idx;
 
@@ -461,6 +473,9 @@ enum {
 	 */
 	M0_NETBUF_MASK              = 4096 - 1,
 	M0_NETBUF_SHIFT             = 12,
+
+	/* Parity groups queued per m0_client::m0c_parity_pool thread. */
+	M0_PARITY_POOL_JOBS_PER_THREAD = 4,
 };
 
 /**
@@ -581,6 +596,20 @@ struct m0_client {
 #endif
 
 	struct m0_htable                        m0c_rm_ctxs;
+
+	/** Object data read cache. */
+	struct m0_io_cache                      m0c_read_cache;
+
+#ifndef __KERNEL__
+	/**
+	 * Threads computing parity of write requests in parallel, see
+	 * m0_config::mc_parity_threads. The pool processes one request at a
+	 * time, m0c_parity_lock is held while a request uses it.
+	 */
+	struct m0_parallel_pool                 m0c_parity_pool;
+	struct m0_mutex                         m0c_parity_lock;
+	bool                                    m0c_parity_pool_on;
+#endif
 };
 
 /** CPUs semaphore - to control CPUs usage by parity calcs. */
@@ -426,6 +426,11 @@ static void cob_entity_sm_move(struct m0_op *op)
 		else
 			m0_sm_move(&entity->en_sm, 0, M0_ES_INIT);
 		m0_sm_group_unlock(&entity->en_sm_group);
+		/* Drop groups filled by reads racing with the deletion. */
+		if (op->op_code == M0_EO_DELETE)
+			m0_io_cache_obj_invalidate(
+				&m0__entity_instance(entity)->m0c_read_cache,
+				&entity->en_id);
 
 		M0_LEAVE();
 		return;
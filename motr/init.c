@@ -65,6 +65,7 @@
 #  include "conf/confd.h"       /* m0_confd_register */
 #  include "mdstore/mdstore.h"  /* m0_mdstore_mod_init */
 #endif
+#include "be/btree.h"          /* m0_be_btree_mod_init */
 #include "cob/cob.h"
 #include "ioservice/io_fops.h"
 #include "ioservice/io_service.h"
@@ -189,6 +190,7 @@ struct init_fini_call subsystem[] = {
 #endif
 	{ &m0_mem_xprt_init,    &m0_mem_xprt_fini,    "bulk/mem" },
 	{ &m0_net_lnet_init,    &m0_net_lnet_fini,    "net/lnet" },
+	{ &m0_be_btree_mod_init, &m0_be_btree_mod_fini, "be-btree" },
 	{ &m0_cob_mod_init,     &m0_cob_mod_fini,     "cob" },
 	{ &m0_stob_mod_init,    &m0_stob_mod_fini,    "stob" },
 #ifndef __KERNEL__
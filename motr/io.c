@@ -288,6 +288,16 @@ static void obj_io_cb_launch(struct m0_op_common *oc)
 		goto end;
 	}
 
+	if (op->op_code == M0_OC_READ) {
+		rc = m0_io_cache_read_prepare(ioo);
+		if (rc != 0) {
+			ioo->ioo_ops->iro_iomaps_destroy(ioo);
+			ioo->ioo_nwxfer.nxr_state = NXS_COMPLETE;
+			goto end;
+		}
+	} else if (m0__is_update_op(op))
+		m0_io_cache_invalidate(ioo);
+
 	rc = ioo->ioo_nwxfer.nxr_ops->nxo_distribute(&ioo->ioo_nwxfer);
 	if (rc != 0) {
 		ioo->ioo_ops->iro_iomaps_destroy(ioo);
@@ -492,6 +502,16 @@ static void obj_io_cb_free(struct m0_op_common *oc)
 	M0_LEAVE();
 }
 
+/** Returns the di type of the object IO, see m0_obj_attr::oa_di_type. */
+static uint32_t obj_di_type(const struct m0_obj *obj)
+{
+#ifdef ENABLE_DATA_INTEGRITY
+	return obj->ob_attr.oa_di_type ?: M0_DI_DEFAULT_TYPE;
+#else
+	return M0_DI_NONE;
+#endif
+}
+
 static int obj_io_init(struct m0_obj      *obj,
 		       enum m0_obj_opcode  opcode,
 		       struct m0_indexvec *ext,
@@ -512,6 +532,8 @@ static int obj_io_init(struct m0_obj      *obj,
 
 	M0_PRE(obj != NULL);
 	cinst = m0__entity_instance(&obj->ob_entity);
+	if (!m0_di_type_is_supported(obj_di_type(obj)))
+		return M0_ERR(-EINVAL);
 
 	M0_ASSERT(op->op_size >= sizeof *ioo);
 	oc = bob_of(op, struct m0_op_common, oc_op, &oc_bobtype);
@@ -521,6 +543,9 @@ static int obj_io_init(struct m0_obj      *obj,
 	ioo->ioo_obj = obj;
 	ioo->ioo_ops = &ioo_ops;
 	ioo->ioo_pver = oo->oo_pver;
+	/* No rm domain: the file is only used for its di ops. */
+	m0_file_init(&ioo->ioo_flock, &ioo->ioo_oo.oo_fid, NULL,
+		     obj_di_type(obj));
 
 	/* Initialise this operation as a network transfer */
 	nw_xfer_request_init(&ioo->ioo_nwxfer);
@@ -0,0 +1,408 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "motr/client.h"
+#include "motr/client_internal.h"
+#include "motr/magic.h"
+#include "motr/pg.h"
+#include "motr/io.h"
+#include "motr/io_cache.h"
+
+#include "lib/memory.h"            /* M0_ALLOC_PTR */
+#include "lib/misc.h"              /* M0_SET0 */
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CLIENT
+#include "lib/trace.h"             /* M0_LOG */
+
+/**
+ * @addtogroup client_io_cache
+ * @{
+ */
+
+enum {
+	/** Number of buckets in m0_io_cache::ic_hash. */
+	IO_CACHE_BUCKET_NR = 1024
+};
+
+struct io_cache_key {
+	struct m0_uint128 ick_id;
+	uint64_t          ick_grp;
+};
+
+/** Cached data of a parity group. */
+struct io_cache_pg {
+	uint64_t            icp_magic;
+	struct io_cache_key icp_key;
+	/** Linkage into m0_io_cache::ic_hash. */
+	struct m0_hlink     icp_hlink;
+	/** Linkage into m0_io_cache::ic_lru. */
+	struct m0_tlink     icp_lru;
+	/** data_size() of the layout, all data units of the group. */
+	m0_bcount_t         icp_size;
+	void               *icp_data;
+};
+
+static uint64_t icp_hash_func(const struct m0_htable   *htable,
+			      const struct io_cache_key *key)
+{
+	return m0_hash(key->ick_id.u_hi ^ key->ick_id.u_lo ^
+		       m0_hash(key->ick_grp)) % htable->h_bucket_nr;
+}
+
+static bool icp_hash_eq(const struct io_cache_key *k0,
+			const struct io_cache_key *k1)
+{
+	return m0_uint128_eq(&k0->ick_id, &k1->ick_id) &&
+		k0->ick_grp == k1->ick_grp;
+}
+
+M0_HT_DESCR_DEFINE(icp_hash, "io-cache-pgs", static, struct io_cache_pg,
+		   icp_hlink, icp_magic, M0_IO_CACHE_PG_MAGIC,
+		   M0_IO_CACHE_HT_MAGIC, icp_key, icp_hash_func, icp_hash_eq);
+M0_HT_DEFINE(icp_hash, static, struct io_cache_pg, struct io_cache_key);
+
+M0_TL_DESCR_DEFINE(icp_lru, "io-cache-lru", static, struct io_cache_pg,
+		   icp_lru, icp_magic, M0_IO_CACHE_PG_MAGIC,
+		   M0_IO_CACHE_LRU_MAGIC);
+M0_TL_DEFINE(icp_lru, static, struct io_cache_pg);
+
+static struct m0_io_cache *ioo_cache(struct m0_op_io *ioo)
+{
+	return &m0__op_instance(m0__ioo_to_op(ioo))->m0c_read_cache;
+}
+
+static bool cache_is_usable(struct m0_io_cache *cache, struct m0_op_io *ioo)
+{
+	return cache->ic_budget > 0 &&
+		!m0__op_instance(m0__ioo_to_op(ioo))->m0c_config->
+		mc_is_read_verify;
+}
+
+static struct io_cache_pg *pg_lookup(struct m0_io_cache      *cache,
+				     const struct m0_uint128 *id,
+				     uint64_t                 grp)
+{
+	struct io_cache_key key = { .ick_id = *id, .ick_grp = grp };
+
+	M0_PRE(m0_mutex_is_locked(&cache->ic_lock));
+	return icp_hash_htable_lookup(&cache->ic_hash, &key);
+}
+
+static void pg_del(struct m0_io_cache *cache, struct io_cache_pg *pg)
+{
+	M0_PRE(m0_mutex_is_locked(&cache->ic_lock));
+	M0_PRE(cache->ic_used >= pg->icp_size);
+
+	icp_hash_htable_del(&cache->ic_hash, pg);
+	icp_hash_tlink_fini(pg);
+	icp_lru_tlink_del_fini(pg);
+	cache->ic_used -= pg->icp_size;
+	m0_free(pg->icp_data);
+	m0_free(pg);
+}
+
+/** Offset of the data page (row, col) of the map within its parity group. */
+static m0_bindex_t pg_offset(struct pargrp_iomap *map, uint32_t row,
+			     uint32_t col)
+{
+	return data_page_offset_get(map, row, col) -
+		data_size(pdlayout_get(map->pi_ioo)) * map->pi_grpid;
+}
+
+/** True iff all data pages of the group are present and were read. */
+static bool map_is_full(const struct pargrp_iomap *map)
+{
+	uint32_t row;
+	uint32_t col;
+
+	if (map->pi_is_corrupted)
+		return false;
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col) {
+			if (map->pi_databufs[row][col] == NULL ||
+			    !(map->pi_databufs[row][col]->db_flags & PA_READ))
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Copies between cached group data and the data pages of the map.
+ * All pages present in the map are copied.
+ */
+static void pg_copy(struct io_cache_pg *pg, struct pargrp_iomap *map,
+		    bool to_map)
+{
+	struct data_buf *buf;
+	m0_bindex_t      off;
+	uint32_t         row;
+	uint32_t         col;
+
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col) {
+			buf = map->pi_databufs[row][col];
+			if (buf == NULL)
+				continue;
+			off = pg_offset(map, row, col);
+			M0_ASSERT(off + buf->db_buf.b_nob <= pg->icp_size);
+			if (to_map)
+				memcpy(buf->db_buf.b_addr, pg->icp_data + off,
+				       buf->db_buf.b_nob);
+			else
+				memcpy(pg->icp_data + off, buf->db_buf.b_addr,
+				       buf->db_buf.b_nob);
+		}
+	}
+}
+
+/**
+ * Updates the sequential detector with an access to groups [first, last] of
+ * the object and returns true iff the access continues a sequential stream.
+ */
+static bool stream_update(struct m0_io_cache      *cache,
+			  const struct m0_uint128 *id,
+			  uint64_t                 first,
+			  uint64_t                 last)
+{
+	struct m0_io_cache_stream *s;
+
+	s = &cache->ic_streams[m0_hash(id->u_hi ^ id->u_lo) %
+			       ARRAY_SIZE(cache->ic_streams)];
+	if (m0_uint128_eq(&s->ics_id, id) &&
+	    (first == s->ics_next || first + 1 == s->ics_next))
+		++s->ics_seq;
+	else {
+		s->ics_id  = *id;
+		s->ics_seq = 0;
+	}
+	s->ics_next = last + 1;
+	return s->ics_seq > 0;
+}
+
+M0_INTERNAL void m0_io_cache_init(struct m0_io_cache *cache,
+				  m0_bcount_t budget)
+{
+	int rc;
+
+	M0_SET0(cache);
+	m0_mutex_init(&cache->ic_lock);
+	icp_lru_tlist_init(&cache->ic_lru);
+	if (budget == 0)
+		return;
+	rc = icp_hash_htable_init(&cache->ic_hash, IO_CACHE_BUCKET_NR);
+	if (rc != 0) {
+		M0_LOG(M0_WARN, "Read cache is disabled: rc=%d", rc);
+		return;
+	}
+	cache->ic_budget = budget;
+}
+
+M0_INTERNAL void m0_io_cache_fini(struct m0_io_cache *cache)
+{
+	struct io_cache_pg       *pg;
+	struct m0_io_cache_stats *st = &cache->ic_stats;
+
+	if (cache->ic_budget > 0) {
+		M0_LOG(M0_INFO, "Read cache: hits=%"PRIu64" misses=%"PRIu64
+		       " fills=%"PRIu64" evictions=%"PRIu64
+		       " invalidations=%"PRIu64" readrests=%"PRIu64,
+		       st->ics_hits, st->ics_misses, st->ics_fills,
+		       st->ics_evictions, st->ics_invalidations,
+		       st->ics_readrests);
+		m0_mutex_lock(&cache->ic_lock);
+		while ((pg = icp_lru_tlist_head(&cache->ic_lru)) != NULL)
+			pg_del(cache, pg);
+		m0_mutex_unlock(&cache->ic_lock);
+		icp_hash_htable_fini(&cache->ic_hash);
+	}
+	M0_ASSERT(cache->ic_used == 0);
+	icp_lru_tlist_fini(&cache->ic_lru);
+	m0_mutex_fini(&cache->ic_lock);
+}
+
+M0_INTERNAL int m0_io_cache_read_prepare(struct m0_op_io *ioo)
+{
+	struct m0_io_cache  *cache = ioo_cache(ioo);
+	struct m0_uint128   *id    = &ioo->ioo_obj->ob_entity.en_id;
+	struct pargrp_iomap *map;
+	struct io_cache_pg  *pg;
+	m0_bcount_t          size;
+	uint64_t             i;
+	bool                 seq;
+	int                  rc    = 0;
+
+	M0_ENTRY("ioo %p", ioo);
+	M0_PRE(m0__ioo_to_op(ioo)->op_code == M0_OC_READ);
+
+	ioo->ioo_cached_nr = 0;
+	if (!cache_is_usable(cache, ioo) || ioo->ioo_iomap_nr == 0)
+		return M0_RC(0);
+
+	size = data_size(pdlayout_get(ioo));
+	m0_mutex_lock(&cache->ic_lock);
+	ioo->ioo_cache_gen = cache->ic_gen;
+	seq = stream_update(cache, id, ioo->ioo_iomaps[0]->pi_grpid,
+			    ioo->ioo_iomaps[ioo->ioo_iomap_nr - 1]->pi_grpid);
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		pg = pg_lookup(cache, id, map->pi_grpid);
+		if (pg != NULL && pg->icp_size == size) {
+			pg_copy(pg, map, true);
+			map->pi_cached = true;
+			++ioo->ioo_cached_nr;
+			icp_lru_tlist_move(&cache->ic_lru, pg);
+			++cache->ic_stats.ics_hits;
+			continue;
+		}
+		++cache->ic_stats.ics_misses;
+		if (seq && !map_is_full(map)) {
+			/* Read the whole group, so that it can be cached. */
+			map->pi_rtype = PIR_READREST;
+			rc = map->pi_ops->pi_readrest(map);
+			map->pi_rtype = PIR_NONE;
+			if (rc != 0)
+				break;
+			++cache->ic_stats.ics_readrests;
+		}
+	}
+	m0_mutex_unlock(&cache->ic_lock);
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void m0_io_cache_read_done(struct m0_op_io *ioo)
+{
+	struct m0_io_cache  *cache = ioo_cache(ioo);
+	struct m0_uint128   *id    = &ioo->ioo_obj->ob_entity.en_id;
+	struct pargrp_iomap *map;
+	struct io_cache_pg  *pg;
+	m0_bcount_t          size;
+	uint64_t             i;
+
+	M0_ENTRY("ioo %p", ioo);
+
+	if (!cache_is_usable(cache, ioo) || ioo->ioo_nwxfer.nxr_rc != 0 ||
+	    ioo->ioo_dgmap_nr > 0)
+		goto leave;
+	size = data_size(pdlayout_get(ioo));
+	if (size > cache->ic_budget)
+		goto leave;
+	m0_mutex_lock(&cache->ic_lock);
+	/* Skip the fill if an update raced with this read. */
+	for (i = 0; cache->ic_gen == ioo->ioo_cache_gen &&
+		    i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		if (map->pi_cached || !map_is_full(map) ||
+		    pg_lookup(cache, id, map->pi_grpid) != NULL)
+			continue;
+		M0_ALLOC_PTR(pg);
+		if (pg == NULL)
+			break;
+		pg->icp_data = m0_alloc(size);
+		if (pg->icp_data == NULL) {
+			m0_free(pg);
+			break;
+		}
+		while (cache->ic_used + size > cache->ic_budget) {
+			pg_del(cache, icp_lru_tlist_tail(&cache->ic_lru));
+			++cache->ic_stats.ics_evictions;
+		}
+		pg->icp_key  = (struct io_cache_key) {
+			.ick_id  = *id,
+			.ick_grp = map->pi_grpid
+		};
+		pg->icp_size = size;
+		pg_copy(pg, map, false);
+		icp_hash_tlink_init(pg);
+		icp_hash_htable_add(&cache->ic_hash, pg);
+		icp_lru_tlink_init_at(pg, &cache->ic_lru);
+		cache->ic_used += size;
+		++cache->ic_stats.ics_fills;
+	}
+	m0_mutex_unlock(&cache->ic_lock);
+leave:
+	M0_LEAVE();
+}
+
+M0_INTERNAL void m0_io_cache_invalidate(struct m0_op_io *ioo)
+{
+	struct m0_io_cache *cache = ioo_cache(ioo);
+	struct io_cache_pg *pg;
+	uint64_t            i;
+
+	if (cache->ic_budget == 0)
+		return;
+	m0_mutex_lock(&cache->ic_lock);
+	++cache->ic_gen;
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
+		pg = pg_lookup(cache, &ioo->ioo_obj->ob_entity.en_id,
+			       ioo->ioo_iomaps[i]->pi_grpid);
+		if (pg != NULL) {
+			pg_del(cache, pg);
+			++cache->ic_stats.ics_invalidations;
+		}
+	}
+	m0_mutex_unlock(&cache->ic_lock);
+}
+
+M0_INTERNAL void m0_io_cache_obj_invalidate(struct m0_io_cache      *cache,
+					    const struct m0_uint128 *id)
+{
+	struct io_cache_pg *pg;
+
+	if (cache->ic_budget == 0)
+		return;
+	m0_mutex_lock(&cache->ic_lock);
+	++cache->ic_gen;
+	m0_tl_for(icp_lru, &cache->ic_lru, pg) {
+		if (m0_uint128_eq(&pg->icp_key.ick_id, id)) {
+			pg_del(cache, pg);
+			++cache->ic_stats.ics_invalidations;
+		}
+	} m0_tl_endfor;
+	m0_mutex_unlock(&cache->ic_lock);
+}
+
+M0_INTERNAL void m0_io_cache_stats_get(struct m0_io_cache       *cache,
+				       struct m0_io_cache_stats *stats)
+{
+	m0_mutex_lock(&cache->ic_lock);
+	*stats = cache->ic_stats;
+	m0_mutex_unlock(&cache->ic_lock);
+}
+
+#undef M0_TRACE_SUBSYSTEM
+
+/** @} end of client_io_cache group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
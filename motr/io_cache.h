@@ -0,0 +1,158 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_IO_CACHE_H__
+#define __MOTR_IO_CACHE_H__
+
+#include "lib/mutex.h"
+#include "lib/tlist.h"
+#include "lib/hash.h"
+#include "lib/types.h"           /* m0_uint128 */
+
+/**
+ * @defgroup client_io_cache Client read cache
+ *
+ * Optional per-client cache of object data, enabled by a non-zero
+ * m0_config::mc_read_cache_size.
+ *
+ * The unit of caching is the data part of a parity group, keyed by object id
+ * and parity group index. A group is inserted when a read completes having
+ * read all data pages of the group. A read whose parity groups are all cached
+ * is served without network IO; partially cached reads fetch only the missing
+ * groups.
+ *
+ * A per-object stream detector recognises sequential readers. For such
+ * streams every spanned parity group is read as a whole (read-rest), so that
+ * subsequent small reads of the same group are served from the cache instead
+ * of doing a network round-trip per read. Read-rest is done synchronously, as
+ * part of the read that spans the group; groups following the read are not
+ * fetched in advance.
+ *
+ * Writes and frees invalidate the groups they span both when launched and
+ * when executed, deletion of an object invalidates all its groups. A cache
+ * generation counter prevents reads that were in flight during an
+ * invalidation from inserting stale data.
+ *
+ * Memory is bounded by the budget; least recently used groups are evicted.
+ * The cache is disabled in read-verify mode.
+ *
+ * @{
+ */
+
+struct m0_op_io;
+
+/** Read cache statistics. */
+struct m0_io_cache_stats {
+	/** Parity groups served from the cache. */
+	uint64_t ics_hits;
+	/** Parity groups read over the network. */
+	uint64_t ics_misses;
+	/** Parity groups inserted. */
+	uint64_t ics_fills;
+	/** Parity groups evicted to stay within the budget. */
+	uint64_t ics_evictions;
+	/** Parity groups dropped because of local updates. */
+	uint64_t ics_invalidations;
+	/**
+	 * Parity groups of a sequential stream extended to a whole-group read
+	 * (read-rest), so that they can be cached.
+	 */
+	uint64_t ics_readrests;
+};
+
+enum {
+	/** Number of object streams tracked by the sequential detector. */
+	M0_IO_CACHE_STREAM_NR = 64
+};
+
+/** Sequential access detector slot. */
+struct m0_io_cache_stream {
+	struct m0_uint128 ics_id;
+	/** Parity group expected to be read next. */
+	uint64_t          ics_next;
+	/** Number of consecutive sequential accesses. */
+	uint32_t          ics_seq;
+};
+
+/** Per-client read cache. */
+struct m0_io_cache {
+	struct m0_mutex           ic_lock;
+	/** Memory budget in bytes, 0 if the cache is disabled. */
+	m0_bcount_t               ic_budget;
+	/** Memory currently used by cached groups. */
+	m0_bcount_t               ic_used;
+	/** Cached groups, hashed by (object id, group). */
+	struct m0_htable          ic_hash;
+	/** Cached groups, most recently used first. */
+	struct m0_tl              ic_lru;
+	/** Incremented on every invalidation. */
+	uint64_t                  ic_gen;
+	struct m0_io_cache_stream ic_streams[M0_IO_CACHE_STREAM_NR];
+	struct m0_io_cache_stats  ic_stats;
+};
+
+/**
+ * Initialises the cache with the given budget. A zero budget, or failure to
+ * allocate the hash table, leaves the cache disabled.
+ */
+M0_INTERNAL void m0_io_cache_init(struct m0_io_cache *cache,
+				  m0_bcount_t budget);
+M0_INTERNAL void m0_io_cache_fini(struct m0_io_cache *cache);
+
+/**
+ * Called for a read operation after its parity group maps are prepared and
+ * before they are distributed. Fills the maps of cached groups from the cache
+ * and marks them pargrp_iomap::pi_cached, extends maps of sequential streams
+ * to whole groups.
+ */
+M0_INTERNAL int  m0_io_cache_read_prepare(struct m0_op_io *ioo);
+
+/** Inserts completely read groups of a successfully finished read. */
+M0_INTERNAL void m0_io_cache_read_done(struct m0_op_io *ioo);
+
+/** Drops cached groups spanned by an update operation. */
+M0_INTERNAL void m0_io_cache_invalidate(struct m0_op_io *ioo);
+
+/** Drops all cached groups of the object, called when it is deleted. */
+M0_INTERNAL void m0_io_cache_obj_invalidate(struct m0_io_cache      *cache,
+					    const struct m0_uint128 *id);
+
+M0_INTERNAL void m0_io_cache_stats_get(struct m0_io_cache *cache,
+				       struct m0_io_cache_stats *stats);
+
+/** @} end of client_io_cache group */
+#endif /* __MOTR_IO_CACHE_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
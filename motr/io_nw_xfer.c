@@ -86,9 +86,8 @@ static void m0_op_io_to_rpc_map(const struct m0_op_io    *ioo,
 /**
  * Calculate the size needed for per-segment on-wire data integrity.
  * Note: Client leaves its applications to decide how to use locks on
- * objects, so it doesn't manage any lock. But file lock is needed
- * to calculate di size, a file lock is faked here to get di details.
- * Clearly, a more reliable way to get di size is needed.
+ * objects, so it doesn't manage any lock. The di size is taken from the di
+ * ops of the file initialised for the operation (obj_io_init()).
  *
  * @param ioo The IO operation, to find the client instance.
  * @return the size of data integrity data.
@@ -96,7 +95,6 @@ static void m0_op_io_to_rpc_map(const struct m0_op_io    *ioo,
 static uint32_t io_di_size(struct m0_op_io *ioo)
 {
 	uint32_t                rc = 0;
-	const struct m0_fid    *fid;
 	const struct m0_di_ops *di_ops;
 	struct m0_file         *file;
 
@@ -105,10 +103,7 @@ static uint32_t io_di_size(struct m0_op_io *ioo)
 	#ifndef ENABLE_DATA_INTEGRITY
 		return M0_RC(rc);
 	#endif
-	/* Get di details (workaround!) by setting the dom be NULL*/
 	file = &ioo->ioo_flock;
-	fid = &ioo->ioo_oo.oo_fid;
-	m0_file_init(file, fid, NULL, M0_DI_DEFAULT_TYPE);
 	di_ops = file->fi_di_ops;
 
 	if (di_ops->do_out_shift(file) == 0)
@@ -1246,6 +1241,8 @@ static int nw_xfer_io_distribute(struct nw_xfer_request *xfer)
 	for (map = 0; map < ioo->ioo_iomap_nr; ++map) {
 		count        = 0;
 		iomap        = ioo->ioo_iomaps[map];
+		if (iomap->pi_cached)
+			continue;
 		pgstart      = data_size(play) * iomap->pi_grpid;
 		src.sa_group = iomap->pi_grpid;
 
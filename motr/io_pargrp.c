@@ -32,6 +32,7 @@
 #include "rm/rm.h"               /* stuct m0_rm_owner */
 #include "sns/parity_repair.h"   /* m0_sns_repair_spare_map*/
 #include "fd/fd.h"               /* m0_fd_fwd_map m0_fd_bwd_map */
+#include "file/di.h"             /* m0_di_cksum */
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CLIENT
 #include "lib/trace.h"           /* M0_LOG */
@@ -852,8 +853,15 @@ static int pargrp_iomap_seg_process(struct pargrp_iomap *map,
 			 */
 			if (buf_cursor && m0_bufvec_cursor_move(buf_cursor, 0))
 				buf_cursor = NULL;
+			/*
+			 * Only full pages may use application memory: the
+			 * network transfers whole pages, and partial pages
+			 * are read-modify-written (readold) or read beyond
+			 * the requested extent.
+			 */
 			rc = map->pi_ops->pi_databuf_alloc(map, row, col,
-							   buf_cursor);
+						count == pagesize ?
+						buf_cursor : NULL);
 			if (rc == 0 && buf_cursor)
 				m0_bufvec_cursor_move(buf_cursor, count);
 		}
@@ -919,7 +927,12 @@ static int pargrp_iomap_databuf_alloc(struct pargrp_iomap     *map,
 		return M0_ERR(-ENOMEM);
 	}
 
-	if (data)
+	/*
+	 * Application memory is used directly (zero copy) iff the current
+	 * application segment covers the whole page.
+	 */
+	if (data != NULL &&
+	    m0_bufvec_cursor_step(data) >= obj_buffer_size(obj))
 		addr = m0_bufvec_cursor_addr(data);
 
 	flags = PA_NONE | PA_APP_MEMORY;
@@ -928,7 +941,8 @@ static int pargrp_iomap_databuf_alloc(struct pargrp_iomap     *map,
 		addr = m0_alloc_aligned(obj_buffer_size(obj),
 				        M0_NETBUF_SHIFT);
 		flags = PA_NONE;
-	}
+	} else
+		++map->pi_ioo->ioo_zcopy_nr;
 
 	data_buf_init(buf, addr, obj_buffer_size(obj), flags);
 	M0_POST_EX(data_buf_invariant(buf));
@@ -2064,14 +2078,15 @@ end:
 
 static bool crc_cmp(const struct m0_buf *val1, const struct m0_buf *val2)
 {
-	return *(uint32_t *)val1->b_addr == *(uint32_t *)val2->b_addr;
+	/* data_buf::db_crc, wider than 32 bits for some di types. */
+	return *(uint64_t *)val1->b_addr == *(uint64_t *)val2->b_addr;
 }
 
-static void db_crc_set(struct data_buf *dbuf, uint32_t key,
-		       struct m0_key_val *kv)
+static void db_crc_set(struct m0_op_io *ioo, struct data_buf *dbuf,
+		       uint32_t key, struct m0_key_val *kv)
 {
-	m0_crc32(dbuf->db_buf.b_addr, dbuf->db_buf.b_nob,
-		 (void *)&dbuf->db_crc);
+	m0_di_cksum(&ioo->ioo_flock, dbuf->db_buf.b_addr, dbuf->db_buf.b_nob,
+		    &dbuf->db_crc);
 	dbuf->db_key = key;
 	m0_key_val_init(kv, &M0_BUF_INIT_PTR(&dbuf->db_key),
 			&M0_BUF_INIT_PTR(&dbuf->db_crc));
@@ -2153,7 +2168,7 @@ static int pargrp_iomap_replica_elect(struct pargrp_iomap *map)
 			dbuf->db_crc = 0;
 		else {
 			unit_id = 0;
-			db_crc_set(dbuf, unit_id, &crc_arr[crc_idx++]);
+			db_crc_set(ioo, dbuf, unit_id, &crc_arr[crc_idx++]);
 		}
 		for (col = 0; col < layout_k(play); ++col) {
 			pbuf = map->pi_paritybufs[row][col];
@@ -2166,7 +2181,8 @@ static int pargrp_iomap_replica_elect(struct pargrp_iomap *map)
 			else {
 				/* Shift by one to count for the data unit. */
 				unit_id = col + 1;
-				db_crc_set(pbuf, unit_id, &crc_arr[crc_idx++]);
+				db_crc_set(ioo, pbuf, unit_id,
+					   &crc_arr[crc_idx++]);
 			}
 		}
 		vote_nr = 0;
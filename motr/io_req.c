@@ -360,6 +360,13 @@ static void ioreq_iosm_handle_launch(struct m0_sm_group *grp,
 			ioreq_sm_executed_post(ioo);
 			goto out;
 		}
+		if (op->op_code == M0_OC_READ &&
+		    ioo->ioo_cached_nr == ioo->ioo_iomap_nr) {
+			/* All groups were served from the read cache. */
+			ioreq_sm_state_set_locked(ioo, IRS_READ_COMPLETE);
+			ioreq_sm_executed_post(ioo);
+			goto out;
+		}
 		rc = ioo->ioo_nwxfer.nxr_ops->nxo_dispatch(&ioo->ioo_nwxfer);
 		if (rc != 0) {
 			M0_LOG(M0_ERROR, "nxo_dispatch() failed: rc=%d", rc);
@@ -400,8 +407,9 @@ static void ioreq_iosm_handle_launch(struct m0_sm_group *grp,
 		}
 	}
 out:
-	M0_LOG(M0_INFO, "nxr_bytes = %"PRIu64", copied_nr = %"PRIu64,
-	       ioo->ioo_nwxfer.nxr_bytes, ioo->ioo_copied_nr);
+	M0_LOG(M0_INFO, "nxr_bytes = %"PRIu64", copied_nr = %"PRIu64
+	       ", zcopy_nr = %"PRIu64, ioo->ioo_nwxfer.nxr_bytes,
+	       ioo->ioo_copied_nr, ioo->ioo_zcopy_nr);
 
 	/* lock this as it isn't a locality group lock */
 	m0_sm_group_lock(&op->op_sm_group);
@@ -517,6 +525,9 @@ static void ioreq_iosm_handle_executed(struct m0_sm_group *grp,
 			     ioo->ioo_dgmap_nr > 0)
 				rc = ioo->ioo_ops->iro_dgmode_recover(ioo);
 
+			if (op->op_code == M0_OC_READ)
+				m0_io_cache_read_done(ioo);
+
 			/* Valid data are available now, copy to application */
 			rc = ioo->ioo_ops->iro_application_data_copy(ioo,
 				CD_COPY_TO_APP, 0);
@@ -672,6 +683,8 @@ static void ioreq_iosm_handle_executed(struct m0_sm_group *grp,
 		}
 	}
 done:
+	if (m0__is_update_op(op))
+		m0_io_cache_invalidate(ioo);
 	ioo->ioo_nwxfer.nxr_ops->nxo_complete(&ioo->ioo_nwxfer, rmw);
 
 #ifdef CLIENT_FOR_M0T1FS
@@ -712,6 +725,8 @@ out:
 
 fail_locked:
 	ioo->ioo_rc = rc;
+	if (m0__is_update_op(op))
+		m0_io_cache_invalidate(ioo);
 	ioreq_sm_failed_locked(ioo, rc);
 	/* N.B. Failed is not a terminal state */
 	ioreq_sm_state_set_locked(ioo, IRS_REQ_COMPLETE);
@@ -1173,6 +1188,51 @@ static int ioreq_application_data_copy(struct m0_op_io *ioo,
 	return M0_RC(0);
 }
 
+#ifndef __KERNEL__
+static int parity_recalc_job(void *job)
+{
+	struct pargrp_iomap *map = job;
+
+	return map->pi_ops->pi_parity_recalc(map);
+}
+
+/**
+ * Recalculates parity of all parity groups of the request on the client
+ * parity pool. Groups are independent, so the order in which they are
+ * processed does not matter; the call returns when all of them are done.
+ * Returns -EBUSY if the pool is used by another request.
+ */
+static int ioreq_parity_recalc_parallel(struct m0_op_io *ioo)
+{
+	struct m0_client        *cinst = m0__op_instance(m0__ioo_to_op(ioo));
+	struct m0_parallel_pool *pool  = &cinst->m0c_parity_pool;
+	uint64_t                 map;
+	int                      rc    = 0;
+	int                      rc1;
+
+	if (!cinst->m0c_parity_pool_on || ioo->ioo_iomap_nr < 2 ||
+	    m0_mutex_trylock(&cinst->m0c_parity_lock) != 0)
+		return -EBUSY;
+	for (map = 0; map < ioo->ioo_iomap_nr && rc == 0; ++map) {
+		rc = m0_parallel_pool_job_add(pool, ioo->ioo_iomaps[map]);
+		if (rc == -EFBIG) {
+			m0_parallel_pool_start(pool, &parity_recalc_job);
+			rc = m0_parallel_pool_wait(pool) ?:
+			     m0_parallel_pool_job_add(pool,
+						      ioo->ioo_iomaps[map]);
+		}
+	}
+	/*
+	 * Jobs queued before a failure are processed too: the pool is shared
+	 * by the requests of the client and must be left with an empty queue.
+	 */
+	m0_parallel_pool_start(pool, &parity_recalc_job);
+	rc1 = m0_parallel_pool_wait(pool);
+	m0_mutex_unlock(&cinst->m0c_parity_lock);
+	return M0_RC(rc ?: rc1);
+}
+#endif
+
 /**
  * Recalculates the parity for each row of this operations io map.
  * This is heavily based on m0t1fs/linux_kernel/file.c::ioreq_partiy_recalc
@@ -1190,6 +1250,15 @@ static int ioreq_parity_recalc(struct m0_op_io *ioo)
 
 	m0_semaphore_down(&cpus_sem);
 
+#ifndef __KERNEL__
+	rc = ioreq_parity_recalc_parallel(ioo);
+	if (rc != -EBUSY) {
+		m0_semaphore_up(&cpus_sem);
+		return rc == 0 ? M0_RC(rc) :
+			M0_ERR_INFO(rc, "Parallel parity recalc failed");
+	}
+	rc = 0;
+#endif
 	for (map = 0; map < ioo->ioo_iomap_nr; ++map) {
 		rc = ioo->ioo_iomaps[map]->pi_ops->pi_parity_recalc(ioo->
 				ioo_iomaps[map]);
@@ -169,6 +169,11 @@ struct m0_workload_io {
 	uint32_t          cwi_rounds;
 	bool              cwi_random_io;
 	bool              cwi_share_object;
+	/**
+	 * Misalign I/O buffers, so that the client copies data instead of
+	 * using the buffers directly (zero copy).
+	 */
+	bool              cwi_force_copy;
 	int32_t	          cwi_opcode;
 	struct m0_uint128 cwi_start_obj_id;
 	m0_time_t         cwi_start_time;
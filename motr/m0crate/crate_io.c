@@ -66,6 +66,7 @@
  * * NR_THREADS: - Number of threads.
  * * EXEC_TIME - time limit for executing (seconds or "unlimited").
  * * NR_ROUNDS:  - How many times this workload to be executed.
+ * * FORCE_COPY: - Misalign I/O buffers (1) to disable client zero copy.
  *
  * ## Measurements
  * Currently, only execution time is measured during the test. It measures with
@@ -88,6 +89,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <sys/resource.h>
 
 #include "lib/finject.h"
 #include "lib/trace.h"
@@ -789,8 +791,51 @@ void cr_get_oids(struct m0_uint128 *ids, uint32_t nr_objs)
 	}
 }
 
+enum {
+	/** Offset of misaligned buffers, see m0_workload_io::cwi_force_copy. */
+	CR_MISALIGN = 8
+};
+
+/** Shifts buffers of a bufvec allocated with CR_MISALIGN extra bytes. */
+static void cr_bufvec_misalign(struct m0_bufvec *bv, bool on)
+{
+	int i;
+
+	for (i = 0; i < bv->ov_vec.v_nr; i++) {
+		if (on) {
+			bv->ov_buf[i] += CR_MISALIGN;
+			bv->ov_vec.v_count[i] -= CR_MISALIGN;
+		} else {
+			bv->ov_buf[i] -= CR_MISALIGN;
+			bv->ov_vec.v_count[i] += CR_MISALIGN;
+		}
+	}
+}
+
+/**
+ * Allocates a bufvec of the workload. With cwi_force_copy, the buffers are
+ * misaligned right away, so that every allocated bufvec can be released by
+ * cr_task_bufs_free().
+ */
+static int cr_bufvec_alloc(struct m0_workload_io *cwi, struct m0_bufvec *bv)
+{
+	int rc;
+
+	rc = m0_bufvec_alloc_aligned(bv, cwi->cwi_bcount_per_op,
+				     cwi->cwi_bs +
+				     (cwi->cwi_force_copy ? CR_MISALIGN : 0),
+				     M0_DEFAULT_BUF_SHIFT);
+	if (rc == 0 && cwi->cwi_force_copy)
+		cr_bufvec_misalign(bv, true);
+	return rc;
+}
+
 void cr_task_bufs_free(struct m0_task_io *cti, int idx)
 {
+	if (cti->cti_cwi->cwi_force_copy) {
+		cr_bufvec_misalign(&cti->cti_bufvec[idx], false);
+		cr_bufvec_misalign(&cti->cti_rd_bufvec[idx], false);
+	}
 	m0_bufvec_free_aligned(&cti->cti_bufvec[idx],
 			       M0_DEFAULT_BUF_SHIFT);
 	m0_bufvec_free_aligned(&cti->cti_rd_bufvec[idx],
@@ -823,30 +868,34 @@ int cr_task_prep_bufs(struct m0_workload_io *cwi,
 {
 	int i;
 	int k;
-	int rc;
+	int rc = 0;
 
 	M0_ALLOC_ARR(cti->cti_bufvec, cwi->cwi_nr_objs);
 	M0_ALLOC_ARR(cti->cti_rd_bufvec, cwi->cwi_nr_objs);
+	if (cti->cti_bufvec == NULL || cti->cti_rd_bufvec == NULL) {
+		rc = -ENOMEM;
+		goto free;
+	}
 
 	for (i = 0; i < cwi->cwi_nr_objs; i++) {
-		rc = m0_bufvec_alloc_aligned(&cti->cti_bufvec[i],
-					     cwi->cwi_bcount_per_op,
-					     cwi->cwi_bs,
-					     M0_DEFAULT_BUF_SHIFT) ?:
-		     m0_bufvec_alloc_aligned(&cti->cti_rd_bufvec[i],
-					     cwi->cwi_bcount_per_op,
-					     cwi->cwi_bs,
-					     M0_DEFAULT_BUF_SHIFT);
-		if (rc != 0)
-			return rc;
-		for (k = 0; k < cwi->cwi_bcount_per_op; k++) {
+		rc = cr_bufvec_alloc(cwi, &cti->cti_bufvec[i]) ?:
+		     cr_bufvec_alloc(cwi, &cti->cti_rd_bufvec[i]);
+		for (k = 0; rc == 0 && k < cwi->cwi_bcount_per_op; k++)
 			rc = cr_buffer_read(cti->cti_bufvec[i].ov_buf[k],
 					    cwi->cwi_filename, cwi->cwi_bs);
-			if (rc != 0)
-				return rc;
+		if (rc != 0) {
+			/* Failed bufvec allocations leave the bufvec empty. */
+			for (; i >= 0; i--)
+				cr_task_bufs_free(cti, i);
+			break;
 		}
 	}
-	return 0;
+free:
+	if (rc != 0) {
+		m0_free0(&cti->cti_bufvec);
+		m0_free0(&cti->cti_rd_bufvec);
+	}
+	return rc;
 }
 
 int cr_task_prep_one(struct m0_workload_io *cwi,
@@ -982,6 +1031,11 @@ bool cr_time_not_expired(struct workload *w)
 		cwi->cwi_execution_time ? false : true;
 }
 
+static uint64_t tv_usec(const struct timeval *tv)
+{
+	return tv->tv_sec * 1000000ULL + tv->tv_usec;
+}
+
 /** Returns bandwidth in bytes / sec. */
 static uint64_t bw(uint64_t bytes, m0_time_t time)
 {
@@ -995,8 +1049,11 @@ void run(struct workload *w, struct workload_task *tasks)
 	uint64_t               read;
 	int                    rc;
 	struct m0_workload_io *cwi = w->u.cw_io;
+	struct rusage          ru_start;
+	struct rusage          ru_finish;
 
 	m0_mutex_init(&cwi->cwi_g.cg_mutex);
+	getrusage(RUSAGE_SELF, &ru_start);
 	cwi->cwi_start_time = m0_time_now();
 	if (M0_IN(cwi->cwi_opcode, (CR_POPULATE, CR_CLEANUP)) &&
 	    !entity_id_is_valid(&cwi->cwi_start_obj_id))
@@ -1015,12 +1072,17 @@ void run(struct workload *w, struct workload_task *tasks)
 	}
 	m0_mutex_fini(&cwi->cwi_g.cg_mutex);
 	cwi->cwi_finish_time = m0_time_now();
+	getrusage(RUSAGE_SELF, &ru_finish);
 
 	cr_log(CLL_INFO, "I/O workload is finished.\n");
 	cr_log(CLL_INFO, "Total: time="TIME_F" objs=%d ops=%lu\n",
 	       TIME_P(m0_time_sub(cwi->cwi_finish_time, cwi->cwi_start_time)),
 	       cwi->cwi_nr_objs * w->cw_nr_thread,
 	       cwi->cwi_ops_done[CR_WRITE] + cwi->cwi_ops_done[CR_READ]);
+	cr_log(CLL_INFO, "CPU: user=%"PRIu64"us sys=%"PRIu64"us (%s)\n",
+	       tv_usec(&ru_finish.ru_utime) - tv_usec(&ru_start.ru_utime),
+	       tv_usec(&ru_finish.ru_stime) - tv_usec(&ru_start.ru_stime),
+	       cwi->cwi_force_copy ? "copy" : "zero copy");
 	if (cwi->cwi_ops_done[CR_CREATE] != 0)
 		cr_log(CLL_INFO, "C: "TIME_F" ("TIME_F" per op)\n",
 		       TIME_P(cwi->cwi_time[CR_CREATE]),
@@ -88,6 +88,7 @@ enum config_key_val {
 	NR_ROUNDS,
 	ADDB_INIT,
 	ADDB_SIZE,
+	FORCE_COPY,
 };
 
 struct key_lookup_table {
@@ -146,6 +147,7 @@ struct key_lookup_table lookuptable[] = {
 	{"NR_ROUNDS", NR_ROUNDS},
 	{"ADDB_INIT", ADDB_INIT},
 	{"ADDB_SIZE", ADDB_SIZE},
+	{"FORCE_COPY", FORCE_COPY},
 };
 
 #define NKEYS (sizeof(lookuptable)/sizeof(struct key_lookup_table))
@@ -534,6 +536,11 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			cw = workload_io(w);
 			cw->cwi_rounds = atoi(value);
 			break;
+		case FORCE_COPY:
+			w = &load[*index];
+			cw = workload_io(w);
+			cw->cwi_force_copy = atoi(value);
+			break;
 		case ADDB_INIT:
 			conf->is_addb_init = atoi(value);
 			break;
@@ -101,6 +101,9 @@ enum m0_magic_satchel {
 	/* be_alloc_chunk::bac_magic_free (edifice faded) */
 	M0_BE_ALLOC_FREE_LINK_MAGIC = 0xed1f1cefaded,
 
+	/* m0_be_alloc_mag::bam_chunks (sagged cases) */
+	M0_BE_ALLOC_MAG_MAGIC = 0x5a66edca5e5,
+
 	/* m0_be_0type::b0_magic (bee fires stig) */
 	M0_BE_0TYPE_MAGIC = 0x33beef17e5519177,
 
@@ -245,6 +248,9 @@ enum m0_magic_satchel {
 	/* m0_conf_cache::ca_registry::t_magic (fabled feodal) */
 	M0_CONF_CACHE_MAGIC = 0x33fab1edfe0da177,
 
+	/* m0_conf_cache::ca_hash::t_magic (cased idle bee) */
+	M0_CONF_CACHE_HASH_MAGIC = 0x33ca5ed1d1eb0e77,
+
 	/* m0_conf_obj::co_gen_magic (selfless cell) */
 	M0_CONF_OBJ_MAGIC = 0x335e1f1e55ce1177,
 
@@ -686,6 +692,12 @@ enum m0_magic_satchel {
 	/* net/sock.c: buf list head (bad dada decaf) */
 	M0_NET_SOCK_BUF_HEAD_MAGIC = 0x33baddadadecaf77,
 
+	/* net/sock.c: conn list element, conn::c_magix (coded iced ice) */
+	M0_NET_SOCK_CONN_MAGIC = 0x33c0ded1ced1ce77,
+
+	/* net/sock.c: conn list head (acceded, coded) */
+	M0_NET_SOCK_CONN_HEAD_MAGIC = 0x33accededc0ded77,
+
 	/* net/net.h: m0_nep list element, endpoint (obsessed loll) */
 	M0_NET_NEP_MAGIC = 0x330b5e55ed101177,
 
@@ -862,6 +874,9 @@ enum m0_magic_satchel {
 	/* rpc_conn_tl::td_head_magic (bloodless god) */
 	M0_RPC_CONN_HEAD_MAGIC = 0x33b100d1e5590d77,
 
+	/* rpc_conn_hash_tl::td_head_magic (baseball boated) */
+	M0_RPC_CONN_HASH_HEAD_MAGIC = 0x33ba5eba11b0a7ed,
+
 	/* m0_rpc_session::s_magic (azido ballade) */
 	M0_RPC_SESSION_MAGIC = 0x33a21d0ba11ade77,
 
@@ -913,6 +928,9 @@ enum m0_magic_satchel {
 	/* stob/cache.c:stob_cache_tl::td_head_magic (cache billed) */
 	M0_STOB_CACHE_HEAD_MAGIC    = 0x33cac4eb111ed77,
 
+	/* stob/cache.c:stob_cache_hash_tl::td_head_magic (cache fed) */
+	M0_STOB_CACHE_HASH_MAGIC    = 0x33cac4ef0ed77,
+
 	/* m0_stob_type::st_magic (disc class) */
 	M0_STOB_TYPES_MAGIC         = 0x33d15cc1a5577,
 
@@ -1007,6 +1025,9 @@ enum m0_magic_satchel {
 	/* m0_timer_tid::tt_magic (eila alia dill) */
 	M0_LIB_TIMER_TID_MAGIC = 0x33e11aa11ad11177,
 
+	/* lib/objpool.c:objpool_hdr::oh_magic (obelisk bead) */
+	M0_LIB_OBJPOOL_MAGIC   = 0x330be115cbead077,
+
 /* sss */
 	/* ss_svc::sss_magic (coffeeleaf ad) */
 	M0_SS_SVC_MAGIC = 0x33c0ffee1eafad77,
@@ -1062,6 +1083,12 @@ enum m0_magic_satchel {
 	M0_RM_MAGIC           = 0x331CE1CE1C0E2277,
 	/* rm_ctx_tl::td_head_magic (coca cola sea) */
 	M0_RM_HEAD_MAGIC      = 0x33C0CAC01A5EA277,
+	/* io_cache_pg::icp_magic (cached bead fed) */
+	M0_IO_CACHE_PG_MAGIC  = 0x33cacedbeadfed77,
+	/* icp_lru_tl::td_head_magic (cache dead beef) */
+	M0_IO_CACHE_LRU_MAGIC = 0x33cacedeadbeef77,
+	/* icp_hash_tl::td_head_magic (feed cached bee) */
+	M0_IO_CACHE_HT_MAGIC  = 0x33feedcacedbee77,
 
 /* module/param */
 	/* m0_param_source::ps_magic (boozed billie) */
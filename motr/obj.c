@@ -250,6 +250,9 @@ static void obj_namei_cb_launch(struct m0_op_common *oc)
 		case M0_EO_DELETE:
 			m0_sm_move(&op->op_entity->en_sm, 0,
 				   M0_ES_DELETING);
+			m0_io_cache_obj_invalidate(
+				&m0__entity_instance(op->op_entity)->
+				m0c_read_cache, &op->op_entity->en_id);
 			break;
 		case M0_EO_OPEN:
 			m0_sm_move(&op->op_entity->en_sm, 0,
@@ -392,6 +392,11 @@ struct pargrp_iomap {
 	 * any of the replicas of this group are corrupted.
 	 */
 	bool                            pi_is_corrupted;
+	/**
+	 * True if data pages of this group were filled from the client read
+	 * cache, no network IO is done for such a group.
+	 */
+	bool                            pi_cached;
 };
 
 /** Operations vector for struct pargrp_iomap. */
@@ -0,0 +1,473 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "motr/client.h"
+#include "motr/client_internal.h"
+#include "motr/io.h"
+#include "motr/pg.h"
+#include "motr/io_cache.h"
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CLIENT
+#include "lib/trace.h"        /* M0_LOG */
+
+#include "ut/ut.h"            /* M0_UT_ASSERT */
+#include "motr/ut/client.h"
+
+struct m0_ut_suite        ut_suite_io_cache;
+static struct m0_client  *dummy_instance;
+static struct m0_realm    dummy_realm;
+
+/** Number of pargrp_iomap_ops::pi_readrest() calls made by the cache. */
+static uint32_t           readrest_nr;
+
+/** Fills all data pages of the map with "pattern". */
+static void cache_map_fill(struct pargrp_iomap *map, char pattern)
+{
+	struct data_buf *db;
+	uint32_t         row;
+	uint32_t         col;
+
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col) {
+			db = map->pi_databufs[row][col];
+			memset(db->db_buf.b_addr, pattern, db->db_buf.b_nob);
+		}
+	}
+}
+
+/** True iff every data page of the map holds "pattern". */
+static bool cache_map_holds(struct pargrp_iomap *map, char pattern)
+{
+	struct data_buf *db;
+	uint32_t         row;
+	uint32_t         col;
+	m0_bcount_t      i;
+
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col) {
+			db = map->pi_databufs[row][col];
+			for (i = 0; i < db->db_buf.b_nob; ++i) {
+				if (((char *)db->db_buf.b_addr)[i] != pattern)
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Emulates pargrp_iomap_readrest(): all pages of the dummy maps are already
+ * allocated, so it only has to mark them for reading.
+ */
+static int cache_ut_readrest(struct pargrp_iomap *map)
+{
+	uint32_t row;
+	uint32_t col;
+
+	M0_UT_ASSERT(map->pi_rtype == PIR_READREST);
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col)
+			map->pi_databufs[row][col]->db_flags |= PA_READ;
+	}
+	++readrest_nr;
+	return 0;
+}
+
+static const struct pargrp_iomap_ops cache_ut_iomap_ops = {
+	.pi_readrest = cache_ut_readrest
+};
+
+/** Identifier of the object all operations of this suite are done on. */
+static struct m0_uint128 cache_obj_id(void)
+{
+	struct m0_uint128 id = M0_ID_APP;
+
+	id.u_lo++;
+	return id;
+}
+
+/**
+ * Creates an operation on groups [grp, grp + nr) of a fixed object. All data
+ * pages of the groups are marked as read, so that the groups are cacheable and
+ * the sequential read-rest path is never taken.
+ */
+static struct m0_op_io *cache_ioo_create(enum m0_obj_opcode opcode,
+					 uint64_t grp, uint32_t nr)
+{
+	struct m0_op_io     *ioo;
+	struct pargrp_iomap *map;
+	uint32_t             i;
+	uint32_t             row;
+	uint32_t             col;
+
+	ioo = ut_dummy_ioo_create(dummy_instance, nr);
+	ioo->ioo_oo.oo_oc.oc_op.op_code = opcode;
+	ioo->ioo_obj->ob_entity.en_realm = &dummy_realm;
+	ioo->ioo_obj->ob_entity.en_id = cache_obj_id();
+	ioo->ioo_nwxfer.nxr_rc = 0;
+
+	for (i = 0; i < nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		map->pi_grpid = grp + i;
+		map->pi_ops = &cache_ut_iomap_ops;
+		for (row = 0; row < map->pi_max_row; ++row) {
+			for (col = 0; col < map->pi_max_col; ++col)
+				map->pi_databufs[row][col]->db_flags |=
+					PA_READ;
+		}
+	}
+	return ioo;
+}
+
+static void cache_ioo_delete(struct m0_op_io *ioo)
+{
+	ioo->ioo_oo.oo_oc.oc_op.op_code = M0_OC_READ;
+	ut_dummy_ioo_delete(ioo, dummy_instance);
+}
+
+/**
+ * Executes the read operation "ioo", whose groups hold "pattern". Checks the
+ * groups served from the cache and fills the cache with the others. Returns
+ * the number of groups served from the cache.
+ */
+static uint32_t cache_ioo_read(struct m0_op_io *ioo, char pattern)
+{
+	struct pargrp_iomap *map;
+	uint32_t             nr = 0;
+	uint32_t             i;
+	int                  rc;
+
+	/* Pages are overwritten on a hit, start with a different pattern. */
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i)
+		cache_map_fill(ioo->ioo_iomaps[i], ~pattern);
+	rc = m0_io_cache_read_prepare(ioo);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		if (map->pi_cached) {
+			M0_UT_ASSERT(cache_map_holds(map, pattern));
+			++nr;
+		} else
+			/* Emulate the data coming from the ioservices. */
+			cache_map_fill(map, pattern);
+	}
+	M0_UT_ASSERT(nr == ioo->ioo_cached_nr);
+	m0_io_cache_read_done(ioo);
+	return nr;
+}
+
+/** Reads group "grp", filling the cache on a miss. Returns true on a hit. */
+static bool cache_read(uint64_t grp, char pattern)
+{
+	struct m0_op_io *ioo;
+	bool             hit;
+
+	ioo = cache_ioo_create(M0_OC_READ, grp, 1);
+	hit = cache_ioo_read(ioo, pattern) == 1;
+	cache_ioo_delete(ioo);
+	return hit;
+}
+
+/**
+ * Reads the first page of group "grp", which must not be cached, only. Returns
+ * true iff the group was extended to a whole-group read.
+ */
+static bool cache_read_partial(uint64_t grp, char pattern)
+{
+	struct m0_op_io     *ioo;
+	struct pargrp_iomap *map;
+	uint32_t             row;
+	uint32_t             col;
+	bool                 full;
+
+	ioo = cache_ioo_create(M0_OC_READ, grp, 1);
+	map = ioo->ioo_iomaps[0];
+	for (row = 0; row < map->pi_max_row; ++row) {
+		for (col = 0; col < map->pi_max_col; ++col) {
+			if (row + col > 0)
+				map->pi_databufs[row][col]->db_flags &=
+					~PA_READ;
+		}
+	}
+	M0_UT_ASSERT(cache_ioo_read(ioo, pattern) == 0);
+	full = map->pi_databufs[map->pi_max_row - 1]
+			       [map->pi_max_col - 1]->db_flags & PA_READ;
+	cache_ioo_delete(ioo);
+	return full;
+}
+
+static void cache_update(enum m0_obj_opcode opcode, uint64_t grp)
+{
+	struct m0_op_io *ioo;
+
+	ioo = cache_ioo_create(opcode, grp, 1);
+	m0_io_cache_invalidate(ioo);
+	cache_ioo_delete(ioo);
+}
+
+/** Re-initialises the client cache with a budget of "grp_nr" groups. */
+static void cache_reset(uint32_t grp_nr)
+{
+	struct m0_op_io *ioo;
+	m0_bcount_t      size;
+
+	ioo = cache_ioo_create(M0_OC_READ, 0, 1);
+	size = data_size(pdlayout_get(ioo));
+	cache_ioo_delete(ioo);
+
+	m0_io_cache_fini(&dummy_instance->m0c_read_cache);
+	m0_io_cache_init(&dummy_instance->m0c_read_cache, grp_nr * size);
+	readrest_nr = 0;
+}
+
+static void cache_stats(struct m0_io_cache_stats *stats)
+{
+	m0_io_cache_stats_get(&dummy_instance->m0c_read_cache, stats);
+}
+
+static void ut_test_io_cache_hit(void)
+{
+	struct m0_io_cache_stats st;
+
+	cache_reset(2);
+	M0_UT_ASSERT(!cache_read(0, 'a'));
+	M0_UT_ASSERT(cache_read(0, 'a'));
+	M0_UT_ASSERT(cache_read(0, 'a'));
+	M0_UT_ASSERT(!cache_read(1, 'b'));
+	M0_UT_ASSERT(cache_read(1, 'b'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_hits == 3);
+	M0_UT_ASSERT(st.ics_misses == 2);
+	M0_UT_ASSERT(st.ics_fills == 2);
+	M0_UT_ASSERT(st.ics_evictions == 0);
+	cache_reset(0);
+}
+
+static void ut_test_io_cache_invalidate(void)
+{
+	struct m0_io_cache_stats st;
+	struct m0_op_io         *ioo;
+	int                      rc;
+
+	cache_reset(2);
+	/* Write. */
+	M0_UT_ASSERT(!cache_read(0, 'a'));
+	cache_update(M0_OC_WRITE, 0);
+	M0_UT_ASSERT(!cache_read(0, 'b'));
+	M0_UT_ASSERT(cache_read(0, 'b'));
+	/* Truncate. */
+	cache_update(M0_OC_FREE, 0);
+	M0_UT_ASSERT(!cache_read(0, 'c'));
+	M0_UT_ASSERT(cache_read(0, 'c'));
+	/* An update of another group keeps this one. */
+	cache_update(M0_OC_WRITE, 1);
+	M0_UT_ASSERT(cache_read(0, 'c'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_invalidations == 2);
+
+	/* A read that raced with an update must not fill the cache. */
+	cache_update(M0_OC_WRITE, 0);
+	ioo = cache_ioo_create(M0_OC_READ, 0, 1);
+	rc = m0_io_cache_read_prepare(ioo);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(ioo->ioo_cached_nr == 0);
+	cache_update(M0_OC_WRITE, 0);
+	cache_map_fill(ioo->ioo_iomaps[0], 'd');
+	m0_io_cache_read_done(ioo);
+	cache_ioo_delete(ioo);
+	M0_UT_ASSERT(!cache_read(0, 'e'));
+	M0_UT_ASSERT(cache_read(0, 'e'));
+	cache_reset(0);
+}
+
+static void ut_test_io_cache_evict(void)
+{
+	struct m0_io_cache_stats st;
+
+	cache_reset(2);
+	M0_UT_ASSERT(!cache_read(0, 'a'));
+	M0_UT_ASSERT(!cache_read(1, 'b'));
+	/* Make group 1 the least recently used one. */
+	M0_UT_ASSERT(cache_read(0, 'a'));
+	M0_UT_ASSERT(!cache_read(2, 'c'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_evictions == 1);
+	M0_UT_ASSERT(dummy_instance->m0c_read_cache.ic_used <=
+		     dummy_instance->m0c_read_cache.ic_budget);
+	M0_UT_ASSERT(cache_read(0, 'a'));
+	M0_UT_ASSERT(cache_read(2, 'c'));
+	M0_UT_ASSERT(!cache_read(1, 'b'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_evictions == 2);
+	cache_reset(0);
+}
+
+static void ut_test_io_cache_readrest(void)
+{
+	struct m0_io_cache_stats st;
+
+	cache_reset(4);
+	/* A lone partial read is not extended and not cached. */
+	M0_UT_ASSERT(!cache_read_partial(0, 'a'));
+	M0_UT_ASSERT(readrest_nr == 0);
+	/* The next group continues the stream and is read whole. */
+	M0_UT_ASSERT(cache_read_partial(1, 'b'));
+	M0_UT_ASSERT(readrest_nr == 1);
+	M0_UT_ASSERT(cache_read(1, 'b'));
+	M0_UT_ASSERT(!cache_read(0, 'a'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_readrests == 1);
+	M0_UT_ASSERT(st.ics_fills == 2);
+
+	/* A stream jumping ahead is restarted. */
+	M0_UT_ASSERT(!cache_read_partial(3, 'c'));
+	M0_UT_ASSERT(cache_read_partial(4, 'd'));
+	M0_UT_ASSERT(cache_read(4, 'd'));
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_readrests == 2);
+	cache_reset(0);
+}
+
+static void ut_test_io_cache_multi_group(void)
+{
+	struct m0_io_cache_stats st;
+	struct m0_op_io         *ioo;
+
+	cache_reset(4);
+	M0_UT_ASSERT(!cache_read(1, 'a'));
+	/* Only the middle group of the three is served from the cache. */
+	ioo = cache_ioo_create(M0_OC_READ, 0, 3);
+	M0_UT_ASSERT(cache_ioo_read(ioo, 'a') == 1);
+	M0_UT_ASSERT(!ioo->ioo_iomaps[0]->pi_cached);
+	M0_UT_ASSERT(ioo->ioo_iomaps[1]->pi_cached);
+	M0_UT_ASSERT(!ioo->ioo_iomaps[2]->pi_cached);
+	cache_ioo_delete(ioo);
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_hits == 1);
+	M0_UT_ASSERT(st.ics_misses == 3);
+	M0_UT_ASSERT(st.ics_fills == 3);
+
+	/* The remaining groups were filled by the partially cached read. */
+	ioo = cache_ioo_create(M0_OC_READ, 0, 3);
+	M0_UT_ASSERT(cache_ioo_read(ioo, 'a') == 3);
+	cache_ioo_delete(ioo);
+
+	/* An update of one group leaves the others cached. */
+	cache_update(M0_OC_WRITE, 1);
+	ioo = cache_ioo_create(M0_OC_READ, 0, 3);
+	M0_UT_ASSERT(cache_ioo_read(ioo, 'a') == 2);
+	M0_UT_ASSERT(!ioo->ioo_iomaps[1]->pi_cached);
+	cache_ioo_delete(ioo);
+	cache_reset(0);
+}
+
+static void ut_test_io_cache_obj_delete(void)
+{
+	struct m0_io_cache      *cache = &dummy_instance->m0c_read_cache;
+	struct m0_io_cache_stats st;
+	struct m0_uint128        id    = cache_obj_id();
+	struct m0_uint128        other = id;
+	struct m0_op_io         *ioo;
+	int                      rc;
+
+	cache_reset(4);
+	M0_UT_ASSERT(!cache_read(0, 'a'));
+	M0_UT_ASSERT(!cache_read(1, 'b'));
+	/* Deletion of another object keeps the groups. */
+	other.u_lo++;
+	m0_io_cache_obj_invalidate(cache, &other);
+	M0_UT_ASSERT(cache_read(0, 'a'));
+	m0_io_cache_obj_invalidate(cache, &id);
+	cache_stats(&st);
+	M0_UT_ASSERT(st.ics_invalidations == 2);
+	M0_UT_ASSERT(cache->ic_used == 0);
+	M0_UT_ASSERT(!cache_read(0, 'c'));
+	M0_UT_ASSERT(!cache_read(1, 'c'));
+
+	/* A read in flight during the deletion does not fill the cache. */
+	ioo = cache_ioo_create(M0_OC_READ, 2, 1);
+	rc = m0_io_cache_read_prepare(ioo);
+	M0_UT_ASSERT(rc == 0);
+	m0_io_cache_obj_invalidate(cache, &id);
+	cache_map_fill(ioo->ioo_iomaps[0], 'd');
+	m0_io_cache_read_done(ioo);
+	cache_ioo_delete(ioo);
+	M0_UT_ASSERT(!cache_read(2, 'e'));
+	cache_reset(0);
+}
+
+M0_INTERNAL int ut_io_cache_init(void)
+{
+	int                       rc;
+	struct m0_pdclust_layout *dummy_pdclust_layout;
+
+	m0_client_init_io_op();
+
+	rc = ut_m0_client_init(&dummy_instance);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(!dummy_instance->m0c_config->mc_is_read_verify);
+	dummy_realm.re_instance = dummy_instance;
+
+	ut_layout_domain_fill(dummy_instance);
+	dummy_pdclust_layout =
+		ut_dummy_pdclust_layout_create(dummy_instance);
+	M0_UT_ASSERT(dummy_pdclust_layout != NULL);
+
+	return 0;
+}
+
+M0_INTERNAL int ut_io_cache_fini(void)
+{
+	ut_layout_domain_empty(dummy_instance);
+	ut_m0_client_fini(&dummy_instance);
+
+	return 0;
+}
+
+struct m0_ut_suite ut_suite_io_cache = {
+	.ts_name = "io-cache-ut",
+	.ts_init = ut_io_cache_init,
+	.ts_fini = ut_io_cache_fini,
+	.ts_tests = {
+		{ "hit",        &ut_test_io_cache_hit },
+		{ "invalidate", &ut_test_io_cache_invalidate },
+		{ "evict",      &ut_test_io_cache_evict },
+		{ "readrest",   &ut_test_io_cache_readrest },
+		{ "multi-group", &ut_test_io_cache_multi_group },
+		{ "obj-delete", &ut_test_io_cache_obj_delete },
+		{ NULL, NULL },
+	}
+};
+#undef M0_TRACE_SUBSYSTEM
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
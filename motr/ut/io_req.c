@@ -26,6 +26,7 @@
 #include "lib/trace.h"        /* M0_LOG */
 #include "lib/uuid.h"         /* m0_uuid_generate */
 #include "lib/finject.h"      /* Failure Injection */
+#include "lib/atomic.h"       /* m0_atomic64 */
 #include "ioservice/fid_convert.h"
 
 #include "ut/ut.h"            /* M0_UT_ASSERT */
@@ -906,6 +907,81 @@ static void ut_test_ioreq_parity_recalc(void)
 	ut_dummy_ioo_delete(ioo, instance);
 }
 
+static struct m0_atomic64 parity_job_nr;
+static int                parity_job_rc;
+
+static int ut_parity_recalc_count(struct pargrp_iomap *map)
+{
+	m0_atomic64_inc(&parity_job_nr);
+	return map->pi_grpid == 3 ? parity_job_rc : 0;
+}
+
+static const struct pargrp_iomap_ops parity_count_ops = {
+	.pi_parity_recalc = ut_parity_recalc_count,
+};
+
+static void ut_test_ioreq_parity_recalc_parallel(void)
+{
+	int                      rc;
+	int                      i;
+	struct m0_op_io         *ioo;
+	struct m0_client        *instance = dummy_instance;
+	struct m0_parallel_pool *pool = &instance->m0c_parity_pool;
+	struct m0_realm          realm;
+
+	/* The queue is shorter than the request, so it is run in batches. */
+	rc = m0_parallel_pool_init(pool, 2, 2);
+	M0_UT_ASSERT(rc == 0);
+	instance->m0c_parity_pool_on = true;
+
+	ioo = ut_dummy_ioo_create(instance, 5);
+	ioo->ioo_obj->ob_entity.en_realm = &realm;
+	ioo->ioo_oo.oo_oc.oc_op.op_code = M0_OC_WRITE;
+	realm.re_instance = instance;
+	for (i = 0; i < ioo->ioo_iomap_nr; i++)
+		ioo->ioo_iomaps[i]->pi_ops = &parity_count_ops;
+
+	m0_semaphore_init(&cpus_sem, 1);
+
+	/* Test 1. All groups are processed on the pool. */
+	parity_job_rc = 0;
+	m0_atomic64_set(&parity_job_nr, 0);
+	rc = ioreq_parity_recalc(ioo);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&parity_job_nr) == 5);
+
+	/*
+	 * Test 2. A failed group fails the request. The batch holding it is
+	 * completed, the rest of the groups are not queued.
+	 */
+	parity_job_rc = -EIO;
+	m0_atomic64_set(&parity_job_nr, 0);
+	rc = ioreq_parity_recalc(ioo);
+	M0_UT_ASSERT(rc != 0);
+	M0_UT_ASSERT(m0_atomic64_get(&parity_job_nr) == 4);
+
+	/* Test 3. Nothing is left queued by the failed request. */
+	parity_job_rc = 0;
+	m0_atomic64_set(&parity_job_nr, 0);
+	rc = ioreq_parity_recalc(ioo);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&parity_job_nr) == 5);
+
+	/* Test 4. The pool is busy, groups are processed in place. */
+	m0_atomic64_set(&parity_job_nr, 0);
+	m0_mutex_lock(&instance->m0c_parity_lock);
+	rc = ioreq_parity_recalc(ioo);
+	m0_mutex_unlock(&instance->m0c_parity_lock);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&parity_job_nr) == 5);
+
+	/* Clean up */
+	ut_dummy_ioo_delete(ioo, instance);
+	instance->m0c_parity_pool_on = false;
+	m0_parallel_pool_terminate_wait(pool);
+	m0_parallel_pool_fini(pool);
+}
+
 static void ut_test_ioreq_application_data_copy(void)
 {
 	int               i;
@@ -1243,6 +1319,8 @@ struct m0_ut_suite ut_suite_io_req = {
 				    &ut_test_ioreq_application_data_copy},
 		{ "ioreq_parity_recalc",
 				    &ut_test_ioreq_parity_recalc},
+		{ "ioreq_parity_recalc_parallel",
+				    &ut_test_ioreq_parity_recalc_parallel},
 		{ "device_check",
 				    &ut_test_device_check},
 		{ "ioreq_dgmode_recover",
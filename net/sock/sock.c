@@ -325,37 +325,75 @@
  * Concurrency
  * -----------
  *
- * sock module uses a very simple locking model: all state transitions are
- * protected by a per-tm mutex: m0_net_transfer_mc::ntm_mutex. For synchronous
- * activity, this mutex is taken by the entry-point code in net/ and is not
- * released until the entry-point completes. For asynchronous activity, poller()
- * keeps the lock taken most of the time.
+ * A transfer machine runs one or more poller threads (the number is set per
+ * transfer machine by m0_net_sock_tm_poller_nr_set(), default is 1), each with
+ * its own epoll instance and its own lock. An end-point is assigned to a poller
+ * when it is created (ep::e_poller). All sockets to the end-point are
+ * monitored by that poller and all writers sending to the end-point are run by
+ * it, so events for an end-point are handled in order by a single thread.
+ *
+ * There are two locks:
+ *
+ *     - the tm lock: m0_net_transfer_mc::ntm_mutex. It is taken by the
+ *       entry-point code in net/ and protects the generic transfer machine
+ *       state (buffer queues, the list of end-points and their reference
+ *       counts), sock state machines, the lists of sockets of end-points
+ *       (ep::e_sock, poller::p_deathrow) and the queues through which a poller
+ *       gets work from other threads (poller::p_writer, poller::p_conn,
+ *       poller::p_done);
+ *
+ *     - the poller lock: poller::p_grp::s_lock. It protects the state private
+ *       to the poller: its movers (which are in poller::p_grp state machine
+ *       group), writer lists of its end-points (ep::e_writer) and the io state
+ *       of its sockets.
+ *
+ * The poller lock is taken before the tm lock. Lists and fields protected by
+ * the tm lock, but owned by a poller (ep::e_sock, sock states, etc.) are
+ * modified with both locks held, so that they can be read under either.
+ *
+ * A poller keeps its lock while it handles an epoll_wait(2) batch and takes
+ * the tm lock only for short sections that touch the transfer machine: to
+ * find a buffer for an incoming packet (pk_header_done()), to complete a
+ * buffer (pk_done(), writer_error()), to link a new socket (sock_init()), etc.
+ * Socket io runs under the poller lock only, in parallel with the other
+ * pollers and with the user threads.
+ *
+ * Threads holding the tm lock (user threads calling into net/ and pollers
+ * completing buffers) never take a poller lock. Instead, they queue work to
+ * the poller and wake it up through its eventfd (poller_wake()):
+ *
+ *     - buf_add() places a new writer on poller::p_writer. The poller moves it
+ *       to the end-point writer list and opens a socket if necessary
+ *       (poller_intake());
+ *
+ *     - a connection accepted by the poller monitoring the listening socket is
+ *       passed to the poller of the peer end-point through poller::p_conn;
+ *
+ *     - buffer completion (buf_done()) includes removing the buffer from its
+ *       queue and invoking a user-supplied call-back
+ *       (m0_net_buffer::nb_callbacks), which net.h requires to be invoked with
+ *       the tm lock released. This cannot be done in the middle of a mover
+ *       state transition or in a synchronous context (m0_net_buf_del()->...->
+ *       buf_del()), so the buffer is always placed on poller::p_done of the
+ *       poller running its movers (buf::b_poller). The poller completes it in
+ *       poller_buf_done() at the end of the batch.
  *
  * A few items related to concurrency worth mentioning:
  *
- *     - transfer machine shutdown (ma_stop()) is somewhat subtle, see a comment
- *       in poller() about ma__fini();
+ *     - transfer machine shutdown (ma__fini()) sets ma::t_shutdown, wakes the
+ *       pollers up and releases the tm lock while it waits for them to exit.
+ *       Then it takes all poller locks and finalises the sockets on behalf of
+ *       the pollers;
  *
- *     - the tm lock is not held while epoll_wait() is executed by poller(). On
+ *     - the locks are not held while epoll_wait() is executed by poller(). On
  *       the other hand, the pointer to a sock structure is stored inside of
  *       epoll kernel-state (sock_ctl()). This means that sock structures cannot
  *       be freed in a synchronous context, lest the epoll-stored state points
  *       to an invalid memory region. To deal with this, a sock is not freed
  *       immediately. Instead it is moved to S_DELETED state and placed on a
- *       special per-tm list: ma::t_deathrow. Actual freeing is done by
- *       ma_prune() called from poller();
- *
- *     - buffer completion (buf_done()) includes removing the buffer from its
- *       queue and invoking a user-supplied call-back
- *       (m0_net_buffer::nb_callbacks). Completion can happen both
- *       asynchronously (when a transfer operation completes for the buffer or
- *       the buffer times out (ma_buf_timeout())) and synchronously (when the
- *       buffer is canceled by the user (m0_net_buf_del()->...->buf_del()). The
- *       difficulty is that net.h interface specifies that the transfer machine
- *       lock is to be released before invoking the call-back. This cannot be
- *       done in a synchronous context (to avoid breaking invariants), so in
- *       this case the buffer is queued to a special ma::t_done queue which is
- *       processed asynchronously by ma_buf_done().
+ *       special per-poller list: poller::p_deathrow. Actual freeing is done by
+ *       poller_prune() called from poller() of the poller monitoring the
+ *       sock, after the events from the last epoll_wait() are processed.
  *
  * Socket interface use
  * --------------------
@@ -375,6 +413,14 @@
  *     - ipv4 and ipv6 protocol families are supported. Unix domain sockets are
  *       not supported.
  *
+ *     - optionally (m0_net_sock_zerocopy_set(), or M0_NET_SOCK_ZEROCOPY
+ *       environment variable read at module initialisation), large payloads
+ *       are sent over stream sockets with linux MSG_ZEROCOPY. Such a buffer is
+ *       completed only after the completion notification is read from the
+ *       socket error queue (sock_zc_reap()), or after the connection is
+ *       aborted (sock_zc_abort()). Incoming payload is read by readv(2)
+ *       directly into the buffer segments, see pk_io().
+ *
  * When a socket is created, it is added to the epoll instance monitored by
  * poller() (sock_init_fd()). All sockets are monitored for read events. Only
  * sockets to end-points with a non-empty list of writers are monitored for
@@ -471,8 +517,8 @@
  *
  *     - operation is in progress: data are transferred to or from the buffer;
  *
- *     - normal operation completion: buf_done(), ma_buf_done(). User-provided
- *       call-back is invoked;
+ *     - normal operation completion: buf_done(), poller_buf_done().
+ *       User-provided call-back is invoked;
  *
  *     - alternatively: timeout (ma_buf_timeout());
  *
@@ -615,8 +661,25 @@
 #include <netinet/in.h>                    /* INET_ADDRSTRLEN */
 #include <netinet/ip.h>
 #include <arpa/inet.h>                     /* inet_pton, htons */
-#include <string.h>                        /* strchr */
+#include <string.h>                        /* strchr, strcmp */
+#include <stdlib.h>                        /* getenv */
 #include <unistd.h>                        /* close */
+#include <sys/eventfd.h>                   /* eventfd */
+#include <linux/errqueue.h>                /* sock_extended_err */
+
+/* Older headers do not define these; old kernels fail setsockopt(2). */
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY                (60)
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY               (0x4000000)
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY      (5)
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED (1)
+#endif
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_NET
 #include "lib/trace.h"
@@ -632,6 +695,7 @@
 #include "lib/bitmap.h"
 #include "lib/refs.h"
 #include "lib/time.h"
+#include "lib/hash.h"                      /* m0_hash */
 #include "sm/sm.h"
 #include "motr/magic.h"
 #include "net/net.h"
@@ -639,6 +703,7 @@
 #include "net/net_internal.h"              /* m0_net__tm_invariant */
 #include "format/format.h"
 
+#include "net/sock/sock.h"
 #include "net/sock/xcode.h"
 #include "net/sock/xcode_xc.h"
 
@@ -682,7 +747,8 @@ enum sock_state {
 	S_OPEN,
 	/**
 	 * The sock has been finalised (sock_done()) and is now placed on
-	 * ma::t_deathrow list. It will be collected and freed by ma_prune().
+	 * poller::p_deathrow list. It will be collected and freed by
+	 * poller_prune().
 	 */
 	S_DELETED
 };
@@ -707,7 +773,9 @@ enum sock_flags {
 	/** Non blocking write is possible on the sock. */
 	HAS_WRITE  = M0_BITS(M_WRITE),
 	/** Non-blocking writes are monitored for this sock by epoll(2). */
-	WRITE_POLL = M0_BITS(M_NR + 1)
+	WRITE_POLL = M0_BITS(M_NR + 1),
+	/** Payload is sent with MSG_ZEROCOPY, see sock_zc_reap(). */
+	ZEROCOPY   = M0_BITS(M_NR + 2)
 };
 
 /**
@@ -755,8 +823,17 @@ struct ep {
 	struct addr             e_a;
 	/** Sockets opened to this end-point. */
 	struct m0_tl            e_sock;
-	/** Writers sending data to this end-point. */
+	/**
+	 * Writers sending data to this end-point. Protected by the poller
+	 * lock.
+	 */
 	struct m0_tl            e_writer;
+	/**
+	 * Index of the poller (in ma::t_poller[]) monitoring all sockets to
+	 * this end-point. Keeping all sockets of an end-point in the same
+	 * poller preserves the order of events for the end-point.
+	 */
+	uint32_t                e_poller;
 #ifdef EP_DEBUG
 	int e_r_mover;
 	int e_r_sock;
@@ -765,41 +842,88 @@ struct ep {
 #endif
 };
 
+/**
+ * A poller: a thread with its own epoll(2) instance.
+ *
+ * All asynchronous activity happens in poller threads:
+ *
+ *     - notifications about incoming connections;
+ *
+ *     - notifications about possibility of non-blocking socket io;
+ *
+ *     - buffer completion events (poller_buf_done());
+ *
+ *     - buffer timeouts (ma_buf_timeout());
+ *
+ *     - freeing socket structures (poller_prune());
+ *
+ * A transfer machine has one or more pollers (ma::t_poller[]). Sockets and
+ * writers are sharded across pollers by end-point (ep::e_poller). See the
+ * "Concurrency" section for locking.
+ *
+ * Poller can easily be adapter to be a "chore" in a locality.
+ */
+struct poller {
+	struct ma                 *p_ma;
+	struct m0_thread           p_thread;
+	/** epoll(2) instance file descriptor. */
+	int                        p_epollfd;
+	/**
+	 * eventfd(2) through which other threads wake the poller up, see
+	 * poller_wake(). It is in the epoll instance with NULL data pointer.
+	 */
+	int                        p_wakefd;
+	/** The poller has been woken up, but has not taken its queues yet. */
+	bool                       p_woken;
+	/**
+	 * State machine group of the movers run by the poller. Its lock is
+	 * the poller lock.
+	 */
+	struct m0_sm_group         p_grp;
+	/** New writers to the end-points of this poller, see ep_add(). */
+	struct m0_tl               p_writer;
+	/** Incoming connections to the end-points of this poller. */
+	struct m0_tl               p_conn;
+	/** Buffers to be completed by this poller, see buf_done(). */
+	struct m0_tl               p_done;
+	/**
+	 * List of finalised sock structures, monitored by this poller.
+	 *
+	 * Only the poller itself frees them, after it has processed the
+	 * events returned by the last epoll_wait(2), which can point to them.
+	 */
+	struct m0_tl               p_deathrow;
+	/** Number of sockets monitored by this poller. */
+	uint32_t                   p_sock_nr;
+	/** Number of socket events handled by this poller. */
+	uint64_t                   p_event_nr;
+};
+
 /** A network transfer machine */
 struct ma {
 	/** Generic transfer machine with buffer queues, etc. */
 	struct m0_net_transfer_mc *t_ma;
-	/**
-	 * Poller thread.
-	 *
-	 * All asynchronous activity happens in this thread:
-	 *
-	 *     - notifications about incoming connections;
-	 *
-	 *     - notifications about possibility of non-blocking socket io;
-	 *
-	 *     - buffer completion events (ma_buf_done());
-	 *
-	 *     - buffer timeouts (ma_buf_timeout());
-	 *
-	 *     - freeing socket structures (ma_prune());
-	 *
-	 * Poller can easily be adapter to be a "chore" in a locality.
-	 *
-	 */
-	struct m0_thread           t_poller;
-	/** epoll(2) instance file descriptor. */
-	int                        t_epollfd;
+	/** Pollers, see struct poller. */
+	struct poller             *t_poller;
+	uint32_t                   t_poller_nr;
+	/** Processors to which pollers are confined, see ma_confine(). */
+	struct m0_bitmap           t_processors;
+	/** Set by ma__fini() to tell the pollers to exit. */
 	bool                       t_shutdown;
-	/** List of finalised sock structures. */
-	struct m0_tl               t_deathrow;
-	/**
-	 * A lock used for synchronisation with the poller thread during
-	 * transfer machine shutdown. See the comment in poller().
-	 */
-	struct m0_mutex            t_endlock;
-	/** List of completed buffers. */
-	struct m0_tl               t_done;
+};
+
+/**
+ * An incoming connection, accepted by the poller monitoring the listening
+ * socket and passed to the poller of the peer end-point (poller::p_conn).
+ */
+struct conn {
+	uint64_t        c_magix;
+	/** The socket returned by accept4(2). */
+	int             c_fd;
+	/** The peer end-point. The connection holds a reference to it. */
+	struct ep      *c_ep;
+	/** Linkage in poller::p_conn. */
+	struct m0_tlink c_linkage;
 };
 
 /**
@@ -863,7 +987,10 @@ struct mover {
 	struct ep                 *m_ep;
 	struct m0_sm               m_sm;
 	const struct mover_op_vec *m_op;
-	/** Linkage in the list of writers for an end-point (ep::e_writer). */
+	/**
+	 * Linkage in the list of writers for an end-point (ep::e_writer) or,
+	 * until the poller takes the writer, in poller::p_writer.
+	 */
 	struct m0_tlink            m_linkage;
 	/** The buffer from or to which data are moved. */
 	struct buf                *m_buf;
@@ -900,8 +1027,16 @@ struct buf {
 	struct bdesc          b_peer;
 	/** The other end-point for the transfer. */
 	struct ep            *b_other;
-	/** Linkage in the list of completed buffers (ma::t_done). */
+	/**
+	 * Linkage in the list of completed buffers (poller::p_done) or in
+	 * sock::s_zc_wait.
+	 */
 	struct m0_tlink       b_linkage;
+	/**
+	 * The poller running movers of this buffer, which completes the
+	 * buffer. NULL if the buffer has not been used by a mover yet.
+	 */
+	struct poller        *b_poller;
 	/** Not currently used. */
 	m0_bindex_t           b_offset;
 	/**
@@ -909,6 +1044,16 @@ struct buf {
 	 * packet::p_totalsize.
 	 */
 	m0_bindex_t           b_length;
+	/**
+	 * Socket through which buffer data were last sent with MSG_ZEROCOPY,
+	 * or NULL.
+	 */
+	struct sock          *b_zc_sock;
+	/**
+	 * The buffer cannot be completed until sock::s_zc_done reaches this
+	 * value: the kernel still references buffer pages.
+	 */
+	uint32_t              b_zc_end;
 };
 
 /** A socket: connection to an end-point. */
@@ -923,10 +1068,19 @@ struct sock {
 	struct ep      *s_ep;
 	/** The reader that handles packets incoming to this socket. */
 	struct mover    s_reader;
-	/** Linkage in the list of finalised sockets (ma::t_deathrow). */
+	/** Linkage in the list of finalised sockets (poller::p_deathrow). */
 	struct m0_tlink s_linkage;
 	/** Not currently used. Will be used to garbage collect idle sockets. */
 	m0_time_t       s_last;
+	/** Sequence number of the next MSG_ZEROCOPY send through the sock. */
+	uint32_t        s_zc_next;
+	/** All MSG_ZEROCOPY sends before this one have been completed. */
+	uint32_t        s_zc_done;
+	/**
+	 * Buffers done with, waiting for MSG_ZEROCOPY completions. Linked
+	 * through buf::b_linkage.
+	 */
+	struct m0_tl    s_zc_wait;
 };
 
 /**
@@ -986,6 +1140,11 @@ M0_TL_DESCR_DEFINE(b, "buffers",
 		   M0_NET_SOCK_BUF_MAGIC, M0_NET_SOCK_BUF_HEAD_MAGIC);
 M0_TL_DEFINE(b, static, struct buf);
 
+M0_TL_DESCR_DEFINE(c, "connections",
+		   static, struct conn, c_linkage, c_magix,
+		   M0_NET_SOCK_CONN_MAGIC, M0_NET_SOCK_CONN_HEAD_MAGIC);
+M0_TL_DEFINE(c, static, struct conn);
+
 static int  dom_init(struct m0_net_xprt *xprt, struct m0_net_domain *dom);
 static void dom_fini(struct m0_net_domain *dom);
 static int  ma_init(struct m0_net_transfer_mc *ma);
@@ -1009,15 +1168,26 @@ static m0_bcount_t get_max_buffer_segment_size(const struct m0_net_domain *);
 static int32_t get_max_buffer_segments(const struct m0_net_domain *dom);
 static m0_bcount_t get_max_buffer_desc_size(const struct m0_net_domain *);
 
-static void poller   (struct ma *ma);
+static void poller   (struct poller *p);
+static void poller_prune(struct poller *p);
+static void poller_lock  (struct poller *p);
+static void poller_unlock(struct poller *p);
+static bool poller_is_locked(const struct poller *p);
+static bool poller_invariant(struct poller *p);
+static void poller_wake  (struct poller *p);
+static bool poller_intake(struct poller *p);
+static void poller_buf_done(struct poller *p);
+static int  poller_open  (struct poller *p);
+static void poller_drain (struct poller *p);
+static int  ma_pollers_init(struct ma *ma, uint32_t nr);
+static void ma_pollers_fini(struct ma *ma);
+static struct sock *ma_sock(struct ma *ma);
 static void ma__fini (struct ma *ma);
-static void ma_prune (struct ma *ma);
 static void ma_lock  (struct ma *ma);
 static void ma_unlock(struct ma *ma);
 static bool ma_is_locked(const struct ma *ma);
 static bool ma_invariant(const struct ma *ma);
 static void ma_event_post (struct ma *ma, enum m0_net_tm_state state);
-static void ma_buf_done   (struct ma *ma);
 static void ma_buf_timeout(struct ma *ma);
 static struct buf *ma_recv_buf(struct ma *ma, m0_bcount_t len);
 
@@ -1031,12 +1201,15 @@ static void ep_put    (struct ep *ep);
 static void ep_get    (struct ep *ep);
 static bool ep_eq     (const struct ep *ep, const struct addr *addr);
 static struct ma *ep_ma (struct ep *ep);
+static struct poller *ep_poller(struct ep *ep);
 static struct ep *ep_net(struct m0_net_end_point *net);
 static void ep_release(struct m0_ref *ref);
 static bool ep_invariant(const struct ep *ep);
-static int  ep_add(struct ep *ep, struct mover *w);
+static bool ep_writers_invariant(struct ep *ep);
+static void ep_add(struct ep *ep, struct mover *w);
 static void ep_del(struct mover *w);
 static int  ep_balance(struct ep *ep);
+static int  conn_add(struct ep *ep, int fd);
 
 static int   addr_resolve     (struct addr *addr, const char *name);
 static int   addr_parse       (struct addr *addr, const char *name);
@@ -1047,6 +1220,7 @@ static void  addr_encode      (const struct addr *addr, struct sockaddr *sa);
 static char *addr_print       (const struct addr *addr);
 static bool  addr_invariant   (const struct addr *addr);
 static bool  addr_eq          (const struct addr *a0, const struct addr *a1);
+static uint64_t addr_hash      (const struct addr *addr);
 
 static int  sock_in(struct sock *s);
 static void sock_out(struct sock *s);
@@ -1057,22 +1231,32 @@ static bool sock_event(struct sock *s, uint32_t ev);
 static int  sock_ctl(struct sock *s, int op, uint32_t flags);
 static int  sock_init_fd(int fd, struct sock *s, struct ep *ep, uint32_t flags);
 static int  sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags);
+static int  sock_open(int fd, struct ep *src, struct ep *tgt, uint32_t flags,
+		      struct sock **out);
+static void sock_link(struct sock *s, int state);
+static void sock_free(struct sock *s);
 static struct mover *sock_writer(struct sock *s);
 static bool sock_invariant(const struct sock *s);
+static bool sock_zc_reap(struct sock *s);
+static void sock_zc_abort(struct sock *s);
 
 static struct ma *buf_ma(struct buf *buf);
+static struct poller *buf_poller(struct buf *buf);
 static bool buf_invariant(const struct buf *buf);
 static void buf_fini     (struct buf *buf);
 static int  buf_accept   (struct buf *buf, struct mover *m);
 static void buf_done     (struct buf *buf, int rc);
 static void buf_complete (struct buf *buf);
+static bool buf_zc_busy  (const struct buf *buf);
+static void buf_writer_add(struct buf *buf, struct ep *ep,
+			   const struct mover_op_vec *vop);
 
 static int bdesc_create(struct addr *addr, struct buf *buf,
 			struct m0_net_buf_desc *out);
 static int bdesc_encode(const struct bdesc *bd, struct m0_net_buf_desc *out);
 static int bdesc_decode(const struct m0_net_buf_desc *nbd, struct bdesc *out);
 
-static void mover_init(struct mover *m, struct ma *ma,
+static void mover_init(struct mover *m, struct poller *p,
 		       const struct mover_op_vec *vop);
 static void mover_fini(struct mover *m);
 static int  mover_op  (struct mover *m, struct sock *s, int op);
@@ -1090,6 +1274,7 @@ static int pk_iov_prep(struct mover *m, struct iovec *iv, int nr,
 		       struct m0_bufvec *bv, m0_bcount_t size, int *count);
 static void pk_header_init(struct mover *m, struct sock *s);
 static int  pk_header_done(struct mover *m);
+static int  pk_buf_find(struct mover *m, bool isget, bool hasdst);
 static void pk_done  (struct mover *m);
 static void pk_encdec(struct mover *m, enum m0_xcode_what what);
 static void pk_decode(struct mover *m);
@@ -1194,28 +1379,60 @@ static const struct socktype stype[] = {
 #define EP_PUT(e, f) ep_put(e)
 #endif
 
+enum {
+	/**
+	 * Minimal payload size sent with MSG_ZEROCOPY. Page pinning and
+	 * completion notifications cost more than copying of small writes.
+	 */
+	ZEROCOPY_MIN = 16 * 1024
+};
+
+/** Whether sockets opened afterwards try to enable MSG_ZEROCOPY. */
+static bool sock_zerocopy = false;
+
+M0_INTERNAL void m0_net_sock_zerocopy_set(bool on)
+{
+	sock_zerocopy = on;
+}
+
 static bool ma_invariant(const struct ma *ma)
 {
 	const struct m0_net_transfer_mc *net = ma->t_ma;
 	const struct m0_tl              *eps = &net->ntm_end_points;
+	const struct poller             *pl  = ma->t_poller;
 
 	return  _0C(net != NULL) &&
 		_0C(net->ntm_xprt_private == ma) &&
 		m0_net__tm_invariant(net) &&
-		s_tlist_invariant(&ma->t_deathrow) &&
+		_0C(pl != NULL && ma->t_poller_nr > 0) &&
+		_0C(m0_forall(i, ma->t_poller_nr,
+			      pl[i].p_ma == ma &&
+			      s_tlist_invariant(&pl[i].p_deathrow) &&
+			      m_tlist_invariant(&pl[i].p_writer) &&
+			      c_tlist_invariant(&pl[i].p_conn) &&
+			      b_tlist_invariant(&pl[i].p_done))) &&
 		/* ma is either fully uninitialised or fully initialised. */
-		_0C((ma->t_poller.t_func == NULL && ma->t_epollfd == -1 &&
-		     m0_nep_tlist_is_empty(eps) &&
-		     s_tlist_is_empty(&ma->t_deathrow)) ||
-		    (ma->t_poller.t_func != NULL && ma->t_epollfd >= 0 &&
+		_0C((m0_forall(i, ma->t_poller_nr,
+			       pl[i].p_thread.t_func == NULL &&
+			       pl[i].p_epollfd == -1 &&
+			       pl[i].p_wakefd == -1 &&
+			       s_tlist_is_empty(&pl[i].p_deathrow)) &&
+		     m0_nep_tlist_is_empty(eps)) ||
+		    (m0_forall(i, ma->t_poller_nr,
+			       pl[i].p_thread.t_func != NULL &&
+			       pl[i].p_epollfd >= 0 &&
+			       pl[i].p_wakefd >= 0) &&
 		     m0_tl_exists(m0_nep, nep, eps,
 				  m0_tl_exists(s, s, &ep_net(nep)->e_sock,
 					  s->s_sm.sm_state == S_LISTENING))) ||
 		    ma->t_shutdown) &&
 		/* In STARTED state ma is fully initialised. */
 		_0C(ergo(net->ntm_state == M0_NET_TM_STARTED,
-			 ma->t_epollfd >= 0)) &&
-		_0C(m0_tl_forall(s, s, &ma->t_deathrow, sock_invariant(s))) &&
+			 m0_forall(i, ma->t_poller_nr,
+				   pl[i].p_epollfd >= 0))) &&
+		_0C(m0_forall(i, ma->t_poller_nr,
+			      m0_tl_forall(s, s, &pl[i].p_deathrow,
+					   sock_invariant(s)))) &&
 		/* Endpoints are unique. */
 		_0C(m0_tl_forall(m0_nep, p, eps,
 			m0_tl_forall(m0_nep, q, eps,
@@ -1225,15 +1442,36 @@ static bool ma_invariant(const struct ma *ma)
 		_0C(m0_forall(i, ARRAY_SIZE(net->ntm_q),
 			m0_tl_forall(m0_net_tm, nb, &net->ntm_q[i],
 				     buf_invariant(nb->nb_xprt_private)))) &&
-		_0C(m0_tl_forall(b, buf, &ma->t_done, buf_invariant(buf)));
+		_0C(m0_forall(i, ma->t_poller_nr,
+			      m0_tl_forall(b, buf, &pl[i].p_done,
+					   buf_invariant(buf))));
+}
+
+/**
+ * Checks the state owned by a poller. Both the poller and the tm locks must
+ * be held.
+ */
+static bool poller_invariant(struct poller *p)
+{
+	struct ma *ma = p->p_ma;
+
+	return  _0C(poller_is_locked(p) && ma_is_locked(ma)) &&
+		_0C(m0_tl_forall(m, w, &p->p_writer,
+				 mover_is_writer(w) && w->m_ep != NULL &&
+				 ep_poller(w->m_ep) == p)) &&
+		_0C(m0_tl_forall(c, c, &p->p_conn,
+				 ep_poller(c->c_ep) == p)) &&
+		_0C(m0_tl_forall(m0_nep, nep, &ma->t_ma->ntm_end_points,
+				 ep_poller(ep_net(nep)) != p ||
+				 ep_writers_invariant(ep_net(nep))));
 }
 
 static bool sock_invariant(const struct sock *s)
 {
-	struct ma *ma = ep_ma(s->s_ep);
+	struct poller *p = ep_poller(s->s_ep);
 
 	return  _0C((s->s_sm.sm_state == S_DELETED) ==
-		    s_tlist_contains(&ma->t_deathrow, s)) &&
+		    s_tlist_contains(&p->p_deathrow, s)) &&
 		_0C((s->s_sm.sm_state != S_DELETED) ==
 		    s_tlist_contains(&s->s_ep->e_sock, s));
 }
@@ -1273,21 +1511,33 @@ static bool ep_invariant(const struct ep *ep)
 		_0C(ep->e_ep.nep_addr != NULL) &&
 #ifdef EP_DEBUG
 		/*
-		 * Reference counters consistency:
-		 */
-
-		/* Each writer got a reference... */
-		_0C(ep->e_r_mover == m_tlist_length(&ep->e_writer)) &&
-		/*
-		 * and each socket (including ones lingering on ma->t_deathrow)
-		 * got a reference.
+		 * Reference counters consistency: each socket (including ones
+		 * lingering on poller::p_deathrow) got a reference. Writer
+		 * references are checked by ep_writers_invariant().
 		 */
 		_0C(ep->e_r_sock  == s_tlist_length(&ep->e_sock) +
-		    m0_tl_fold(s, s, dead, &ma->t_deathrow, 0,
-			       dead + (s->s_ep == ep))) &&
+		    m0_tl_fold(s, s, dead, &ep_poller((void *)ep)->p_deathrow,
+			       0, dead + (s->s_ep == ep))) &&
 #endif
+		_0C(ep->e_poller < ma->t_poller_nr) &&
 		_0C(m0_tl_forall(s, s, &ep->e_sock,
-				 s->s_ep == ep && sock_invariant(s))) &&
+				 s->s_ep == ep && sock_invariant(s)));
+}
+
+/**
+ * Checks the writers of an end-point, which are protected by the poller lock,
+ * see poller_invariant().
+ */
+static bool ep_writers_invariant(struct ep *ep)
+{
+	return
+#ifdef EP_DEBUG
+		/* Each writer, including not yet taken by the poller, got a
+		   reference. */
+		_0C(ep->e_r_mover == m_tlist_length(&ep->e_writer) +
+		    m0_tl_fold(m, w, nr, &ep_poller(ep)->p_writer,
+			       0, nr + (w->m_ep == ep))) &&
+#endif
 		_0C(m0_tl_forall(m, w, &ep->e_writer,
 				 w->m_ep == ep &&
 				 /*
@@ -1335,13 +1585,58 @@ static bool ma_is_locked(const struct ma *ma)
 	return m0_mutex_is_locked(&ma->t_ma->ntm_mutex);
 }
 
+static void poller_lock(struct poller *p)
+{
+	m0_mutex_lock(&p->p_grp.s_lock);
+}
+
+static void poller_unlock(struct poller *p)
+{
+	m0_mutex_unlock(&p->p_grp.s_lock);
+}
+
+static bool poller_is_locked(const struct poller *p)
+{
+	return m0_mutex_is_locked(&p->p_grp.s_lock);
+}
+
+/**
+ * Wakes the poller up to take the work queued to it.
+ *
+ * The poller does not have to wake itself up: it checks its queues before
+ * waiting for events again.
+ */
+static void poller_wake(struct poller *p)
+{
+	uint64_t one = 1;
+
+	M0_PRE(ma_is_locked(p->p_ma));
+	if (m0_thread_self() != &p->p_thread && !p->p_woken &&
+	    p->p_wakefd >= 0) {
+		p->p_woken = true;
+		if (write(p->p_wakefd, &one, sizeof one) != sizeof one)
+			M0_LOG(M0_ERROR, "eventfd: %i.", errno);
+	}
+}
+
+/** Consumes the wake-ups, see poller_wake(). */
+static void poller_drain(struct poller *p)
+{
+	uint64_t nr;
+
+	if (read(p->p_wakefd, &nr, sizeof nr) < 0 && errno != EAGAIN)
+		M0_LOG(M0_ERROR, "eventfd: %i.", errno);
+}
+
 /**
- * Main loop of a per-ma thread that polls sockets.
+ * Main loop of a poller thread.
  */
-static void poller(struct ma *ma)
+static void poller(struct poller *p)
 {
 	enum { EV_NR = 256 };
+	struct ma         *ma = p->p_ma;
 	struct epoll_event ev[EV_NR] = {};
+	int                timeout = 1000;
 	int                nr;
 	int                i;
 	/*
@@ -1349,8 +1644,8 @@ static void poller(struct ma *ma)
 	 *
 	 * This also sets ma->ntm_ep.
 	 *
-	 * This should be done once per tm, so if multiple poller threads are
-	 * used, only 1 event should be posted.
+	 * This should be done once per tm, so only the first poller posts the
+	 * event.
 	 *
 	 * @todo there is a race condition here: an application (i.e., the rpc
 	 * layer), might timeout waiting for the ma to start and call
@@ -1359,52 +1654,33 @@ static void poller(struct ma *ma)
 	 *
 	 * Because of this, we do not assert ma states here.
 	 */
-	ma_event_post(ma, M0_NET_TM_STARTED);
+	if (p == &ma->t_poller[0])
+		ma_event_post(ma, M0_NET_TM_STARTED);
 	while (1) {
-		nr = epoll_wait(ma->t_epollfd, ev, ARRAY_SIZE(ev), 1000);
+		nr = epoll_wait(p->p_epollfd, ev, ARRAY_SIZE(ev), timeout);
 		if (nr == -1) {
 			M0_LOG(M0_DEBUG, "epoll: %i.", -errno);
 			M0_ASSERT(errno == EINTR);
 			continue;
 		}
 		M0_LOG(M0_DEBUG, "Got: %d.", nr);
+		poller_lock(p);
 		/*
-		 * Synchronisation between the poller thread and ma shutdown
-		 * process (ma__fini()) is complicated.
-		 *
-		 * ma__fini() is called under the ma lock and has to wait for
-		 * the thread termination. ma__fini() cannot release the ma
-		 * lock, because ma invariants are broken at this point. The
-		 * thread cannot take ma lock, because that would deadlock with
-		 * ma__fini().
-		 *
-		 * A separate lock ma->t_endlock is introduced. ma__fini() sets
-		 * ma->t_shutdown under both ma lock and ma->t_endlock (taken in
-		 * this order), and immediately releases ->t_endlock.
-		 *
-		 * The poller thread takes locks in the opposite direction
-		 * through the trylock-repeat loop below.
+		 * Drain the eventfd before taking the queues, so that work
+		 * queued after poller_intake() wakes the poller up again.
 		 */
-		while (1) {
-			m0_mutex_lock(&ma->t_endlock);
-			if (ma->t_shutdown)
-				break;
-			else if (m0_mutex_trylock(&ma->t_ma->ntm_mutex) != 0) {
-				m0_mutex_unlock(&ma->t_endlock);
-				ma_lock(ma);
-				ma_unlock(ma);
-			} else
-				break;
-		}
-		m0_mutex_unlock(&ma->t_endlock); /* It is safe to unlock. */
-		if (ma->t_shutdown)
+		if (m0_exists(j, nr, ev[j].data.ptr == NULL))
+			poller_drain(p);
+		if (!poller_intake(p)) { /* ma__fini() waits for the exit. */
+			poller_unlock(p);
 			break;
-		M0_ASSERT(ma_is_locked(ma) && ma_invariant(ma));
+		}
 		for (i = 0; i < nr; ++i) {
 			struct sock *s = ev[i].data.ptr;
 
-			if (s->s_sm.sm_state == S_DELETED)
+			if (s == NULL || s->s_sm.sm_state == S_DELETED)
 				continue;
+			p->p_event_nr++;
 			if (sock_event(s, ev[i].events))
 				/*
 				 * Ran out of buffers on the receive queue,
@@ -1413,22 +1689,104 @@ static void poller(struct ma *ma)
 				 */
 				break;
 		}
+		ma_lock(ma);
 		/* @todo close long-unused sockets. */
-		ma_buf_timeout(ma);
+		if (p == &ma->t_poller[0])
+			ma_buf_timeout(ma);
 		/*
 		 * Deliver buffer completion events and re-provision receive
 		 * queue if necessary.
 		 */
-		ma_buf_done(ma);
-		M0_ASSERT(ma_invariant(ma));
+		poller_buf_done(p);
 		/*
 		 * This is the only place, where sock structures are freed,
 		 * except for ma finalisation.
 		 */
-		ma_prune(ma);
-		M0_ASSERT(ma_invariant(ma));
+		poller_prune(p);
+		M0_ASSERT(ma_invariant(ma) && poller_invariant(p));
+		/* Do not wait for events, if the poller queued work to itself. */
+		timeout = m_tlist_is_empty(&p->p_writer) &&
+			  c_tlist_is_empty(&p->p_conn) ? 1000 : 0;
+		ma_unlock(ma);
+		poller_unlock(p);
+	}
+}
+
+/**
+ * Takes the work queued to the poller by other threads and by the poller
+ * itself.
+ *
+ * New writers are moved to the writer lists of their end-points and sockets
+ * are opened or armed for writes (ep_balance()). Sock structures are created
+ * for the accepted connections.
+ *
+ * Returns false iff the transfer machine is shutting down.
+ */
+static bool poller_intake(struct poller *p)
+{
+	struct ma    *ma = p->p_ma;
+	struct mover *w;
+	struct conn  *c;
+	int           result;
+
+	M0_PRE(poller_is_locked(p) && !ma_is_locked(ma));
+	ma_lock(ma);
+	if (ma->t_shutdown) {
 		ma_unlock(ma);
+		return false;
+	}
+	M0_ASSERT(ma_invariant(ma) && poller_invariant(p));
+	p->p_woken = false;
+	while ((w = m_tlist_pop(&p->p_writer)) != NULL) {
+		m_tlist_add_tail(&w->m_ep->e_writer, w);
+		ma_unlock(ma);
+		result = ep_balance(w->m_ep);
+		if (result != 0) {
+			m0_sm_state_set(&w->m_sm, R_FAIL);
+			w->m_op->v_error(w, NULL, result);
+			m0_sm_state_set(&w->m_sm, R_DONE);
+		}
+		ma_lock(ma);
+	}
+	while ((c = c_tlist_pop(&p->p_conn)) != NULL) {
+		ma_unlock(ma);
+		/* sock_init() closes the socket on a failure. */
+		(void)sock_init(c->c_fd, ma_src(ma), c->c_ep, 0);
+		ma_lock(ma);
+		EP_PUT(c->c_ep, find);
+		c_tlink_fini(c);
+		m0_free(c);
+	}
+	ma_unlock(ma);
+	return true;
+}
+
+/**
+ * Completes the buffers queued to the poller (poller::p_done).
+ *
+ * A buffer is placed on poller::p_done by buf_done(), when its operation is
+ * done. Completion call-back is invoked here, at the end of an event batch,
+ * with the tm lock released around it (buf_complete()).
+ */
+static void poller_buf_done(struct poller *p)
+{
+	struct ma  *ma = p->p_ma;
+	struct buf *buf;
+	int         nr = 0;
+
+	M0_PRE(poller_is_locked(p) && ma_is_locked(ma) && ma_invariant(ma));
+	while ((buf = b_tlist_pop(&p->p_done)) != NULL) {
+		if (buf_zc_busy(buf))
+			/* Wait until sock_zc_reap() releases the buffer. */
+			b_tlist_add_tail(&buf->b_zc_sock->s_zc_wait, buf);
+		else {
+			buf_complete(buf);
+			nr++;
+		}
 	}
+	if (nr > 0 && ma->t_ma->ntm_callback_counter == 0)
+		m0_chan_broadcast(&ma->t_ma->ntm_chan);
+	M0_POST(ma_invariant(ma));
 }
 
 /**
@@ -1440,11 +1798,13 @@ static void poller(struct ma *ma)
  * address to bind, which is supplied as a parameter to
  * m0_net_xprt_ops::xo_tm_start(), is known.
  *
- * Poller thread (ma::t_poller) cannot be started, because a call to
- * m0_net_tm_confine() can be done after initialisation.
+ * Poller threads (ma::t_poller[]) cannot be started, because a call to
+ * m0_net_tm_confine() can be done after initialisation. The transfer machine
+ * gets a single poller, m0_net_sock_tm_poller_nr_set() can change this before
+ * the start.
  *
- * ->epollfd can be initialised here, but it is easier to initialise everything
- * in ma_start().
+ * ->p_epollfd can be initialised here, but it is easier to initialise
+ * everything in ma_start().
  *
  * Used as m0_net_xprt_ops::xo_tm_init().
  */
@@ -1457,29 +1817,90 @@ static int ma_init(struct m0_net_transfer_mc *net)
 
 	M0_ALLOC_PTR(ma);
 	if (ma != NULL) {
-		ma->t_epollfd = -1;
-		ma->t_shutdown = false;
-		net->ntm_xprt_private = ma;
-		ma->t_ma = net;
-		s_tlist_init(&ma->t_deathrow);
-		b_tlist_init(&ma->t_done);
-		m0_mutex_init(&ma->t_endlock);
-		result = 0;
+		result = ma_pollers_init(ma, 1);
+		if (result == 0) {
+			ma->t_shutdown = false;
+			net->ntm_xprt_private = ma;
+			ma->t_ma = net;
+		} else
+			m0_free(ma);
 	} else
 		result = M0_ERR(-ENOMEM);
 	return M0_RC(result);
 }
 
-/** Frees finalised sock structures. */
-static void ma_prune(struct ma *ma)
+/**
+ * Allocates and initialises "nr" pollers, replacing the current ones, which
+ * must not have been started.
+ */
+static int ma_pollers_init(struct ma *ma, uint32_t nr)
+{
+	struct poller *pl;
+	uint32_t       i;
+
+	M0_PRE(nr > 0);
+	M0_ALLOC_ARR(pl, nr);
+	if (pl == NULL)
+		return M0_ERR(-ENOMEM);
+	for (i = 0; i < nr; ++i) {
+		pl[i].p_ma      = ma;
+		pl[i].p_epollfd = -1;
+		pl[i].p_wakefd  = -1;
+		m0_sm_group_init(&pl[i].p_grp);
+		m_tlist_init(&pl[i].p_writer);
+		c_tlist_init(&pl[i].p_conn);
+		b_tlist_init(&pl[i].p_done);
+		s_tlist_init(&pl[i].p_deathrow);
+	}
+	ma_pollers_fini(ma);
+	ma->t_poller    = pl;
+	ma->t_poller_nr = nr;
+	return 0;
+}
+
+/** Finalises and frees the pollers. */
+static void ma_pollers_fini(struct ma *ma)
+{
+	struct poller *p;
+	uint32_t       i;
+
+	for (i = 0; i < ma->t_poller_nr; ++i) {
+		p = &ma->t_poller[i];
+		M0_ASSERT(p->p_epollfd == -1 && p->p_wakefd == -1);
+		s_tlist_fini(&p->p_deathrow);
+		b_tlist_fini(&p->p_done);
+		c_tlist_fini(&p->p_conn);
+		m_tlist_fini(&p->p_writer);
+		m0_sm_group_fini(&p->p_grp);
+	}
+	m0_free0(&ma->t_poller);
+	ma->t_poller_nr = 0;
+}
+
+/** Frees finalised sock structures of a poller. */
+static void poller_prune(struct poller *p)
 {
 	struct sock *sock;
 
-	M0_PRE(ma_is_locked(ma));
-	m0_tl_for(s, &ma->t_deathrow, sock) {
+	M0_PRE(poller_is_locked(p) && ma_is_locked(p->p_ma));
+	m0_tl_for(s, &p->p_deathrow, sock) {
 		sock_fini(sock);
 	} m0_tl_endfor;
-	M0_POST(s_tlist_is_empty(&ma->t_deathrow));
+	M0_POST(s_tlist_is_empty(&p->p_deathrow));
+}
+
+/** Returns a socket that has not been finalised yet, if any. */
+static struct sock *ma_sock(struct ma *ma)
+{
+	struct m0_net_end_point *net;
+	struct sock             *s;
+
+	ma_lock(ma);
+	net = m0_tl_find(m0_nep, nep, &ma->t_ma->ntm_end_points,
+			 !s_tlist_is_empty(&ep_net(nep)->e_sock));
+	s = net != NULL ? s_tlist_head(&ep_net(net)->e_sock) : NULL;
+	ma_unlock(ma);
+	return s;
 }
 
 /**
@@ -1487,41 +1908,74 @@ static void ma_prune(struct ma *ma)
  *
  * This is called from the normal finalisation path (ma_fini()) and in error
  * cleanup case during initialisation (ma_start()).
+ *
+ * The tm lock is released while the pollers are waited for, see the
+ * "Concurrency" section.
  */
 static void ma__fini(struct ma *ma)
 {
-	struct m0_net_end_point *net;
+	struct poller *p;
+	struct mover  *w;
+	struct conn   *c;
+	struct sock   *s;
+	int            i;
 
 	M0_PRE(ma_is_locked(ma));
 	if (!ma->t_shutdown) {
-		/* See comment in poller(). */
-		m0_mutex_lock(&ma->t_endlock);
 		ma->t_shutdown = true;
-		m0_mutex_unlock(&ma->t_endlock);
-		if (ma->t_poller.t_func != NULL) {
-			m0_thread_join(&ma->t_poller);
-			m0_thread_fini(&ma->t_poller);
-		}
-		m0_tl_for(m0_nep, &ma->t_ma->ntm_end_points, net) {
-			struct ep   *ep = ep_net(net);
-			struct sock *sock;
-			m0_tl_for(s, &ep->e_sock, sock) {
-				sock_done(sock, false);
-			} m0_tl_endfor;
-		} m0_tl_endfor;
+		for (i = 0; i < ma->t_poller_nr; ++i)
+			poller_wake(&ma->t_poller[i]);
 		/*
-		 * Finalise epoll after sockets, because sock_done() removes the
-		 * socket from the poll set.
+		 * A poller notices the shutdown (poller_intake()) and
+		 * completes its current batch under the tm lock.
 		 */
-		if (ma->t_epollfd >= 0) {
-			close(ma->t_epollfd);
-			ma->t_epollfd = -1;
+		ma_unlock(ma);
+		for (i = 0; i < ma->t_poller_nr; ++i) {
+			p = &ma->t_poller[i];
+			if (p->p_thread.t_func != NULL) {
+				m0_thread_join(&p->p_thread);
+				m0_thread_fini(&p->p_thread);
+			}
+		}
+		/* Act on behalf of the pollers from now on. */
+		for (i = 0; i < ma->t_poller_nr; ++i)
+			poller_lock(&ma->t_poller[i]);
+		ma_lock(ma);
+		for (i = 0; i < ma->t_poller_nr; ++i) {
+			p = &ma->t_poller[i];
+			m0_tl_teardown(m, &p->p_writer, w) {
+				m_tlist_add_tail(&w->m_ep->e_writer, w);
+			}
+			m0_tl_teardown(c, &p->p_conn, c) {
+				close(c->c_fd);
+				EP_PUT(c->c_ep, find);
+				c_tlink_fini(c);
+				m0_free(c);
+			}
+		}
+		ma_unlock(ma);
+		while ((s = ma_sock(ma)) != NULL)
+			sock_done(s, false);
+		ma_lock(ma);
+		for (i = 0; i < ma->t_poller_nr; ++i) {
+			p = &ma->t_poller[i];
+			poller_buf_done(p);
+			poller_prune(p);
+			/*
+			 * Finalise epoll after sockets, because sock_done()
+			 * removes the socket from the poll set.
+			 */
+			if (p->p_epollfd >= 0) {
+				close(p->p_epollfd);
+				p->p_epollfd = -1;
+			}
+			if (p->p_wakefd >= 0) {
+				close(p->p_wakefd);
+				p->p_wakefd = -1;
+			}
 		}
-		ma_buf_done(ma);
-		ma_prune(ma);
-		b_tlist_fini(&ma->t_done);
-		s_tlist_fini(&ma->t_deathrow);
-		m0_mutex_fini(&ma->t_endlock);
+		for (i = 0; i < ma->t_poller_nr; ++i)
+			poller_unlock(&ma->t_poller[i]);
 		M0_ASSERT(m0_nep_tlist_is_empty(&ma->t_ma->ntm_end_points));
 		ma->t_ma->ntm_ep = NULL;
 	}
@@ -1540,9 +1994,69 @@ static void ma_fini(struct m0_net_transfer_mc *net)
 	ma__fini(ma);
 	ma_unlock(ma);
 	net->ntm_xprt_private = NULL;
+	if (ma->t_processors.b_words != NULL)
+		m0_bitmap_fini(&ma->t_processors);
+	ma_pollers_fini(ma);
 	m0_free(ma);
 }
 
+/**
+ * Creates the epoll instance of the poller and the eventfd through which the
+ * poller is woken up.
+ */
+static int poller_open(struct poller *p)
+{
+	p->p_epollfd = epoll_create(1);
+	if (p->p_epollfd < 0)
+		return M0_ERR(-errno);
+	p->p_wakefd = eventfd(0, EFD_NONBLOCK);
+	if (p->p_wakefd < 0)
+		return M0_ERR(-errno);
+	if (epoll_ctl(p->p_epollfd, EPOLL_CTL_ADD, p->p_wakefd,
+		      &(struct epoll_event){
+			      .events = EPOLLIN,
+			      .data   = { .ptr = NULL }}) != 0)
+		return M0_ERR(-errno);
+	return 0;
+}
+
+/**
+ * Starts the idx-th poller thread.
+ *
+ * If the transfer machine is confined (ma_confine()), pollers are spread
+ * round-robin over the allowed processors, one processor per poller.
+ */
+static int poller_start(struct poller *p, int idx)
+{
+	struct ma       *ma = p->p_ma;
+	struct m0_bitmap cpu = {};
+	size_t           allowed;
+	size_t           nr;
+	size_t           i;
+	int              result;
+
+	result = M0_THREAD_INIT(&p->p_thread, struct poller *, NULL,
+				&poller, p, "socktm%d", idx);
+	if (result != 0 || ma->t_processors.b_nr == 0)
+		return M0_RC(result);
+	allowed = m0_bitmap_set_nr(&ma->t_processors);
+	if (allowed == 0)
+		return M0_RC(0);
+	result = m0_bitmap_init(&cpu, ma->t_processors.b_nr);
+	if (result == 0) {
+		for (i = 0, nr = 0; i < ma->t_processors.b_nr; ++i) {
+			if (m0_bitmap_get(&ma->t_processors, i) &&
+			    nr++ == idx % allowed) {
+				m0_bitmap_set(&cpu, i, true);
+				break;
+			}
+		}
+		result = m0_thread_confine(&p->p_thread, &cpu);
+		m0_bitmap_fini(&cpu);
+	}
+	return M0_RC(result);
+}
+
 /**
  * Starts initialised ma.
  *
@@ -1556,39 +2070,52 @@ static int ma_start(struct m0_net_transfer_mc *net, const char *name)
 {
 	struct ma *ma = net->ntm_xprt_private;
 	int        result;
+	int        i;
 
 	M0_PRE(ma_is_locked(ma) && ma_invariant(ma));
 	M0_PRE(net->ntm_state == M0_NET_TM_STARTING);
 
 	/*
-	 * - initialise epoll
+	 * - initialise epoll instances
 	 *
 	 * - parse the address and create the source endpoint
 	 *
 	 * - create the listening socket
 	 *
-	 * - start the poller thread.
+	 * - start the poller threads.
 	 *
 	 * Should be done in this order, because the poller thread uses the
 	 * listening socket to get the source endpoint to post a ma state change
 	 * event (outside of ma lock).
 	 */
-	ma->t_epollfd = epoll_create(1);
-	if (ma->t_epollfd >= 0) {
-		struct ep *ep;
+	for (i = 0, result = 0; i < ma->t_poller_nr && result == 0; ++i)
+		result = poller_open(&ma->t_poller[i]);
+	if (result == 0) {
+		struct ep     *ep;
+		struct poller *p;
+		struct sock   *s;
 
 		result = ep_find(ma, name, &ep);
 		if (result == 0) {
-			result = sock_init(-1, ep, NULL, EPOLLET);
-			if (result == 0) {
-				result = M0_THREAD_INIT(&ma->t_poller,
-							struct ma *, NULL,
-							&poller, ma, "socktm");
+			p = ep_poller(ep);
+			/*
+			 * Pollers are not running yet, so the poller lock can
+			 * be taken under the tm lock.
+			 */
+			poller_lock(p);
+			result = sock_open(-1, ep, NULL, EPOLLET, &s);
+			if (result >= 0) {
+				sock_link(s, result);
+				result = 0;
 			}
+			poller_unlock(p);
+			/* The first poller posts M0_NET_TM_STARTED, start it
+			   last. */
+			for (i = ma->t_poller_nr - 1; i >= 0 && result == 0; --i)
+				result = poller_start(&ma->t_poller[i], i);
 			EP_PUT(ep, find);
 		}
-	} else
-		result = -errno;
+	}
 	if (result != 0)
 		ma__fini(ma);
 	M0_POST(ma_invariant(ma));
@@ -1620,10 +2147,25 @@ static int ma_stop(struct m0_net_transfer_mc *net, bool cancel)
 	return 0;
 }
 
-static int ma_confine(struct m0_net_transfer_mc *ma,
+/**
+ * Remembers processors to which poller threads are confined when the transfer
+ * machine is started.
+ *
+ * Used as m0_net_xprt_ops::xo_tm_confine().
+ */
+static int ma_confine(struct m0_net_transfer_mc *net,
 		      const struct m0_bitmap *processors)
 {
-	return -ENOSYS;
+	struct ma *ma = net->ntm_xprt_private;
+	int        result;
+
+	M0_PRE(processors != NULL);
+	if (ma->t_processors.b_words != NULL)
+		m0_bitmap_fini(&ma->t_processors);
+	result = m0_bitmap_init(&ma->t_processors, processors->b_nr);
+	if (result == 0)
+		m0_bitmap_copy(&ma->t_processors, processors);
+	return M0_RC(result);
 }
 
 /**
@@ -1677,29 +2219,6 @@ static void ma_buf_timeout(struct ma *ma)
 	M0_POST(ma_invariant(ma));
 }
 
-/**
- * Finds buffers pending completion and completes them.
- *
- * A buffer is placed on ma::t_done queue when its operation is done, but the
- * completion call-back cannot be immediately invoked, for example, because
- * completion happened in a synchronous context.
- */
-static void ma_buf_done(struct ma *ma)
-{
-	struct buf *buf;
-	int         nr = 0;
-
-	M0_PRE(ma_is_locked(ma) && ma_invariant(ma));
-	m0_tl_for(b, &ma->t_done, buf) {
-		b_tlist_del(buf);
-		buf_complete(buf);
-		nr++;
-	} m0_tl_endfor;
-	if (nr > 0 && ma->t_ma->ntm_callback_counter == 0)
-		m0_chan_broadcast(&ma->t_ma->ntm_chan);
-	M0_POST(ma_invariant(ma));
-}
-
 /**
  * Finds a buffer on M0_NET_QT_MSG_RECV queue, ready to receive "len" bytes of
  * data.
@@ -1710,7 +2229,8 @@ static struct buf *ma_recv_buf(struct ma *ma, m0_bcount_t len)
 	nb = m0_tl_find(m0_net_tm, nb, &ma->t_ma->ntm_q[M0_NET_QT_MSG_RECV],({
 			struct buf *b = nb->nb_xprt_private;
 
-			b->b_done.b_words == NULL &&
+			/* Skip buffers pending completion. */
+			!b_tlink_is_in(b) && b->b_done.b_words == NULL &&
 			m0_vec_count(&nb->nb_buffer.ov_vec) >= len;
 	      }));
 	return nb != NULL ? nb->nb_xprt_private : NULL;
@@ -1792,7 +2312,6 @@ static int buf_add(struct m0_net_buffer *nb)
 {
 	struct buf   *buf  = nb->nb_xprt_private;
 	struct ma    *ma   = buf_ma(buf);
-	struct mover *w    = &buf->b_writer;
 	struct bdesc *peer = &buf->b_peer;
 	int           qt   = nb->nb_qtype;
 	int           result;
@@ -1802,11 +2321,6 @@ static int buf_add(struct m0_net_buffer *nb)
 	M0_PRE(nb->nb_offset == 0); /* Do not support an offset during add. */
 	M0_PRE((nb->nb_flags & M0_NET_BUF_RETAIN) == 0);
 
-	if (M0_IN(qt, (M0_NET_QT_MSG_SEND, M0_NET_QT_ACTIVE_BULK_SEND)))
-		mover_init(w, ma, &writer_op);
-	else if (qt == M0_NET_QT_ACTIVE_BULK_RECV)
-		mover_init(w, ma, &get_op);
-	w->m_buf = buf;
 	switch (qt) {
 	case M0_NET_QT_MSG_RECV:
 		result = 0;
@@ -1816,7 +2330,8 @@ static int buf_add(struct m0_net_buffer *nb)
 
 		M0_ASSERT(nb->nb_length <= m0_vec_count(&nb->nb_buffer.ov_vec));
 		peer->bd_addr = ep->e_a;
-		result = ep_add(ep, w);
+		buf_writer_add(buf, ep, &writer_op);
+		result = 0;
 		break;
 	}
 	case M0_NET_QT_PASSIVE_BULK_RECV: /* For passive buffers, generate */
@@ -1831,7 +2346,9 @@ static int buf_add(struct m0_net_buffer *nb)
 			struct ep *ep; /* Passive peer end-point. */
 			result = ep_create(ma, &peer->bd_addr, NULL, &ep);
 			if (result == 0) {
-				result = ep_add(ep, w);
+				buf_writer_add(buf, ep,
+					       qt == M0_NET_QT_ACTIVE_BULK_SEND ?
+					       &writer_op : &get_op);
 				EP_PUT(ep, find);
 			}
 		}
@@ -1840,8 +2357,6 @@ static int buf_add(struct m0_net_buffer *nb)
 		M0_IMPOSSIBLE("invalid queue type: %x", qt);
 		break;
 	}
-	if (result != 0)
-		mover_fini(w);
 	M0_POST(ma_is_locked(ma) && ma_invariant(ma) && buf_invariant(buf));
 	return M0_RC(result);
 }
@@ -1986,30 +2501,34 @@ static void sock_fini(struct sock *s)
 {
 	struct ma *ma = ep_ma(s->s_ep);
 
-	M0_PRE(ma_is_locked(ma));
+	M0_PRE(ma_is_locked(ma) && poller_is_locked(ep_poller(s->s_ep)));
 	M0_PRE(s->s_ep != NULL);
 	M0_PRE(s->s_reader.m_sm.sm_conf == NULL);
 	M0_PRE(s->s_sm.sm_conf != NULL);
 	M0_PRE(s->s_sm.sm_state == S_DELETED);
-	M0_PRE(s_tlist_contains(&ma->t_deathrow, s));
+	M0_PRE(s_tlist_contains(&ep_poller(s->s_ep)->p_deathrow, s));
 
 	EP_PUT(s->s_ep, sock);
 	s->s_ep = NULL;
 	m0_sm_fini(&s->s_sm);
 	s_tlink_del_fini(s);
+	b_tlist_fini(&s->s_zc_wait);
 	m0_free(s);
 }
 
 /**
  * Finalises the socket.
  *
+ * Called by the poller monitoring the socket, without the tm lock.
+ *
  * @see sock_fini().
  */
 static void sock_done(struct sock *s, bool balance)
 {
-	struct ma *ma = ep_ma(s->s_ep);
+	struct ma     *ma = ep_ma(s->s_ep);
+	struct poller *p  = ep_poller(s->s_ep);
 
-	M0_PRE(ma_is_locked(ma));
+	M0_PRE(poller_is_locked(p) && !ma_is_locked(ma));
 	M0_PRE(s->s_ep != NULL);
 	M0_PRE(s->s_reader.m_sm.sm_conf != NULL);
 	M0_PRE(s->s_sm.sm_conf != NULL);
@@ -2024,19 +2543,47 @@ static void sock_done(struct sock *s, bool balance)
 		if (s->s_fd > 0) {
 			int result = sock_ctl(s, EPOLL_CTL_DEL, 0);
 			M0_ASSERT(ergo(result != 0, errno == ENOENT));
+			if (s->s_zc_next != 0)
+				sock_zc_abort(s);
 			shutdown(s->s_fd, SHUT_RDWR);
 			close(s->s_fd);
 			s->s_fd = -1;
 		}
+		ma_lock(ma);
 		m0_sm_state_set(&s->s_sm, S_DELETED);
-		s_tlist_move(&ma->t_deathrow, s);
+		s_tlist_move(&p->p_deathrow, s);
+		M0_CNT_DEC(p->p_sock_nr);
+		ma_unlock(ma);
 		if (balance)
 			(void)ep_balance(s->s_ep);
 	}
 }
 
 /**
- * Allocates and initialises a new socket between given endpoints.
+ * Opens a new socket (sock_open()) and links it to the transfer machine
+ * (sock_link()).
+ *
+ * Called by the poller monitoring the socket, without the tm lock.
+ */
+static int sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags)
+{
+	struct ma   *ma = ep_ma(src);
+	struct sock *s;
+	int          result;
+
+	M0_PRE(!ma_is_locked(ma));
+	result = sock_open(fd, src, tgt, flags, &s);
+	if (result >= 0) {
+		ma_lock(ma);
+		sock_link(s, result);
+		ma_unlock(ma);
+		result = 0;
+	}
+	return M0_RC(result);
+}
+
+/**
+ * Allocates a new socket between given endpoints.
  *
  * "src" is the source end-point, the "self" end-point of the local transfer
  * machine.
@@ -2047,8 +2594,14 @@ static void sock_done(struct sock *s, bool balance)
  * If "fd" is negative, a new socket is created and connected (without
  * blocking). Otherwise (fd >= 0), the socket already exists (returned from
  * accept4(2), see sock_event()), and a sock structure should be created for it.
+ *
+ * The new socket is added to the epoll instance of the poller, but is not
+ * visible to the transfer machine: this does not need the tm lock. Returns the
+ * initial socket state, to be passed to sock_link(), or an error. In the
+ * latter case the socket, including "fd", is released.
  */
-static int sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags)
+static int sock_open(int fd, struct ep *src, struct ep *tgt, uint32_t flags,
+		     struct sock **out)
 {
 	struct ma   *ma = ep_ma(src);
 	struct ep   *ep = tgt ?: src;
@@ -2056,23 +2609,23 @@ static int sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags)
 	int          result;
 	int          state = S_INIT;
 
-	M0_PRE(ma_is_locked(ma));
+	M0_PRE(poller_is_locked(ep_poller(ep)));
 	M0_PRE((flags & ~(EPOLLOUT|EPOLLET)) == 0);
-	M0_PRE(src != NULL);
 	M0_PRE(M0_IN(ma->t_ma->ntm_ep, (NULL, &src->e_ep)));
 	M0_PRE(ergo(tgt != NULL, ma == ep_ma(tgt) &&
 		    src->e_a.a_family   == tgt->e_a.a_family &&
 		    src->e_a.a_socktype == tgt->e_a.a_socktype &&
 		    src->e_a.a_protocol == tgt->e_a.a_protocol));
 	M0_ALLOC_PTR(s);
-	if (s == NULL)
+	if (s == NULL) {
+		if (fd >= 0)
+			close(fd);
 		return M0_ERR(-ENOMEM);
+	}
 	s->s_ep = ep;
-	EP_GET(ep, sock);
-	s_tlink_init_at(s, &ep->e_sock);
-	m0_sm_init(&s->s_sm, &sock_conf, state, &ma->t_ma->ntm_group);
-	mover_init(&s->s_reader, ma, stype[ep->e_a.a_socktype].st_reader);
-	s->s_reader.m_sock = s;
+	s->s_fd = -1;
+	s_tlink_init(s);
+	b_tlist_init(&s->s_zc_wait);
 	result = sock_init_fd(fd, s, src, flags);
 	if (result == 0) {
 		if (fd >= 0) {
@@ -2109,17 +2662,51 @@ static int sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags)
 			} else
 				result = M0_ERR(-errno);
 		}
-		if (result == 0)
-			m0_sm_state_set(&s->s_sm, state);
 	}
-	if (result != 0)
-		sock_done(s, false);
-	M0_POST(ergo(result == 0, s != NULL && sock_invariant(s)));
-	return M0_RC(result);
+	if (result == 0)
+		*out = s;
+	else
+		sock_free(s);
+	return M0_RC(result ?: state);
+}
+
+/**
+ * Makes a socket returned by sock_open() visible to the transfer machine.
+ *
+ * Both the tm lock and the lock of the poller monitoring the socket must be
+ * held.
+ */
+static void sock_link(struct sock *s, int state)
+{
+	struct ep     *ep = s->s_ep;
+	struct ma     *ma = ep_ma(ep);
+	struct poller *p  = ep_poller(ep);
+
+	M0_PRE(ma_is_locked(ma) && poller_is_locked(p));
+	EP_GET(ep, sock);
+	s_tlist_add_tail(&ep->e_sock, s);
+	m0_sm_init(&s->s_sm, &sock_conf, S_INIT, &ma->t_ma->ntm_group);
+	mover_init(&s->s_reader, p, stype[ep->e_a.a_socktype].st_reader);
+	s->s_reader.m_sock = s;
+	m0_sm_state_set(&s->s_sm, state);
+	p->p_sock_nr++;
+	M0_POST(sock_invariant(s));
+}
+
+/** Releases a socket that failed in sock_open(). */
+static void sock_free(struct sock *s)
+{
+	if (s->s_fd >= 0) {
+		(void)sock_ctl(s, EPOLL_CTL_DEL, 0);
+		close(s->s_fd);
+	}
+	b_tlist_fini(&s->s_zc_wait);
+	s_tlink_fini(s);
+	m0_free(s);
 }
 
 /**
- * A helper for sock_init().
+ * A helper for sock_open().
  *
  * Create the socket, set options, bind(2) if necessary.
  */
@@ -2155,8 +2742,15 @@ static int sock_init_fd(int fd, struct sock *s, struct ep *ep, uint32_t flags)
 				result = 0;
 		}
 	}
+	if (fd >= 0)
+		s->s_fd = fd; /* sock_free() closes it on a failure. */
 	if (fd >= 0 && result == 0) {
-		s->s_fd = fd;
+		/* Failure means that the kernel has no MSG_ZEROCOPY. */
+		if (sock_zerocopy && !(flags & EPOLLET) &&
+		    ep->e_a.a_socktype == SOCK_STREAM &&
+		    setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY,
+			       &(int){ 1 }, sizeof(int)) == 0)
+			s->s_flags |= ZEROCOPY;
 		result = sock_ctl(s, EPOLL_CTL_ADD, flags & ~EPOLLET);
 	}
 	if (result != 0 || fd < 0)
@@ -2175,8 +2769,10 @@ static bool sock_event(struct sock *s, uint32_t ev)
 	enum { EV_ERR = EPOLLRDHUP|EPOLLERR|EPOLLHUP };
 	struct sockaddr_storage sa = {};
 	struct addr             addr;
+	struct ma              *ma = ep_ma(s->s_ep);
 	int                     result;
 
+	M0_PRE(poller_is_locked(ep_poller(s->s_ep)) && !ma_is_locked(ma));
 	M0_PRE(sock_invariant(s));
 	M0_LOG(M0_DEBUG, "State: %x, event: %x.", s->s_sm.sm_state, ev);
 
@@ -2200,23 +2796,23 @@ static bool sock_event(struct sock *s, uint32_t ev)
 
 				addr_decode(&addr, (void *)&sa);
 				M0_ASSERT(addr_invariant(&addr));
-				result = ep_create(ep_ma(we),
-						   &addr, NULL, &ep) ?:
+				ma_lock(ma);
+				result = ep_create(ma, &addr, NULL, &ep) ?:
 					/*
 					 * Accept incoming connections
 					 * unconditionally. Alternatively, it
 					 * can be rejected by some admission
 					 * policy.
+					 *
+					 * The sock structure is created by the
+					 * poller of the peer end-point.
 					 */
-					sock_init(fd, we, ep, 0);
-				if (result != 0)
-					/*
-					 * Maybe already closed in sock_init()
-					 * failure path, do not care.
-					 */
-					close(fd);
+					conn_add(ep, fd);
 				if (ep != NULL)
 					EP_PUT(ep, find);
+				ma_unlock(ma);
+				if (result != 0)
+					close(fd);
 			} else if (M0_IN(errno, (EWOULDBLOCK,  /* BSD */
 						 ECONNABORTED, /* POSIX */
 						 EPROTO)) ||   /* SVR4 */
@@ -2244,7 +2840,9 @@ static bool sock_event(struct sock *s, uint32_t ev)
 	case S_CONNECTING:
 		if ((ev & (EPOLLOUT|EPOLLIN)) == EPOLLOUT) {
 			/* Successful connection. */
+			ma_lock(ma);
 			m0_sm_state_set(&s->s_sm, S_OPEN);
+			ma_unlock(ma);
 		} else if ((ev & (EPOLLOUT|EPOLLIN)) == (EPOLLOUT|EPOLLIN)) {
 			/* Failed connection. */
 			sock_done(s, false);
@@ -2254,6 +2852,12 @@ static bool sock_event(struct sock *s, uint32_t ev)
 		}
 		break;
 	case S_OPEN:
+		/*
+		 * MSG_ZEROCOPY completions are reported through the error
+		 * queue. Only close the socket on a real error.
+		 */
+		if ((ev & EPOLLERR) && s->s_zc_next != 0 && sock_zc_reap(s))
+			ev &= ~EPOLLERR;
 		if (ev & EPOLLIN) {
 			/* Ran out of buffer on the receive queue. */
 			if (sock_in(s) == -ENOBUFS)
@@ -2280,7 +2884,7 @@ static int sock_ctl(struct sock *s, int op, uint32_t flags)
 
 	/* Always monitor errors. */
 	flags |= EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP;
-	result = epoll_ctl(ep_ma(s->s_ep)->t_epollfd, op, s->s_fd,
+	result = epoll_ctl(ep_poller(s->s_ep)->p_epollfd, op, s->s_fd,
 			   &(struct epoll_event){
 				   .events = flags,
 				   .data   = { .ptr = s }});
@@ -2293,6 +2897,109 @@ static int sock_ctl(struct sock *s, int op, uint32_t flags)
 	return result;
 }
 
+/**
+ * Processes MSG_ZEROCOPY completions from the socket error queue.
+ *
+ * Buffers, for which all zero-copy sends completed, are moved to
+ * poller::p_done to be completed by poller_buf_done().
+ *
+ * If the kernel had to copy the data anyway (e.g., for a loopback
+ * destination), stop using MSG_ZEROCOPY for this socket.
+ *
+ * Returns true iff there is no pending socket error.
+ */
+static bool sock_zc_reap(struct sock *s)
+{
+	char                      control[128];
+	struct msghdr             msg;
+	struct cmsghdr           *cm;
+	struct sock_extended_err *ee;
+	struct buf               *buf;
+	struct ma                *ma  = ep_ma(s->s_ep);
+	int                       err = 0;
+	socklen_t                 len = sizeof err;
+
+	M0_PRE(poller_is_locked(ep_poller(s->s_ep)) && !ma_is_locked(ma));
+	while (1) {
+		msg = (struct msghdr) {
+			.msg_control    = control,
+			.msg_controllen = sizeof control
+		};
+		if (recvmsg(s->s_fd, &msg, MSG_ERRQUEUE) < 0)
+			break;
+		for (cm = CMSG_FIRSTHDR(&msg); cm != NULL;
+		     cm = CMSG_NXTHDR(&msg, cm)) {
+			if (!(cm->cmsg_level == SOL_IP &&
+			      cm->cmsg_type  == IP_RECVERR) &&
+			    !(cm->cmsg_level == SOL_IPV6 &&
+			      cm->cmsg_type  == IPV6_RECVERR))
+				continue;
+			ee = (void *)CMSG_DATA(cm);
+			if (ee->ee_errno != 0 ||
+			    ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+				continue;
+			/* [ee_info, ee_data] range of sends completed. */
+			if ((int32_t)(ee->ee_data + 1 - s->s_zc_done) > 0)
+				s->s_zc_done = ee->ee_data + 1;
+			if (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+				s->s_flags &= ~ZEROCOPY;
+		}
+	}
+	ma_lock(ma);
+	m0_tl_for(b, &s->s_zc_wait, buf) {
+		if (!buf_zc_busy(buf))
+			b_tlist_move(&ep_poller(s->s_ep)->p_done, buf);
+	} m0_tl_endfor;
+	ma_unlock(ma);
+	return getsockopt(s->s_fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 &&
+		err == 0;
+}
+
+/**
+ * Releases buffers sent with MSG_ZEROCOPY over a socket that is being closed.
+ *
+ * Completion notifications are not delivered after the socket is closed, so
+ * the buffers still waiting for them (sock::s_zc_wait) would never complete.
+ * They cannot be completed while the kernel might still be sending from their
+ * pages either. Instead, the connection is aborted: with zero SO_LINGER
+ * timeout close(2) resets the connection and drops the unsent data. Such
+ * buffers are completed with -ECONNABORTED, because their data are not known
+ * to be sent. The pages of dropped packets can stay referenced by the kernel
+ * for a little while, but they are never sent.
+ *
+ * Writers locked to the socket were closed by sock_close() already. Drop
+ * references to the socket from their buffers too, because the socket is
+ * freed before they complete.
+ */
+static void sock_zc_abort(struct sock *s)
+{
+	struct ma    *ma = ep_ma(s->s_ep);
+	struct linger l  = { .l_onoff = 1, .l_linger = 0 };
+	struct buf   *buf;
+	struct mover *w;
+	int           result;
+
+	(void)sock_zc_reap(s);
+	if (!b_tlist_is_empty(&s->s_zc_wait)) {
+		result = setsockopt(s->s_fd, SOL_SOCKET, SO_LINGER,
+				    &l, sizeof l);
+		if (result != 0)
+			M0_LOG(M0_ERROR, "SO_LINGER: %i.", errno);
+	}
+	ma_lock(ma);
+	m0_tl_for(b, &s->s_zc_wait, buf) {
+		if (buf->b_writer.m_sm.sm_rc == 0)
+			buf->b_writer.m_sm.sm_rc = M0_ERR(-ECONNABORTED);
+		buf->b_zc_sock = NULL;
+		b_tlist_move(&ep_poller(s->s_ep)->p_done, buf);
+	} m0_tl_endfor;
+	ma_unlock(ma);
+	m0_tl_for(m, &s->s_ep->e_writer, w) {
+		if (w->m_buf != NULL && w->m_buf->b_zc_sock == s)
+			w->m_buf->b_zc_sock = NULL;
+	} m0_tl_endfor;
+}
+
 /**
  * Returns the end-point with a given address.
  *
@@ -2340,6 +3047,7 @@ static int ep_create(struct ma *ma, struct addr *addr, const char *name,
 	m_tlist_init(&ep->e_writer);
 	net->nep_addr = cname;
 	ep->e_a = *addr;
+	ep->e_poller = addr_hash(addr) % ma->t_poller_nr;
 	*out = ep;
 	M0_POST(*out != NULL && ep_invariant(*out));
 	M0_POST(ma_is_locked(ma));
@@ -2360,6 +3068,15 @@ static struct ma *ep_ma(struct ep *ep)
 	return ep->e_ep.nep_tm->ntm_xprt_private;
 }
 
+/** Returns the poller monitoring sockets to the end-point. */
+static struct poller *ep_poller(struct ep *ep)
+{
+	struct ma *ma = ep_ma(ep);
+
+	M0_PRE(ep->e_poller < ma->t_poller_nr);
+	return &ma->t_poller[ep->e_poller];
+}
+
 /** Converts generic end-point to its sock structure. */
 static struct ep *ep_net(struct m0_net_end_point *net)
 {
@@ -2380,17 +3097,22 @@ static void ep_release(struct m0_ref *ref)
 /**
  * Adds a writer to an endpoint.
  *
- * If necessary creates a new socket to the endpoint.
+ * The writer is queued to the poller of the end-point, which moves it to
+ * ep::e_writer and creates a new socket to the endpoint if necessary, see
+ * poller_intake().
  */
-static int ep_add(struct ep *ep, struct mover *w)
+static void ep_add(struct ep *ep, struct mover *w)
 {
-	M0_PRE(ep_invariant(ep));
+	struct poller *p = ep_poller(ep);
+
+	M0_PRE(ma_is_locked(ep_ma(ep)) && ep_invariant(ep));
 	M0_PRE(mover_invariant(w) && mover_is_writer(w));
 	M0_PRE(w->m_ep == NULL);
-	m_tlist_add_tail(&ep->e_writer, w);
+	m_tlist_add_tail(&p->p_writer, w);
 	EP_GET(ep, mover);
 	w->m_ep = ep;
-	return M0_RC(ep_balance(ep));
+	w->m_buf->b_poller = p;
+	poller_wake(p);
 }
 
 /**
@@ -2404,13 +3126,16 @@ static void ep_del(struct mover *w)
 	struct ep *ep = w->m_ep;
 
 	if (ep != NULL) {
+		M0_PRE(ma_is_locked(ep_ma(ep)) &&
+		       poller_is_locked(ep_poller(ep)));
 		M0_PRE(ep_invariant(ep));
 		M0_PRE(mover_invariant(w) && mover_is_writer(w));
 		M0_PRE(M0_IN(w->m_sm.sm_state, (R_DONE, R_FAIL)));
 
 		if (m_tlink_is_in(w)) {
 			m_tlist_del(w);
-			ep_balance(ep);
+			if (m_tlist_is_empty(&ep->e_writer))
+				(void)ep_balance(ep);
 			EP_PUT(ep, mover);
 		}
 		w->m_ep = NULL;
@@ -2423,12 +3148,16 @@ static void ep_del(struct mover *w)
  * If there are writers, but no sockets, open a socket.
  *
  * If there are sockets, but no writers, stop monitoring sockets for writer.
+ *
+ * Called by the poller of the end-point. Opening a socket takes the tm lock,
+ * so it must not be held if there are writers.
  */
 static int ep_balance(struct ep *ep)
 {
 	int          result = 0;
 	struct sock *s;
 
+	M0_PRE(poller_is_locked(ep_poller(ep)));
 	if (m_tlist_is_empty(&ep->e_writer)) {
 		/*
 		 * No more writers.
@@ -2441,6 +3170,7 @@ static int ep_balance(struct ep *ep)
 			result = sock_ctl(s, EPOLL_CTL_MOD, 0);
 		M0_ASSERT(result == 0);
 	} else {
+		M0_PRE(!ma_is_locked(ep_ma(ep)));
 		s = m0_tl_find(s, s, &ep->e_sock, M0_IN(s->s_sm.sm_state,
 						(S_CONNECTING, S_OPEN)));
 		if (s == NULL)
@@ -2460,6 +3190,24 @@ static int ep_balance(struct ep *ep)
 	return result;
 }
 
+/** Passes an accepted connection to the poller of the peer end-point. */
+static int conn_add(struct ep *ep, int fd)
+{
+	struct poller *p = ep_poller(ep);
+	struct conn   *c;
+
+	M0_PRE(ma_is_locked(ep_ma(ep)));
+	M0_ALLOC_PTR(c);
+	if (c == NULL)
+		return M0_ERR(-ENOMEM);
+	c->c_fd = fd;
+	c->c_ep = ep;
+	EP_GET(ep, find);
+	c_tlink_init_at_tail(c, &p->p_conn);
+	poller_wake(p);
+	return 0;
+}
+
 /** Finalises the end-point. */
 static void ep_free(struct ep *ep)
 {
@@ -2783,6 +3531,16 @@ static bool addr_eq(const struct addr *a0, const struct addr *a1)
 		       ARRAY_SIZE(a0->a_data.v_data)) == 0;
 }
 
+/** Hashes the address to distribute end-points across pollers. */
+static uint64_t addr_hash(const struct addr *addr)
+{
+	uint64_t word[2];
+
+	M0_CASSERT(sizeof word == sizeof addr->a_data.v_data);
+	memcpy(word, addr->a_data.v_data, sizeof word);
+	return m0_hash(word[0] ^ m0_hash(word[1] ^ addr->a_port));
+}
+
 /** Returns true iff an end-point has a given addr. */
 static bool ep_eq(const struct ep *ep, const struct addr *a0)
 {
@@ -2796,6 +3554,12 @@ static struct ma *buf_ma(struct buf *buf)
 	return buf->b_buf->nb_tm->ntm_xprt_private;
 }
 
+/** Returns the poller completing the buffer, see buf::b_poller. */
+static struct poller *buf_poller(struct buf *buf)
+{
+	return buf->b_poller ?: &buf_ma(buf)->t_poller[0];
+}
+
 /**
  * Checks that a valid incoming packet (m->m_pk) is received for "buf".
  *
@@ -2823,6 +3587,7 @@ static int buf_accept(struct buf *buf, struct mover *m)
 		m->m_buf      = buf;
 		buf->b_peer   = *src;
 		buf->b_length = p->p_totalsize;
+		buf->b_poller = ep_poller(m->m_sock->s_ep);
 		result = ep_create(buf_ma(buf),
 				   &src->bd_addr, NULL, &buf->b_other);
 #ifdef EP_DEBUG
@@ -2858,12 +3623,29 @@ static void buf_fini(struct buf *buf)
 	M0_SET0(&buf->b_peer);
 	buf->b_offset = 0;
 	buf->b_length = 0;
+	buf->b_zc_sock = NULL;
+	buf->b_zc_end = 0;
+	buf->b_poller = NULL;
 }
 
-/** Completes the buffer operation. */
+/** True iff the kernel can still reference buffer pages (MSG_ZEROCOPY). */
+static bool buf_zc_busy(const struct buf *buf)
+{
+	return buf->b_zc_sock != NULL &&
+		(int32_t)(buf->b_zc_sock->s_zc_done - buf->b_zc_end) < 0;
+}
+
+/**
+ * Completes the buffer operation.
+ *
+ * The buffer is queued to the poller running its movers. The completion
+ * call-back releases the tm lock, which cannot be done in the middle of the
+ * caller, so it is invoked later by poller_buf_done().
+ */
 static void buf_done(struct buf *buf, int rc)
 {
-	struct ma *ma = buf_ma(buf);
+	struct ma     *ma = buf_ma(buf);
+	struct poller *p  = buf_poller(buf);
 
 	M0_PRE(ma_is_locked(ma) && ma_invariant(ma) && buf_invariant(buf));
 	/*printf("done: %p[%i] %"PRIi64" %i\n", buf,
@@ -2876,26 +3658,32 @@ static void buf_done(struct buf *buf, int rc)
 	 * buffer is cancelled.
 	 */
 	if (!b_tlink_is_in(buf)) {
-		/* Try to finalise. */
-		if (m0_thread_self() == &ma->t_poller)
-			buf_complete(buf);
-		else
-			/* Otherwise, postpone finalisation to ma_buf_done(). */
-			b_tlist_add_tail(&ma->t_done, buf);
+		b_tlist_add_tail(&p->p_done, buf);
+		poller_wake(p);
 	}
 }
 
+/** Initialises the writer of a buffer and adds it to the end-point. */
+static void buf_writer_add(struct buf *buf, struct ep *ep,
+			   const struct mover_op_vec *vop)
+{
+	mover_init(&buf->b_writer, ep_poller(ep), vop);
+	buf->b_writer.m_buf = buf;
+	ep_add(ep, &buf->b_writer);
+}
+
 /** Invokes completion call-back (releasing tm lock). */
 static void buf_complete(struct buf *buf)
 {
 	struct ma *ma  = buf_ma(buf);
-
 	struct m0_net_buffer *nb = buf->b_buf;
 	struct m0_net_buffer_event ev = {
 		.nbe_buffer = nb,
 		.nbe_status = buf->b_writer.m_sm.sm_rc,
 		.nbe_time   = m0_time_now()
 	};
+
+	M0_PRE(poller_is_locked(buf_poller(buf)));
 	if (M0_IN(nb->nb_qtype, (M0_NET_QT_MSG_RECV,
 				 M0_NET_QT_PASSIVE_BULK_RECV,
 				 M0_NET_QT_ACTIVE_BULK_RECV))) {
@@ -2959,13 +3747,14 @@ static int bdesc_decode(const struct m0_net_buf_desc *nbd, struct bdesc *out)
 					 nbd->nbd_data, nbd->nbd_len);
 }
 
-static void mover_init(struct mover *m, struct ma *ma,
+/** Initialises a mover, run by the given poller. */
+static void mover_init(struct mover *m, struct poller *p,
 		       const struct mover_op_vec *vop)
 {
 	M0_PRE(m->m_sm.sm_conf == NULL);
 	M0_SET0(m);
 	m_tlink_init(m);
-	m0_sm_init(&m->m_sm, &rw_conf, R_IDLE, &ma->t_ma->ntm_group);
+	m0_sm_init(&m->m_sm, &rw_conf, R_IDLE, &p->p_grp);
 	m->m_op = vop;
 	M0_POST(mover_invariant(m));
 }
@@ -3175,6 +3964,20 @@ static int pk_iov_prep(struct mover *m, struct iovec *iv, int nr,
 	return idx;
 }
 
+/**
+ * True iff the payload prepared by pk_iov_prep() should be sent with
+ * MSG_ZEROCOPY.
+ *
+ * The header, stored in the mover, is always copied: zero-copy is only used
+ * when the iovec contains nothing but buffer data.
+ */
+static bool pk_zerocopy(const struct mover *m, const struct sock *s, int count)
+{
+	return  (s->s_flags & ZEROCOPY) && m->m_op == &writer_op &&
+		m->m_buf != NULL && m->m_nob >= sizeof m->m_pkbuf &&
+		count >= ZEROCOPY_MIN;
+}
+
 /**
  * Does packet io.
  *
@@ -3195,7 +3998,19 @@ static int pk_io(struct mover *m, struct sock *s, uint64_t flag,
 			 bv ?: m->m_buf != NULL ?
 			 &m->m_buf->b_buf->nb_buffer : NULL, tgt, &count);
 	s->s_flags &= ~flag;
-	rc = (flag == HAS_READ ? readv : writev)(s->s_fd, iv, nr);
+	if (flag == HAS_WRITE && pk_zerocopy(m, s, count)) {
+		rc = sendmsg(s->s_fd, &(struct msghdr) {
+				.msg_iov    = iv,
+				.msg_iovlen = nr
+			}, MSG_ZEROCOPY);
+		if (rc > 0) {
+			m->m_buf->b_zc_sock = s;
+			m->m_buf->b_zc_end  = ++s->s_zc_next;
+		} else if (rc < 0 && errno == ENOBUFS)
+			/* Out of optmem for notifications, copy this time. */
+			rc = writev(s->s_fd, iv, nr);
+	} else
+		rc = (flag == HAS_READ ? readv : writev)(s->s_fd, iv, nr);
 	M0_LOG(M0_DEBUG, "flag: %"PRIi64", rc: %i, idx: %i, errno: %i.",
 	       flag, rc, nr, errno);
 	if (rc >= 0) {
@@ -3250,8 +4065,6 @@ static int pk_header_done(struct mover *m)
 	bool                 isget;
 	bool                 hassrc;
 	bool                 hasdst;
-	struct buf          *buf = NULL;
-	uint64_t            *cookie;
 
 	M0_PRE(m->m_nob >= sizeof *p);
 	M0_PRE(mover_is_reader(m));
@@ -3283,6 +4096,30 @@ static int pk_header_done(struct mover *m)
 	hasdst = !M0_IS0(&p->p_dst.bd_cookie);
 	if (!hassrc && !hasdst)         /* Go I know not whither */
 		return M0_ERR(-EPROTO); /* and fetch I know not what? */
+	if (isget && (p->p_idx != 0 || p->p_nr != 1 || p->p_size != 0 ||
+		      p->p_offset != 0 || !hasdst))
+		return M0_ERR(-EPROTO);
+	ma_lock(ma);
+	result = pk_buf_find(m, isget, hasdst);
+	ma_unlock(ma);
+	return result;
+}
+
+/**
+ * Finds the buffer for the incoming packet, which header has been verified by
+ * pk_header_done().
+ *
+ * For a GET packet, starts sending the requested buffer.
+ */
+static int pk_buf_find(struct mover *m, bool isget, bool hasdst)
+{
+	struct packet *p   = &m->m_pk;
+	struct ma     *ma  = ep_ma(m->m_sock->s_ep);
+	struct buf    *buf = NULL;
+	uint64_t      *cookie;
+	int            result;
+
+	M0_PRE(ma_is_locked(ma));
 	if (hasdst) {
 		result = m0_cookie_dereference(&p->p_dst.bd_cookie, &cookie);
 		if (result != 0)
@@ -3296,19 +4133,15 @@ static int pk_header_done(struct mover *m)
 		if (!M0_IS0(&buf->b_peer) &&
 		    memcmp(&buf->b_peer, &p->p_src, sizeof p->p_src) != 0)
 			return M0_ERR(-EPERM);
+		/* The buffer is pending completion, e.g., cancelled. */
+		if (b_tlink_is_in(buf))
+			return M0_ERR(-ECANCELED);
 	}
 	if (isget) {
-		if (p->p_idx != 0 || p->p_nr != 1 || p->p_size != 0 ||
-		    p->p_offset != 0 || !hasdst)
-			return M0_ERR(-EPROTO);
 		if (buf->b_buf->nb_qtype != M0_NET_QT_PASSIVE_BULK_SEND)
 			return M0_ERR(-EPERM);
 		buf->b_peer = p->p_src;
-		mover_init(&buf->b_writer, ma, &writer_op);
-		buf->b_writer.m_buf = buf;
-		result = ep_add(m->m_sock->s_ep, &buf->b_writer);
-		if (result != 0)
-			buf_done(buf, result);
+		buf_writer_add(buf, m->m_sock->s_ep, &writer_op);
 		return R_IDLE;
 	}
 	if (!hasdst) {
@@ -3368,13 +4201,16 @@ static void pk_done(struct mover *m)
 {
 	struct buf    *buf = m->m_buf;
 	struct packet *pk  = &m->m_pk;
+	struct ma     *ma  = buf_ma(buf);
 
 	M0_PRE(!m0_bitmap_get(&buf->b_done, pk->p_idx));
 	M0_PRE(mover_is_reader(m));
 	m->m_buf = NULL;
+	ma_lock(ma);
 	m0_bitmap_set(&buf->b_done, pk->p_idx, true);
 	if (m0_bitmap_ffz(&buf->b_done) == -1)
 		buf_done(buf, 0); /* If all packets have been received, done. */
+	ma_unlock(ma);
 }
 
 static void pk_encdec(struct mover *m, enum m0_xcode_what what)
@@ -3641,8 +4477,12 @@ static void writer_done(struct mover *w, struct sock *s)
  */
 static void writer_error(struct mover *w, struct sock *s, int rc)
 {
+	struct ma *ma = buf_ma(w->m_buf);
+
+	ma_lock(ma);
 	ep_del(w);
 	buf_done(w->m_buf, rc);
+	ma_unlock(ma);
 }
 
 /** Starts processing of a GET packet. */
@@ -3665,10 +4505,20 @@ static int get_pk(struct mover *cmd, struct sock *s)
 	return R_HEADER;
 }
 
-/** Completes a GET packet. */
+/**
+ * Completes a GET packet.
+ *
+ * The buffer waits for the data, which can be received by a different poller,
+ * so the writer is finalised here, by its poller.
+ */
 static void get_done(struct mover *w, struct sock *s)
 {
+	struct ma *ma = buf_ma(w->m_buf);
+
+	ma_lock(ma);
 	ep_del(w);
+	ma_unlock(ma);
+	mover_fini(w);
 }
 
 static struct m0_sm_state_descr sock_conf_state[] = {
@@ -3886,9 +4736,52 @@ struct m0_net_xprt m0_net_lnet_xprt = {
 };
 #endif
 
-M0_INTERNAL int m0_net_sock_mod_init(void)
+M0_INTERNAL int m0_net_sock_tm_poller_nr_set(struct m0_net_transfer_mc *tm,
+					      uint32_t nr)
 {
 	int result;
+
+	M0_PRE(nr > 0);
+	m0_mutex_lock(&tm->ntm_mutex);
+	M0_PRE(tm->ntm_state == M0_NET_TM_INITIALIZED);
+	M0_PRE(tm->ntm_dom->nd_xprt->nx_ops == &xprt_ops);
+	result = ma_pollers_init(tm->ntm_xprt_private, nr);
+	m0_mutex_unlock(&tm->ntm_mutex);
+	return M0_RC(result);
+}
+
+M0_INTERNAL uint32_t m0_net_sock_tm_poller_nr(struct m0_net_transfer_mc *tm)
+{
+	struct ma *ma = tm->ntm_xprt_private;
+
+	M0_PRE(tm->ntm_dom->nd_xprt->nx_ops == &xprt_ops);
+	return ma->t_poller_nr;
+}
+
+M0_INTERNAL void m0_net_sock_tm_poller_stats(struct m0_net_transfer_mc *tm,
+					     uint32_t idx,
+					     struct m0_net_sock_poller_stats *st)
+{
+	struct ma     *ma = tm->ntm_xprt_private;
+	struct poller *p;
+
+	M0_PRE(tm->ntm_dom->nd_xprt->nx_ops == &xprt_ops);
+	M0_PRE(idx < ma->t_poller_nr);
+	p = &ma->t_poller[idx];
+	poller_lock(p);
+	st->nsps_sock_nr  = p->p_sock_nr;
+	st->nsps_event_nr = p->p_event_nr;
+	poller_unlock(p);
+}
+
+M0_INTERNAL int m0_net_sock_mod_init(void)
+{
+	const char *env;
+	int         result;
+
+	env = getenv("M0_NET_SOCK_ZEROCOPY");
+	if (env != NULL)
+		m0_net_sock_zerocopy_set(strcmp(env, "0") != 0);
 	/*
 	 * Ignore SIGPIPE that a write to socket gets when RST is received.
 	 *
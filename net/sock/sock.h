@@ -25,12 +25,52 @@
 #ifndef __MOTR_NET_SOCK_SOCK_H__
 #define __MOTR_NET_SOCK_SOCK_H__
 
+#include "lib/types.h"
+
+struct m0_net_transfer_mc;
+
 /**
  * @defgroup netsock
  *
  * @{
  */
 
+/** Statistics of a poller thread, see m0_net_sock_tm_poller_stats(). */
+struct m0_net_sock_poller_stats {
+	/** Number of sockets currently monitored by the poller. */
+	uint32_t nsps_sock_nr;
+	/** Number of epoll events processed since the transfer machine start. */
+	uint64_t nsps_event_nr;
+};
+
+/**
+ * Sets the number of poller threads, each with its own epoll instance, lock
+ * and sockets, used by a sock transfer machine. Sockets are sharded across
+ * pollers by end-point. Default is 1.
+ *
+ * Must be called after m0_net_tm_init() and before m0_net_tm_start(). If the
+ * transfer machine is confined (m0_net_tm_confine()), its pollers are spread
+ * over the given processors.
+ */
+M0_INTERNAL int m0_net_sock_tm_poller_nr_set(struct m0_net_transfer_mc *tm,
+					      uint32_t nr);
+
+/** Returns the number of poller threads of a sock transfer machine. */
+M0_INTERNAL uint32_t m0_net_sock_tm_poller_nr(struct m0_net_transfer_mc *tm);
+
+/** Returns statistics of the idx-th poller of a sock transfer machine. */
+M0_INTERNAL void m0_net_sock_tm_poller_stats(struct m0_net_transfer_mc *tm,
+					     uint32_t idx,
+					     struct m0_net_sock_poller_stats *st);
+
+/**
+ * Enables or disables sending of bulk payload with MSG_ZEROCOPY on stream
+ * sockets opened after this call. A buffer sent this way is completed only
+ * after the kernel reports that it no longer references the buffer pages.
+ * Default is disabled.
+ */
+M0_INTERNAL void m0_net_sock_zerocopy_set(bool on);
+
 
 /** @} end of netsock group */
 #endif /* __MOTR_NET_SOCK_SOCK_H__ */
@@ -29,6 +29,9 @@
 
 #include "net/net.h"		/* m0_net_buffer */
 #include "net/lnet/lnet.h"	/* m0_net_lnet_xprt */
+#if !defined(__KERNEL__) && !defined(ENABLE_LUSTRE)
+#include "net/sock/sock.h"	/* m0_net_sock_tm_poller_nr_set */
+#endif
 
 #include "net/test/network.h"
 
@@ -295,6 +298,14 @@ static int net_test_network_ctx_initfini(struct m0_net_test_network_ctx *ctx,
 	rc = m0_net_tm_init(ctx->ntc_tm, ctx->ntc_dom);
 	if (rc != 0)
 		goto fini_dom;
+#if !defined(__KERNEL__) && !defined(ENABLE_LUSTRE)
+	if (ctx->ntc_cfg.ntncfg_poller_nr != 0) {
+		rc = m0_net_sock_tm_poller_nr_set(ctx->ntc_tm,
+						  ctx->ntc_cfg.ntncfg_poller_nr);
+		if (rc != 0)
+			goto fini_tm;
+	}
+#endif
 
 	rc = ctx->ntc_cfg.ntncfg_sync ?
 	     m0_net_buffer_event_deliver_synchronously(ctx->ntc_tm) : 0;
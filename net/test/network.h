@@ -97,6 +97,12 @@ struct m0_net_test_network_cfg {
 	struct m0_net_test_network_timeouts	    ntncfg_timeouts;
 	/** transfer machine should use synchronous event delivery */
 	bool					    ntncfg_sync;
+	/**
+	 * Number of poller threads of the transfer machine, 0 means the
+	 * transport default. Only used by the sock transport.
+	 * @see m0_net_sock_tm_poller_nr_set()
+	 */
+	uint32_t				    ntncfg_poller_nr;
 };
 
 /**
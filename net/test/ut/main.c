@@ -39,7 +39,9 @@ extern void m0_net_test_service_ut(void);
 
 extern void m0_net_test_network_ut_buf_desc(void);
 extern void m0_net_test_network_ut_ping(void);
+extern void m0_net_test_network_ut_ping_pollers(void);
 extern void m0_net_test_network_ut_bulk(void);
+extern void m0_net_test_network_ut_bulk_zerocopy(void);
 
 extern void m0_net_test_cmd_ut_single(void);
 extern void m0_net_test_cmd_ut_multiple(void);
@@ -69,7 +71,9 @@ struct m0_ut_suite m0_net_test_ut = {
 		{ "service",		m0_net_test_service_ut		  },
 		{ "network-buf-desc",	m0_net_test_network_ut_buf_desc	  },
 		{ "network-ping",	m0_net_test_network_ut_ping	  },
+		{ "network-pollers",	m0_net_test_network_ut_ping_pollers },
 		{ "network-bulk",	m0_net_test_network_ut_bulk	  },
+		{ "network-zerocopy",	m0_net_test_network_ut_bulk_zerocopy },
 		{ "cmd-single",		m0_net_test_cmd_ut_single	  },
 		{ "cmd-multiple",	m0_net_test_cmd_ut_multiple	  },
 		{ "cmd-multiple2",	m0_net_test_cmd_ut_multiple2	  },
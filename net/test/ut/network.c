@@ -25,6 +25,9 @@
 #include "lib/semaphore.h"	/* m0_semaphore */
 #include "lib/memory.h"		/* m0_alloc */
 #include "net/lnet/lnet.h"	/* m0_net_lnet_ifaces_get */
+#ifndef __KERNEL__
+#include "net/sock/sock.h"	/* m0_net_sock_tm_poller_nr */
+#endif
 
 #include "net/test/network.h"
 
@@ -33,6 +36,9 @@ enum {
 	NET_TEST_PING_BUF_STEP = 511,	/** @see m0_net_test_network_ut_ping */
 	NET_TEST_BULK_BUF_SIZE = 1024 * 1024,
 	NET_TEST_BUF_DESC_NR   = 10,
+	NET_TEST_POLLER_NR        = 4,
+	NET_TEST_POLLER_SENDER_NR = 8,
+	NET_TEST_POLLER_ROUND_NR  = 16,
 };
 
 static m0_bcount_t bv_copy(struct m0_bufvec *dst,
@@ -203,6 +209,113 @@ void m0_net_test_network_ut_ping(void)
 	m0_net_test_network_ctx_fini(&recv);
 }
 
+/**
+ * Ping from several end-points to a single one, with sockets sharded across
+ * several poller threads of the sock transport. Senders use one or two pollers.
+ */
+void m0_net_test_network_ut_ping_pollers(void)
+{
+#if !defined(__KERNEL__) && !defined(ENABLE_LUSTRE)
+	static struct m0_net_test_network_cfg cfg;
+	static struct m0_net_test_network_ctx send[NET_TEST_POLLER_SENDER_NR];
+	static struct m0_net_test_network_ctx recv;
+	struct m0_net_sock_poller_stats	      st;
+	bool				      seen[NET_TEST_POLLER_SENDER_NR];
+	char				      addr[0x40];
+	uint64_t			      event_nr;
+	uint32_t			      sock_nr;
+	int				      round;
+	int				      i;
+	int				      j;
+	int				      rc;
+
+	M0_SET0(&cfg);
+	cfg.ntncfg_tm_cb	 = ping_tm_cb;
+	cfg.ntncfg_buf_cb	 = ping_buf_cb;
+	cfg.ntncfg_buf_size_ping = NET_TEST_PING_BUF_SIZE;
+	cfg.ntncfg_buf_ping_nr	 = NET_TEST_POLLER_SENDER_NR;
+	cfg.ntncfg_ep_max	 = NET_TEST_POLLER_SENDER_NR;
+	cfg.ntncfg_timeouts	 = m0_net_test_network_timeouts_never();
+	cfg.ntncfg_poller_nr	 = NET_TEST_POLLER_NR;
+	rc = m0_net_test_network_ctx_init(&recv, &cfg, "0@lo:12345:42:1000");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_net_sock_tm_poller_nr(recv.ntc_tm) ==
+		     NET_TEST_POLLER_NR);
+	cfg.ntncfg_buf_ping_nr = 1;
+	cfg.ntncfg_ep_max      = 1;
+	for (i = 0; i < ARRAY_SIZE(send); ++i) {
+		cfg.ntncfg_poller_nr = 1 + i % 2;
+		snprintf(addr, sizeof addr, "0@lo:12345:42:%d", 1001 + i);
+		rc = m0_net_test_network_ctx_init(&send[i], &cfg, addr);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(m0_net_sock_tm_poller_nr(send[i].ntc_tm) ==
+			     1 + i % 2);
+		rc = m0_net_test_network_ep_add(&send[i], "0@lo:12345:42:1000");
+		M0_UT_ASSERT(rc == 0);
+		m0_net_test_network_buf_fill(&send[i], M0_NET_TEST_BUF_PING,
+					     0, 1 + i);
+	}
+
+	m0_semaphore_init(&recv_sem, 0);
+	m0_semaphore_init(&send_sem, 0);
+	for (round = 0; round < NET_TEST_POLLER_ROUND_NR; ++round) {
+		for (i = 0; i < ARRAY_SIZE(send); ++i) {
+			m0_net_test_network_buf_fill(&recv,
+						     M0_NET_TEST_BUF_PING,
+						     i, 0xff);
+			rc = m0_net_test_network_msg_recv(&recv, i);
+			M0_UT_ASSERT(rc == 0);
+		}
+		for (i = 0; i < ARRAY_SIZE(send); ++i) {
+			rc = m0_net_test_network_msg_send(&send[i], 0, 0);
+			M0_UT_ASSERT(rc == 0);
+		}
+		for (i = 0; i < ARRAY_SIZE(send); ++i) {
+			m0_semaphore_down(&recv_sem);
+			m0_semaphore_down(&send_sem);
+		}
+		/* Each sender's message is received exactly once. */
+		M0_SET_ARR0(seen);
+		for (i = 0; i < ARRAY_SIZE(send); ++i) {
+			for (j = 0; j < ARRAY_SIZE(send); ++j) {
+				if (net_buf_data_eq(M0_NET_TEST_BUF_PING,
+						    &recv, i, &send[j], 0))
+					break;
+			}
+			M0_UT_ASSERT(j < ARRAY_SIZE(send) && !seen[j]);
+			seen[j] = true;
+		}
+	}
+	m0_semaphore_fini(&recv_sem);
+	m0_semaphore_fini(&send_sem);
+
+	/*
+	 * The receiver monitors its listening socket and a socket accepted
+	 * from every sender. Each message took at least one event.
+	 */
+	for (i = 0, sock_nr = 0, event_nr = 0; i < NET_TEST_POLLER_NR; ++i) {
+		m0_net_sock_tm_poller_stats(recv.ntc_tm, i, &st);
+		sock_nr  += st.nsps_sock_nr;
+		event_nr += st.nsps_event_nr;
+	}
+	M0_UT_ASSERT(sock_nr == NET_TEST_POLLER_SENDER_NR + 1);
+	M0_UT_ASSERT(event_nr >= NET_TEST_POLLER_ROUND_NR *
+				 NET_TEST_POLLER_SENDER_NR);
+	/* A sender monitors its listening socket and the outgoing one. */
+	for (i = 0; i < ARRAY_SIZE(send); ++i) {
+		for (j = 0, sock_nr = 0; j < 1 + i % 2; ++j) {
+			m0_net_sock_tm_poller_stats(send[i].ntc_tm, j, &st);
+			sock_nr += st.nsps_sock_nr;
+		}
+		M0_UT_ASSERT(sock_nr == 2);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(send); ++i)
+		m0_net_test_network_ctx_fini(&send[i]);
+	m0_net_test_network_ctx_fini(&recv);
+#endif
+}
+
 static struct m0_semaphore bulk_cb_sem[M0_NET_QT_NR];
 static bool bulk_offset_mismatch;
 
@@ -238,7 +351,7 @@ static struct m0_net_test_network_buffer_callbacks bulk_buf_cb = {
 	}
 };
 
-void m0_net_test_network_ut_bulk(void)
+static void bulk_test(m0_bcount_t bulk_size)
 {
 	static struct m0_net_test_network_cfg cfg;
 	static struct m0_net_test_network_ctx client;
@@ -255,7 +368,7 @@ void m0_net_test_network_ut_bulk(void)
 	cfg.ntncfg_buf_cb	 = bulk_buf_cb;
 	cfg.ntncfg_buf_size_ping = NET_TEST_PING_BUF_SIZE;
 	cfg.ntncfg_buf_ping_nr	 = 1;
-	cfg.ntncfg_buf_size_bulk = NET_TEST_PING_BUF_SIZE;
+	cfg.ntncfg_buf_size_bulk = bulk_size;
 	cfg.ntncfg_buf_bulk_nr	 = 2;
 	cfg.ntncfg_ep_max	 = 1;
 	cfg.ntncfg_timeouts	 = m0_net_test_network_timeouts_never();
@@ -364,6 +477,25 @@ void m0_net_test_network_ut_bulk(void)
 	m0_net_test_network_ctx_fini(&server);
 }
 
+void m0_net_test_network_ut_bulk(void)
+{
+	bulk_test(NET_TEST_PING_BUF_SIZE);
+}
+
+/**
+ * Bulk transfers of large buffers with MSG_ZEROCOPY enabled in the sock
+ * transport. Loopback sends are copied by the kernel anyway, but buffers still
+ * complete only after the completion notifications are reaped.
+ */
+void m0_net_test_network_ut_bulk_zerocopy(void)
+{
+#if !defined(__KERNEL__) && !defined(ENABLE_LUSTRE)
+	m0_net_sock_zerocopy_set(true);
+	bulk_test(NET_TEST_BULK_BUF_SIZE);
+	m0_net_sock_zerocopy_set(false);
+#endif
+}
+
 static void tm_event_cb_empty(const struct m0_net_tm_event *ev)
 {
 }
@@ -462,7 +462,7 @@ M0_INTERNAL void m0_rpc_conn_reset(struct m0_rpc_conn *conn)
 	conn_state_set(conn, M0_RPC_CONN_INITIALISED);
 	session0 = m0_rpc_conn_session0(conn);
 	session0->s_xid = 0;
-	conn->c_sender_id = SENDER_ID_INVALID;
+	m0_rpc_machine_conn_sender_id_set(conn, SENDER_ID_INVALID);
 	M0_POST(m0_rpc_conn_invariant(conn));
 	m0_rpc_machine_unlock(machine);
 }
@@ -666,7 +666,7 @@ M0_INTERNAL void m0_rpc_conn_fini_locked(struct m0_rpc_conn *conn)
 					M0_RPC_CONN_FAILED,
 					M0_RPC_CONN_INITIALISED)));
 
-	rpc_conn_tlist_del(conn);
+	m0_rpc_machine_del_conn(conn->c_rpc_machine, conn);
 	M0_LOG(M0_DEBUG, "rpcmach %p conn %p deleted from %s list",
 		conn->c_rpc_machine, conn,
 		(conn->c_flags & RCF_SENDER_END) ? "outgoing" : "incoming");
@@ -955,7 +955,8 @@ M0_INTERNAL void m0_rpc_conn_establish_reply_received(struct m0_rpc_item *item)
 	if (rc == 0) {
 		M0_ASSERT(reply != NULL);
 		if (reply->rcer_sender_id != SENDER_ID_INVALID) {
-			conn->c_sender_id = reply->rcer_sender_id;
+			m0_rpc_machine_conn_sender_id_set(conn,
+						reply->rcer_sender_id);
 			conn_state_set(conn, M0_RPC_CONN_ACTIVE);
 		} else
 			rc = M0_ERR(-EPROTO);
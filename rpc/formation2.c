@@ -426,7 +426,7 @@ static void frm_balance(struct m0_rpc_frm *frm)
 		return;
 
 	while (frm_is_ready(frm)) {
-		M0_ALLOC_PTR(p);
+		p = m0_rpc_packet_alloc();
 		if (p == NULL) {
 			M0_LOG(M0_ERROR, "Error: packet allocation failed");
 			break;
@@ -435,8 +435,7 @@ static void frm_balance(struct m0_rpc_frm *frm)
 		frm_fill_packet(frm, p);
 		if (m0_rpc_packet_is_empty(p)) {
 			/* See FRM_BALANCE_NOTE_1 at the end of this function */
-			m0_rpc_packet_fini(p);
-			m0_free(p);
+			m0_rpc_packet_discard(p);
 			break;
 		}
 		++packet_count;
@@ -29,6 +29,7 @@
 #include "lib/errno.h"
 #include "lib/finject.h"
 #include "lib/memory.h"
+#include "lib/objpool.h"
 #include "motr/magic.h"
 #include "xcode/xcode.h"
 #include "rpc/rpc_internal.h"
@@ -131,11 +132,35 @@ M0_INTERNAL void m0_rpc_packet_fini(struct m0_rpc_packet *p)
 	M0_LEAVE();
 }
 
+enum {
+	/** Free packets cached per locality. */
+	RPC_PACKET_POOL_CAP = 256
+};
+
+/** Pool of outgoing packets, which are allocated by formation. */
+static struct m0_objpool packet_pool;
+
+M0_INTERNAL int m0_rpc_packet_module_init(void)
+{
+	return M0_OBJPOOL_INIT(&packet_pool, struct m0_rpc_packet,
+			       "rpc-packet", RPC_PACKET_POOL_CAP, NULL, NULL);
+}
+
+M0_INTERNAL void m0_rpc_packet_module_fini(void)
+{
+	m0_objpool_fini(&packet_pool);
+}
+
+M0_INTERNAL struct m0_rpc_packet *m0_rpc_packet_alloc(void)
+{
+	return m0_objpool_alloc(&packet_pool);
+}
+
 M0_INTERNAL void m0_rpc_packet_discard(struct m0_rpc_packet *packet)
 {
 	m0_rpc_packet_remove_all_items(packet);
 	m0_rpc_packet_fini(packet);
-	m0_free(packet);
+	m0_objpool_free(&packet_pool, packet);
 }
 
 M0_INTERNAL void m0_rpc_packet_add_item(struct m0_rpc_packet *p,
@@ -81,9 +81,15 @@ M0_INTERNAL void m0_rpc_packet_init(struct m0_rpc_packet *packet,
 				    struct m0_rpc_machine *rmach);
 M0_INTERNAL void m0_rpc_packet_fini(struct m0_rpc_packet *packet);
 
+/** Allocates a packet from the packet pool, returns NULL on failure. */
+M0_INTERNAL struct m0_rpc_packet *m0_rpc_packet_alloc(void);
+
 /** Removes all items from the packet, finalises and frees it. */
 M0_INTERNAL void m0_rpc_packet_discard(struct m0_rpc_packet *packet);
 
+M0_INTERNAL int  m0_rpc_packet_module_init(void);
+M0_INTERNAL void m0_rpc_packet_module_fini(void);
+
 /**
    @pre  !packet_item_tlink_is_in(item)
    @post m0_rpc_packet_is_carrying_item(packet, item)
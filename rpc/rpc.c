@@ -43,6 +43,7 @@ M0_INTERNAL int m0_rpc_init(void)
 {
 	M0_ENTRY();
 	return M0_RC(m0_rpc_item_module_init() ?:
+		     m0_rpc_packet_module_init() ?:
 		     m0_rpc_service_register() ?:
 		     m0_rpc_session_module_init() ?:
 		     m0_rpc_link_module_init());
@@ -55,6 +56,7 @@ M0_INTERNAL void m0_rpc_fini(void)
 	m0_rpc_link_module_fini();
 	m0_rpc_session_module_fini();
 	m0_rpc_service_unregister();
+	m0_rpc_packet_module_fini();
 	m0_rpc_item_module_fini();
 
 	M0_LEAVE();
@@ -27,6 +27,7 @@
 
 #include "lib/bob.h"
 #include "lib/tlist.h"
+#include "lib/hash.h"  /* m0_htable */
 #include "lib/thread.h"
 #include "lib/chan.h"
 #include "sm/sm.h"     /* m0_sm_group */
@@ -93,6 +94,13 @@ struct m0_rpc_machine {
 	 */
 	struct m0_tl			  rm_incoming_conns;
 	struct m0_tl			  rm_outgoing_conns;
+	/**
+	    Connections from rm_incoming_conns ([0]) and rm_outgoing_conns
+	    ([1]) hashed by m0_rpc_conn::c_sender_id, so that every received
+	    item finds its connection without scanning the lists under the
+	    machine lock. Hash descriptor: rpc_conn_hash
+	 */
+	struct m0_htable		  rm_conn_hash[2];
 	struct m0_rpc_stats		  rm_stats;
 	/**
 	    Request handler this rpc_machine belongs to.
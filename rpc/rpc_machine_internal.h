@@ -72,9 +72,28 @@ struct m0_rpc_chan {
 	uint64_t			  rc_magic;
 };
 
+/**
+ * Initialises the connection lists of the machine and the sender id hash
+ * tables (m0_rpc_machine::rm_conn_hash[]).
+ */
+M0_INTERNAL int m0_rpc_machine_conns_init(struct m0_rpc_machine *machine);
+M0_INTERNAL void m0_rpc_machine_conns_fini(struct m0_rpc_machine *machine);
+
 M0_INTERNAL void m0_rpc_machine_add_conn(struct m0_rpc_machine *rmach,
 					 struct m0_rpc_conn    *conn);
 
+/** Removes the connection from the machine lists and sender id hash. */
+M0_INTERNAL void m0_rpc_machine_del_conn(struct m0_rpc_machine *rmach,
+					 struct m0_rpc_conn    *conn);
+
+/**
+ * Assigns m0_rpc_conn::c_sender_id keeping m0_rpc_machine::rm_conn_hash[]
+ * in sync. Every change of the sender id of a connection added to the machine
+ * must go through this function.
+ */
+M0_INTERNAL void m0_rpc_machine_conn_sender_id_set(struct m0_rpc_conn *conn,
+						   uint64_t            sender_id);
+
 M0_INTERNAL struct m0_rpc_conn *
 m0_rpc_machine_find_conn(const struct m0_rpc_machine *machine,
 			 const struct m0_rpc_item    *item);
@@ -43,19 +43,17 @@ static struct m0_rpc_fop_conn_terminate_rep term_reply;
 
 static struct m0_net_end_point ep;
 
-M0_TL_DESCR_DEFINE(rpc_conn_ut, "rpc-conn", static, struct m0_rpc_conn,
-		   c_link, c_magic, M0_RPC_CONN_MAGIC, M0_RPC_CONN_HEAD_MAGIC);
-M0_TL_DEFINE(rpc_conn_ut, static, struct m0_rpc_conn);
-
 static int conn_ut_init(void)
 {
+	int rc;
+
 	ep.nep_addr = "dummy ep";
 
 	est_fop.f_item.ri_reply  = &est_fop_rep.f_item;
 	term_fop.f_item.ri_reply = &term_fop_rep.f_item;
 
-	rpc_conn_ut_tlist_init(&machine.rm_incoming_conns);
-	rpc_conn_ut_tlist_init(&machine.rm_outgoing_conns);
+	rc = m0_rpc_machine_conns_init(&machine);
+	M0_UT_ASSERT(rc == 0);
 	rmach_watch_tlist_init(&machine.rm_watch);
 	m0_sm_group_init(&machine.rm_sm_grp);
 
@@ -69,8 +67,7 @@ static int conn_ut_init(void)
 static int conn_ut_fini(void)
 {
 	rmach_watch_tlist_fini(&machine.rm_watch);
-	rpc_conn_ut_tlist_fini(&machine.rm_incoming_conns);
-	rpc_conn_ut_tlist_fini(&machine.rm_outgoing_conns);
+	m0_rpc_machine_conns_fini(&machine);
 	m0_sm_group_fini(&machine.rm_sm_grp);
 	m0_fi_disable("rpc_chan_get", "do_nothing");
 	m0_fi_disable("rpc_chan_put", "do_nothing");
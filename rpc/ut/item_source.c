@@ -141,7 +141,7 @@ static void item_source_limits_test(void)
 	frm = &conn->c_rpcchan->rc_frm;
 
 	for (cond = 0; cond < 3; cond++) {
-		M0_ALLOC_PTR(p);
+		p = m0_rpc_packet_alloc();
 		M0_UT_ASSERT(p != NULL);
 		has_item_calls = get_item_calls = 0;
 		m0_fi_enable_once("has_item", "yes");
@@ -331,6 +331,14 @@ M0_INTERNAL void m0_sm_fini(struct m0_sm *mach)
 	m0_chan_fini(&mach->sm_chan);
 }
 
+M0_INTERNAL void m0_sm_regroup(struct m0_sm *mach, struct m0_sm_group *grp)
+{
+	M0_PRE(sm_is_locked(mach));
+
+	mach->sm_grp = grp;
+	mach->sm_chan.ch_guard = &grp->s_lock;
+}
+
 M0_INTERNAL void (*m0_sm__conf_init)(const struct m0_sm_conf *conf) = NULL;
 
 M0_INTERNAL void m0_sm_conf_init(struct m0_sm_conf *conf)
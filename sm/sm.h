@@ -533,6 +533,15 @@ M0_INTERNAL void m0_sm_init(struct m0_sm *mach, const struct m0_sm_conf *conf,
  */
 M0_INTERNAL void m0_sm_fini(struct m0_sm *mach);
 
+/**
+   Moves a state machine to another state machine group.
+
+   The original group must be locked. The caller guarantees that no asts,
+   timeouts or timers of the machine are pending in the original group and that
+   the machine is not used until the new group is locked.
+ */
+M0_INTERNAL void m0_sm_regroup(struct m0_sm *mach, struct m0_sm_group *grp);
+
 M0_INTERNAL void m0_sm_group_init(struct m0_sm_group *grp);
 M0_INTERNAL void m0_sm_group_fini(struct m0_sm_group *grp);
 
@@ -40,7 +40,8 @@ M0_INTERNAL void m0_sns_cpx_init(struct m0_fop_type *ft,
 			 .rpc_flags = rpc_flags,
 			 .fom_ops   = fomt_ops,
 			 .sm        = &m0_generic_conf,
-			 .svc_type  = &cmt->ct_stype);
+			 .svc_type  = &cmt->ct_stype,
+			 .fom_class = M0_FSC_BACKGROUND);
 }
 
 M0_INTERNAL void m0_sns_cpx_fini(struct m0_fop_type *ft)
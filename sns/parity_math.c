@@ -194,15 +194,15 @@ static void (*fidx_recover[M0_PARITY_CAL_ALGO_NR])(struct m0_parity_math *math,
 
 enum {
 	SNS_PARITY_MATH_DATA_BLOCKS_MAX = 1 << (M0_PARITY_GALOIS_W - 1),
-	BAD_FAIL_INDEX = -1
+	BAD_FAIL_INDEX = -1,
+	/*
+	 * Units are processed by chunks of this size, so that the chunk
+	 * being accumulated stays in cache while all sources are added.
+	 */
+	SNS_PARITY_MATH_CHUNK = 16384,
 };
 
 /* m0_parity_* are to much eclectic. just more simple names. */
-static int gadd(int x, int y)
-{
-	return m0_parity_add(x, y);
-}
-
 static int gsub(int x, int y)
 {
 	return m0_parity_sub(x, y);
@@ -399,9 +399,7 @@ static void reed_solomon_diff(struct m0_parity_math *math,
 			      uint32_t               index)
 {
 	struct m0_matrix *mat;
-	uint32_t          ei;
 	uint32_t          ui;
-	uint8_t		  diff_data;
 	m0_parity_elem_t  mat_elem;
 
 	M0_PRE(math   != NULL);
@@ -415,13 +413,12 @@ static void reed_solomon_diff(struct m0_parity_math *math,
 
 	mat = &math->pmi_vandmat_parity_slice;
 	for (ui = 0; ui < math->pmi_parity_count; ++ui) {
-		for (ei = 0; ei < new[index].b_nob; ++ei) {
-			mat_elem = *m0_matrix_elem_get(mat, index, ui);
-			diff_data = ((uint8_t *)old[index].b_addr)[ei] ^
-				    ((uint8_t *)new[index].b_addr)[ei];
-			((uint8_t*)parity[ui].b_addr)[ei] ^=
-				gmul(diff_data, mat_elem);
-		}
+		mat_elem = *m0_matrix_elem_get(mat, index, ui);
+		/* c * (old ^ new) == c * old ^ c * new */
+		m0_parity_region_mul_add(parity[ui].b_addr, old[index].b_addr,
+					 new[index].b_nob, mat_elem);
+		m0_parity_region_mul_add(parity[ui].b_addr, new[index].b_addr,
+					 new[index].b_nob, mat_elem);
 	}
 }
 
@@ -452,11 +449,8 @@ static void reed_solomon_encode(struct m0_parity_math *math,
 				const struct m0_buf *data,
 				struct m0_buf *parity)
 {
-#define PARITY_MATH_REGION_ENABLE 0
-
-#if !PARITY_MATH_REGION_ENABLE
-	uint32_t	  ei; /* block element index. */
-#endif
+	uint32_t	  off; /* chunk offset. */
+	uint32_t	  len; /* chunk length. */
 	uint32_t	  pi; /* parity unit index. */
 	uint32_t	  di; /* data unit index. */
 	m0_parity_elem_t  mat_elem;
@@ -469,40 +463,23 @@ static void reed_solomon_encode(struct m0_parity_math *math,
 	for (pi = 0; pi < math->pmi_parity_count; ++pi)
 		M0_ASSERT(block_size == parity[pi].b_nob);
 
-	for (pi = 0; pi < math->pmi_parity_count; ++pi) {
-		for (di = 0; di < math->pmi_data_count; ++di) {
-			mat_elem =
-			*m0_matrix_elem_get(&math->pmi_vandmat_parity_slice,
-					    di, pi);
-			if (mat_elem == 0)
-				continue;
-#if !PARITY_MATH_REGION_ENABLE
-			for (ei = 0; ei < block_size; ++ei) {
-				if (di == 0)
-					((uint8_t*)parity[pi].b_addr)[ei] =
-						M0_PARITY_ZERO;
-
-				((uint8_t*)parity[pi].b_addr)[ei] =
-					gadd(((uint8_t*)parity[pi].b_addr)[ei],
-					     gmul(mat_elem,
-						  ((uint8_t*)data[di].b_addr)
-						  [ei]));
+	for (off = 0; off < block_size; off += len) {
+		len = min_check(block_size - off,
+				(uint32_t)SNS_PARITY_MATH_CHUNK);
+		for (pi = 0; pi < math->pmi_parity_count; ++pi) {
+			memset((uint8_t *)parity[pi].b_addr + off,
+			       M0_PARITY_ZERO, len);
+			for (di = 0; di < math->pmi_data_count; ++di) {
+				mat_elem = *m0_matrix_elem_get(
+					&math->pmi_vandmat_parity_slice,
+					di, pi);
+				m0_parity_region_mul_add(
+					(uint8_t *)parity[pi].b_addr + off,
+					(uint8_t *)data[di].b_addr + off,
+					len, mat_elem);
 			}
-#else
-			if (di == 0)
-				memset((uint8_t*)parity[pi].b_addr,
-				       M0_PARITY_ZERO, block_size);
-
-			m0_parity_region_mac(
-				(m0_parity_elem_t*) parity[pi].b_addr,
-				(const m0_parity_elem_t*) data[di].b_addr,
-				block_size,
-				mat_elem);
-#endif
 		}
 	}
-
-#undef PARITY_MATH_REGION_ENABLE
 }
 
 M0_INTERNAL void m0_parity_math_calculate(struct m0_parity_math *math,
@@ -674,6 +651,54 @@ static void xor_recover(struct m0_parity_math *math,
         }
 }
 
+/*
+ * Recovers failed data units with the matrix prepared by
+ * m0_parity_recov_mat_gen(): every failed unit is a linear combination of
+ * the first pmi_data_count alive units, see recovery_vec_fill().
+ */
+static void reed_solomon_inverse_recover(struct m0_parity_math *math,
+					 struct m0_buf *data,
+					 struct m0_buf *parity,
+					 uint8_t *fail)
+{
+	const struct m0_matrix *mat = &math->pmi_recov_mat;
+	uint8_t                *alive[SNS_PARITY_MATH_DATA_BLOCKS_MAX];
+	uint32_t                unit_count;
+	uint32_t                block_size = data[0].b_nob;
+	uint32_t                off;
+	uint32_t                len;
+	uint32_t                ui;
+	uint32_t                x;
+	uint32_t                y = 0;
+
+	M0_PRE(mat->m_width == math->pmi_data_count);
+
+	unit_count = math->pmi_data_count + math->pmi_parity_count;
+	for (ui = 0; ui < unit_count && y < mat->m_width; ++ui) {
+		if (fail[ui])
+			continue;
+		alive[y++] = ui < math->pmi_data_count ? data[ui].b_addr :
+			parity[ui - math->pmi_data_count].b_addr;
+	}
+	M0_ASSERT(y == mat->m_width);
+
+	for (off = 0; off < block_size; off += len) {
+		len = min_check(block_size - off,
+				(uint32_t)SNS_PARITY_MATH_CHUNK);
+		for (ui = 0; ui < math->pmi_data_count; ++ui) {
+			if (fail[ui] == 0)
+				continue;
+			memset((uint8_t *)data[ui].b_addr + off,
+			       M0_PARITY_ZERO, len);
+			for (x = 0; x < mat->m_width; ++x)
+				m0_parity_region_mul_add(
+					(uint8_t *)data[ui].b_addr + off,
+					alive[x] + off, len,
+					*m0_matrix_elem_get(mat, x, ui));
+		}
+	}
+}
+
 static void reed_solomon_recover(struct m0_parity_math *math,
 				 struct m0_buf *data,
 				 struct m0_buf *parity,
@@ -699,6 +724,11 @@ static void reed_solomon_recover(struct m0_parity_math *math,
 	for (ui = 0; ui < math->pmi_parity_count; ++ui)
 		M0_ASSERT(block_size == parity[ui].b_nob);
 
+	if (algo == M0_LA_INVERSE) {
+		reed_solomon_inverse_recover(math, data, parity, fail);
+		return;
+	}
+
 	for (ei = 0; ei < block_size; ++ei) {
 		struct m0_matvec *recovered = &math->pmi_sys_res;
 
@@ -786,11 +816,8 @@ M0_INTERNAL void m0_parity_math_fail_index_recover(struct m0_parity_math *math,
 M0_INTERNAL void m0_parity_math_buffer_xor(struct m0_buf *dest,
 					   const struct m0_buf *src)
 {
-        uint32_t ei; /* block element index. */
-
-        for (ei = 0; ei < src[0].b_nob; ++ei)
-		((uint8_t*)dest[0].b_addr)[ei] ^=
-			(m0_parity_elem_t)((uint8_t*)src[0].b_addr)[ei];
+	m0_parity_region_mul_add(dest[0].b_addr, src[0].b_addr, src[0].b_nob,
+				 1);
 }
 
 M0_INTERNAL int m0_sns_ir_init(const struct m0_parity_math *math,
@@ -1094,7 +1121,6 @@ static void incr_recover(struct m0_sns_ir_block *failed_block,
 static void gfaxpy(struct m0_bufvec *y, struct m0_bufvec *x,
 		   m0_parity_elem_t alpha)
 {
-	uint32_t		i;
 	uint32_t		seg_size;
 	uint8_t		       *y_addr;
 	uint8_t		       *x_addr;
@@ -1115,23 +1141,7 @@ static void gfaxpy(struct m0_bufvec *y, struct m0_bufvec *x,
 	do {
 		x_addr  = m0_bufvec_cursor_addr(&x_cursor);
 		y_addr  = m0_bufvec_cursor_addr(&y_cursor);
-
-		switch (alpha) {
-		/* This is a special case of the 'default' case that follows.
-		 * Here we avoid unnecessary call to gmul.*/
-		case 1:
-			for (i = 0; i <seg_size; ++i) {
-				y_addr[i] = gadd(y_addr[i],
-						 x_addr[i]);
-			}
-			break;
-		default:
-			for (i = 0; i < seg_size; ++i) {
-				y_addr[i] = gadd(y_addr[i], gmul(x_addr[i],
-							         alpha));
-			}
-			break;
-		}
+		m0_parity_region_mul_add(y_addr, x_addr, seg_size, alpha);
 		step = m0_bufvec_cursor_step(&y_cursor);
 	} while (!m0_bufvec_cursor_move(&x_cursor, step) &&
 		 !m0_bufvec_cursor_move(&y_cursor, step));
@@ -27,6 +27,167 @@
 #include "lib/assert.h"
 #include "sns/parity_ops.h"
 
+#if defined(__x86_64__) && !defined(__KERNEL__)
+#  define PARITY_REGION_X86 1
+#  include <immintrin.h>
+#else
+#  define PARITY_REGION_X86 0
+#endif
+
+typedef void (*region_mul_add_t)(uint8_t *dst, const uint8_t *src,
+				 m0_bcount_t len,
+				 const uint8_t *lo, const uint8_t *hi);
+
+static void region_mul_add_scalar(uint8_t *dst, const uint8_t *src,
+				  m0_bcount_t len,
+				  const uint8_t *lo, const uint8_t *hi)
+{
+	m0_bcount_t i;
+
+	for (i = 0; i < len; ++i)
+		dst[i] ^= lo[src[i] & 0x0f] ^ hi[src[i] >> 4];
+}
+
+#if PARITY_REGION_X86
+__attribute__((target("ssse3")))
+static void region_mul_add_ssse3(uint8_t *dst, const uint8_t *src,
+				 m0_bcount_t len,
+				 const uint8_t *lo, const uint8_t *hi)
+{
+	__m128i     tlo  = _mm_loadu_si128((const __m128i *)lo);
+	__m128i     thi  = _mm_loadu_si128((const __m128i *)hi);
+	__m128i     mask = _mm_set1_epi8(0x0f);
+	__m128i     s;
+	__m128i     d;
+	m0_bcount_t i;
+
+	for (i = 0; i + 16 <= len; i += 16) {
+		s = _mm_loadu_si128((const __m128i *)(src + i));
+		d = _mm_loadu_si128((const __m128i *)(dst + i));
+		d = _mm_xor_si128(d, _mm_shuffle_epi8(tlo,
+						      _mm_and_si128(s, mask)));
+		d = _mm_xor_si128(d, _mm_shuffle_epi8(thi,
+				  _mm_and_si128(_mm_srli_epi64(s, 4), mask)));
+		_mm_storeu_si128((__m128i *)(dst + i), d);
+	}
+	region_mul_add_scalar(dst + i, src + i, len - i, lo, hi);
+}
+
+__attribute__((target("avx2")))
+static void region_mul_add_avx2(uint8_t *dst, const uint8_t *src,
+				m0_bcount_t len,
+				const uint8_t *lo, const uint8_t *hi)
+{
+	__m256i     tlo  = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128((const __m128i *)lo));
+	__m256i     thi  = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128((const __m128i *)hi));
+	__m256i     mask = _mm256_set1_epi8(0x0f);
+	__m256i     s;
+	__m256i     d;
+	m0_bcount_t i;
+
+	for (i = 0; i + 32 <= len; i += 32) {
+		s = _mm256_loadu_si256((const __m256i *)(src + i));
+		d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		d = _mm256_xor_si256(d, _mm256_shuffle_epi8(tlo,
+					_mm256_and_si256(s, mask)));
+		d = _mm256_xor_si256(d, _mm256_shuffle_epi8(thi,
+			_mm256_and_si256(_mm256_srli_epi64(s, 4), mask)));
+		_mm256_storeu_si256((__m256i *)(dst + i), d);
+	}
+	region_mul_add_scalar(dst + i, src + i, len - i, lo, hi);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void region_mul_add_avx512(uint8_t *dst, const uint8_t *src,
+				  m0_bcount_t len,
+				  const uint8_t *lo, const uint8_t *hi)
+{
+	__m512i     tlo  = _mm512_broadcast_i32x4(
+				_mm_loadu_si128((const __m128i *)lo));
+	__m512i     thi  = _mm512_broadcast_i32x4(
+				_mm_loadu_si128((const __m128i *)hi));
+	__m512i     mask = _mm512_set1_epi8(0x0f);
+	__m512i     s;
+	__m512i     d;
+	m0_bcount_t i;
+
+	for (i = 0; i + 64 <= len; i += 64) {
+		s = _mm512_loadu_si512((const void *)(src + i));
+		d = _mm512_loadu_si512((const void *)(dst + i));
+		d = _mm512_xor_si512(d, _mm512_shuffle_epi8(tlo,
+					_mm512_and_si512(s, mask)));
+		d = _mm512_xor_si512(d, _mm512_shuffle_epi8(thi,
+			_mm512_and_si512(_mm512_srli_epi64(s, 4), mask)));
+		_mm512_storeu_si512((void *)(dst + i), d);
+	}
+	region_mul_add_scalar(dst + i, src + i, len - i, lo, hi);
+}
+#endif
+
+static const region_mul_add_t region_impls[M0_PARITY_REGION_NR] = {
+	[M0_PARITY_REGION_SCALAR] = &region_mul_add_scalar,
+#if PARITY_REGION_X86
+	[M0_PARITY_REGION_SSSE3]  = &region_mul_add_ssse3,
+	[M0_PARITY_REGION_AVX2]   = &region_mul_add_avx2,
+	[M0_PARITY_REGION_AVX512] = &region_mul_add_avx512,
+#endif
+};
+
+static enum m0_parity_region_impl region_best = M0_PARITY_REGION_SCALAR;
+static enum m0_parity_region_impl region_impl = M0_PARITY_REGION_SCALAR;
+
+static enum m0_parity_region_impl region_impl_detect(void)
+{
+#if PARITY_REGION_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512bw"))
+		return M0_PARITY_REGION_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return M0_PARITY_REGION_AVX2;
+	if (__builtin_cpu_supports("ssse3"))
+		return M0_PARITY_REGION_SSSE3;
+#endif
+	return M0_PARITY_REGION_SCALAR;
+}
+
+M0_INTERNAL void m0_parity_region_mul_add(uint8_t *dst, const uint8_t *src,
+					  m0_bcount_t len, m0_parity_elem_t c)
+{
+	uint8_t lo[16];
+	uint8_t hi[16];
+	int     i;
+
+	if (c == M0_PARITY_ZERO || len == 0)
+		return;
+	for (i = 0; i < 16; ++i) {
+		lo[i] = m0_parity_mul(c, i);
+		hi[i] = m0_parity_mul(c, i << 4);
+	}
+	region_impls[region_impl](dst, src, len, lo, hi);
+}
+
+M0_INTERNAL bool m0_parity_region_impl_set(enum m0_parity_region_impl impl)
+{
+	M0_PRE(impl < M0_PARITY_REGION_NR);
+
+	if (impl > region_best)
+		return false;
+	region_impl = impl;
+	return true;
+}
+
+M0_INTERNAL enum m0_parity_region_impl m0_parity_region_impl_get(void)
+{
+	return region_impl;
+}
+
+M0_INTERNAL enum m0_parity_region_impl m0_parity_region_impl_best(void)
+{
+	return region_best;
+}
+
 M0_INTERNAL void m0_parity_fini(void)
 {
 	galois_calc_tables_release();
@@ -36,6 +197,9 @@ M0_INTERNAL int m0_parity_init(void)
 {
 	int ret = galois_create_mult_tables(M0_PARITY_GALOIS_W);
 	M0_ASSERT(ret == 0);
+	region_best = region_impl_detect();
+	region_impl = region_best;
+	M0_LOG(M0_INFO, "parity region implementation: %d", region_impl);
 	return 0;
 }
 
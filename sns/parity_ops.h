@@ -27,6 +27,7 @@
 
 #include "galois/galois.h"
 #include "lib/assert.h"
+#include "lib/types.h"
 
 #define M0_PARITY_ZERO (0)
 #define M0_PARITY_GALOIS_W (8)
@@ -60,6 +61,39 @@ static inline m0_parity_elem_t m0_parity_div(m0_parity_elem_t x, m0_parity_elem_
 	return galois_multtable_divide(x, y, M0_PARITY_GALOIS_W);
 }
 
+/**
+ * Implementations of m0_parity_region_mul_add(). All of them multiply using
+ * a pair of 16-entry tables: products of the constant with the low and with
+ * the high nibble of a byte. SIMD variants look both tables up for a whole
+ * vector with a byte shuffle.
+ */
+enum m0_parity_region_impl {
+	M0_PARITY_REGION_SCALAR,
+	M0_PARITY_REGION_SSSE3,
+	M0_PARITY_REGION_AVX2,
+	M0_PARITY_REGION_AVX512,
+	M0_PARITY_REGION_NR
+};
+
+/**
+ * dst[i] ^= c * src[i] for i in [0, len).
+ *
+ * Uses the best implementation supported by the CPU, selected by
+ * m0_parity_init().
+ */
+M0_INTERNAL void m0_parity_region_mul_add(uint8_t *dst, const uint8_t *src,
+					  m0_bcount_t len, m0_parity_elem_t c);
+
+/**
+ * Switches m0_parity_region_mul_add() to the given implementation.
+ *
+ * @retval false the implementation is not supported, nothing is changed.
+ */
+M0_INTERNAL bool m0_parity_region_impl_set(enum m0_parity_region_impl impl);
+M0_INTERNAL enum m0_parity_region_impl m0_parity_region_impl_get(void);
+/** The best implementation supported by the CPU. */
+M0_INTERNAL enum m0_parity_region_impl m0_parity_region_impl_best(void);
+
 static inline m0_parity_elem_t m0_parity_lt(m0_parity_elem_t x, m0_parity_elem_t y)
 {
 	return x < y;
@@ -324,6 +324,42 @@ static void test_xor_fail_idx_recover(void)
 	test_recovery(M0_PARITY_CAL_ALGO_XOR, FAIL_INDEX);
 }
 
+/* Compares every supported implementation with m0_parity_mul(). */
+static void test_region_mul_add(void)
+{
+	static const m0_parity_elem_t consts[] = { 0, 1, 2, 0x1d, 0x8e, 0xff };
+	static const uint32_t         lens[]   = { 0, 1, 15, 16, 17, 31, 33,
+						   63, 64, 65, 127, 1000 };
+	enum m0_parity_region_impl    saved = m0_parity_region_impl_get();
+	enum m0_parity_region_impl    impl;
+	uint8_t                      *src = data[0] + 1; /* misaligned */
+	uint8_t                      *dst = data[1] + 3;
+	uint8_t                      *ref = expected[0];
+	uint32_t                      i;
+	uint32_t                      j;
+	uint32_t                      k;
+
+	for (k = 0; k < 1100; ++k) {
+		data[0][k] = m0_rnd64(&seed);
+		data[1][k] = m0_rnd64(&seed);
+	}
+	for (impl = 0; impl <= m0_parity_region_impl_best(); ++impl) {
+		M0_UT_ASSERT(m0_parity_region_impl_set(impl));
+		for (i = 0; i < ARRAY_SIZE(consts); ++i) {
+			for (j = 0; j < ARRAY_SIZE(lens); ++j) {
+				for (k = 0; k < lens[j]; ++k)
+					ref[k] = dst[k] ^
+						m0_parity_mul(consts[i],
+							      src[k]);
+				m0_parity_region_mul_add(dst, src, lens[j],
+							 consts[i]);
+				M0_UT_ASSERT(memcmp(dst, ref, lens[j]) == 0);
+			}
+		}
+	}
+	M0_UT_ASSERT(m0_parity_region_impl_set(saved));
+}
+
 static void test_buffer_xor(void)
 {
 	bool          generated;
@@ -1292,6 +1328,7 @@ static inline uint32_t block_nr(const struct m0_sns_ir *ir)
 	{ "parity_math_diff_xor", test_parity_math_diff_xor },		\
 	{ "parity_math_diff_rs", test_parity_math_diff_rs },		\
 	{ "incr_recov_rs", test_incr_recov_rs },			\
+	{ "region_mul_add", test_region_mul_add },			\
 	{ NULL, NULL }
 
 struct m0_ut_suite parity_math_ut = {
@@ -1302,8 +1339,27 @@ struct m0_ut_suite parity_math_ut = {
 };
 M0_EXPORTED(parity_math_ut);
 
+static enum m0_parity_region_impl parity_math_ut_impl;
+
+/* Runs the tests with SSSE3 kernels, or scalar ones if not supported. */
+static int parity_math_ssse3_ut_init(void)
+{
+	parity_math_ut_impl = m0_parity_region_impl_get();
+	if (!m0_parity_region_impl_set(M0_PARITY_REGION_SSSE3))
+		m0_parity_region_impl_set(M0_PARITY_REGION_SCALAR);
+	return 0;
+}
+
+static int parity_math_ssse3_ut_fini(void)
+{
+	m0_parity_region_impl_set(parity_math_ut_impl);
+	return 0;
+}
+
 struct m0_ut_suite parity_math_ssse3_ut = {
         .ts_name = "parity_math_ssse3-ut",
+        .ts_init = parity_math_ssse3_ut_init,
+        .ts_fini = parity_math_ssse3_ut_fini,
         .ts_tests = { _TESTS }
 };
 M0_EXPORTED(parity_math_ssse3_ut);
@@ -1434,7 +1490,62 @@ static void ub_large_32768(int iter)
 	parity_math_tb();
 }
 
-enum { UB_ITER = 1 };
+/* Encodes N data units of UNIT_BUFF_SIZE_MAX bytes into K parity units. */
+static void ub_encode(uint32_t n, uint32_t k)
+{
+	struct m0_parity_math math;
+	struct m0_buf         data_buf[DATA_UNIT_COUNT_MAX];
+	struct m0_buf         parity_buf[PARITY_UNIT_COUNT_MAX];
+	uint32_t              i;
+	int                   rc;
+
+	rc = m0_parity_math_init(&math, n, k);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < n; ++i)
+		m0_buf_init(&data_buf[i], data[i], UNIT_BUFF_SIZE_MAX);
+	for (i = 0; i < k; ++i)
+		m0_buf_init(&parity_buf[i], parity[i], UNIT_BUFF_SIZE_MAX);
+	m0_parity_math_calculate(&math, data_buf, parity_buf);
+	m0_parity_math_fini(&math);
+}
+
+static void ub_encode_4_2(int iter)
+{
+	ub_encode(4, 2);
+}
+
+static void ub_encode_8_2(int iter)
+{
+	ub_encode(8, 2);
+}
+
+static void ub_encode_8_4(int iter)
+{
+	ub_encode(8, 4);
+}
+
+static void ub_encode_16_4(int iter)
+{
+	ub_encode(16, 4);
+}
+
+static void ub_encode_20_6(int iter)
+{
+	ub_encode(20, 6);
+}
+
+enum { UB_ITER = 1, UB_ENCODE_ITER = 100 };
+
+/*
+ * Encoding benchmarks report bandwidth of the data units, block size and
+ * blocks per operation are set for that.
+ */
+#define UB_ENCODE(name, n, round)				\
+	{ .ub_name          = name,				\
+	  .ub_iter          = UB_ENCODE_ITER,			\
+	  .ub_block_size    = UNIT_BUFF_SIZE_MAX,		\
+	  .ub_blocks_per_op = n,				\
+	  .ub_round         = round }
 
 struct m0_ub_set m0_parity_math_ub = {
         .us_name = "parity-math-ub",
@@ -1477,10 +1588,18 @@ struct m0_ub_set m0_parity_math_ub = {
                   .ub_iter  = UB_ITER,
                   .ub_round = ub_large_1048576 },
 
+		UB_ENCODE("enc 04/02/1M", 4, ub_encode_4_2),
+		UB_ENCODE("enc 08/02/1M", 8, ub_encode_8_2),
+		UB_ENCODE("enc 08/04/1M", 8, ub_encode_8_4),
+		UB_ENCODE("enc 16/04/1M", 16, ub_encode_16_4),
+		UB_ENCODE("enc 20/06/1M", 20, ub_encode_20_6),
+
 		{ .ub_name = NULL}
 	}
 };
 
+#undef UB_ENCODE
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -115,7 +115,8 @@ void m0_spiel_tx_open(struct m0_spiel *spiel, struct m0_spiel_tx *tx)
 	tx->spt_buffer = NULL;
 
 	m0_mutex_init(lock);
-	m0_conf_cache_init(&tx->spt_cache, lock);
+	rc = m0_conf_cache_init(&tx->spt_cache, lock);
+	M0_ASSERT(rc == 0); /* XXX Error handling is for cowards. */
 
 	/* Create root object. */
 	m0_mutex_lock(lock);
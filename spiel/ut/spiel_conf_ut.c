@@ -1668,7 +1668,8 @@ static void spiel_conf_file(void)
 	M0_UT_ASSERT(rc == 0);
 
 	m0_mutex_init(&lock);
-	m0_conf_cache_init(&cache, &lock);
+	rc = m0_conf_cache_init(&cache, &lock);
+	M0_UT_ASSERT(rc == 0);
 
 	m0_mutex_lock(&lock);
 
@@ -72,6 +72,14 @@ enum m0_battr_id {
 	 * 64-bit Reference Tag
 	 */
 	M0_BI_REF_TAG,
+	/**
+	 * 32-bit CRC32C (Castagnoli) checksum
+	 */
+	M0_BI_CKSUM_CRC_32C,
+	/**
+	 * 64-bit xxHash64 checksum
+	 */
+	M0_BI_CKSUM_XXHASH_64,
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "motr/magic.h"
 
 #include "stob/stob.h"	/* m0_stob */
+#include "lib/misc.h"	/* m0_forall, INT_MAX */
 
 /**
  * @addtogroup stobcache
@@ -39,204 +40,320 @@ M0_TL_DESCR_DEFINE(stob_cache, "cached stobs", static, struct m0_stob,
 		   M0_STOB_CACHE_MAGIC, M0_STOB_CACHE_HEAD_MAGIC);
 M0_TL_DEFINE(stob_cache, static, struct m0_stob);
 
+enum {
+	/** Number of hash buckets in a shard. */
+	STOB_CACHE_SHARD_BUCKET_NR = 64,
+};
+
+static uint64_t stob_cache_fid_hash(const struct m0_fid *fid)
+{
+	return m0_fid_hash(fid);
+}
+
+static uint64_t stob_cache_hash_func(const struct m0_htable *htable,
+				     const struct m0_fid *fid)
+{
+	/* Low bits select the shard, see stob_cache_shard(). */
+	return stob_cache_fid_hash(fid) / M0_STOB_CACHE_SHARD_NR %
+		htable->h_bucket_nr;
+}
+
+static bool stob_cache_hash_eq(const struct m0_fid *a, const struct m0_fid *b)
+{
+	return m0_fid_eq(a, b);
+}
+
+M0_HT_DESCR_DEFINE(stob_cache_hash, "cached stobs by fid", static,
+		   struct m0_stob, so_cache_hlink, so_cache_magic,
+		   M0_STOB_CACHE_MAGIC, M0_STOB_CACHE_HASH_MAGIC,
+		   so_id.si_fid, stob_cache_hash_func, stob_cache_hash_eq);
+M0_HT_DEFINE(stob_cache_hash, static, struct m0_stob, struct m0_fid);
+
+static struct m0_stob_cache_shard *
+stob_cache_shard(const struct m0_stob_cache *cache, const struct m0_fid *fid)
+{
+	return (struct m0_stob_cache_shard *)
+		&cache->sc_shard[stob_cache_fid_hash(fid) %
+				 M0_STOB_CACHE_SHARD_NR];
+}
+
+static void stob_cache_shard_fini(struct m0_stob_cache_shard *shard)
+{
+	struct m0_stob *zombie;
+
+	m0_tl_for(stob_cache, &shard->scs_ring, zombie) {
+		M0_LOG(M0_FATAL, "Still %s "FID_F,
+		       zombie->so_cache_idle ? "idle" : "busy",
+		       FID_P(m0_stob_fid_get(zombie)));
+	} m0_tl_endfor;
+	stob_cache_tlist_fini(&shard->scs_ring);
+	stob_cache_hash_htable_fini(&shard->scs_hash);
+	m0_mutex_fini(&shard->scs_lock);
+}
+
 M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 				   uint64_t idle_size,
 				   m0_stob_cache_eviction_cb_t eviction_cb)
 {
+	struct m0_stob_cache_shard *shard;
+	int                         rc = 0;
+	int                         i;
+
 	*cache = (struct m0_stob_cache){
-		.sc_idle_size	= idle_size,
-		.sc_idle_used	= 0,
 		.sc_eviction_cb = eviction_cb,
-		.sc_busy_hits	= 0,
-		.sc_idle_hits	= 0,
-		.sc_misses	= 0,
-		.sc_evictions	= 0,
 	};
-	m0_mutex_init(&cache->sc_lock);
-	stob_cache_tlist_init(&cache->sc_busy);
-	stob_cache_tlist_init(&cache->sc_idle);
-	return 0;
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shard[i];
+		rc = stob_cache_hash_htable_init(&shard->scs_hash,
+						 STOB_CACHE_SHARD_BUCKET_NR);
+		if (rc != 0)
+			break;
+		m0_mutex_init(&shard->scs_lock);
+		stob_cache_tlist_init(&shard->scs_ring);
+		shard->scs_idle_size = (idle_size + M0_STOB_CACHE_SHARD_NR - 1) /
+				       M0_STOB_CACHE_SHARD_NR;
+	}
+	if (rc != 0) {
+		while (--i >= 0)
+			stob_cache_shard_fini(&cache->sc_shard[i]);
+	}
+	return M0_RC(rc);
 }
 
 M0_INTERNAL void m0_stob_cache_fini(struct m0_stob_cache *cache)
 {
-	struct m0_stob *zombie;
+	int i;
 
-	m0_stob_cache_purge(cache, cache->sc_idle_size);
+	m0_stob_cache_purge(cache, INT_MAX);
 	m0_stob_cache__print(cache);
-	m0_tl_for(stob_cache, &cache->sc_busy, zombie) {
-		M0_LOG(M0_FATAL, "Still busy "FID_F,
-		       FID_P(m0_stob_fid_get(zombie)));
-	} m0_tl_endfor;
-	m0_tl_for(stob_cache, &cache->sc_idle, zombie) {
-		M0_LOG(M0_FATAL, "Still idle "FID_F,
-		       FID_P(m0_stob_fid_get(zombie)));
-	} m0_tl_endfor;
-	stob_cache_tlist_fini(&cache->sc_idle);
-	stob_cache_tlist_fini(&cache->sc_busy);
-	m0_mutex_fini(&cache->sc_lock);
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i)
+		stob_cache_shard_fini(&cache->sc_shard[i]);
 }
 
-
-M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache)
+static bool stob_cache_shard_invariant(const struct m0_stob_cache_shard *shard)
 {
-	return _0C(m0_stob_cache_is_locked(cache)) &&
-	       _0C(cache->sc_idle_size >= cache->sc_idle_used) &&
-	       M0_CHECK_EX(_0C(stob_cache_tlist_length(&cache->sc_idle) ==
-			       cache->sc_idle_used));
+	return _0C(m0_mutex_is_locked(&shard->scs_lock)) &&
+	       _0C(shard->scs_stats.scs_idle_used <= shard->scs_idle_size) &&
+	       _0C(ergo(shard->scs_hand != NULL,
+			stob_cache_tlist_contains(&shard->scs_ring,
+						  shard->scs_hand))) &&
+	       M0_CHECK_EX(_0C(stob_cache_hash_htable_size(&shard->scs_hash) ==
+			       stob_cache_tlist_length(&shard->scs_ring))) &&
+	       M0_CHECK_EX(_0C(m0_tl_reduce(stob_cache, stob, &shard->scs_ring,
+					    0, + stob->so_cache_idle) ==
+			       shard->scs_stats.scs_idle_used));
+}
 
+M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache,
+					  const struct m0_fid *stob_fid)
+{
+	return stob_cache_shard_invariant(stob_cache_shard(cache, stob_fid));
 }
 
-static void stob_cache_evict(struct m0_stob_cache *cache,
-			     struct m0_stob *stob)
+static struct m0_stob *stob_cache_next(struct m0_stob_cache_shard *shard,
+				       struct m0_stob *stob)
 {
-	cache->sc_eviction_cb(cache, stob);
-	++cache->sc_evictions;
+	return stob_cache_tlist_next(&shard->scs_ring, stob) ?:
+		stob_cache_tlist_head(&shard->scs_ring);
 }
 
-static void stob_cache_idle_del(struct m0_stob_cache *cache,
-				struct m0_stob *stob)
+static void stob_cache_evict(struct m0_stob_cache *cache,
+			     struct m0_stob_cache_shard *shard,
+			     struct m0_stob *stob)
 {
 	M0_ENTRY("stob %p, stob_fid "FID_F, stob,
 	       FID_P(m0_stob_fid_get(stob)));
+	M0_PRE(stob->so_cache_idle);
+
+	if (shard->scs_hand == stob)
+		shard->scs_hand = stob_cache_tlist_next(&shard->scs_ring, stob);
+	stob_cache_hash_htable_del(&shard->scs_hash, stob);
+	stob_cache_hash_tlink_fini(stob);
 	stob_cache_tlink_del_fini(stob);
-	--cache->sc_idle_used;
+	stob->so_cache_idle = false;
+	--shard->scs_stats.scs_idle_used;
+	++shard->scs_stats.scs_evictions;
+	cache->sc_eviction_cb(cache, stob);
 }
 
-static void stob_cache_idle_moveto(struct m0_stob_cache *cache,
-				   struct m0_stob *stob)
+/**
+ * Advances the clock hand to an idle stob with the reference bit clear and
+ * evicts it. Terminates after at most two turns, because the first turn
+ * clears the reference bits of all idle stobs.
+ */
+static void stob_cache_clock(struct m0_stob_cache *cache,
+			     struct m0_stob_cache_shard *shard)
 {
-	struct m0_stob *evicted;
+	struct m0_stob *stob = shard->scs_hand ?:
+				stob_cache_tlist_head(&shard->scs_ring);
+
+	M0_PRE(shard->scs_stats.scs_idle_used > 0);
 
-	stob_cache_tlist_move(&cache->sc_idle, stob);
-	++cache->sc_idle_used;
-	if (cache->sc_idle_used > cache->sc_idle_size) {
-		evicted = stob_cache_tlist_tail(&cache->sc_idle);
-		stob_cache_idle_del(cache, evicted);
-		stob_cache_evict(cache, evicted);
+	while (!stob->so_cache_idle || stob->so_cache_referenced) {
+		if (stob->so_cache_idle)
+			stob->so_cache_referenced = false;
+		stob = stob_cache_next(shard, stob);
 	}
+	shard->scs_hand = stob;
+	stob_cache_evict(cache, shard, stob);
 }
 
 M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 				   struct m0_stob *stob)
 {
-	M0_PRE(m0_stob_cache__invariant(cache));
-	M0_PRE_EX(m0_stob_cache_lookup(cache, m0_stob_fid_get(stob)) == NULL);
-
-	stob_cache_tlink_init_at(stob, &cache->sc_busy);
+	struct m0_stob_cache_shard *shard;
+
+	shard = stob_cache_shard(cache, m0_stob_fid_get(stob));
+	M0_PRE(stob_cache_shard_invariant(shard));
+	M0_PRE_EX(stob_cache_hash_htable_lookup(&shard->scs_hash,
+					m0_stob_fid_get(stob)) == NULL);
+
+	stob->so_cache_idle       = false;
+	stob->so_cache_referenced = true;
+	stob_cache_tlink_init_at_tail(stob, &shard->scs_ring);
+	stob_cache_hash_tlink_init(stob);
+	stob_cache_hash_htable_add(&shard->scs_hash, stob);
 }
 
 M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
 				   struct m0_stob *stob)
 {
-	M0_PRE(m0_stob_cache__invariant(cache));
+	struct m0_stob_cache_shard *shard;
+
+	shard = stob_cache_shard(cache, m0_stob_fid_get(stob));
+	M0_PRE(stob_cache_shard_invariant(shard));
+	M0_PRE(!stob->so_cache_idle);
 
-	stob_cache_idle_moveto(cache, stob);
+	stob->so_cache_idle       = true;
+	stob->so_cache_referenced = true;
+	++shard->scs_stats.scs_idle_used;
+	if (shard->scs_stats.scs_idle_used > shard->scs_idle_size)
+		stob_cache_clock(cache, shard);
 }
 
 M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
 						 const struct m0_fid *stob_fid)
 {
-	struct m0_stob *stob;
-
-	M0_PRE(m0_stob_cache__invariant(cache));
-
-	m0_tl_for(stob_cache, &cache->sc_busy, stob) {
-		if (m0_fid_cmp(stob_fid, m0_stob_fid_get(stob)) == 0) {
-			++cache->sc_busy_hits;
-			return stob;
-		}
-	} m0_tl_endfor;
-
-	m0_tl_for(stob_cache, &cache->sc_idle, stob) {
-		if (m0_fid_cmp(stob_fid, m0_stob_fid_get(stob)) == 0) {
-			++cache->sc_idle_hits;
-			stob_cache_idle_del(cache, stob);
-			stob_cache_tlink_init_at(stob, &cache->sc_busy);
-			return stob;
-		}
-	} m0_tl_endfor;
-
-	++cache->sc_misses;
-	return NULL;
+	struct m0_stob_cache_shard *shard = stob_cache_shard(cache, stob_fid);
+	struct m0_stob             *stob;
+
+	M0_PRE(stob_cache_shard_invariant(shard));
+
+	stob = stob_cache_hash_htable_lookup(&shard->scs_hash, stob_fid);
+	if (stob == NULL) {
+		++shard->scs_stats.scs_misses;
+	} else if (stob->so_cache_idle) {
+		++shard->scs_stats.scs_idle_hits;
+		--shard->scs_stats.scs_idle_used;
+		stob->so_cache_idle       = false;
+		stob->so_cache_referenced = true;
+	} else {
+		++shard->scs_stats.scs_busy_hits;
+	}
+	return stob;
 }
 
-
 M0_INTERNAL void m0_stob_cache_purge(struct m0_stob_cache *cache, int nr)
 {
-	struct m0_stob *stob;
-	struct m0_stob *prev;
-
-	m0_stob_cache_lock(cache);
-	M0_PRE(m0_stob_cache__invariant(cache));
-
-	stob = stob_cache_tlist_tail(&cache->sc_idle);
-	for (; stob != NULL && nr > 0; --nr) {
-		prev = stob_cache_tlist_prev(&cache->sc_idle, stob);
-		stob_cache_idle_del(cache, stob);
-		stob_cache_evict(cache, stob);
-		stob = prev;
+	struct m0_stob_cache_shard *shard;
+	struct m0_stob             *stob;
+	int                         i;
+
+	M0_PRE(m0_stob_cache_is_not_locked(cache));
+
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR && nr > 0; ++i) {
+		shard = &cache->sc_shard[i];
+		m0_mutex_lock(&shard->scs_lock);
+		M0_PRE(stob_cache_shard_invariant(shard));
+		m0_tl_for(stob_cache, &shard->scs_ring, stob) {
+			if (nr == 0)
+				break;
+			if (stob->so_cache_idle) {
+				stob_cache_evict(cache, shard, stob);
+				--nr;
+			}
+		} m0_tl_endfor;
+		M0_POST(stob_cache_shard_invariant(shard));
+		m0_mutex_unlock(&shard->scs_lock);
 	}
-
-	M0_POST(m0_stob_cache__invariant(cache));
-	m0_stob_cache_unlock(cache);
 }
 
-M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache)
+M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache,
+				    const struct m0_fid *stob_fid)
 {
-	m0_mutex_lock(&cache->sc_lock);
+	m0_mutex_lock(&stob_cache_shard(cache, stob_fid)->scs_lock);
 }
 
-M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache)
+M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache,
+				      const struct m0_fid *stob_fid)
 {
-	m0_mutex_unlock(&cache->sc_lock);
+	m0_mutex_unlock(&stob_cache_shard(cache, stob_fid)->scs_lock);
 }
 
-M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache)
+M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache,
+					 const struct m0_fid *stob_fid)
 {
-	return m0_mutex_is_locked(&cache->sc_lock);
+	return m0_mutex_is_locked(&stob_cache_shard(cache, stob_fid)->scs_lock);
 }
 
 M0_INTERNAL bool m0_stob_cache_is_not_locked(const struct m0_stob_cache *cache)
 {
-	return m0_mutex_is_not_locked(&cache->sc_lock);
+	return m0_forall(i, M0_STOB_CACHE_SHARD_NR,
+			 m0_mutex_is_not_locked(&cache->sc_shard[i].scs_lock));
+}
+
+M0_INTERNAL void m0_stob_cache_stats_get(struct m0_stob_cache *cache,
+					 struct m0_stob_cache_stats *stats)
+{
+	struct m0_stob_cache_shard *shard;
+	int                         i;
+
+	M0_SET0(stats);
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shard[i];
+		m0_mutex_lock(&shard->scs_lock);
+		stats->scs_busy_hits += shard->scs_stats.scs_busy_hits;
+		stats->scs_idle_hits += shard->scs_stats.scs_idle_hits;
+		stats->scs_misses    += shard->scs_stats.scs_misses;
+		stats->scs_evictions += shard->scs_stats.scs_evictions;
+		stats->scs_idle_used += shard->scs_stats.scs_idle_used;
+		m0_mutex_unlock(&shard->scs_lock);
+	}
 }
 
 M0_INTERNAL void m0_stob_cache__print(struct m0_stob_cache *cache)
 {
 #define LEVEL M0_DEBUG
-	struct m0_stob *stob;
-	int		i;
+	struct m0_stob_cache_stats  stats;
+	struct m0_stob_cache_shard *shard;
+	struct m0_stob             *stob;
+	int                         i;
+	int                         j;
 
+	m0_stob_cache_stats_get(cache, &stats);
 	M0_LOG(LEVEL, "m0_stob_cache %p: "
-	       "sc_busy_hits = %"PRIu64", sc_idle_hits = %"PRIu64", "
-	       "sc_misses = %"PRIu64", sc_evictions = %"PRIu64, cache,
-	       cache->sc_busy_hits, cache->sc_idle_hits,
-	       cache->sc_misses, cache->sc_evictions);
-	M0_LOG(LEVEL, "m0_stob_cache %p: "
-	       "sc_idle_size = %"PRIu64", sc_idle_used = %"PRIu64", ",
-	       cache, cache->sc_idle_size, cache->sc_idle_used);
-	M0_LOG(LEVEL, "m0_stob_cache %p: "
-	       "sc_busy length = %zu, sc_idle length = %zu", cache,
-	       stob_cache_tlist_length(&cache->sc_busy),
-	       stob_cache_tlist_length(&cache->sc_idle));
-
-
-	M0_LOG(LEVEL, "m0_stob_cache %p: sc_busy list", cache);
-	i = 0;
-	m0_tl_for(stob_cache, &cache->sc_busy, stob) {
-		M0_LOG(LEVEL, "%d: %p, stob_fid =" FID_F,
-		       i, stob, FID_P(m0_stob_fid_get(stob)));
-		++i;
-	} m0_tl_endfor;
-
-	M0_LOG(LEVEL, "m0_stob_cache %p: sc_idle list", cache);
-	i = 0;
-	m0_tl_for(stob_cache, &cache->sc_idle, stob) {
-		M0_LOG(LEVEL, "%d: %p, stob_key =" FID_F,
-		       i, stob, FID_P(m0_stob_fid_get(stob)));
-		++i;
-	} m0_tl_endfor;
+	       "busy_hits = %"PRIu64", idle_hits = %"PRIu64", "
+	       "misses = %"PRIu64", evictions = %"PRIu64", "
+	       "idle_used = %"PRIu64, cache,
+	       stats.scs_busy_hits, stats.scs_idle_hits,
+	       stats.scs_misses, stats.scs_evictions, stats.scs_idle_used);
+
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shard[i];
+		m0_mutex_lock(&shard->scs_lock);
+		M0_LOG(LEVEL, "m0_stob_cache %p: shard %d: idle_size = %"PRIu64
+		       ", idle_used = %"PRIu64", length = %zu", cache, i,
+		       shard->scs_idle_size, shard->scs_stats.scs_idle_used,
+		       stob_cache_tlist_length(&shard->scs_ring));
+		j = 0;
+		m0_tl_for(stob_cache, &shard->scs_ring, stob) {
+			M0_LOG(LEVEL, "%d: %p, stob_fid =" FID_F ", %s", j,
+			       stob, FID_P(m0_stob_fid_get(stob)),
+			       stob->so_cache_idle ? "idle" : "busy");
+			++j;
+		} m0_tl_endfor;
+		m0_mutex_unlock(&shard->scs_lock);
+	}
 	M0_LOG(LEVEL, "m0_stob_cache %p: end.", cache);
 #undef LEVEL
 }
@@ -27,13 +27,28 @@
 
 #include "lib/mutex.h"	/* m0_mutex */
 #include "lib/tlist.h"	/* m0_tl */
+#include "lib/hash.h"	/* m0_htable */
 #include "lib/types.h"	/* uint64_t */
 #include "fid/fid.h"    /* m0_fid */
 
 /**
  * @defgroup stob Storage object
  *
- * @todo more scalable object index instead of a list.
+ * Stob cache keeps stobs found in a stob domain. A stob is "busy" from
+ * m0_stob_cache_add() or m0_stob_cache_lookup() until m0_stob_cache_idle(),
+ * and "idle" after that. Idle stobs stay in the cache and are evicted when
+ * there are too many of them.
+ *
+ * The cache is split into M0_STOB_CACHE_SHARD_NR shards, selected by the hash
+ * of the stob fid. Each shard has its own lock, a hash table of its stobs and
+ * a CLOCK ring, so that finding stobs with different fids does not serialise
+ * on a single lock. All operations on a stob must be done under the lock of
+ * its shard: m0_stob_cache_lock(cache, stob_fid).
+ *
+ * Idle stobs are evicted in CLOCK order: every stob has a reference bit that
+ * is set when the stob becomes idle or is found. The clock hand skips busy
+ * stobs, clears the bit of referenced idle stobs and evicts the first idle
+ * stob with the bit clear.
  *
  * @{
  */
@@ -43,28 +58,54 @@ struct m0_stob_cache;
 
 typedef void (*m0_stob_cache_eviction_cb_t)(struct m0_stob_cache *cache,
 					    struct m0_stob *stob);
-/**
- * @todo document
- */
+
+enum {
+	/** Number of shards in a stob cache. */
+	M0_STOB_CACHE_SHARD_NR = 16,
+};
+
+/** Stob cache statistics, summed over shards. */
+struct m0_stob_cache_stats {
+	/** Lookups that found a busy stob. */
+	uint64_t scs_busy_hits;
+	/** Lookups that found an idle stob. */
+	uint64_t scs_idle_hits;
+	/** Lookups that found nothing. */
+	uint64_t scs_misses;
+	/** Idle stobs evicted. */
+	uint64_t scs_evictions;
+	/** Idle stobs in the cache. */
+	uint64_t scs_idle_used;
+};
+
+/** Stob cache shard. */
+struct m0_stob_cache_shard {
+	struct m0_mutex             scs_lock;
+	/** Stobs of the shard, by fid. Linked through m0_stob::so_cache_hlink. */
+	struct m0_htable            scs_hash;
+	/**
+	 * CLOCK ring of all stobs of the shard.
+	 * Linked through m0_stob::so_cache_linkage.
+	 */
+	struct m0_tl		    scs_ring;
+	/** Clock hand, NULL means the head of scs_ring. */
+	struct m0_stob		   *scs_hand;
+	/** Maximal number of idle stobs in the shard. */
+	uint64_t		    scs_idle_size;
+	struct m0_stob_cache_stats  scs_stats;
+};
+
 struct m0_stob_cache {
-	struct m0_mutex             sc_lock;
-	struct m0_tl		    sc_busy;
-	struct m0_tl		    sc_idle;
-	uint64_t		    sc_idle_size;
-	uint64_t		    sc_idle_used;
+	struct m0_stob_cache_shard  sc_shard[M0_STOB_CACHE_SHARD_NR];
 	m0_stob_cache_eviction_cb_t sc_eviction_cb;
-
-	uint64_t		    sc_busy_hits;
-	uint64_t		    sc_idle_hits;
-	uint64_t		    sc_misses;
-	uint64_t		    sc_evictions;
 };
 
 /**
  * Initialises stob cache.
  *
  * @param cache stob cache
- * @param idle_size idle list maximum size
+ * @param idle_size maximum number of idle stobs. The limit is divided between
+ *		    the shards and rounded up.
  */
 M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 				   uint64_t idle_size,
@@ -72,19 +113,20 @@ M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 M0_INTERNAL void m0_stob_cache_fini(struct m0_stob_cache *cache);
 
 /**
- * Stob cache invariant.
+ * Stob cache invariant for the shard of stob_fid.
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, stob_fid)
+ * @post m0_stob_cache_is_locked(cache, stob_fid)
  */
-M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache);
+M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache,
+					  const struct m0_fid *stob_fid);
 
 /**
  * Adds stob to the stob cache. Stob should be deleted from the stob cache using
  * m0_stob_cache_idle().
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
+ * @post m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
  */
 M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 				   struct m0_stob *stob);
@@ -92,8 +134,8 @@ M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 /**
  * Deletes item from the stob cache.
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
+ * @post m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
  */
 M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
 				   struct m0_stob *stob);
@@ -102,8 +144,8 @@ M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
  * Finds item in the stob cache. Stob found should be deleted from the stob
  * cache using m0_stob_cache_idle().
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, stob_fid)
+ * @post m0_stob_cache_is_locked(cache, stob_fid)
  */
 M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
 						 const struct m0_fid *stob_fid);
@@ -116,13 +158,21 @@ M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
  */
 M0_INTERNAL void m0_stob_cache_purge(struct m0_stob_cache *cache, int nr);
 
-M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache);
-M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache);
-M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache);
+M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache,
+				    const struct m0_fid *stob_fid);
+M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache,
+				      const struct m0_fid *stob_fid);
+M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache,
+					 const struct m0_fid *stob_fid);
+/** No shard of the cache is locked by the current thread. */
 M0_INTERNAL bool m0_stob_cache_is_not_locked(const struct m0_stob_cache *cache);
 
+M0_INTERNAL void m0_stob_cache_stats_get(struct m0_stob_cache *cache,
+					 struct m0_stob_cache_stats *stats);
+
 M0_INTERNAL void m0_stob_cache__print(struct m0_stob_cache *cache);
 
+/** @} end group stob */
 
 #endif /* __MOTR_STOB_CACHE_H__ */
 
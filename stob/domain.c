@@ -45,10 +45,13 @@ enum {
 	 * Maximum number of cached stobs that ain't held by any user and
 	 * ain't finalised yet.
 	 *
-	 * @note 0x10 may be too small value.
+	 * The limit is split between the cache shards, each of them keeps as
+	 * many idle stobs as the whole cache did before it was sharded.
+	 *
+	 * @note 0x10 per shard may be too small value.
 	 * @todo make a parameter for stob domain.
 	 */
-	M0_STOB_CACHE_MAX_SIZE = 0x10,
+	M0_STOB_CACHE_MAX_SIZE = 0x10 * M0_STOB_CACHE_SHARD_NR,
 };
 
 static int stob_domain_type(const char *location,
@@ -175,13 +178,18 @@ static int stob_domain_init_create(const char *location,
 		}
 	}
 	M0_ASSERT(ergo(rc == 0, *out != NULL));
+	if (rc == 0) {
+		rc = m0_stob_cache_init(&(*out)->sd_cache,
+					M0_STOB_CACHE_MAX_SIZE,
+					&stob_domain_cache_evict_cb);
+		if (rc != 0)
+			(*out)->sd_ops->sdo_fini(*out);
+	}
 	if (rc == 0) {
 		dom		      = *out;
 		dom->sd_location      = m0_strdup(location);
 		dom->sd_location_data = location_data;
 		dom->sd_type	      = type;
-		m0_stob_cache_init(&dom->sd_cache, M0_STOB_CACHE_MAX_SIZE,
-				   &stob_domain_cache_evict_cb);
 		M0_ASSERT_EX(m0_stob_domain_find(m0_stob_domain_id_get(dom)) ==
 			     NULL);
 		m0_stob_type__dom_add(type, dom);
@@ -96,6 +96,35 @@
    implemented, because it requires synchronization between user actions
    (cancellation) and ongoing IO in SIS_BUSY state.
 
+   <b>io_uring engine</b>
+
+   When motr is configured with --enable-io-uring, a domain can be initialised
+   with M0_STOB_IOQ_ENGINE_URING (see m0_stob_ioq_init()). Fragments are still
+   built as iocb-s and go through the same admission queue, but:
+
+       - ioq_queue_submit() moves all fragments that fit into the submission
+         queue under ioq_lock and issues a single io_uring_enter(2) for the
+         whole batch. It is called directly by the launching thread (normally
+         a fom locality handler), no worker thread is involved in submission;
+
+       - files opened in the domain are registered in the io_uring fixed file
+         table (m0_stob_ioq_fd_register()), which saves an fget/fput pair per
+         request;
+
+       - a single reaper thread (stob_ioq_reaper()) harvests completions from
+         the completion queue in batches and calls ioq_complete() for them
+         without a system call per event. ioq_complete() broadcasts
+         m0_stob_io::si_wait, which posts the wakeup AST straight to the locality
+         of the fom waiting for the io.
+
+   The reaper waits for completions with a timeout passed directly to
+   io_uring_enter(2), which requires IORING_FEAT_EXT_ARG (Linux 5.11). On older
+   kernels the domain falls back to libaio.
+
+   User buffers are not registered as fixed buffers: adieu buffers are
+   arbitrary user memory (network buffers, be segments), which is not known in
+   advance.
+
    @todo use explicit state machine instead of ioq threads
 
    @see http://www.kernel.org/doc/man-pages/online/pages/man2/io_setup.2.html
@@ -119,6 +148,8 @@ struct ioq_qev {
 	    (linux_domain::ioq_queue). */
 	struct m0_queue_link  iq_linkage;
 	struct m0_stob_io    *iq_io;
+	/** Slot of the stob fd in the io_uring fixed file table or -1. */
+	int                   iq_slot;
 };
 
 /**
@@ -268,6 +299,7 @@ static int stob_linux_io_launch(struct m0_stob_io *io)
 		m0_bcount_t  chunk_size = 0;
 
 		qev->iq_io = io;
+		qev->iq_slot = lstob->sl_fd_slot;
 		m0_queue_link_init(&qev->iq_linkage);
 
 		iocb->u.v.vec = iov;
@@ -386,6 +418,52 @@ static void ioq_queue_unlock(struct m0_stob_ioq *ioq)
 	m0_mutex_unlock(&ioq->ioq_lock);
 }
 
+#ifdef HAVE_LIBURING
+/**
+   Transfers fragments from the admission queue to the io_uring submission
+   queue and submits all of them with a single system call.
+ */
+static void ioq_uring_submit(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_sqe *sqe;
+	struct ioq_qev      *qev;
+	struct iocb         *iocb;
+	int                  fd;
+	int                  put;
+
+	ioq_queue_lock(ioq);
+	while (ioq->ioq_queued > 0 && m0_atomic64_get(&ioq->ioq_avail) > 0) {
+		sqe = io_uring_get_sqe(&ioq->ioq_uring);
+		if (sqe == NULL)
+			break;
+		qev  = ioq_queue_get(ioq);
+		iocb = &qev->iq_iocb;
+		fd   = qev->iq_slot >= 0 ? qev->iq_slot : iocb->aio_fildes;
+		if (iocb->aio_lio_opcode == IO_CMD_PREADV)
+			io_uring_prep_readv(sqe, fd, iocb->u.v.vec,
+					    iocb->u.v.nr, iocb->u.v.offset);
+		else
+			io_uring_prep_writev(sqe, fd, iocb->u.v.vec,
+					     iocb->u.v.nr, iocb->u.v.offset);
+		if (qev->iq_slot >= 0)
+			io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+		io_uring_sqe_set_data(sqe, qev);
+		m0_atomic64_dec(&ioq->ioq_avail);
+	}
+	/*
+	 * Entries which were not consumed because of a transient error
+	 * (-EAGAIN, -EBUSY) stay in the submission queue and are submitted by
+	 * the next call, which is made at least once per reaper timeout.
+	 */
+	if (io_uring_sq_ready(&ioq->ioq_uring) > 0) {
+		put = io_uring_submit(&ioq->ioq_uring);
+		if (put < 0)
+			M0_LOG(M0_ERROR, "io_uring_submit: rc=%d", put);
+	}
+	ioq_queue_unlock(ioq);
+}
+#endif
+
 /**
    Transfers fragments from the admission queue to the ring buffer in batches
    until the ring buffer is full.
@@ -400,6 +478,12 @@ static void ioq_queue_submit(struct m0_stob_ioq *ioq)
 	struct ioq_qev  *qev[M0_STOB_IOQ_BATCH_IN_SIZE];
 	struct iocb    *evin[M0_STOB_IOQ_BATCH_IN_SIZE];
 
+#ifdef HAVE_LIBURING
+	if (ioq->ioq_engine == M0_STOB_IOQ_ENGINE_URING) {
+		ioq_uring_submit(ioq);
+		return;
+	}
+#endif
 	do {
 		ioq_queue_lock(ioq);
 		avail = m0_atomic64_get(&ioq->ioq_avail);
@@ -683,18 +767,155 @@ static void stob_ioq_thread(struct m0_stob_ioq *ioq)
 	m0_timer_locality_fini(&ioq->ioq_stop_timer_loc[thread_index]);
 }
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq)
+#ifdef HAVE_LIBURING
+/**
+   Completion reaper of io_uring engine.
+
+   Waits for completion events, delivers them to the users in batches and
+   refills the submission queue from the admission queue.
+ */
+static void stob_ioq_reaper(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_cqe     *cqe[M0_STOB_IOQ_BATCH_OUT_SIZE];
+	struct __kernel_timespec timeout;
+	struct m0_addb2_hist     inflight = {};
+	struct m0_addb2_hist     queued   = {};
+	struct m0_addb2_hist     gotten   = {};
+	struct ioq_qev          *qev;
+	bool                     stop = false;
+	int                      got;
+	int                      rc;
+	int                      i;
+
+	M0_ADDB2_PUSH(M0_AVI_STOB_IOQ, M0_STOB_IOQ_NR_THREADS);
+	m0_addb2_hist_add_auto(&inflight, 1000, M0_AVI_STOB_IOQ_INFLIGHT, -1);
+	m0_addb2_hist_add_auto(&queued,   1000, M0_AVI_STOB_IOQ_QUEUED, -1);
+	m0_addb2_hist_add_auto(&gotten,   1000, M0_AVI_STOB_IOQ_GOT, -1);
+	while (!stop) {
+		timeout = (struct __kernel_timespec){
+			.tv_sec  = ioq_timeout_default.tv_sec,
+			.tv_nsec = ioq_timeout_default.tv_nsec
+		};
+		rc = io_uring_wait_cqe_timeout(&ioq->ioq_uring, &cqe[0],
+					       &timeout);
+		got = rc == 0 ? io_uring_peek_batch_cqe(&ioq->ioq_uring, cqe,
+							ARRAY_SIZE(cqe)) : 0;
+		for (i = 0; i < got; ++i) {
+			qev = io_uring_cqe_get_data(cqe[i]);
+			if (qev == NULL)
+				continue; /* Wake-up from m0_stob_ioq_fini(). */
+			M0_ASSERT(!m0_queue_link_is_in(&qev->iq_linkage));
+			m0_atomic64_inc(&ioq->ioq_avail);
+			ioq_complete(ioq, qev, cqe[i]->res, 0);
+		}
+		io_uring_cq_advance(&ioq->ioq_uring, got);
+		ioq_uring_submit(ioq);
+		m0_addb2_hist_mod(&gotten, got);
+		m0_addb2_hist_mod(&queued, ioq->ioq_queued);
+		m0_addb2_hist_mod(&inflight, M0_STOB_IOQ_RING_SIZE -
+				     m0_atomic64_get(&ioq->ioq_avail));
+		m0_addb2_force(M0_MKTIME(5, 0));
+		ioq_queue_lock(ioq);
+		stop = ioq->ioq_reaper_stop;
+		ioq_queue_unlock(ioq);
+	}
+	m0_addb2_pop(M0_AVI_STOB_IOQ);
+}
+
+static int stob_ioq_uring_init(struct m0_stob_ioq *ioq)
+{
+	int fds[M0_STOB_IOQ_URING_FILES_NR];
+	int rc;
+	int i;
+
+	rc = io_uring_queue_init(M0_STOB_IOQ_RING_SIZE, &ioq->ioq_uring, 0);
+	if (rc != 0)
+		return M0_ERR(rc);
+	/*
+	 * Without IORING_FEAT_EXT_ARG (kernels before 5.11) liburing
+	 * implements io_uring_wait_cqe_timeout() with an internal timeout sqe,
+	 * which races with ioq_uring_submit() in the launching threads.
+	 */
+	if (!(ioq->ioq_uring.features & IORING_FEAT_EXT_ARG)) {
+		rc = -ENOSYS;
+		goto queue_exit;
+	}
+	/* Sparse table, slots are filled by m0_stob_ioq_fd_register(). */
+	for (i = 0; i < ARRAY_SIZE(fds); ++i)
+		fds[i] = -1;
+	rc = io_uring_register_files(&ioq->ioq_uring, fds, ARRAY_SIZE(fds));
+	if (rc != 0)
+		goto queue_exit;
+	rc = m0_bitmap_init(&ioq->ioq_files, ARRAY_SIZE(fds));
+	if (rc != 0)
+		goto unregister;
+	ioq->ioq_reaper_stop = false;
+	rc = M0_THREAD_INIT(&ioq->ioq_reaper, struct m0_stob_ioq *, NULL,
+			    &stob_ioq_reaper, ioq, "ioq_reaper");
+	if (rc == 0)
+		return M0_RC(0);
+	m0_bitmap_fini(&ioq->ioq_files);
+unregister:
+	io_uring_unregister_files(&ioq->ioq_uring);
+queue_exit:
+	io_uring_queue_exit(&ioq->ioq_uring);
+	return M0_ERR(rc);
+}
+
+static void stob_ioq_uring_fini(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_sqe *sqe;
+
+	ioq_queue_lock(ioq);
+	ioq->ioq_reaper_stop = true;
+	/* Kick the reaper out of io_uring_wait_cqe_timeout(). */
+	sqe = io_uring_get_sqe(&ioq->ioq_uring);
+	if (sqe != NULL) {
+		io_uring_prep_nop(sqe);
+		io_uring_sqe_set_data(sqe, NULL);
+		io_uring_submit(&ioq->ioq_uring);
+	}
+	ioq_queue_unlock(ioq);
+	m0_thread_join(&ioq->ioq_reaper);
+	m0_thread_fini(&ioq->ioq_reaper);
+	m0_bitmap_fini(&ioq->ioq_files);
+	io_uring_unregister_files(&ioq->ioq_uring);
+	io_uring_queue_exit(&ioq->ioq_uring);
+}
+#endif
+
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq,
+				 enum m0_stob_ioq_engine engine)
 {
 	int result;
 	int i;
 
+	M0_PRE(engine < M0_STOB_IOQ_ENGINE_NR);
+
 	ioq->ioq_ctx      = NULL;
 	m0_atomic64_set(&ioq->ioq_avail, M0_STOB_IOQ_RING_SIZE);
 	ioq->ioq_queued   = 0;
+	ioq->ioq_engine   = M0_STOB_IOQ_ENGINE_AIO;
 
 	m0_queue_init(&ioq->ioq_queue);
 	m0_mutex_init(&ioq->ioq_lock);
 
+	if (engine == M0_STOB_IOQ_ENGINE_URING) {
+#ifdef HAVE_LIBURING
+		result = stob_ioq_uring_init(ioq);
+		if (result == 0) {
+			ioq->ioq_engine = M0_STOB_IOQ_ENGINE_URING;
+			m0_stob_ioq_directio_setup(ioq, false);
+			return M0_RC(0);
+		}
+		M0_LOG(M0_WARN, "io_uring is not available: rc=%d, "
+		       "falling back to libaio", result);
+#else
+		M0_LOG(M0_WARN, "motr is built without io_uring support, "
+		       "falling back to libaio");
+#endif
+	}
+
 	result = io_setup(M0_STOB_IOQ_RING_SIZE, &ioq->ioq_ctx);
 	if (result == 0) {
 		for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
@@ -717,6 +938,14 @@ M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq)
 {
 	int i;
 
+#ifdef HAVE_LIBURING
+	if (ioq->ioq_engine == M0_STOB_IOQ_ENGINE_URING) {
+		stob_ioq_uring_fini(ioq);
+		m0_queue_fini(&ioq->ioq_queue);
+		m0_mutex_fini(&ioq->ioq_lock);
+		return;
+	}
+#endif
 	for (i = 0; i < ARRAY_SIZE(ioq->ioq_stop_timer); ++i)
 		m0_timer_start(&ioq->ioq_stop_timer[i], M0_TIME_IMMEDIATELY);
 	for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
@@ -729,6 +958,57 @@ M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq)
 	m0_mutex_fini(&ioq->ioq_lock);
 }
 
+M0_INTERNAL enum m0_stob_ioq_engine m0_stob_ioq_engine(struct m0_stob_ioq *ioq)
+{
+	return ioq->ioq_engine;
+}
+
+M0_INTERNAL void m0_stob_ioq_fd_register(struct m0_stob_ioq *ioq, int fd,
+					 int *slot)
+{
+#ifdef HAVE_LIBURING
+	size_t idx;
+	int    rc;
+#endif
+
+	*slot = -1;
+#ifdef HAVE_LIBURING
+	if (ioq->ioq_engine != M0_STOB_IOQ_ENGINE_URING)
+		return;
+	ioq_queue_lock(ioq);
+	idx = m0_bitmap_ffz(&ioq->ioq_files);
+	if (idx != (size_t)-1) {
+		rc = io_uring_register_files_update(&ioq->ioq_uring, idx,
+						    &fd, 1);
+		if (rc == 1) {
+			m0_bitmap_set(&ioq->ioq_files, idx, true);
+			*slot = idx;
+		} else
+			M0_LOG(M0_DEBUG, "fd=%d is not registered: rc=%d",
+			       fd, rc);
+	}
+	ioq_queue_unlock(ioq);
+#endif
+}
+
+M0_INTERNAL void m0_stob_ioq_fd_deregister(struct m0_stob_ioq *ioq, int slot)
+{
+#ifdef HAVE_LIBURING
+	int fd = -1;
+
+	if (slot < 0)
+		return;
+	M0_PRE(ioq->ioq_engine == M0_STOB_IOQ_ENGINE_URING);
+	ioq_queue_lock(ioq);
+	M0_ASSERT(m0_bitmap_get(&ioq->ioq_files, slot));
+	io_uring_register_files_update(&ioq->ioq_uring, slot, &fd, 1);
+	m0_bitmap_set(&ioq->ioq_files, slot, false);
+	ioq_queue_unlock(ioq);
+#else
+	M0_PRE(slot < 0);
+#endif
+}
+
 M0_INTERNAL uint32_t m0_stob_ioq_bshift(struct m0_stob_ioq *ioq)
 {
 	return ioq->ioq_use_directio ? STOB_IOQ_BSHIFT : 0;
@@ -26,6 +26,9 @@
 #define __MOTR_STOB_IOQ_H__
 
 #include <libaio.h>        /* io_context_t */
+#ifdef HAVE_LIBURING
+#include <liburing.h>      /* io_uring */
+#endif
 
 #include "lib/types.h"     /* bool */
 #include "lib/atomic.h"    /* m0_atomic64 */
@@ -34,6 +37,7 @@
 #include "lib/queue.h"     /* m0_queue */
 #include "lib/timer.h"     /* m0_timer */
 #include "lib/semaphore.h" /* m0_semaphore */
+#include "lib/bitmap.h"    /* m0_bitmap */
 
 /**
  * @defgroup stoblinux
@@ -55,6 +59,24 @@ enum {
 	/** Size of a batch in which completion events are extracted from the
 	    ring buffer. */
 	M0_STOB_IOQ_BATCH_OUT_SIZE = 8,
+	/** Size of the registered (fixed) file table of io_uring engine. */
+	M0_STOB_IOQ_URING_FILES_NR = 1024,
+};
+
+/** I/O engine used to execute linux stob adieu requests. */
+enum m0_stob_ioq_engine {
+	/**
+	 * libaio io_submit(2)/io_getevents(2) with M0_STOB_IOQ_NR_THREADS
+	 * worker threads. Default.
+	 */
+	M0_STOB_IOQ_ENGINE_AIO,
+	/**
+	 * io_uring(7) with batched submission from the launching thread and a
+	 * single completion reaper. Only available when motr is configured
+	 * with --enable-io-uring.
+	 */
+	M0_STOB_IOQ_ENGINE_URING,
+	M0_STOB_IOQ_ENGINE_NR
 };
 
 struct m0_stob_ioq {
@@ -89,10 +111,35 @@ struct m0_stob_ioq {
 	struct m0_semaphore      ioq_stop_sem[M0_STOB_IOQ_NR_THREADS];
 	struct m0_timer          ioq_stop_timer[M0_STOB_IOQ_NR_THREADS];
 	struct m0_timer_locality ioq_stop_timer_loc[M0_STOB_IOQ_NR_THREADS];
+	/** Engine selected at m0_stob_ioq_init(). */
+	enum m0_stob_ioq_engine  ioq_engine;
+#ifdef HAVE_LIBURING
+	/**
+	    io_uring instance used instead of ioq_ctx when ioq_engine is
+	    M0_STOB_IOQ_ENGINE_URING. Submission queue is protected by ioq_lock,
+	    completion queue is only touched by ioq_reaper.
+	 */
+	struct io_uring          ioq_uring;
+	/** Completion reaper thread of io_uring engine. */
+	struct m0_thread         ioq_reaper;
+	/** Set under ioq_lock when ioq_reaper has to exit. */
+	bool                     ioq_reaper_stop;
+	/** Used slots of the registered file table, protected by ioq_lock. */
+	struct m0_bitmap         ioq_files;
+#endif
 };
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq);
+/**
+ * Initialises ioq with the given engine.
+ *
+ * If M0_STOB_IOQ_ENGINE_URING is requested, but motr is built without
+ * liburing or the kernel doesn't support io_uring, ioq falls back to
+ * M0_STOB_IOQ_ENGINE_AIO.
+ */
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq,
+				 enum m0_stob_ioq_engine engine);
 M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq);
+M0_INTERNAL enum m0_stob_ioq_engine m0_stob_ioq_engine(struct m0_stob_ioq *ioq);
 M0_INTERNAL void m0_stob_ioq_directio_setup(struct m0_stob_ioq *ioq,
 					    bool use_directio);
 
@@ -101,6 +148,18 @@ M0_INTERNAL uint32_t m0_stob_ioq_bshift(struct m0_stob_ioq *ioq);
 M0_INTERNAL m0_bcount_t m0_stob_ioq_bsize(struct m0_stob_ioq *ioq);
 M0_INTERNAL m0_bcount_t m0_stob_ioq_bmask(struct m0_stob_ioq *ioq);
 
+/**
+ * Registers fd in the fixed file table of io_uring engine.
+ *
+ * Sets *slot to the index of registered file, or to -1 if the file is not
+ * registered (AIO engine, or the table is full). I/O to a stob without a slot
+ * is submitted with plain fd.
+ */
+M0_INTERNAL void m0_stob_ioq_fd_register(struct m0_stob_ioq *ioq, int fd,
+					 int *slot);
+/** Removes a file registered by m0_stob_ioq_fd_register(). */
+M0_INTERNAL void m0_stob_ioq_fd_deregister(struct m0_stob_ioq *ioq, int slot);
+
 M0_INTERNAL int m0_stob_linux_io_init(struct m0_stob *stob,
 				      struct m0_stob_io *io);
 
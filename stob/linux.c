@@ -71,6 +71,12 @@
    somewhere in str_cfg_init for m0_stob_domain_init() or
    m0_stob_domain_create().
 
+   <b>I/O engine</b>
+
+   By default adieu requests are executed with libaio. If motr is configured
+   with --enable-io-uring, "ioq=uring" in str_cfg_init selects io_uring engine
+   for the domain (@see m0_stob_ioq_engine).
+
    <b>Symlinks</b>
 
    To make stob pointing to other file on the filesystem just pass filename
@@ -196,10 +202,13 @@ static int stob_linux_domain_cfg_init_parse(const char *str_cfg_init,
 			.sldc_file_mode	   = 0700,
 			.sldc_file_flags   = 0,
 			.sldc_use_directio = false,
+			.sldc_ioq_engine   = M0_STOB_IOQ_ENGINE_AIO,
 		};
 		if (str_cfg_init != NULL) {
 			cfg->sldc_use_directio = strstr(str_cfg_init,
 						"directio=true") != NULL;
+			if (strstr(str_cfg_init, "ioq=uring") != NULL)
+				cfg->sldc_ioq_engine = M0_STOB_IOQ_ENGINE_URING;
 		}
 	}
 	if (rc == 0)
@@ -246,7 +255,8 @@ static int stob_linux_domain_init(struct m0_stob_type *type,
 
 	rc = rc ?: stob_linux_domain_key_get_set(path, &dom_key, true);
 	rc = rc ?: m0_stob_domain__dom_key_is_valid(dom_key) ? 0 : -EINVAL;
-	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq);
+	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq,
+				    ldom->sld_cfg.sldc_ioq_engine);
 	if (rc == 0) {
 		m0_stob_ioq_directio_setup(&ldom->sld_ioq,
 					   ldom->sld_cfg.sldc_use_directio);
@@ -339,7 +349,11 @@ static struct m0_stob *stob_linux_alloc(struct m0_stob_domain *dom,
 	struct m0_stob_linux *lstob;
 
 	M0_ALLOC_PTR(lstob);
-	return lstob == NULL ? NULL : &lstob->sl_stob;
+	if (lstob == NULL)
+		return NULL;
+	lstob->sl_fd      = -1;
+	lstob->sl_fd_slot = -1;
+	return &lstob->sl_stob;
 }
 
 static void stob_linux_free(struct m0_stob_domain *dom,
@@ -399,6 +413,9 @@ static int stob_linux_open(struct m0_stob *stob,
 	lstob->sl_fd = rc ?: open(file_stob, flags,
 				  ldom->sld_cfg.sldc_file_mode);
 	rc = lstob->sl_fd == -1 ? -errno : stob_linux_stat(lstob);
+	if (rc == 0)
+		m0_stob_ioq_fd_register(&ldom->sld_ioq, lstob->sl_fd,
+					&lstob->sl_fd_slot);
 
 	m0_free(file_stob);
 
@@ -417,6 +434,9 @@ static void stob_linux_close(struct m0_stob_linux *lstob)
 	int rc;
 
 	if (lstob->sl_fd != -1) {
+		m0_stob_ioq_fd_deregister(&lstob->sl_dom->sld_ioq,
+					  lstob->sl_fd_slot);
+		lstob->sl_fd_slot = -1;
 		rc = close(lstob->sl_fd);
 		M0_ASSERT(rc == 0);
 		lstob->sl_fd = -1;
@@ -42,6 +42,8 @@ struct m0_stob_linux_domain_cfg {
 	mode_t sldc_file_mode;
 	int    sldc_file_flags;
 	bool   sldc_use_directio;
+	/** I/O engine of the domain ioq, "ioq=uring" selects io_uring. */
+	enum m0_stob_ioq_engine sldc_ioq_engine;
 };
 
 struct m0_stob_linux_domain {
@@ -58,6 +60,8 @@ struct m0_stob_linux {
 	struct m0_stob_linux_domain *sl_dom;
 	/** fd from returned open(2) */
 	int			     sl_fd;
+	/** sl_fd slot in the ioq fixed file table or -1 */
+	int			     sl_fd_slot;
 	/** file mode as returned by stat(2) */
 	mode_t			     sl_mode;
 	/** fid of the corresponding m0_conf_sdev object */
@@ -77,6 +77,7 @@ static uint32_t block_shift;
 static uint32_t buf_size;
 
 static int test_adieu_init(const char *location,
+			   const char *dom_init_cfg,
 			   const char *dom_cfg,
 			   const char *stob_cfg)
 {
@@ -84,8 +85,8 @@ static int test_adieu_init(const char *location,
 	int               rc;
 	struct m0_stob_id stob_id;
 
-	rc = m0_stob_domain_create(location,
-				   NULL, M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
+	rc = m0_stob_domain_create(location, dom_init_cfg,
+				   M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
 	M0_ASSERT(rc == 0);
 	M0_ASSERT(dom != NULL);
 
@@ -254,7 +255,21 @@ void m0_stob_ut_adieu_linux(void)
 {
 	int rc;
 
-	rc = test_adieu_init(linux_location, NULL, NULL);
+	rc = test_adieu_init(linux_location, NULL, NULL, NULL);
+	M0_ASSERT(rc == 0);
+	test_adieu(linux_path);
+	test_adieu_fini();
+}
+
+/*
+ * Falls back to libaio if io_uring is not compiled in or is not supported by
+ * the kernel, so the test is valid in every configuration.
+ */
+void m0_stob_ut_adieu_linux_uring(void)
+{
+	int rc;
+
+	rc = test_adieu_init(linux_location, "ioq=uring", NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(linux_path);
 	test_adieu_fini();
@@ -264,7 +279,7 @@ void m0_stob_ut_adieu_perf(void)
 {
 	int rc;
 
-	rc = test_adieu_init(perf_location, NULL, NULL);
+	rc = test_adieu_init(perf_location, NULL, NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(perf_path);
 	test_adieu_fini();
@@ -341,7 +356,7 @@ static void ub_iovec_sort_invert()
 
 static int ub_init(const char *opts M0_UNUSED)
 {
-	return test_adieu_init(linux_location, NULL, NULL);
+	return test_adieu_init(linux_location, NULL, NULL, NULL);
 }
 
 static void ub_fini(void)
@@ -25,6 +25,7 @@
 #include "lib/memory.h"		/* M0_ALLOC_PTR */
 #include "lib/thread.h"		/* M0_THREAD_INIT */
 #include "lib/arith.h"		/* m0_rnd64 */
+#include "lib/atomic.h"		/* m0_atomic64 */
 
 #include "ut/ut.h"		/* M0_UT_ASSERT */
 #include "ut/threads.h"		/* M0_UT_THREADS_DEFINE */
@@ -64,7 +65,7 @@ static void stob_ut_cache_thread(struct stob_ut_cache_ctx *ctx)
 		stob = &stob_ut_cache_stobs[j];
 		/* add to cache if it hasn't been added yet */
 		/* delete if it has already been added */
-		m0_stob_cache_lock(cache);
+		m0_stob_cache_lock(cache, m0_stob_fid_get(stob));
 		found = m0_stob_cache_lookup(cache, m0_stob_fid_get(stob));
 		if (found == NULL) {
 			m0_stob_cache_add(cache, stob);
@@ -80,16 +81,19 @@ static void stob_ut_cache_thread(struct stob_ut_cache_ctx *ctx)
 		 */
 		if (found != NULL && found2 != NULL)
 			m0_stob_cache_idle(cache, stob);
-		m0_stob_cache_unlock(cache);
+		m0_stob_cache_unlock(cache, m0_stob_fid_get(stob));
 		M0_UT_ASSERT(ergo(found == NULL, found2 != NULL));
 		M0_UT_ASSERT(M0_IN(stob, (found, found2)));
 	}
 }
 
+static struct m0_atomic64 stob_ut_cache_evicted;
+
 static void stob_ut_cache_evict_cb(struct m0_stob_cache *cache,
 				   struct m0_stob *stob)
 {
-	/* XXX check that it is called */
+	M0_UT_ASSERT(!stob->so_cache_idle);
+	m0_atomic64_inc(&stob_ut_cache_evicted);
 }
 
 M0_UT_THREADS_DEFINE(stob_cache, stob_ut_cache_thread);
@@ -101,6 +105,7 @@ static void stob_ut_cache_test(size_t thread_nr,
 	struct stob_ut_cache_ctx *ctxs;
 	struct m0_stob		 *stob;
 	const struct m0_fid      *stob_fid;
+	struct m0_stob_cache_stats stats;
 	size_t			  i;
 	int			  rc;
 	uint64_t		  state = 0;
@@ -110,6 +115,7 @@ static void stob_ut_cache_test(size_t thread_nr,
 
 	M0_SET0(&stob_ut_cache);
 	M0_SET_ARR0(stob_ut_cache_stobs);
+	m0_atomic64_set(&stob_ut_cache_evicted, 0);
 
 	rc = m0_stob_cache_init(&stob_ut_cache, idle_size,
 				&stob_ut_cache_evict_cb);
@@ -128,15 +134,23 @@ static void stob_ut_cache_test(size_t thread_nr,
 	M0_UT_THREADS_START(stob_cache, thread_nr, ctxs);
 	M0_UT_THREADS_STOP(stob_cache);
 
+	m0_stob_cache_stats_get(&stob_ut_cache, &stats);
+	M0_UT_ASSERT(stats.scs_evictions ==
+		     m0_atomic64_get(&stob_ut_cache_evicted));
+	M0_UT_ASSERT(stats.scs_busy_hits + stats.scs_idle_hits +
+		     stats.scs_misses == thread_nr * iter_nr * 2);
+	M0_UT_ASSERT(stats.scs_idle_used <=
+		     idle_size + M0_STOB_CACHE_SHARD_NR - 1);
+
 	/* clear stob cache */
-	m0_stob_cache_lock(&stob_ut_cache);
 	for (i = 0; i < ARRAY_SIZE(stob_ut_cache_stobs); ++i) {
 		stob_fid = m0_stob_fid_get(&stob_ut_cache_stobs[i]);
+		m0_stob_cache_lock(&stob_ut_cache, stob_fid);
 		stob = m0_stob_cache_lookup(&stob_ut_cache, stob_fid);
 		if (stob != NULL)
 			m0_stob_cache_idle(&stob_ut_cache, stob);
+		m0_stob_cache_unlock(&stob_ut_cache, stob_fid);
 	}
-	m0_stob_cache_unlock(&stob_ut_cache);
 
 	m0_stob_cache_fini(&stob_ut_cache);
 	m0_free(ctxs);
@@ -153,6 +167,171 @@ void m0_stob_ut_cache_idle_size0(void)
 	stob_ut_cache_test(STOB_UT_CACHE_THREAD_NR, STOB_UT_CACHE_ITER_NR, 0);
 }
 
+static struct m0_stob *stob_ut_cache_find(const struct m0_fid *fid)
+{
+	struct m0_stob *stob;
+
+	m0_stob_cache_lock(&stob_ut_cache, fid);
+	stob = m0_stob_cache_lookup(&stob_ut_cache, fid);
+	m0_stob_cache_unlock(&stob_ut_cache, fid);
+	return stob;
+}
+
+static void stob_ut_cache_idle(struct m0_stob *stob)
+{
+	m0_stob_cache_lock(&stob_ut_cache, m0_stob_fid_get(stob));
+	m0_stob_cache_idle(&stob_ut_cache, stob);
+	m0_stob_cache_unlock(&stob_ut_cache, m0_stob_fid_get(stob));
+}
+
+/*
+ * Checks CLOCK eviction order on three stobs of the same shard, with one idle
+ * stob allowed per shard.
+ */
+void m0_stob_ut_cache_clock(void)
+{
+	struct m0_stob_cache_stats stats;
+	struct m0_stob		  *s = stob_ut_cache_stobs;
+	uint64_t		   key;
+	int			   i;
+	int			   rc;
+
+	M0_SET0(&stob_ut_cache);
+	M0_SET_ARR0(stob_ut_cache_stobs);
+	m0_atomic64_set(&stob_ut_cache_evicted, 0);
+	rc = m0_stob_cache_init(&stob_ut_cache, M0_STOB_CACHE_SHARD_NR,
+				&stob_ut_cache_evict_cb);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0, key = 0; i < 3; ++key) {
+		s[i].so_id.si_fid = M0_FID_INIT(0, key);
+		if (m0_fid_hash(&s[i].so_id.si_fid) %
+		    M0_STOB_CACHE_SHARD_NR == 0)
+			++i;
+	}
+	for (i = 0; i < 3; ++i) {
+		m0_stob_cache_lock(&stob_ut_cache, m0_stob_fid_get(&s[i]));
+		m0_stob_cache_add(&stob_ut_cache, &s[i]);
+		m0_stob_cache_unlock(&stob_ut_cache, m0_stob_fid_get(&s[i]));
+	}
+	/* s[2] is busy and is never evicted. */
+	stob_ut_cache_idle(&s[0]);
+	M0_UT_ASSERT(m0_atomic64_get(&stob_ut_cache_evicted) == 0);
+	/* Both idle stobs are referenced: the hand clears both, evicts s[0]. */
+	stob_ut_cache_idle(&s[1]);
+	M0_UT_ASSERT(m0_atomic64_get(&stob_ut_cache_evicted) == 1);
+	M0_UT_ASSERT(stob_ut_cache_find(m0_stob_fid_get(&s[0])) == NULL);
+	M0_UT_ASSERT(stob_ut_cache_find(m0_stob_fid_get(&s[1])) == &s[1]);
+	M0_UT_ASSERT(stob_ut_cache_find(m0_stob_fid_get(&s[2])) == &s[2]);
+	/* s[0] is re-added and idles with the reference bit set. */
+	m0_stob_cache_lock(&stob_ut_cache, m0_stob_fid_get(&s[0]));
+	m0_stob_cache_add(&stob_ut_cache, &s[0]);
+	m0_stob_cache_unlock(&stob_ut_cache, m0_stob_fid_get(&s[0]));
+	stob_ut_cache_idle(&s[1]);
+	stob_ut_cache_idle(&s[0]);
+	M0_UT_ASSERT(m0_atomic64_get(&stob_ut_cache_evicted) == 2);
+	M0_UT_ASSERT(stob_ut_cache_find(m0_stob_fid_get(&s[1])) == NULL);
+
+	m0_stob_cache_stats_get(&stob_ut_cache, &stats);
+	M0_UT_ASSERT(stats.scs_evictions == 2);
+	M0_UT_ASSERT(stats.scs_misses == 2);
+	M0_UT_ASSERT(stats.scs_idle_hits == 1);
+	M0_UT_ASSERT(stats.scs_busy_hits == 1);
+	M0_UT_ASSERT(stats.scs_idle_used == 1);
+
+	stob_ut_cache_idle(&s[2]);
+	m0_stob_cache_fini(&stob_ut_cache);
+	M0_UT_ASSERT(m0_atomic64_get(&stob_ut_cache_evicted) == 4);
+}
+
+#ifndef __KERNEL__
+#include "lib/ub.h"		/* m0_ub_set */
+#include "lib/errno.h"		/* ENOMEM */
+
+enum {
+	STOB_UB_CACHE_THREAD_NR	= 32,
+	STOB_UB_CACHE_STOB_NR	= 0x400,
+	STOB_UB_CACHE_OPS_NR	= 0x1000,
+	STOB_UB_CACHE_ITER	= 20,
+};
+
+static struct m0_stob *stob_ub_cache_stobs;
+
+/*
+ * Each thread plays a locality that finds and puts random stobs of its own
+ * range, like ioservice foms do with cob stobs.
+ */
+static void stob_ub_cache_thread(struct stob_ut_cache_ctx *ctx)
+{
+	struct m0_stob_cache *cache = &stob_ut_cache;
+	struct m0_stob	     *base;
+	struct m0_stob	     *stob;
+	uint64_t	      state = ctx->suc_index;
+	int		      i;
+
+	base = &stob_ub_cache_stobs[ctx->suc_index * STOB_UB_CACHE_STOB_NR];
+	for (i = 0; i < STOB_UB_CACHE_OPS_NR; ++i) {
+		stob = &base[m0_rnd64(&state) % STOB_UB_CACHE_STOB_NR];
+		m0_stob_cache_lock(cache, m0_stob_fid_get(stob));
+		if (m0_stob_cache_lookup(cache, m0_stob_fid_get(stob)) == NULL)
+			m0_stob_cache_add(cache, stob);
+		m0_stob_cache_idle(cache, stob);
+		m0_stob_cache_unlock(cache, m0_stob_fid_get(stob));
+	}
+}
+
+M0_UT_THREADS_DEFINE(stob_ub_cache, stob_ub_cache_thread);
+
+static struct stob_ut_cache_ctx stob_ub_cache_ctxs[STOB_UB_CACHE_THREAD_NR];
+
+static int stob_ub_cache_init(const char *opts M0_UNUSED)
+{
+	int i;
+	int rc;
+
+	M0_ALLOC_ARR(stob_ub_cache_stobs,
+		     STOB_UB_CACHE_THREAD_NR * STOB_UB_CACHE_STOB_NR);
+	if (stob_ub_cache_stobs == NULL)
+		return -ENOMEM;
+	for (i = 0; i < STOB_UB_CACHE_THREAD_NR * STOB_UB_CACHE_STOB_NR; ++i)
+		stob_ub_cache_stobs[i].so_id.si_fid = M0_FID_INIT(1, i);
+	for (i = 0; i < STOB_UB_CACHE_THREAD_NR; ++i)
+		stob_ub_cache_ctxs[i].suc_index = i;
+	/* Enough idle slots to keep a quarter of the stobs cached. */
+	rc = m0_stob_cache_init(&stob_ut_cache, STOB_UB_CACHE_THREAD_NR *
+				STOB_UB_CACHE_STOB_NR / 4,
+				&stob_ut_cache_evict_cb);
+	if (rc != 0)
+		m0_free0(&stob_ub_cache_stobs);
+	return rc;
+}
+
+static void stob_ub_cache_fini(void)
+{
+	m0_stob_cache_fini(&stob_ut_cache);
+	m0_free0(&stob_ub_cache_stobs);
+}
+
+static void stob_ub_cache_round(int iter M0_UNUSED)
+{
+	M0_UT_THREADS_START(stob_ub_cache, STOB_UB_CACHE_THREAD_NR,
+			    stob_ub_cache_ctxs);
+	M0_UT_THREADS_STOP(stob_ub_cache);
+}
+
+struct m0_ub_set m0_stob_cache_ub = {
+	.us_name = "stob-cache-ub",
+	.us_init = stob_ub_cache_init,
+	.us_fini = stob_ub_cache_fini,
+	.us_run  = {
+		{ .ub_name  = "find-put-mt",
+		  .ub_iter  = STOB_UB_CACHE_ITER,
+		  .ub_round = stob_ub_cache_round },
+
+		{ .ub_name = NULL }
+	}
+};
+#endif /* __KERNEL__ */
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -30,6 +30,7 @@
 #include "ut/threads.h"
 
 #include "stob/ad.h"		/* m0_stob_ad_cfg_make */
+#include "stob/cache.h"		/* m0_stob_cache_stats_get */
 #include "stob/domain.h"
 #include "stob/stob.h"
 
@@ -248,6 +249,56 @@ void m0_stob_ut_stob_null(void)
 			   M0_STOB_UT_THREAD_NR, M0_STOB_UT_STOB_NR);
 }
 
+/*
+ * With one idle slot per shard, m0_stob_put() of a stob evicts an idle stob,
+ * possibly the stob being put. Check that the stob is not touched after that
+ * and that it can be found again.
+ */
+void m0_stob_ut_stob_put_evict(void)
+{
+	struct m0_stob_domain       *dom;
+	struct m0_stob              *stob;
+	struct m0_stob_id            stob_id;
+	struct m0_stob_cache_stats   stats;
+	m0_stob_cache_eviction_cb_t  evict_cb;
+	uint64_t                     dom_key = 0xec0de;
+	uint64_t                     stob_nr = 4 * M0_STOB_CACHE_SHARD_NR;
+	uint64_t                     i;
+	int                          round;
+	int                          rc;
+
+	rc = m0_stob_domain_create("nullstob:path", NULL, dom_key, NULL, &dom);
+	M0_UT_ASSERT(rc == 0);
+	/* The default limit leaves room for several idle stobs per shard. */
+	M0_UT_ASSERT(m0_forall(i, M0_STOB_CACHE_SHARD_NR,
+			       dom->sd_cache.sc_shard[i].scs_idle_size > 1));
+	evict_cb = dom->sd_cache.sc_eviction_cb;
+	m0_stob_cache_fini(&dom->sd_cache);
+	rc = m0_stob_cache_init(&dom->sd_cache, 1, evict_cb);
+	M0_UT_ASSERT(rc == 0);
+
+	/* The second round finds stobs, which were put and evicted. */
+	for (round = 0; round < 2; ++round) {
+		for (i = 1; i <= stob_nr; ++i) {
+			m0_stob_id_make(0, i, &dom->sd_id, &stob_id);
+			rc = m0_stob_find(&stob_id, &stob);
+			M0_UT_ASSERT(rc == 0);
+			M0_UT_ASSERT(m0_fid_eq(m0_stob_fid_get(stob),
+					       &stob_id.si_fid));
+			m0_stob_get(stob);
+			m0_stob_put(stob);
+			m0_stob_put(stob);
+		}
+	}
+	m0_stob_cache_stats_get(&dom->sd_cache, &stats);
+	M0_UT_ASSERT(stats.scs_idle_used <= M0_STOB_CACHE_SHARD_NR);
+	M0_UT_ASSERT(stats.scs_evictions >=
+		     2 * (stob_nr - M0_STOB_CACHE_SHARD_NR));
+
+	rc = m0_stob_domain_destroy(dom);
+	M0_UT_ASSERT(rc == 0);
+}
+
 #ifndef __KERNEL__
 void m0_stob_ut_stob_linux(void)
 {
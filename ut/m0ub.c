@@ -32,12 +32,15 @@
 extern struct m0_ub_set m0_ad_ub;
 extern struct m0_ub_set m0_adieu_ub;
 extern struct m0_ub_set m0_atomic_ub;
+extern struct m0_ub_set m0_be_regmap_ub;
 extern struct m0_ub_set m0_bitmap_ub;
+extern struct m0_ub_set m0_conf_ub;
 extern struct m0_ub_set m0_fol_ub;
 extern struct m0_ub_set m0_fom_ub;
 extern struct m0_ub_set m0_list_ub;
 extern struct m0_ub_set m0_memory_ub;
 extern struct m0_ub_set m0_parity_math_ub;
+extern struct m0_ub_set m0_stob_cache_ub;
 //extern struct m0_ub_set m0_rpc_ub;
 extern struct m0_ub_set m0_thread_ub;
 extern struct m0_ub_set m0_time_ub;
@@ -45,6 +48,7 @@ extern struct m0_ub_set m0_timer_ub;
 extern struct m0_ub_set m0_tlist_ub;
 extern struct m0_ub_set m0_trace_ub;
 extern struct m0_ub_set m0_varr_ub;
+extern struct m0_ub_set m0_xcode_ub;
 
 #define UB_SANDBOX "./ub-sandbox"
 
@@ -98,19 +102,23 @@ static void ub_add(const struct ub_args *args)
 	 * These benchmarks are executed in reverse order from the way
 	 * they are listed here.
 	 */
+	m0_ub_set_add(&m0_xcode_ub);
 	m0_ub_set_add(&m0_varr_ub);
 	m0_ub_set_add(&m0_trace_ub);
 	m0_ub_set_add(&m0_tlist_ub);
 	m0_ub_set_add(&m0_timer_ub);
 	m0_ub_set_add(&m0_time_ub);
 	m0_ub_set_add(&m0_thread_ub);
+	m0_ub_set_add(&m0_stob_cache_ub);
 //	m0_ub_set_add(&m0_rpc_ub);
-//XXX_BE_DB	m0_ub_set_add(&m0_parity_math_ub);
+	m0_ub_set_add(&m0_parity_math_ub);
 	m0_ub_set_add(&m0_memory_ub);
 	m0_ub_set_add(&m0_list_ub);
 	m0_ub_set_add(&m0_fom_ub);
 	m0_ub_set_add(&m0_fol_ub);
+	m0_ub_set_add(&m0_conf_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_bitmap_ub);
+	m0_ub_set_add(&m0_be_regmap_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_atomic_ub);
 	m0_ub_set_add(&m0_adieu_ub);
 	m0_ub_set_add(&m0_ad_ub);
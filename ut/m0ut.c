@@ -67,6 +67,7 @@ extern struct m0_ut_suite ut_suite_obj;
 extern struct m0_ut_suite ut_suite_io;
 extern struct m0_ut_suite ut_suite_io_nw_xfer;
 extern struct m0_ut_suite ut_suite_io_pargrp;
+extern struct m0_ut_suite ut_suite_io_cache;
 extern struct m0_ut_suite ut_suite_io_req;
 extern struct m0_ut_suite ut_suite_io_req_fop;
 extern struct m0_ut_suite ut_suite_sync;
@@ -111,6 +112,7 @@ extern struct m0_ut_suite fdmi_filterc_ut;
 extern struct m0_ut_suite fdmi_filter_eval_ut;
 extern struct m0_ut_suite fit_ut;
 extern struct m0_ut_suite fol_ut;
+extern struct m0_ut_suite fom_sched_ut;
 extern struct m0_ut_suite fom_timedwait_ut;
 extern struct m0_ut_suite frm_ut;
 extern struct m0_ut_suite ha_ut;
@@ -199,6 +201,7 @@ static void tests_add(struct m0_ut_module *m)
 	m0_ut_add(m, &ut_suite_io, true);
 	m0_ut_add(m, &ut_suite_io_nw_xfer, true);
 	m0_ut_add(m, &ut_suite_io_pargrp, true);
+	m0_ut_add(m, &ut_suite_io_cache, true);
 	m0_ut_add(m, &ut_suite_io_req, true);
 	m0_ut_add(m, &ut_suite_io_req_fop, true);
 	m0_ut_add(m, &ut_suite_sync, true);
@@ -238,6 +241,7 @@ static void tests_add(struct m0_ut_module *m)
 	m0_ut_add(m, &fdmi_filter_eval_ut, true);
 	m0_ut_add(m, &fit_ut, true);
 	m0_ut_add(m, &fol_ut, true);
+	m0_ut_add(m, &fom_sched_ut, true);
 	m0_ut_add(m, &fom_timedwait_ut, true);
 	m0_ut_add(m, &frm_ut, true);
 	m0_ut_add(m, &ha_ut, true);
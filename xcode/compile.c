@@ -0,0 +1,422 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "lib/misc.h"                           /* M0_SET0 */
+#include "lib/errno.h"
+#include "lib/assert.h"
+#include "lib/memory.h"
+#include "lib/mutex.h"
+#include "lib/atomic.h"                         /* m0_mb */
+#include "xcode/xcode.h"
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_XCODE
+#include "lib/trace.h"
+
+/**
+   @addtogroup xcode
+
+   Compiled xcoding.
+
+   A type marked with M0_XCODE_TYPE_FLAG_COMPILED (M0_XCA_COMPILED in the
+   header) is "compiled" on its first use: the tree of its sub-types is
+   flattened into a linear program of operations, each operation either
+   copying a run of bytes, contiguous both in memory and in the serialised
+   representation, or xcoding a SEQUENCE. The program produces exactly the
+   same serialised representation as ctx_walk(), but without the cursor and
+   without a per-field dispatch.
+
+   Only types built of RECORD, TYPEDEF, ARRAY, SEQUENCE and ATOM aggregates,
+   without custom m0_xcode_type_ops, can be compiled. For other types a program
+   with prog_failed set is recorded, and xcoding falls back to ctx_walk().
+
+   @{
+ */
+
+enum xprog_opcode {
+	/** Copy po_nob bytes at po_offset. */
+	XPO_COPY,
+	/**
+	 * Xcode elements of a sequence. The counter is xcoded by the preceding
+	 * XPO_COPY operation (unless it is VOID), so when decoding it is
+	 * already in memory when XPO_SEQ is executed.
+	 */
+	XPO_SEQ
+};
+
+struct xprog_op {
+	enum xprog_opcode           po_code;
+	/** XPO_COPY: offset of the data, XPO_SEQ: offset of the counter. */
+	uint32_t                    po_offset;
+	/** XPO_COPY: number of bytes, XPO_SEQ: size of the counter. */
+	uint32_t                    po_nob;
+	/** XPO_SEQ: offset of the pointer to elements. */
+	uint32_t                    po_ptr;
+	/** XPO_SEQ: size of an element. */
+	uint32_t                    po_elsize;
+	/** XPO_SEQ: number of elements when the counter is VOID. */
+	uint64_t                    po_nr;
+	/** XPO_SEQ: program for elements, NULL for atomic elements. */
+	const struct m0_xcode_prog *po_elem;
+};
+
+enum {
+	/** Maximal number of operations in a program. */
+	XPROG_OPS_MAX = 64
+};
+
+struct m0_xcode_prog {
+	/** Type this program is compiled from. */
+	struct m0_xcode_type *prog_type;
+	/** Linkage in the list of all programs. */
+	struct m0_xcode_prog *prog_next;
+	/** The type cannot be compiled. */
+	bool                  prog_failed;
+	/** Program has no XPO_SEQ operations. */
+	bool                  prog_fixed;
+	/** Serialised size, valid when prog_fixed is true. */
+	m0_bcount_t           prog_nob;
+	uint32_t              prog_nr;
+	struct xprog_op       prog_op[XPROG_OPS_MAX];
+};
+
+/** Protects prog_list and m0_xcode_type::xct_prog assignments. */
+static struct m0_mutex       prog_lock = M0_MUTEX_SINIT(&prog_lock);
+static struct m0_xcode_prog *prog_list = NULL;
+
+static bool has_ops(const struct m0_xcode_type *xt)
+{
+	const struct m0_xcode_type_ops *ops = xt->xct_ops;
+
+	return ops != NULL && (ops->xto_encode != NULL ||
+			       ops->xto_decode != NULL ||
+			       ops->xto_length != NULL);
+}
+
+static struct xprog_op *op_add(struct m0_xcode_prog *prog)
+{
+	struct xprog_op *op;
+
+	if (prog->prog_nr == ARRAY_SIZE(prog->prog_op))
+		return NULL;
+	op = &prog->prog_op[prog->prog_nr++];
+	M0_SET0(op);
+	return op;
+}
+
+static int copy_add(struct m0_xcode_prog *prog, size_t offset, size_t nob)
+{
+	struct xprog_op *op;
+
+	if (nob == 0)
+		return 0;
+	op = prog->prog_nr > 0 ? &prog->prog_op[prog->prog_nr - 1] : NULL;
+	/* Merge with the previous copy, if contiguous. */
+	if (op != NULL && op->po_code == XPO_COPY &&
+	    op->po_offset + op->po_nob == offset) {
+		op->po_nob += nob;
+		return 0;
+	}
+	op = op_add(prog);
+	if (op == NULL)
+		return -E2BIG;
+	op->po_code   = XPO_COPY;
+	op->po_offset = offset;
+	op->po_nob    = nob;
+	return 0;
+}
+
+static const struct m0_xcode_prog *prog_compile(struct m0_xcode_type *xt,
+						int depth);
+
+static int emit(struct m0_xcode_prog *prog, const struct m0_xcode_type *xt,
+		size_t base, int depth)
+{
+	const struct m0_xcode_field *f;
+	const struct m0_xcode_type  *et;
+	struct xprog_op             *op;
+	int                          result = 0;
+	uint64_t                     i;
+
+	if (has_ops(xt) || depth >= M0_XCODE_DEPTH_MAX)
+		return -EOPNOTSUPP;
+
+	switch (xt->xct_aggr) {
+	case M0_XA_ATOM:
+		result = copy_add(prog, base, xt->xct_sizeof);
+		break;
+	case M0_XA_RECORD:
+	case M0_XA_TYPEDEF:
+		for (i = 0; i < xt->xct_nr && result == 0; ++i) {
+			f = &xt->xct_child[i];
+			if (f->xf_type == &M0_XT_OPAQUE)
+				return -EOPNOTSUPP;
+			result = emit(prog, f->xf_type, base + f->xf_offset,
+				      depth + 1);
+		}
+		break;
+	case M0_XA_ARRAY:
+		f = &xt->xct_child[0];
+		for (i = 0; i < f->xf_tag && result == 0; ++i)
+			result = emit(prog, f->xf_type, base + f->xf_offset +
+				      i * f->xf_type->xct_sizeof, depth + 1);
+		break;
+	case M0_XA_SEQUENCE:
+		f  = &xt->xct_child[0];
+		et = xt->xct_child[1].xf_type;
+		if (et == &M0_XT_OPAQUE || has_ops(f->xf_type))
+			return -EOPNOTSUPP;
+		/* The counter. */
+		result = copy_add(prog, base + f->xf_offset,
+				  f->xf_type->xct_sizeof);
+		if (result != 0)
+			break;
+		op = op_add(prog);
+		if (op == NULL)
+			return -E2BIG;
+		op->po_code   = XPO_SEQ;
+		op->po_offset = base + f->xf_offset;
+		op->po_nob    = f->xf_type->xct_sizeof;
+		op->po_nr     = f->xf_tag;
+		op->po_ptr    = base + xt->xct_child[1].xf_offset;
+		op->po_elsize = et->xct_sizeof;
+		if (et->xct_aggr != M0_XA_ATOM) {
+			/* Discard const, the same as m0_xcode_type_iterate(). */
+			op->po_elem = prog_compile((void *)et, depth + 1);
+			if (op->po_elem->prog_failed)
+				return -EOPNOTSUPP;
+		} else if (has_ops(et))
+			return -EOPNOTSUPP;
+		prog->prog_fixed = false;
+		break;
+	default:
+		result = -EOPNOTSUPP;
+	}
+	return result;
+}
+
+/**
+ * Returns the program for a type, compiling it if necessary. Never returns
+ * NULL: if the type cannot be compiled or memory cannot be allocated, a
+ * failed program is returned.
+ */
+static const struct m0_xcode_prog *prog_compile(struct m0_xcode_type *xt,
+						int depth)
+{
+	static struct m0_xcode_prog  nomem = { .prog_failed = true };
+	struct m0_xcode_prog        *prog;
+	int                          result;
+
+	M0_PRE(m0_mutex_is_locked(&prog_lock));
+
+	if (xt->xct_prog != NULL)
+		return xt->xct_prog;
+	M0_ALLOC_PTR(prog);
+	if (prog == NULL)
+		return &nomem;
+	prog->prog_type  = xt;
+	prog->prog_fixed = true;
+	/* Recursive types (a sequence of itself) are cut by the depth limit. */
+	result = emit(prog, xt, 0, depth);
+	if (result == 0) {
+		if (prog->prog_fixed)
+			prog->prog_nob = m0_reduce(i, prog->prog_nr, 0ULL,
+						   + prog->prog_op[i].po_nob);
+	} else {
+		M0_LOG(M0_DEBUG, "%s is not compiled: %i", xt->xct_name,
+		       result);
+		prog->prog_failed = true;
+		prog->prog_nr     = 0;
+	}
+	prog->prog_next = prog_list;
+	prog_list = prog;
+	/* Make the program visible only after it is complete. */
+	m0_mb();
+	xt->xct_prog = prog;
+	return prog;
+}
+
+M0_INTERNAL const struct m0_xcode_prog *
+m0_xcode_prog_get(const struct m0_xcode_type *xt)
+{
+	const struct m0_xcode_prog *prog = xt->xct_prog;
+
+	if (!(xt->xct_flags & M0_XCODE_TYPE_FLAG_COMPILED))
+		return NULL;
+	if (prog == NULL) {
+		m0_mutex_lock(&prog_lock);
+		/* Discard const, the same as m0_xcode_type_iterate(). */
+		prog = prog_compile((struct m0_xcode_type *)xt, 0);
+		m0_mutex_unlock(&prog_lock);
+	}
+	return prog->prog_failed ? NULL : prog;
+}
+
+M0_INTERNAL void m0_xcode_prog_fini(void)
+{
+	struct m0_xcode_prog *prog;
+
+	m0_mutex_lock(&prog_lock);
+	while ((prog = prog_list) != NULL) {
+		prog_list = prog->prog_next;
+		prog->prog_type->xct_prog = NULL;
+		m0_free(prog);
+	}
+	m0_mutex_unlock(&prog_lock);
+}
+
+static int copy(struct m0_bufvec_cursor *buf, void *mem, m0_bcount_t nob,
+		enum m0_xcode_what what)
+{
+	void        *addr;
+	m0_bcount_t  done;
+
+	/* Fast path: the whole run fits into the current segment. */
+	if (!m0_bufvec_cursor_move(buf, 0) &&
+	    m0_bufvec_cursor_step(buf) >= nob) {
+		addr = m0_bufvec_cursor_addr(buf);
+		if (what == M0_XCODE_ENCODE)
+			memcpy(addr, mem, nob);
+		else
+			memcpy(mem, addr, nob);
+		m0_bufvec_cursor_move(buf, nob);
+		return 0;
+	}
+	done = what == M0_XCODE_ENCODE ?
+		m0_bufvec_cursor_copyto(buf, mem, nob) :
+		m0_bufvec_cursor_copyfrom(buf, mem, nob);
+	return done == nob ? 0 : -EPROTO;
+}
+
+static uint64_t seq_nr(const struct xprog_op *op, const char *obj)
+{
+	const void *cnt = obj + op->po_offset;
+
+	switch (op->po_nob) {
+	case 0:
+		return op->po_nr;
+	case 1:
+		return *(const uint8_t *)cnt;
+	case 4:
+		return *(const uint32_t *)cnt;
+	case 8:
+		return *(const uint64_t *)cnt;
+	default:
+		M0_IMPOSSIBLE("counter size");
+		return 0;
+	}
+}
+
+/**
+ * Executes the program on an object. For M0_XCODE_DECODE the object memory is
+ * provided by the caller, sequences are allocated with m0_alloc(), the same as
+ * m0_xcode_alloc() does.
+ *
+ * When "buf" is NULL, the serialised size is added to "*nob".
+ */
+static int prog_run(const struct m0_xcode_prog *prog, char *obj,
+		    struct m0_bufvec_cursor *buf, enum m0_xcode_what what,
+		    m0_bcount_t *nob)
+{
+	const struct xprog_op *op;
+	uint64_t               nr;
+	uint64_t               i;
+	char                 **slot;
+	int                    result = 0;
+
+	if (buf == NULL && prog->prog_fixed) {
+		*nob += prog->prog_nob;
+		return 0;
+	}
+	for (op = prog->prog_op;
+	     op < prog->prog_op + prog->prog_nr && result == 0; ++op) {
+		if (op->po_code == XPO_COPY) {
+			if (buf == NULL)
+				*nob += op->po_nob;
+			else
+				result = copy(buf, obj + op->po_offset,
+					      op->po_nob, what);
+			continue;
+		}
+		M0_ASSERT(op->po_code == XPO_SEQ);
+		nr = seq_nr(op, obj);
+		if (nr == 0 || op->po_elsize == 0)
+			continue;
+		slot = (char **)(obj + op->po_ptr);
+		if (what == M0_XCODE_DECODE && *slot == NULL) {
+			if (nr > ~(size_t)0 / op->po_elsize)
+				return M0_ERR(-EPROTO);
+			*slot = m0_alloc(nr * op->po_elsize);
+			if (*slot == NULL)
+				return M0_ERR(-ENOMEM);
+		}
+		if (op->po_elem == NULL) {
+			if (buf == NULL)
+				*nob += nr * op->po_elsize;
+			else
+				result = copy(buf, *slot, nr * op->po_elsize,
+					      what);
+		} else {
+			for (i = 0; i < nr && result == 0; ++i)
+				result = prog_run(op->po_elem,
+						  *slot + i * op->po_elsize,
+						  buf, what, nob);
+		}
+	}
+	return result;
+}
+
+M0_INTERNAL int m0_xcode_prog_encdec(const struct m0_xcode_prog *prog,
+				     void *obj, struct m0_bufvec_cursor *buf,
+				     enum m0_xcode_what what)
+{
+	M0_PRE(!prog->prog_failed);
+	return prog_run(prog, obj, buf, what, NULL);
+}
+
+M0_INTERNAL m0_bcount_t m0_xcode_prog_length(const struct m0_xcode_prog *prog,
+					     const void *obj)
+{
+	m0_bcount_t nob    = 0;
+	int         result;
+
+	M0_PRE(!prog->prog_failed);
+	result = prog_run(prog, (void *)obj, NULL, M0_XCODE_ENCODE, &nob);
+	M0_ASSERT(result == 0);
+	return nob;
+}
+
+#undef M0_TRACE_SUBSYSTEM
+
+/** @} end of xcode group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
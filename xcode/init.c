@@ -20,6 +20,7 @@
  */
 
 
+#include "xcode/xcode.h"        /* m0_xcode_prog_fini */
 
 /**
  * @addtogroup xcode
@@ -70,6 +71,7 @@ void m0_xcode_fini(void)
 #undef _EN
 #undef _FI
 #undef _FF
+	m0_xcode_prog_fini();
 }
 
 /** @} end of xcode group */
@@ -31,6 +31,7 @@
 #include "lib/arith.h"                      /* m0_rnd64 */
 #include "lib/errno.h"                      /* ENOENT */
 #include "lib/string.h"                     /* m0_streq */
+#include "lib/ub.h"                         /* m0_ub_set */
 #include "ut/ut.h"
 
 #include "xcode/xcode.h"
@@ -72,6 +73,18 @@ struct top {
 	struct ar  t_ar;
 };
 
+struct cpl {
+	struct foo   c_foo;
+	uint32_t     c_flag;
+	struct v     c_v;
+	tdef         c_def;
+	struct ar    c_ar;
+	struct fseq {
+		uint64_t    s_nr;
+		struct foo *s_el;
+	} c_seq;
+};
+
 enum { CHILDREN_MAX = 16 };
 
 struct static_xt {
@@ -133,6 +146,24 @@ static struct static_xt xut_top = {
 	}
 };
 
+static struct static_xt xut_fseq = {
+	.xt = {
+		.xct_aggr   = M0_XA_SEQUENCE,
+		.xct_name   = "fseq",
+		.xct_sizeof = sizeof (struct fseq),
+		.xct_nr     = 2
+	}
+};
+
+static struct static_xt xut_cpl = {
+	.xt = {
+		.xct_aggr   = M0_XA_RECORD,
+		.xct_name   = "cpl",
+		.xct_sizeof = sizeof (struct cpl),
+		.xct_nr     = 6
+	}
+};
+
 static char data[] = "Hello, world!\n";
 
 static struct top T = {
@@ -163,6 +194,31 @@ static struct top T = {
 	}
 };
 
+static struct foo cpl_el[] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+
+static struct cpl C = {
+	.c_foo  = {
+		.f_x = 9,
+		.f_y = 10
+	},
+	.c_flag = 0xa,
+	.c_v    = {
+		.v_nr   = sizeof data,
+		.v_data = data
+	},
+	.c_def  = 11,
+	.c_ar   = {
+		.a_el = {
+			[0] = { 6, 0 },
+			[5] = { 0, 6 }
+		}
+	},
+	.c_seq  = {
+		.s_nr = ARRAY_SIZE(cpl_el),
+		.s_el = cpl_el
+	}
+};
+
 static char                 ebuf[1000];
 static m0_bcount_t          count = ARRAY_SIZE(ebuf);
 static void                *vec = ebuf;
@@ -303,6 +359,48 @@ static int xcode_init(void)
 		.xf_tag    = N,
 	};
 
+	xut_fseq.xt.xct_child[0] = (struct m0_xcode_field){
+		.xf_name   = "s_nr",
+		.xf_type   = &M0_XT_U64,
+		.xf_offset = offsetof(struct fseq, s_nr)
+	};
+	xut_fseq.xt.xct_child[1] = (struct m0_xcode_field){
+		.xf_name   = "s_el",
+		.xf_type   = &xut_foo.xt,
+		.xf_offset = offsetof(struct fseq, s_el)
+	};
+
+	xut_cpl.xt.xct_child[0] = (struct m0_xcode_field){
+		.xf_name   = "c_foo",
+		.xf_type   = &xut_foo.xt,
+		.xf_offset = offsetof(struct cpl, c_foo)
+	};
+	xut_cpl.xt.xct_child[1] = (struct m0_xcode_field){
+		.xf_name   = "c_flag",
+		.xf_type   = &M0_XT_U32,
+		.xf_offset = offsetof(struct cpl, c_flag)
+	};
+	xut_cpl.xt.xct_child[2] = (struct m0_xcode_field){
+		.xf_name   = "c_v",
+		.xf_type   = &xut_v.xt,
+		.xf_offset = offsetof(struct cpl, c_v)
+	};
+	xut_cpl.xt.xct_child[3] = (struct m0_xcode_field){
+		.xf_name   = "c_def",
+		.xf_type   = &xut_tdef.xt,
+		.xf_offset = offsetof(struct cpl, c_def)
+	};
+	xut_cpl.xt.xct_child[4] = (struct m0_xcode_field){
+		.xf_name   = "c_ar",
+		.xf_type   = &xut_ar.xt,
+		.xf_offset = offsetof(struct cpl, c_ar)
+	};
+	xut_cpl.xt.xct_child[5] = (struct m0_xcode_field){
+		.xf_name   = "c_seq",
+		.xf_type   = &xut_fseq.xt,
+		.xf_offset = offsetof(struct cpl, c_seq)
+	};
+
 	TD.t_foo.f_x  =  T.t_foo.f_x;
 	TD.t_foo.f_y  =  T.t_foo.f_y;
 	TD.t_flag     =  T.t_flag;
@@ -1259,6 +1357,152 @@ static void xcode_flags(void)
 	m0_xcode_type_iterate(&xut_top.xt, NULL, &fieldclear, (void *)0);
 }
 
+static int cpl_xcode(struct m0_xcode_obj *obj, void *buf, m0_bcount_t nob,
+		     enum m0_xcode_what what)
+{
+	struct m0_bufvec        bv = M0_BUFVEC_INIT_BUF(&buf, &nob);
+	struct m0_bufvec_cursor cur;
+
+	m0_bufvec_cursor_init(&cur, &bv);
+	return m0_xcode_encdec(obj, &cur, what);
+}
+
+static void xcode_compiled(void)
+{
+	static char         cbuf[ARRAY_SIZE(ebuf)];
+	struct m0_xcode_obj obj = { &xut_cpl.xt, &C };
+	struct m0_xcode_obj dec = { &xut_cpl.xt, NULL };
+	struct cpl          D   = {};
+	int                 len;
+	int                 result;
+
+	/* Reference representation, produced by the generic code. */
+	M0_UT_ASSERT(m0_xcode_prog_get(&xut_cpl.xt) == NULL);
+	len = m0_xcode_data_size(&ctx, &obj);
+	M0_UT_ASSERT(len > 0 && len < sizeof ebuf);
+	result = cpl_xcode(&obj, ebuf, len, M0_XCODE_ENCODE);
+	M0_UT_ASSERT(result == 0);
+
+	xut_cpl.xt.xct_flags |= M0_XCODE_TYPE_FLAG_COMPILED;
+	M0_UT_ASSERT(m0_xcode_prog_get(&xut_cpl.xt) != NULL);
+	M0_UT_ASSERT(m0_xcode_data_size(&ctx, &obj) == len);
+	result = cpl_xcode(&obj, cbuf, len, M0_XCODE_ENCODE);
+	M0_UT_ASSERT(result == 0);
+	M0_UT_ASSERT(memcmp(ebuf, cbuf, len) == 0);
+
+	result = cpl_xcode(&dec, ebuf, len, M0_XCODE_DECODE);
+	M0_UT_ASSERT(result == 0);
+	M0_UT_ASSERT(dec.xo_ptr != NULL);
+	M0_UT_ASSERT(m0_xcode_cmp(&obj, &dec) == 0);
+	m0_xcode_free_obj(&dec);
+
+	/* Short buffer. */
+	dec.xo_ptr = &D;
+	result = cpl_xcode(&dec, ebuf, len - 1, M0_XCODE_DECODE);
+	M0_UT_ASSERT(result == -EPROTO);
+	M0_UT_ASSERT(D.c_v.v_nr == C.c_v.v_nr &&
+		     memcmp(D.c_v.v_data, C.c_v.v_data, C.c_v.v_nr) == 0);
+	m0_free(D.c_v.v_data);
+	m0_free(D.c_seq.s_el);
+	xut_cpl.xt.xct_flags &= ~M0_XCODE_TYPE_FLAG_COMPILED;
+
+	/* Types with UNION and OPAQUE fields are not compiled. */
+	xut_top.xt.xct_flags |= M0_XCODE_TYPE_FLAG_COMPILED;
+	M0_UT_ASSERT(m0_xcode_prog_get(&xut_top.xt) == NULL);
+	xcode_length_test();
+	xcode_encode_test();
+	xut_top.xt.xct_flags &= ~M0_XCODE_TYPE_FLAG_COMPILED;
+}
+
+enum { UB_ITER = 1000000 };
+
+static char               ub_buf[ARRAY_SIZE(ebuf)];
+static int                ub_len;
+static struct m0_xcode_obj ub_obj = { &xut_cpl.xt, &C };
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	int result = xcode_init();
+
+	if (result == 0) {
+		ub_len = m0_xcode_data_size(&ctx, &ub_obj);
+		M0_ASSERT(ub_len > 0 && ub_len < sizeof ub_buf);
+		result = cpl_xcode(&ub_obj, ub_buf, ub_len, M0_XCODE_ENCODE);
+	}
+	return result;
+}
+
+static void ub_generic(void)
+{
+	xut_cpl.xt.xct_flags &= ~M0_XCODE_TYPE_FLAG_COMPILED;
+}
+
+static void ub_compiled(void)
+{
+	xut_cpl.xt.xct_flags |= M0_XCODE_TYPE_FLAG_COMPILED;
+}
+
+static void ub_encode(int i)
+{
+	int result = cpl_xcode(&ub_obj, ub_buf, ub_len, M0_XCODE_ENCODE);
+	M0_ASSERT(result == 0);
+}
+
+static void ub_decode(int i)
+{
+	struct m0_xcode_obj obj = { &xut_cpl.xt, NULL };
+	int                 result;
+
+	result = cpl_xcode(&obj, ub_buf, ub_len, M0_XCODE_DECODE);
+	M0_ASSERT(result == 0);
+	m0_xcode_free_obj(&obj);
+}
+
+static void ub_length(int i)
+{
+	int result = m0_xcode_data_size(&ctx, &ub_obj);
+	M0_ASSERT(result == ub_len);
+}
+
+struct m0_ub_set m0_xcode_ub = {
+	.us_name = "xcode-ub",
+	.us_init = ub_init,
+	.us_fini = ub_generic,
+	.us_run  = {
+		{ .ub_name  = "encode",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_generic,
+		  .ub_round = ub_encode },
+
+		{ .ub_name  = "encode-compiled",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_compiled,
+		  .ub_round = ub_encode },
+
+		{ .ub_name  = "decode",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_generic,
+		  .ub_round = ub_decode },
+
+		{ .ub_name  = "decode-compiled",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_compiled,
+		  .ub_round = ub_decode },
+
+		{ .ub_name  = "length",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_generic,
+		  .ub_round = ub_length },
+
+		{ .ub_name  = "length-compiled",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_compiled,
+		  .ub_round = ub_length },
+
+		{ .ub_name = NULL }
+	}
+};
+
 /*
  * Stub function, it's not meant to be used anywhere, it's defined to calm down
  * linker, which throws an "undefined reference to `m0_package_cred_get'"
@@ -1297,6 +1541,7 @@ struct m0_ut_suite xcode_ut = {
 		{ "xcode-enum-field",     xcode_enum_field,        "Nikita" },
 		{ "xcode-iterate",        xcode_iterate,           "Nikita" },
 		{ "xcode-flags",          xcode_flags,             "Nikita" },
+		{ "xcode-compiled",       xcode_compiled },
 		{ NULL, NULL }
 	}
 };
@@ -254,6 +254,24 @@ M0_INTERNAL void m0_xcode_free_obj(struct m0_xcode_obj *obj)
 	m0_xcode_free(&ctx);
 }
 
+/**
+   Returns the compiled program to xcode a sub-object with, or NULL.
+ */
+static const struct m0_xcode_prog *ctx_prog(const struct m0_xcode_ctx *ctx,
+					    const struct m0_xcode_type *xt,
+					    enum xcode_op op)
+{
+	/*
+	 * The program does not visit sub-objects with the cursor, so it cannot
+	 * be used when the user wants to see them.
+	 */
+	if (!(xt->xct_flags & M0_XCODE_TYPE_FLAG_COMPILED) ||
+	    ctx->xcx_iter != NULL ||
+	    (op == XO_DEC && ctx->xcx_alloc != m0_xcode_alloc))
+		return NULL;
+	return m0_xcode_prog_get(xt);
+}
+
 /**
    Common xcoding function, implementing encoding, decoding and sizing.
  */
@@ -272,6 +290,7 @@ static int ctx_walk(struct m0_xcode_ctx *ctx, enum xcode_op op)
 	while ((result = m0_xcode_next(it)) > 0) {
 		const struct m0_xcode_type     *xt;
 		const struct m0_xcode_type_ops *ops;
+		const struct m0_xcode_prog     *prog;
 		struct m0_xcode_obj            *cur;
 		struct m0_xcode_cursor_frame   *top;
 
@@ -294,11 +313,21 @@ static int ctx_walk(struct m0_xcode_ctx *ctx, enum xcode_op op)
 				break;
 		}
 
-		xt  = cur->xo_type;
-		ptr = cur->xo_ptr;
-		ops = xt->xct_ops;
+		xt   = cur->xo_type;
+		ptr  = cur->xo_ptr;
+		ops  = xt->xct_ops;
+		prog = ctx_prog(ctx, xt, op);
 
-		if (ops != NULL &&
+		if (prog != NULL) {
+			if (op == XO_LEN)
+				length += m0_xcode_prog_length(prog, ptr);
+			else
+				result = m0_xcode_prog_encdec(prog, ptr,
+					      &ctx->xcx_buf, op == XO_ENC ?
+					      M0_XCODE_ENCODE :
+					      M0_XCODE_DECODE);
+			m0_xcode_skip(it);
+		} else if (ops != NULL &&
 		    ((op == XO_ENC && ops->xto_encode != NULL) ||
 		     (op == XO_DEC && ops->xto_decode != NULL) ||
 		     (op == XO_LEN && ops->xto_length != NULL))) {
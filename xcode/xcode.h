@@ -154,6 +154,7 @@ struct m0_xcode_obj;
 struct m0_xcode_field;
 struct m0_xcode_cursor;
 struct m0_xcode_field_ops;
+struct m0_xcode_prog;
 
 /**
    Type of aggregation for a data-type.
@@ -304,6 +305,8 @@ enum m0_xcode_type_flags {
 	M0_XCODE_TYPE_FLAG_DOM_RPC    = 1 << 1,
 	/** Type belongs to CONF xcode domain, @see M0_XCA_DOMAIN */
 	M0_XCODE_TYPE_FLAG_DOM_CONF   = 1 << 2,
+	/** Type is xcoded by a compiled program, @see M0_XCA_COMPILED */
+	M0_XCODE_TYPE_FLAG_COMPILED   = 1 << 3,
 };
 M0_BASSERT(sizeof(enum m0_xcode_type_flags) <= sizeof(uint32_t));
 
@@ -341,6 +344,13 @@ struct m0_xcode_type {
 	size_t                          xct_sizeof;
 	/** Number of fields. */
 	size_t                          xct_nr;
+	/**
+	   Compiled xcoding program, built on the first xcoding of a type with
+	   M0_XCODE_TYPE_FLAG_COMPILED flag.
+
+	   @see m0_xcode_prog_get()
+	 */
+	const struct m0_xcode_prog     *xct_prog;
 	/** Array of fields. */
 	struct m0_xcode_field           xct_child[0];
 };
@@ -657,6 +667,34 @@ M0_INTERNAL int m0_xcode_encdec(struct m0_xcode_obj *obj,
 				struct m0_bufvec_cursor *cur,
 				enum m0_xcode_what  what);
 
+/**
+   Returns the compiled program for a type with M0_XCODE_TYPE_FLAG_COMPILED,
+   compiling it on the first call.
+
+   Returns NULL if the type is not marked, or cannot be compiled (contains
+   UNION or OPAQUE sub-objects, or sub-types with custom m0_xcode_type_ops). In
+   this case generic xcoding is used.
+
+   m0_xcode_encode(), m0_xcode_decode() and m0_xcode_length() use the program
+   automatically for marked (sub-)objects, unless the context has
+   m0_xcode_ctx::xcx_iter set or, for decoding, uses an allocator other than
+   m0_xcode_alloc().
+ */
+M0_INTERNAL const struct m0_xcode_prog *
+m0_xcode_prog_get(const struct m0_xcode_type *xt);
+
+/**
+   Encodes or decodes an object with a compiled program. When decoding, "obj"
+   must point to the memory for the object.
+ */
+M0_INTERNAL int m0_xcode_prog_encdec(const struct m0_xcode_prog *prog,
+				     void *obj, struct m0_bufvec_cursor *buf,
+				     enum m0_xcode_what what);
+M0_INTERNAL m0_bcount_t m0_xcode_prog_length(const struct m0_xcode_prog *prog,
+					     const void *obj);
+/** Frees all compiled programs. Called by m0_xcode_fini(). */
+M0_INTERNAL void m0_xcode_prog_fini(void);
+
 /** Allocates buffer and places there encoded object. */
 M0_INTERNAL int m0_xcode_obj_enc_to_buf(struct m0_xcode_obj *obj,
 					void **buf, m0_bcount_t *len);
@@ -58,6 +58,13 @@
 #define M0_XCA_FENUM(value)    M0_XC_ATTR("fenum", #value)
 #define M0_XCA_FBITMASK(value) M0_XC_ATTR("fbitmask", #value)
 
+/**
+ * Mark a struct to be xcoded by a compiled program instead of the generic
+ * type walk, @see m0_xcode_prog_get(). Useful for small types, which are
+ * encoded and decoded at a high rate.
+ */
+#define M0_XCA_COMPILED        M0_XC_ATTR("compiled", "yes")
+
 /**
  * Set "xcode domain" attribute on a struct. The domain is used in `m0protocol`
  * utility to separate xcode structs into groups.